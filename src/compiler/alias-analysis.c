@@ -0,0 +1,324 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "alias-analysis.h"
+
+/* roots being traced, to stop at cycles through copies outside SSA form */
+enum alias_root_state {
+	ALIAS_ROOT_NEW = 0,
+	ALIAS_ROOT_VISITING,
+	ALIAS_ROOT_DONE
+};
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool alias_is_temporary(struct alias_analysis *analysis, struct ir_operand *operand) {
+	return NULL != operand && OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= analysis->max_temporary;
+}
+
+static bool alias_is_load(struct ir_instruction *instruction) {
+	return (
+		IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind
+	);
+}
+
+static bool alias_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+static int alias_width(struct ir_instruction *instruction) {
+	switch (instruction->kind) {
+		case IR_LOAD_HALF_WORD:
+		case IR_LOAD_SIGNED_HALF_WORD:
+		case IR_STORE_HALF_WORD:
+			return 2;
+		case IR_LOAD_BYTE:
+		case IR_LOAD_SIGNED_BYTE:
+		case IR_STORE_BYTE:
+			return 1;
+		default:
+			return 4;
+	}
+}
+
+/* the only instruction writing the temporary */
+static struct ir_instruction *alias_definition(struct alias_analysis *analysis, struct ir_operand *operand) {
+	if (!alias_is_temporary(analysis, operand)) return NULL;
+
+	int temporary = operand->data.temporary;
+	if (1 != analysis->definition_counts[temporary]) return NULL;
+	return analysis->temporary_definitions[temporary]->data;
+}
+
+/* constants optimization 1 turned into immediates are only left in the constants map */
+static bool alias_constant(struct alias_analysis *analysis, struct ir_operand *operand, int *value) {
+	if (!alias_is_temporary(analysis, operand)) return false;
+
+	int temporary = operand->data.temporary;
+	struct ir_instruction *definition = alias_definition(analysis, operand);
+	if (NULL != definition && IR_CONST_INT == definition->kind) {
+		*value = (int)definition->operands[1].data.number;
+		return true;
+	}
+	if (0 == analysis->definition_counts[temporary] && NULL != ir_get_const_map_entry(temporary)) {
+		*value = (int)strtol(ir_get_const_map_entry(temporary), NULL, 10);
+		return true;
+	}
+	return false;
+}
+
+/* the addressOf of a named variable, NULL for strings and everything else */
+static struct ir_instruction *alias_variable_address(struct ir_instruction *instruction) {
+	if (NULL == instruction || IR_ADDRESS_OF != instruction->kind || instruction->operands[2].data.is_string) return NULL;
+	return instruction;
+}
+
+/*********
+ * ROOTS *
+ *********/
+
+static void alias_opaque(struct alias_location *root, int temporary) {
+	root->kind = ALIAS_POINTER;
+	root->base = temporary;
+	root->is_offset_known = true;
+	root->offset = 0;
+}
+
+static struct alias_location *alias_root(struct alias_analysis *analysis, int temporary, enum alias_root_state *states);
+
+/* base + offset, or somewhere in base if the offset isn't a constant */
+static bool alias_shift(
+	struct alias_analysis *analysis, struct alias_location *root, struct ir_operand *base,
+	struct ir_operand *offset, int sign, enum alias_root_state *states
+) {
+	if (!alias_is_temporary(analysis, base)) return false;
+
+	struct alias_location *base_root = alias_root(analysis, base->data.temporary, states);
+	int value;
+
+	if (alias_constant(analysis, offset, &value)) {
+		*root = *base_root;
+		root->offset += sign * value;
+		return true;
+	}
+
+	/* an index into a variable stays in it, for anything else there's no telling which operand is the pointer */
+	if (ALIAS_VARIABLE != base_root->kind) return false;
+	if (alias_is_temporary(analysis, offset)) {
+		if (ALIAS_VARIABLE == alias_root(analysis, offset->data.temporary, states)->kind) return false;
+	}
+	*root = *base_root;
+	root->is_offset_known = false;
+	return true;
+}
+
+static struct alias_location *alias_root(struct alias_analysis *analysis, int temporary, enum alias_root_state *states) {
+	struct alias_location *root = &analysis->roots[temporary];
+
+	if (ALIAS_ROOT_DONE == states[temporary]) return root;
+	alias_opaque(root, temporary);
+	if (ALIAS_ROOT_VISITING == states[temporary]) return root;
+	states[temporary] = ALIAS_ROOT_VISITING;
+
+	struct ir_instruction *definition = NULL;
+	if (1 == analysis->definition_counts[temporary]) definition = analysis->temporary_definitions[temporary]->data;
+
+	if (NULL == definition) {
+		/* written more than once (or not here), it doesn't hold the same pointer at every access */
+		root->is_offset_known = false;
+	} else if (NULL != alias_variable_address(definition)) {
+		root->kind = ALIAS_VARIABLE;
+		root->base = definition->operands[3].data.variable_id;
+	} else if (IR_COPY == definition->kind && alias_is_temporary(analysis, &definition->operands[1])) {
+		*root = *alias_root(analysis, definition->operands[1].data.temporary, states);
+	} else if (IR_ADD_SIGNED_WORD == definition->kind || IR_ADD_UNSIGNED_WORD == definition->kind) {
+		struct alias_location shifted;
+		int value;
+		if (alias_constant(analysis, &definition->operands[1], &value)) {
+			if (alias_shift(analysis, &shifted, &definition->operands[2], &definition->operands[1], 1, states)) *root = shifted;
+		} else if (alias_shift(analysis, &shifted, &definition->operands[1], &definition->operands[2], 1, states)) {
+			*root = shifted;
+		} else if (alias_shift(analysis, &shifted, &definition->operands[2], &definition->operands[1], 1, states)) {
+			*root = shifted;
+		}
+	} else if (IR_SUB_SIGNED_WORD == definition->kind || IR_SUB_UNSIGNED_WORD == definition->kind) {
+		struct alias_location shifted;
+		if (alias_shift(analysis, &shifted, &definition->operands[1], &definition->operands[2], -1, states)) *root = shifted;
+	}
+
+	states[temporary] = ALIAS_ROOT_DONE;
+	return root;
+}
+
+/***********
+ * ESCAPES *
+ ***********/
+
+/* reading an address as one of these doesn't let it out */
+static bool alias_keeps_address(struct alias_analysis *analysis, struct ir_instruction *instruction, struct ir_operand *use) {
+	if (alias_is_load(instruction) && use == &instruction->operands[1]) return true;
+	if (alias_is_store(instruction) && use == &instruction->operands[0]) return true;
+	if (instruction->kind >= IR_LT_SIGNED_WORD && instruction->kind <= IR_NE_WORD) return true;
+
+	/* more arithmetic on the address, as long as the result is traced back to the same variable */
+	struct ir_operand *definition = ir_definition_operand(instruction);
+	if (IR_PHI == instruction->kind || !alias_is_temporary(analysis, definition)) return false;
+
+	struct alias_location *root = &analysis->roots[definition->data.temporary];
+	struct alias_location *used = &analysis->roots[use->data.temporary];
+	return ALIAS_VARIABLE == root->kind && root->base == used->base;
+}
+
+static void alias_find_escapes(struct alias_analysis *analysis) {
+	struct cfg *cfg = analysis->cfg;
+	struct ir_list *iter;
+
+	/* the addressOf of an offset_variable may already be gone from ir_list */
+	analysis->max_variable = 0;
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *address = alias_variable_address(
+			NULL != iter->data->offset_variable ? iter->data->offset_variable : iter->data
+		);
+		if (NULL != address && address->operands[3].data.variable_id > analysis->max_variable) {
+			analysis->max_variable = address->operands[3].data.variable_id;
+		}
+		if (iter == cfg->proc_end) break;
+	}
+
+	analysis->escapes = calloc(analysis->max_variable + 1, sizeof(bool));
+	assert(NULL != analysis->escapes);
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+
+		/* globals can be read and written by any call */
+		struct ir_instruction *address = alias_variable_address(
+			NULL != instruction->offset_variable ? instruction->offset_variable : instruction
+		);
+		if (NULL != address && 0 != address->operands[6].data.number) {
+			analysis->escapes[address->operands[3].data.variable_id] = true;
+		}
+
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (!alias_is_temporary(analysis, use)) continue;
+
+			struct alias_location *root = &analysis->roots[use->data.temporary];
+			if (ALIAS_VARIABLE == root->kind && !alias_keeps_address(analysis, instruction, use)) {
+				analysis->escapes[root->base] = true;
+			}
+		}
+		if (iter == cfg->proc_end) break;
+	}
+}
+
+/************
+ * ANALYSIS *
+ ************/
+
+struct alias_analysis *alias_analysis_create(struct cfg *cfg) {
+	struct alias_analysis *analysis = calloc(1, sizeof(struct alias_analysis));
+	assert(NULL != analysis);
+	struct ir_list *iter;
+
+	analysis->cfg = cfg;
+	analysis->max_temporary = dataflow_max_temporary(cfg);
+	analysis->temporary_definitions = dataflow_temporary_definitions(cfg, analysis->max_temporary);
+	analysis->definition_counts = calloc(analysis->max_temporary + 1, sizeof(int));
+	analysis->roots = malloc(sizeof(struct alias_location) * (analysis->max_temporary + 1));
+	enum alias_root_state *states = calloc(analysis->max_temporary + 1, sizeof(enum alias_root_state));
+	assert(NULL != analysis->definition_counts && NULL != analysis->roots && NULL != states);
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (alias_is_temporary(analysis, definition)) analysis->definition_counts[definition->data.temporary]++;
+		if (iter == cfg->proc_end) break;
+	}
+
+	for (int t = 0; t <= analysis->max_temporary; t++) alias_root(analysis, t, states);
+	free(states);
+
+	alias_find_escapes(analysis);
+	return analysis;
+}
+
+void alias_analysis_destroy(struct alias_analysis *analysis) {
+	free(analysis->temporary_definitions);
+	free(analysis->definition_counts);
+	free(analysis->roots);
+	free(analysis->escapes);
+	free(analysis);
+}
+
+bool alias_location(struct alias_analysis *analysis, struct ir_instruction *instruction, struct alias_location *location) {
+	if (!alias_is_load(instruction) && !alias_is_store(instruction)) return false;
+
+	struct ir_instruction *address = alias_variable_address(instruction->offset_variable);
+	struct ir_operand *operand = &instruction->operands[alias_is_store(instruction) ? 0 : 1];
+
+	if (NULL != address) {
+		location->kind = ALIAS_VARIABLE;
+		location->base = address->operands[3].data.variable_id;
+		location->is_offset_known = true;
+		location->offset = 0;
+	} else if (NULL == instruction->offset_variable && alias_is_temporary(analysis, operand)) {
+		*location = analysis->roots[operand->data.temporary];
+	} else {
+		location->kind = ALIAS_UNKNOWN;
+		location->base = -1;
+		location->is_offset_known = false;
+		location->offset = 0;
+	}
+	location->width = alias_width(instruction);
+	return true;
+}
+
+bool alias_may_alias(struct alias_analysis *analysis, struct alias_location *location_1, struct alias_location *location_2) {
+	if (ALIAS_UNKNOWN == location_1->kind || ALIAS_UNKNOWN == location_2->kind) return true;
+
+	if (location_1->kind == location_2->kind && location_1->base == location_2->base) {
+		if (!location_1->is_offset_known || !location_2->is_offset_known) return true;
+		return (
+			location_1->offset < location_2->offset + location_2->width &&
+			location_2->offset < location_1->offset + location_1->width
+		);
+	}
+
+	if (ALIAS_VARIABLE == location_1->kind && ALIAS_VARIABLE == location_2->kind) return false;
+	if (ALIAS_POINTER == location_1->kind && ALIAS_POINTER == location_2->kind) return true;
+
+	/* a pointer can only reach a variable whose address got out */
+	struct alias_location *variable = ALIAS_VARIABLE == location_1->kind ? location_1 : location_2;
+	return analysis->escapes[variable->base];
+}
+
+bool alias_must_alias(struct alias_location *location_1, struct alias_location *location_2) {
+	return (
+		ALIAS_UNKNOWN != location_1->kind &&
+		location_1->kind == location_2->kind &&
+		location_1->base == location_2->base &&
+		location_1->is_offset_known && location_2->is_offset_known &&
+		location_1->offset == location_2->offset &&
+		location_1->width == location_2->width
+	);
+}
+
+bool alias_is_private(struct alias_analysis *analysis, struct alias_location *location) {
+	return ALIAS_VARIABLE == location->kind && !analysis->escapes[location->base];
+}
@@ -0,0 +1,64 @@
+#ifndef _ALIAS_ANALYSIS_H
+#define _ALIAS_ANALYSIS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+enum alias_base_kind {
+  ALIAS_VARIABLE,          /* the address of a named variable, plus some offset */
+  ALIAS_POINTER,           /* some pointer value (a loaded pointer, a parameter, ...), plus some offset */
+  ALIAS_UNKNOWN
+};
+
+/* the bytes a load or store touches */
+struct alias_location {
+  enum alias_base_kind kind;
+  int base;                /* variable id or the temporary holding the pointer */
+  bool is_offset_known;
+  int offset;
+  int width;
+};
+
+/*
+ * Address based alias analysis of one function. Every temporary is traced
+ * back through copies and additions or subtractions of constants (or of
+ * indexes, losing the offset) to the addressOf of a variable or to a pointer
+ * it can't see through. A variable escapes when an address into it is used
+ * as anything but the address of a load or store, the base of more address
+ * arithmetic or a comparison; globals always do, as other functions see
+ * them.
+ *
+ * Distinct variables never alias, accesses at known offsets from the same
+ * base only do if their bytes overlap, and pointers and calls can only reach
+ * variables that escape. The IR keeps no types beyond the width of an
+ * access, so that is all the type information there is.
+ *
+ * The temporaries have to have one definition each, as in SSA form; those
+ * that don't are opaque pointers.
+ */
+struct alias_analysis {
+  struct cfg *cfg;
+  int max_temporary;
+  struct ir_list **temporary_definitions;
+  int *definition_counts;
+  struct alias_location *roots;            /* temporary -> where it points, width unused */
+  int max_variable;
+  bool *escapes;
+};
+
+struct alias_analysis *alias_analysis_create(struct cfg *cfg);
+void alias_analysis_destroy(struct alias_analysis *analysis);
+
+/* the location a load or store accesses, false for any other instruction */
+bool alias_location(struct alias_analysis *analysis, struct ir_instruction *instruction, struct alias_location *location);
+
+bool alias_may_alias(struct alias_analysis *analysis, struct alias_location *location_1, struct alias_location *location_2);
+bool alias_must_alias(struct alias_location *location_1, struct alias_location *location_2);
+
+/* a local whose address doesn't escape: no pointer or call can read or write it */
+bool alias_is_private(struct alias_analysis *analysis, struct alias_location *location);
+
+#endif
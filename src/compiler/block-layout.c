@@ -0,0 +1,398 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "block-layout.h"
+
+/* an edge weighed by how often it's expected to run */
+struct block_layout_edge {
+	struct cfg_block *from, *to;
+	long weight;
+};
+
+static struct cfg *cfg;
+static struct cfg_block *exit_block;
+
+static int *depths;                             /* block -> loops around it */
+static int *probabilities;                      /* block * 2 + successor -> percent */
+static bool *is_early_return;                   /* block * 2 + successor -> the successor returns, the other not */
+static bool *is_cold;
+
+static int *chain_next, *chain_previous;        /* block -> next and previous block in its chain, -1 at the ends */
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool block_layout_is_conditional(struct ir_instruction *instruction) {
+	return IR_GOTO_IF_FALSE == instruction->kind || IR_GOTO_IF_TRUE == instruction->kind;
+}
+
+/* the block it falls into, NULL after a goto or at the end */
+static struct cfg_block *block_layout_fall_through(struct cfg_block *block) {
+	struct ir_instruction *last = block->last->data;
+	if (IR_GOTO == last->kind || IR_PROC_END == last->kind || block->id + 1 == cfg->block_count) return NULL;
+	return cfg->blocks[block->id + 1];
+}
+
+/* the block its branch goes to, NULL without a branch */
+static struct cfg_block *block_layout_target(struct cfg_block *block) {
+	struct ir_instruction *last = block->last->data;
+	if (!ir_is_branch(last)) return NULL;
+
+	for (int s = 0; s < block->successor_count; s++) {
+		struct ir_instruction *first = block->successors[s]->first->data;
+		if (IR_LABEL == first->kind && 0 == strcmp(first->operands[0].data.name, ir_branch_target(last))) {
+			return block->successors[s];
+		}
+	}
+	assert(0);
+	return NULL;
+}
+
+static bool block_layout_is_back_edge(struct cfg_block *from, struct cfg_block *to) {
+	return from->reverse_postorder >= 0 && to->reverse_postorder >= 0 && cfg_dominates(to, from);
+}
+
+/* the block goes straight to the end of the function */
+static bool block_layout_returns(struct cfg_block *block) {
+	return block == exit_block || (1 == block->successor_count && block->successors[0] == exit_block);
+}
+
+static int block_layout_successor_index(struct cfg_block *block, struct cfg_block *successor) {
+	for (int s = 0; s < block->successor_count; s++) {
+		if (block->successors[s] == successor) return s;
+	}
+	assert(0);
+	return -1;
+}
+
+/* the temporary holds 0, as a constant in the block or one optimization 1 turned into an immediate */
+static bool block_layout_is_zero(struct cfg_block *block, struct ir_operand *operand) {
+	if (OPERAND_TEMPORARY != operand->kind) return false;
+
+	const char *constant = ir_get_const_map_entry(operand->data.temporary);
+	if (NULL != constant) return 0 == atoi(constant);
+
+	for (struct ir_list *iter = block->first; ; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		if (IR_CONST_INT == instruction->kind && instruction->operands[0].data.temporary == operand->data.temporary) {
+			return 0 == instruction->operands[1].data.number;
+		}
+		if (iter == block->last) break;
+	}
+	return false;
+}
+
+/**********************
+ * BRANCH PROBABILITY *
+ **********************/
+
+/* percent chance that the comparison computing the condition holds, 50 if nothing is known */
+static int block_layout_comparison_heuristic(struct cfg_block *block) {
+	int condition = block->last->data->operands[0].data.temporary;
+	struct ir_instruction *comparison = NULL;
+
+	for (struct ir_list *iter = block->last->prev; NULL != iter; iter = iter->prev) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL != definition && OPERAND_TEMPORARY == definition->kind && definition->data.temporary == condition) {
+			comparison = iter->data;
+			break;
+		}
+		if (iter == block->first) break;
+	}
+	if (NULL == comparison) return 50;
+
+	bool left_zero = block_layout_is_zero(block, &comparison->operands[1]);
+	bool right_zero = block_layout_is_zero(block, &comparison->operands[2]);
+	switch (comparison->kind) {
+		case IR_EQ_WORD:
+			return 100 - BLOCK_LAYOUT_LIKELY;
+		case IR_NE_WORD:
+			return BLOCK_LAYOUT_LIKELY;
+		case IR_LT_SIGNED_WORD:
+		case IR_LE_SIGNED_WORD:
+			/* x < 0 */
+			if (right_zero) return 100 - BLOCK_LAYOUT_LIKELY;
+			if (left_zero) return BLOCK_LAYOUT_LIKELY;
+			return 50;
+		case IR_GT_SIGNED_WORD:
+		case IR_GE_SIGNED_WORD:
+			if (right_zero) return BLOCK_LAYOUT_LIKELY;
+			if (left_zero) return 100 - BLOCK_LAYOUT_LIKELY;
+			return 50;
+		default:
+			return 50;
+	}
+}
+
+/* the percent chance of the first successor; the first heuristic that applies decides */
+static void block_layout_predict(struct cfg_block *block, struct cfg_loop *loops, int loop_count) {
+	int *probability = &probabilities[block->id * 2];
+
+	probability[0] = 100;
+	if (2 != block->successor_count) return;
+
+	struct cfg_block *first = block->successors[0], *second = block->successors[1];
+	probability[0] = 50;
+
+	/* loops go round */
+	if (block_layout_is_back_edge(block, first) != block_layout_is_back_edge(block, second)) {
+		probability[0] = block_layout_is_back_edge(block, first) ? BLOCK_LAYOUT_LIKELY : 100 - BLOCK_LAYOUT_LIKELY;
+		return;
+	}
+
+	/* and don't leave, the innermost loop around the block decides */
+	for (int l = 0; l < loop_count; l++) {
+		if (!loops[l].body[block->id]) continue;
+		if (loops[l].body[first->id] != loops[l].body[second->id]) {
+			probability[0] = loops[l].body[first->id] ? BLOCK_LAYOUT_LIKELY : 100 - BLOCK_LAYOUT_LIKELY;
+			return;
+		}
+		break;
+	}
+
+	/* early returns are error checks */
+	if (block_layout_returns(first) != block_layout_returns(second)) {
+		bool first_returns = block_layout_returns(first);
+		probability[0] = first_returns ? 100 - BLOCK_LAYOUT_LIKELY : BLOCK_LAYOUT_LIKELY;
+		is_early_return[block->id * 2 + (first_returns ? 0 : 1)] = true;
+		return;
+	}
+
+	int holds = block_layout_comparison_heuristic(block);
+	struct ir_instruction *branch = block->last->data;
+	struct cfg_block *taken = block_layout_target(block);
+	bool first_when_true = (IR_GOTO_IF_TRUE == branch->kind) == (taken == first);
+	probability[0] = first_when_true ? holds : 100 - holds;
+}
+
+static int block_layout_probability(struct cfg_block *block, int successor) {
+	return 0 == successor ? probabilities[block->id * 2] : 100 - probabilities[block->id * 2];
+}
+
+/* blocks only reached through early returns, or from other cold blocks, go out of line */
+static void block_layout_find_cold(void) {
+	for (int b = 0; b < cfg->block_count; b++) {
+		is_cold[b] = cfg->blocks[b]->reverse_postorder < 0;
+	}
+
+	for (int i = 1; i < cfg->reachable_count; i++) {
+		struct cfg_block *block = cfg->reverse_postorder[i];
+		if (block == exit_block) continue;
+
+		bool cold = true;
+		for (int p = 0; p < block->predecessor_count && cold; p++) {
+			struct cfg_block *predecessor = block->predecessors[p];
+			if (predecessor->reverse_postorder < 0 || block_layout_is_back_edge(predecessor, block)) continue;
+
+			int successor = block_layout_successor_index(predecessor, block);
+			cold = is_cold[predecessor->id] || is_early_return[predecessor->id * 2 + successor];
+		}
+		is_cold[block->id] = cold;
+	}
+}
+
+/**********
+ * CHAINS *
+ **********/
+
+static int block_layout_compare_edges(const void *left, const void *right) {
+	const struct block_layout_edge *edge_1 = left, *edge_2 = right;
+
+	if (edge_1->weight != edge_2->weight) return edge_1->weight > edge_2->weight ? -1 : 1;
+	/* keep the order the source has on ties */
+	if (edge_1->from->id != edge_2->from->id) return edge_1->from->id - edge_2->from->id;
+	return edge_1->to->id - edge_2->to->id;
+}
+
+static int block_layout_chain_head(int block) {
+	while (chain_previous[block] >= 0) block = chain_previous[block];
+	return block;
+}
+
+/* joins the heaviest edges first, as long as each block keeps one block before and one after it */
+static void block_layout_build_chains(void) {
+	struct block_layout_edge *edges = malloc(sizeof(struct block_layout_edge) * cfg->block_count * 2);
+	assert(NULL != edges);
+	int edge_count = 0;
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		chain_next[b] = chain_previous[b] = -1;
+
+		long frequency = 1;
+		for (int d = 0; d < depths[b] && d < 8; d++) frequency *= 8;
+
+		for (int s = 0; s < block->successor_count; s++) {
+			struct cfg_block *successor = block->successors[s];
+			if (successor == cfg->blocks[0] || successor == exit_block || successor == block) continue;
+			/* the loop's bottom stays at its bottom */
+			if (block_layout_is_back_edge(block, successor)) continue;
+			if (is_cold[b] != is_cold[successor->id]) continue;
+
+			edges[edge_count].from = block;
+			edges[edge_count].to = successor;
+			edges[edge_count].weight = frequency * block_layout_probability(block, s);
+			edge_count++;
+		}
+	}
+	qsort(edges, edge_count, sizeof(struct block_layout_edge), block_layout_compare_edges);
+
+	for (int e = 0; e < edge_count; e++) {
+		int from = edges[e].from->id, to = edges[e].to->id;
+		if (chain_next[from] >= 0 || chain_previous[to] >= 0) continue;
+		if (block_layout_chain_head(from) == to) continue;
+
+		chain_next[from] = to;
+		chain_previous[to] = from;
+	}
+
+	free(edges);
+}
+
+/* the entry's chain, the hot chains and then the cold ones by where they start, and the exit */
+static struct cfg_block **block_layout_order(void) {
+	struct cfg_block **order = malloc(sizeof(struct cfg_block *) * cfg->block_count);
+	assert(NULL != order);
+	int count = 0;
+
+	for (int pass = 0; pass < 3; pass++) {
+		for (int b = 0; b < cfg->block_count; b++) {
+			if (chain_previous[b] >= 0 || cfg->blocks[b] == exit_block) continue;
+			if (0 == pass && 0 != b) continue;
+			if (1 == pass && (0 == b || is_cold[b])) continue;
+			if (2 == pass && !is_cold[b]) continue;
+
+			for (int block = b; block >= 0; block = chain_next[block]) order[count++] = cfg->blocks[block];
+		}
+	}
+	order[count++] = exit_block;
+	assert(count == cfg->block_count);
+
+	return order;
+}
+
+/**********
+ * LAYOUT *
+ **********/
+
+static const char *block_layout_label(struct cfg_block *block) {
+	if (IR_LABEL != block->first->data->kind) {
+		struct ir_instruction *label = ir_instruction(IR_LABEL);
+		char *name = ir_create_label_name();
+		label->operands[0].kind = OPERAND_STRING;
+		strncpy(label->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+		free(name);
+		block->first = ir_insert_before(block->first, label);
+	}
+	return block->first->data->operands[0].data.name;
+}
+
+static void block_layout_append_goto(struct cfg_block *block, struct cfg_block *target) {
+	struct ir_instruction *instruction = ir_instruction(IR_GOTO);
+	instruction->operands[0].kind = OPERAND_STRING;
+	strncpy(instruction->operands[0].data.name, block_layout_label(target), IDENTIFIER_MAX + 1);
+	block->last = ir_insert_after(block->last, instruction);
+}
+
+/* makes the block reach its successors with `next` placed right after it */
+static void block_layout_fix_branches(struct cfg_block *block, struct cfg_block *next) {
+	struct ir_instruction *last = block->last->data;
+	struct cfg_block *fall_through = block_layout_fall_through(block);
+	struct cfg_block *target = block_layout_target(block);
+
+	if (IR_GOTO == last->kind) {
+		if (target == next && block->first != block->last) {
+			struct ir_list *branch = block->last;
+			block->last = branch->prev;
+			ir_unlink(branch);
+		}
+	} else if (block_layout_is_conditional(last)) {
+		if (fall_through == next) return;
+		if (target == next && target != fall_through) {
+			/* branch the other way round and fall into the target */
+			last->kind = IR_GOTO_IF_FALSE == last->kind ? IR_GOTO_IF_TRUE : IR_GOTO_IF_FALSE;
+			strncpy(last->operands[1].data.name, block_layout_label(fall_through), IDENTIFIER_MAX + 1);
+		} else {
+			block_layout_append_goto(block, fall_through);
+		}
+	} else if (NULL != fall_through && fall_through != next) {
+		block_layout_append_goto(block, fall_through);
+	}
+}
+
+/* links the blocks' ranges of ir_list in the new order, the entry and exit keep their places */
+static void block_layout_relink(struct cfg_block **order) {
+	struct ir_list *before = cfg->proc_begin->prev, *after = cfg->proc_end->next;
+
+	for (int i = 0; i < cfg->block_count; i++) {
+		struct ir_list *previous = 0 == i ? before : order[i - 1]->last;
+		order[i]->first->prev = previous;
+		if (NULL != previous) previous->next = order[i]->first;
+	}
+	order[cfg->block_count - 1]->last->next = after;
+	if (NULL != after) after->prev = order[cfg->block_count - 1]->last;
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+static void block_layout(struct cfg *function) {
+	cfg = function;
+	exit_block = cfg->blocks[cfg->block_count - 1];
+	assert(exit_block->last == cfg->proc_end);
+
+	depths = calloc(cfg->block_count, sizeof(int));
+	probabilities = malloc(sizeof(int) * cfg->block_count * 2);
+	is_early_return = calloc(cfg->block_count * 2, sizeof(bool));
+	is_cold = malloc(sizeof(bool) * cfg->block_count);
+	chain_next = malloc(sizeof(int) * cfg->block_count);
+	chain_previous = malloc(sizeof(int) * cfg->block_count);
+	assert(
+		NULL != depths && NULL != probabilities && NULL != is_early_return &&
+		NULL != is_cold && NULL != chain_next && NULL != chain_previous
+	);
+
+	cfg_compute_dominators(cfg);
+	int loop_count;
+	struct cfg_loop *loops = cfg_find_loops(cfg, &loop_count);
+	for (int l = 0; l < loop_count; l++) {
+		for (int b = 0; b < cfg->block_count; b++) depths[b] += loops[l].body[b];
+	}
+	for (int b = 0; b < cfg->block_count; b++) block_layout_predict(cfg->blocks[b], loops, loop_count);
+	cfg_destroy_loops(loops, loop_count);
+
+	block_layout_find_cold();
+	block_layout_build_chains();
+
+	struct cfg_block **order = block_layout_order();
+	for (int i = 0; i < cfg->block_count; i++) {
+		block_layout_fix_branches(order[i], i + 1 < cfg->block_count ? order[i + 1] : NULL);
+	}
+	block_layout_relink(order);
+	cfg_rebuild(cfg);
+
+	free(order);
+	free(depths);
+	free(probabilities);
+	free(is_early_return);
+	free(is_cold);
+	free(chain_next);
+	free(chain_previous);
+}
+
+void block_layout_program(void) {
+	struct cfg *cfgs = cfg_build_program();
+
+	for (struct cfg *function = cfgs; NULL != function; function = function->next) {
+		block_layout(function);
+	}
+
+	cfg_destroy_program(cfgs);
+}
@@ -0,0 +1,29 @@
+#ifndef _BLOCK_LAYOUT_H
+#define _BLOCK_LAYOUT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/* percent chance of taking an edge the heuristics call likely; the other edge gets the rest */
+#define BLOCK_LAYOUT_LIKELY 80
+
+/*
+ * Static block placement. Each conditional branch gets a probability from
+ * the first heuristic that applies to it: back edges are taken, loop exits
+ * aren't, paths that return early (error checks) aren't, and == (or
+ * comparisons of a value below 0) usually fails. Blocks are then chained
+ * greedily along their heaviest edges, weighing edges by loop depth, so the
+ * likely successor of a block is the one it falls into. Blocks only reached
+ * through unlikely edges move out of line to the end of the function, and
+ * the other chains keep their source order, which keeps loop bodies
+ * together. Branches are turned around or gotos added where a block no
+ * longer falls into its successor, and gotos to the next block go.
+ *
+ * Works on ir_list outside SSA form.
+ */
+void block_layout_program(void);
+
+#endif
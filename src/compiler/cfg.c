@@ -0,0 +1,638 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+
+/*****************
+ * LABEL LOOKUPS *
+ *****************/
+
+/*
+ * Open addressing table from label name to the block that label starts, so
+ * resolving every branch of a function stays linear.
+ */
+struct cfg_label_table {
+	char **names;
+	struct cfg_block **blocks;
+	int capacity;
+};
+
+static unsigned int cfg_hash_label(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; '\0' != *name; name++) {
+		hash = (hash ^ (unsigned char)*name) * 16777619u;
+	}
+	return hash;
+}
+
+static void cfg_label_table_initialise(struct cfg_label_table *table, int label_count) {
+	table->capacity = 16;
+	while (table->capacity < label_count * 2) table->capacity *= 2;
+	table->names = calloc(table->capacity, sizeof(char *));
+	table->blocks = calloc(table->capacity, sizeof(struct cfg_block *));
+	assert(NULL != table->names && NULL != table->blocks);
+}
+
+static void cfg_label_table_add(struct cfg_label_table *table, char *name, struct cfg_block *block) {
+	unsigned int slot = cfg_hash_label(name) & (table->capacity - 1);
+	while (NULL != table->names[slot]) {
+		slot = (slot + 1) & (table->capacity - 1);
+	}
+	table->names[slot] = name;
+	table->blocks[slot] = block;
+}
+
+static struct cfg_block *cfg_label_table_get(struct cfg_label_table *table, char *name) {
+	unsigned int slot = cfg_hash_label(name) & (table->capacity - 1);
+	while (NULL != table->names[slot]) {
+		if (0 == strcmp(table->names[slot], name)) return table->blocks[slot];
+		slot = (slot + 1) & (table->capacity - 1);
+	}
+	return NULL;
+}
+
+static void cfg_label_table_free(struct cfg_label_table *table) {
+	free(table->names);
+	free(table->blocks);
+}
+
+/*******************
+ * BUILDING BLOCKS *
+ *******************/
+
+static struct cfg_block *cfg_add_block(struct cfg *cfg, struct ir_list *first) {
+	struct cfg_block *block = calloc(1, sizeof(struct cfg_block));
+	assert(NULL != block);
+
+	block->id = cfg->block_count;
+	block->first = first;
+	block->last = first;
+	block->reverse_postorder = -1;
+
+	if (cfg->block_count == cfg->block_capacity) {
+		cfg->block_capacity = 0 == cfg->block_capacity ? 16 : cfg->block_capacity * 2;
+		cfg->blocks = realloc(cfg->blocks, sizeof(struct cfg_block *) * cfg->block_capacity);
+		assert(NULL != cfg->blocks);
+	}
+	cfg->blocks[cfg->block_count++] = block;
+
+	return block;
+}
+
+static void cfg_add_edge(struct cfg_block *from, struct cfg_block *to) {
+	for (int i = 0; i < from->successor_count; i++) {
+		if (from->successors[i] == to) return;
+	}
+	/* a block ends in at most one branch, so it never has more than 2 successors */
+	assert(from->successor_count < 2);
+	if (NULL == from->successors) {
+		from->successors = malloc(sizeof(struct cfg_block *) * 2);
+		assert(NULL != from->successors);
+	}
+	from->successors[from->successor_count++] = to;
+
+	if (to->predecessor_count == to->predecessor_capacity) {
+		to->predecessor_capacity = 0 == to->predecessor_capacity ? 2 : to->predecessor_capacity * 2;
+		to->predecessors = realloc(to->predecessors, sizeof(struct cfg_block *) * to->predecessor_capacity);
+		assert(NULL != to->predecessors);
+	}
+	to->predecessors[to->predecessor_count++] = from;
+}
+
+static void cfg_compute_reverse_postorder(struct cfg *cfg) {
+	struct cfg_block **stack = malloc(sizeof(struct cfg_block *) * (cfg->block_count + 1));
+	int *next_successor = calloc(cfg->block_count, sizeof(int));
+	bool *visited = calloc(cfg->block_count, sizeof(bool));
+	assert(NULL != stack && NULL != next_successor && NULL != visited);
+
+	free(cfg->reverse_postorder);
+	cfg->reverse_postorder = malloc(sizeof(struct cfg_block *) * (cfg->block_count + 1));
+	assert(NULL != cfg->reverse_postorder);
+
+	for (int i = 0; i < cfg->block_count; i++) {
+		cfg->blocks[i]->reverse_postorder = -1;
+	}
+
+	/* iterative dfs, blocks are written in postorder from the back of the array */
+	int top = 0;
+	int postorder = cfg->block_count;
+	stack[top++] = cfg->blocks[0];
+	visited[0] = true;
+	while (top > 0) {
+		struct cfg_block *block = stack[top - 1];
+		if (next_successor[block->id] < block->successor_count) {
+			struct cfg_block *successor = block->successors[next_successor[block->id]++];
+			if (!visited[successor->id]) {
+				visited[successor->id] = true;
+				stack[top++] = successor;
+			}
+		} else {
+			cfg->reverse_postorder[--postorder] = block;
+			top--;
+		}
+	}
+
+	/* shift the reachable blocks to the front */
+	cfg->reachable_count = cfg->block_count - postorder;
+	memmove(cfg->reverse_postorder, cfg->reverse_postorder + postorder,
+		sizeof(struct cfg_block *) * cfg->reachable_count);
+	for (int i = 0; i < cfg->reachable_count; i++) {
+		cfg->reverse_postorder[i]->reverse_postorder = i;
+	}
+
+	free(stack);
+	free(next_successor);
+	free(visited);
+}
+
+/*
+ * Builds the blocks of the function starting at the given procBegin node.
+ * Block 0 is always the entry block.
+ */
+struct cfg *cfg_build(struct ir_list *proc_begin) {
+	assert(NULL != proc_begin);
+	assert(IR_PROC_BEGIN == proc_begin->data->kind);
+
+	struct cfg *cfg = calloc(1, sizeof(struct cfg));
+	assert(NULL != cfg);
+	cfg->proc_begin = proc_begin;
+
+	struct ir_list *iter;
+	struct cfg_block *block = cfg_add_block(cfg, proc_begin);
+	int label_count = 0;
+
+	for (iter = proc_begin->next; NULL != iter; iter = iter->next) {
+		struct ir_instruction *previous = iter->prev->data;
+		if (IR_LABEL == iter->data->kind || ir_is_branch(previous)) {
+			block = cfg_add_block(cfg, iter);
+		}
+		if (IR_LABEL == iter->data->kind) label_count++;
+		block->last = iter;
+		if (IR_PROC_END == iter->data->kind) {
+			cfg->proc_end = iter;
+			break;
+		}
+	}
+	assert(NULL != cfg->proc_end);
+
+	struct cfg_label_table labels;
+	cfg_label_table_initialise(&labels, label_count);
+	for (int i = 0; i < cfg->block_count; i++) {
+		if (IR_LABEL == cfg->blocks[i]->first->data->kind) {
+			cfg_label_table_add(&labels, cfg->blocks[i]->first->data->operands[0].data.name, cfg->blocks[i]);
+		}
+	}
+
+	for (int i = 0; i < cfg->block_count; i++) {
+		struct ir_instruction *last = cfg->blocks[i]->last->data;
+		bool falls_through = IR_GOTO != last->kind && IR_PROC_END != last->kind;
+
+		if (falls_through && i + 1 < cfg->block_count) {
+			cfg_add_edge(cfg->blocks[i], cfg->blocks[i + 1]);
+		}
+		if (ir_is_branch(last)) {
+			struct cfg_block *target = cfg_label_table_get(&labels, ir_branch_target(last));
+			assert(NULL != target);
+			cfg_add_edge(cfg->blocks[i], target);
+		}
+	}
+	cfg_label_table_free(&labels);
+
+	cfg_compute_reverse_postorder(cfg);
+
+	return cfg;
+}
+
+struct cfg *cfg_build_program(void) {
+	struct cfg *head = NULL, *tail = NULL;
+	struct ir_list *iter;
+
+	for (iter = ir_get_ir_list(); NULL != iter; iter = iter->next) {
+		if (IR_PROC_BEGIN != iter->data->kind) continue;
+
+		struct cfg *cfg = cfg_build(iter);
+		if (NULL == head) {
+			head = cfg;
+		} else {
+			tail->next = cfg;
+		}
+		tail = cfg;
+		iter = cfg->proc_end;
+	}
+	return head;
+}
+
+static void cfg_free_blocks(struct cfg *cfg) {
+	for (int i = 0; i < cfg->block_count; i++) {
+		struct cfg_block *block = cfg->blocks[i];
+		free(block->successors);
+		free(block->predecessors);
+		free(block->dominator_children);
+		free(block->dominance_frontier);
+		free(block);
+	}
+	free(cfg->blocks);
+	free(cfg->reverse_postorder);
+}
+
+/*
+ * Rebuilds the blocks of the function from ir_list after its control flow
+ * was edited, keeping the cfg itself and its place in the chain. Dominator
+ * information has to be recomputed afterwards.
+ */
+void cfg_rebuild(struct cfg *cfg) {
+	struct cfg *fresh = cfg_build(cfg->proc_begin);
+	struct cfg *next = cfg->next;
+
+	cfg_free_blocks(cfg);
+	*cfg = *fresh;
+	cfg->next = next;
+	free(fresh);
+}
+
+void cfg_destroy(struct cfg *cfg) {
+	if (NULL == cfg) return;
+
+	cfg_free_blocks(cfg);
+	free(cfg);
+}
+
+void cfg_destroy_program(struct cfg *cfg) {
+	while (NULL != cfg) {
+		struct cfg *next = cfg->next;
+		cfg_destroy(cfg);
+		cfg = next;
+	}
+}
+
+/**************
+ * DOMINATORS *
+ **************/
+
+static struct cfg_block *cfg_intersect(struct cfg_block *block_1, struct cfg_block *block_2) {
+	while (block_1 != block_2) {
+		while (block_1->reverse_postorder > block_2->reverse_postorder) {
+			block_1 = block_1->immediate_dominator;
+		}
+		while (block_2->reverse_postorder > block_1->reverse_postorder) {
+			block_2 = block_2->immediate_dominator;
+		}
+	}
+	return block_1;
+}
+
+static void cfg_number_dominator_tree(struct cfg *cfg) {
+	struct cfg_block **stack = malloc(sizeof(struct cfg_block *) * (cfg->block_count + 1));
+	int *next_child = calloc(cfg->block_count, sizeof(int));
+	assert(NULL != stack && NULL != next_child);
+
+	int top = 0, counter = 0;
+	stack[top++] = cfg->blocks[0];
+	cfg->blocks[0]->dominator_enter = counter++;
+	while (top > 0) {
+		struct cfg_block *block = stack[top - 1];
+		if (next_child[block->id] < block->dominator_child_count) {
+			struct cfg_block *child = block->dominator_children[next_child[block->id]++];
+			child->dominator_enter = counter++;
+			stack[top++] = child;
+		} else {
+			block->dominator_exit = counter++;
+			top--;
+		}
+	}
+
+	free(stack);
+	free(next_child);
+}
+
+/*
+ * Cooper, Harvey and Kennedy's "A Simple, Fast Dominance Algorithm". Blocks
+ * that can't be reached from the entry are left without a dominator.
+ */
+void cfg_compute_dominators(struct cfg *cfg) {
+	for (int i = 0; i < cfg->block_count; i++) {
+		struct cfg_block *block = cfg->blocks[i];
+		block->immediate_dominator = NULL;
+		block->dominator_child_count = 0;
+		block->dominator_enter = block->dominator_exit = -1;
+	}
+
+	struct cfg_block *entry = cfg->reverse_postorder[0];
+	entry->immediate_dominator = entry;
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = 1; i < cfg->reachable_count; i++) {
+			struct cfg_block *block = cfg->reverse_postorder[i];
+			struct cfg_block *new_dominator = NULL;
+
+			for (int j = 0; j < block->predecessor_count; j++) {
+				struct cfg_block *predecessor = block->predecessors[j];
+				if (NULL == predecessor->immediate_dominator) continue;
+				new_dominator = NULL == new_dominator ? predecessor : cfg_intersect(predecessor, new_dominator);
+			}
+			if (new_dominator != block->immediate_dominator) {
+				block->immediate_dominator = new_dominator;
+				changed = true;
+			}
+		}
+	}
+
+	/* build the dominator tree */
+	for (int i = 0; i < cfg->block_count; i++) {
+		free(cfg->blocks[i]->dominator_children);
+		cfg->blocks[i]->dominator_children = NULL;
+	}
+	int *child_counts = calloc(cfg->block_count, sizeof(int));
+	assert(NULL != child_counts);
+	for (int i = 1; i < cfg->reachable_count; i++) {
+		child_counts[cfg->reverse_postorder[i]->immediate_dominator->id]++;
+	}
+	for (int i = 0; i < cfg->reachable_count; i++) {
+		struct cfg_block *block = cfg->reverse_postorder[i];
+		if (child_counts[block->id] > 0) {
+			block->dominator_children = malloc(sizeof(struct cfg_block *) * child_counts[block->id]);
+			assert(NULL != block->dominator_children);
+		}
+	}
+	for (int i = 1; i < cfg->reachable_count; i++) {
+		struct cfg_block *block = cfg->reverse_postorder[i];
+		struct cfg_block *parent = block->immediate_dominator;
+		parent->dominator_children[parent->dominator_child_count++] = block;
+	}
+	free(child_counts);
+
+	cfg_number_dominator_tree(cfg);
+}
+
+bool cfg_dominates(struct cfg_block *dominator, struct cfg_block *block) {
+	if (dominator->dominator_enter < 0 || block->dominator_enter < 0) return false;
+	return (
+		dominator->dominator_enter <= block->dominator_enter &&
+		block->dominator_exit <= dominator->dominator_exit
+	);
+}
+
+static void cfg_add_to_frontier(struct cfg_block *block, struct cfg_block *frontier_block) {
+	for (int i = 0; i < block->dominance_frontier_count; i++) {
+		if (block->dominance_frontier[i] == frontier_block) return;
+	}
+	block->dominance_frontier = realloc(
+		block->dominance_frontier,
+		sizeof(struct cfg_block *) * (block->dominance_frontier_count + 1)
+	);
+	assert(NULL != block->dominance_frontier);
+	block->dominance_frontier[block->dominance_frontier_count++] = frontier_block;
+}
+
+/* requires cfg_compute_dominators */
+void cfg_compute_dominance_frontiers(struct cfg *cfg) {
+	for (int i = 0; i < cfg->block_count; i++) {
+		free(cfg->blocks[i]->dominance_frontier);
+		cfg->blocks[i]->dominance_frontier = NULL;
+		cfg->blocks[i]->dominance_frontier_count = 0;
+	}
+
+	for (int i = 0; i < cfg->reachable_count; i++) {
+		struct cfg_block *block = cfg->reverse_postorder[i];
+		if (block->predecessor_count < 2) continue;
+
+		for (int j = 0; j < block->predecessor_count; j++) {
+			struct cfg_block *runner = block->predecessors[j];
+			if (NULL == runner->immediate_dominator) continue;
+
+			while (runner != block->immediate_dominator) {
+				cfg_add_to_frontier(runner, block);
+				runner = runner->immediate_dominator;
+			}
+		}
+	}
+}
+
+/*********
+ * LOOPS *
+ *********/
+
+static int cfg_compare_loops(const void *loop_1, const void *loop_2) {
+	return ((const struct cfg_loop *)loop_1)->block_count - ((const struct cfg_loop *)loop_2)->block_count;
+}
+
+/* requires cfg_compute_dominators */
+struct cfg_loop *cfg_find_loops(struct cfg *cfg, int *loop_count) {
+	struct cfg_loop *loops = NULL;
+	struct cfg_block **stack = malloc(sizeof(struct cfg_block *) * (cfg->block_count + 1));
+	assert(NULL != stack);
+	*loop_count = 0;
+
+	for (int r = 0; r < cfg->reachable_count; r++) {
+		struct cfg_block *header = cfg->reverse_postorder[r];
+		struct cfg_loop *loop = NULL;
+
+		for (int p = 0; p < header->predecessor_count; p++) {
+			struct cfg_block *latch = header->predecessors[p];
+			if (latch->reverse_postorder < 0 || !cfg_dominates(header, latch)) continue;
+
+			/* back edges to the same header make up one loop */
+			if (NULL == loop) {
+				loops = realloc(loops, sizeof(struct cfg_loop) * (*loop_count + 1));
+				assert(NULL != loops);
+				loop = &loops[(*loop_count)++];
+				loop->header = header;
+				loop->body = calloc(cfg->block_count, sizeof(bool));
+				loop->latches = malloc(sizeof(struct cfg_block *) * header->predecessor_count);
+				assert(NULL != loop->body && NULL != loop->latches);
+				loop->latch_count = 0;
+				loop->block_count = 1;
+				loop->body[header->id] = true;
+			}
+			loop->latches[loop->latch_count++] = latch;
+
+			/* everything reaching the latch without passing the header */
+			int top = 0;
+			if (!loop->body[latch->id]) {
+				loop->body[latch->id] = true;
+				loop->block_count++;
+				stack[top++] = latch;
+			}
+			while (top > 0) {
+				struct cfg_block *block = stack[--top];
+				for (int q = 0; q < block->predecessor_count; q++) {
+					struct cfg_block *predecessor = block->predecessors[q];
+					if (predecessor->reverse_postorder < 0 || loop->body[predecessor->id]) continue;
+					loop->body[predecessor->id] = true;
+					loop->block_count++;
+					stack[top++] = predecessor;
+				}
+			}
+		}
+	}
+
+	free(stack);
+	if (*loop_count > 1) qsort(loops, *loop_count, sizeof(struct cfg_loop), cfg_compare_loops);
+	return loops;
+}
+
+/* the only block outside the loop that enters it, NULL if there are several */
+struct cfg_block *cfg_loop_entry(struct cfg_loop *loop) {
+	struct cfg_block *entry = NULL;
+
+	for (int p = 0; p < loop->header->predecessor_count; p++) {
+		struct cfg_block *predecessor = loop->header->predecessors[p];
+		if (predecessor->reverse_postorder < 0 || loop->body[predecessor->id]) continue;
+		if (NULL != entry) return NULL;
+		entry = predecessor;
+	}
+	return entry;
+}
+
+/*
+ * The node preheader code goes right before: the end of the only block
+ * entering the loop, or a new block on that edge when the block also goes
+ * elsewhere. NULL if there are several ways in.
+ */
+struct ir_list *cfg_loop_preheader(struct cfg *cfg, struct cfg_loop *loop) {
+	struct cfg_block *entry = cfg_loop_entry(loop);
+	if (NULL == entry) return NULL;
+
+	if (1 == entry->successor_count) {
+		return ir_is_branch(entry->last->data) ? entry->last : entry->last->next;
+	}
+
+	struct cfg_block *block = cfg_split_edge(cfg, entry, loop->header);
+	return block->first->next;
+}
+
+void cfg_destroy_loops(struct cfg_loop *loops, int loop_count) {
+	for (int i = 0; i < loop_count; i++) {
+		free(loops[i].body);
+		free(loops[i].latches);
+	}
+	free(loops);
+}
+
+/*****************
+ * EDITING EDGES *
+ *****************/
+
+int cfg_predecessor_index(struct cfg_block *block, struct cfg_block *predecessor) {
+	for (int i = 0; i < block->predecessor_count; i++) {
+		if (block->predecessors[i] == predecessor) return i;
+	}
+	return -1;
+}
+
+bool cfg_falls_through(struct cfg_block *from, struct cfg_block *to) {
+	return IR_GOTO != from->last->data->kind && from->last->next == to->first;
+}
+
+static struct ir_list *cfg_insert_label(struct ir_list *node, bool before, char **name) {
+	struct ir_instruction *label = ir_instruction(IR_LABEL);
+	*name = ir_create_label_name();
+	label->operands[0].kind = OPERAND_STRING;
+	strncpy(label->operands[0].data.name, *name, IDENTIFIER_MAX + 1);
+	return before ? ir_insert_before(node, label) : ir_insert_after(node, label);
+}
+
+static struct ir_list *cfg_insert_goto(struct ir_list *node, char *target) {
+	struct ir_instruction *instruction = ir_instruction(IR_GOTO);
+	instruction->operands[0].kind = OPERAND_STRING;
+	strncpy(instruction->operands[0].data.name, target, IDENTIFIER_MAX + 1);
+	return ir_insert_after(node, instruction);
+}
+
+/*
+ * Puts an empty block on the edge from -> to and returns it. The new block
+ * takes over from's slot in to's predecessor list so phi arguments stay in
+ * place. Falling through edges get the block right after `from`; taken
+ * branches get a block parked after an unconditional goto so nothing else
+ * falls into it. Dominator information is stale afterwards.
+ */
+struct cfg_block *cfg_split_edge(struct cfg *cfg, struct cfg_block *from, struct cfg_block *to) {
+	int predecessor_index = cfg_predecessor_index(to, from);
+	assert(predecessor_index >= 0);
+
+	struct cfg_block *block;
+	char *name;
+
+	if (cfg_falls_through(from, to)) {
+		struct ir_list *label = cfg_insert_label(from->last, false, &name);
+		block = cfg_add_block(cfg, label);
+
+		/* a branch to the block it falls into anyway is the same edge */
+		if (ir_is_branch(from->last->data) && IR_LABEL == to->first->data->kind &&
+			0 == strcmp(ir_branch_target(from->last->data), to->first->data->operands[0].data.name)) {
+			strncpy(from->last->data->operands[1].data.name, name, IDENTIFIER_MAX + 1);
+		}
+	} else {
+		assert(IR_LABEL == to->first->data->kind);
+		assert(ir_is_branch(from->last->data));
+
+		/* find a spot no block falls into */
+		struct ir_list *anchor = NULL, *iter;
+		for (iter = cfg->proc_begin; iter != cfg->proc_end; iter = iter->next) {
+			if (IR_GOTO == iter->data->kind) {
+				anchor = iter;
+				break;
+			}
+		}
+		if (NULL == anchor) {
+			/* guard the new block with a jump over it */
+			anchor = cfg_insert_goto(to->first->prev, to->first->data->operands[0].data.name);
+		}
+
+		struct ir_list *label = cfg_insert_label(anchor, false, &name);
+		block = cfg_add_block(cfg, label);
+		block->last = cfg_insert_goto(label, to->first->data->operands[0].data.name);
+
+		/* retarget the branch */
+		struct ir_instruction *branch = from->last->data;
+		int target_operand = IR_GOTO == branch->kind ? 0 : 1;
+		strncpy(branch->operands[target_operand].data.name, name, IDENTIFIER_MAX + 1);
+	}
+
+	for (int i = 0; i < from->successor_count; i++) {
+		if (from->successors[i] == to) from->successors[i] = block;
+	}
+	block->successors = malloc(sizeof(struct cfg_block *) * 2);
+	assert(NULL != block->successors);
+	block->successors[block->successor_count++] = to;
+	block->predecessors = malloc(sizeof(struct cfg_block *) * 2);
+	assert(NULL != block->predecessors);
+	block->predecessor_capacity = 2;
+	block->predecessors[block->predecessor_count++] = from;
+	to->predecessors[predecessor_index] = block;
+
+	return block;
+}
+
+/************
+ * PRINTING *
+ ************/
+
+void cfg_print(FILE *output, struct cfg *cfg) {
+	fprintf(output, "cfg for %s\n", cfg->proc_begin->data->operands[0].data.name);
+	for (int i = 0; i < cfg->block_count; i++) {
+		struct cfg_block *block = cfg->blocks[i];
+		fprintf(output, "  block %d", block->id);
+		if (IR_LABEL == block->first->data->kind) {
+			fprintf(output, " (%s)", block->first->data->operands[0].data.name);
+		}
+		fprintf(output, " preds:");
+		for (int j = 0; j < block->predecessor_count; j++) {
+			fprintf(output, " %d", block->predecessors[j]->id);
+		}
+		fprintf(output, " succs:");
+		for (int j = 0; j < block->successor_count; j++) {
+			fprintf(output, " %d", block->successors[j]->id);
+		}
+		if (NULL != block->immediate_dominator) {
+			fprintf(output, " idom: %d", block->immediate_dominator->id);
+		}
+		fprintf(output, "\n");
+	}
+}
@@ -0,0 +1,85 @@
+#ifndef _CFG_H
+#define _CFG_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+
+/*
+ * A basic block is an inclusive range of nodes in ir_list. Blocks start at a
+ * label (or the procBegin) and end at a goto, gotoIfFalse/gotoIfTrue or just
+ * before the next label.
+ */
+struct cfg_block {
+  int id;
+  struct ir_list *first, *last;
+
+  struct cfg_block **successors;
+  int successor_count;
+  struct cfg_block **predecessors;
+  int predecessor_count;
+  int predecessor_capacity;
+
+  int reverse_postorder;                      /* -1 if unreachable from the entry */
+
+  /* filled in by cfg_compute_dominators */
+  struct cfg_block *immediate_dominator;
+  struct cfg_block **dominator_children;
+  int dominator_child_count;
+  int dominator_enter, dominator_exit;        /* dominator tree dfs interval */
+
+  /* filled in by cfg_compute_dominance_frontiers */
+  struct cfg_block **dominance_frontier;
+  int dominance_frontier_count;
+};
+
+/*
+ * A natural loop: the header and every block that reaches one of its back
+ * edges without passing the header. Back edges to the same header make up
+ * one loop.
+ */
+struct cfg_loop {
+  struct cfg_block *header;
+  bool *body;                                 /* block id -> in the loop */
+  int block_count;
+  struct cfg_block **latches;                 /* the sources of the back edges */
+  int latch_count;
+};
+
+/* one cfg per function, chained in program order */
+struct cfg {
+  struct ir_list *proc_begin, *proc_end;
+  struct cfg_block **blocks;
+  int block_count;
+  int block_capacity;
+
+  struct cfg_block **reverse_postorder;      /* reachable blocks only */
+  int reachable_count;
+
+  struct cfg *next;
+};
+
+struct cfg *cfg_build(struct ir_list *proc_begin);
+struct cfg *cfg_build_program(void);
+void cfg_rebuild(struct cfg *cfg);
+void cfg_destroy(struct cfg *cfg);
+void cfg_destroy_program(struct cfg *cfg);
+
+void cfg_compute_dominators(struct cfg *cfg);
+void cfg_compute_dominance_frontiers(struct cfg *cfg);
+bool cfg_dominates(struct cfg_block *dominator, struct cfg_block *block);
+
+/* innermost (smallest) loops first, requires cfg_compute_dominators */
+struct cfg_loop *cfg_find_loops(struct cfg *cfg, int *loop_count);
+struct cfg_block *cfg_loop_entry(struct cfg_loop *loop);
+struct ir_list *cfg_loop_preheader(struct cfg *cfg, struct cfg_loop *loop);
+void cfg_destroy_loops(struct cfg_loop *loops, int loop_count);
+
+int cfg_predecessor_index(struct cfg_block *block, struct cfg_block *predecessor);
+bool cfg_falls_through(struct cfg_block *from, struct cfg_block *to);
+struct cfg_block *cfg_split_edge(struct cfg *cfg, struct cfg_block *from, struct cfg_block *to);
+
+void cfg_print(FILE *output, struct cfg *cfg);
+
+#endif
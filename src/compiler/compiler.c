@@ -1,7 +1,9 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <limits.h>
 #include <stdarg.h>
 
@@ -13,8 +15,8 @@
 #include "type.h"
 #include "ir.h"
 #include "mips.h"
-#include "optimization-1.h"
-#include "optimization-2.h"
+#include "pass-manager.h"
+#include "loop-unrolling.h"
 
 extern int errno;
 int annotation = 0;
@@ -48,6 +50,9 @@ static void print_errors_from_pass(char *pass, int error_count) {
  * -s : the name of the stage to stop after. Defaults to
  *      runs all of the stages.
  * -o : the name of the output file. Defaults to "output.s"      
+ * -funroll-loops : adds loop unrolling to the -O pipeline, -unroll-factor
+ *      and -unroll-budget set the copies per loop and the instructions they
+ *      may take up.
  *
  * You should pass the name of the file to process or redirect stdin.
  */
@@ -59,10 +64,24 @@ int main(int argc, char **argv) {
   yyscan_t scanner;
   struct node *parse_tree;
   int error_count;
+  const char *passes = NULL;
+  bool time_passes = false;
+  bool unroll_loops = false;
+  struct pass_pipeline *pipeline = NULL;
+  /* long options are only taken with a single dash by getopt_long_only */
+  static struct option long_options[] = {
+    { "passes", required_argument, NULL, 'p' },
+    { "pass-budget", required_argument, NULL, 'b' },
+    { "time-passes", no_argument, NULL, 't' },
+    { "funroll-loops", no_argument, NULL, 'u' },
+    { "unroll-factor", required_argument, NULL, 'f' },
+    { "unroll-budget", required_argument, NULL, 'g' },
+    { NULL, 0, NULL, 0 }
+  };
 
   strncpy(output_name, "output.s", NAME_MAX + 1);
   stage = "mips";
-  while (-1 != (opt = getopt(argc, argv, "o:s:O:a"))) {
+  while (-1 != (opt = getopt_long_only(argc, argv, "o:s:O:a", long_options, NULL))) {
     switch (opt) {
       case 'o':
         strncpy(output_name, optarg, NAME_MAX);
@@ -80,6 +99,37 @@ int main(int argc, char **argv) {
         }
         break;
       }
+      case 'p':
+        passes = optarg;
+        break;
+      case 'b':
+        pass_manager_set_budget(atoi(optarg));
+        break;
+      case 't':
+        time_passes = true;
+        break;
+      case 'u':
+        unroll_loops = true;
+        break;
+      case 'f':
+        loop_unrolling_set_factor(atoi(optarg));
+        break;
+      case 'g':
+        loop_unrolling_set_budget(atoi(optarg));
+        break;
+      default:
+        return 1;
+    }
+  }
+
+  /* a custom pipeline implies the optimizing backend */
+  if (NULL != passes && !optimization) {
+    optimization = 1;
+  }
+  if (optimization) {
+    pipeline = pass_manager_parse(NULL != passes ? passes : pass_manager_default_pipeline(optimization, unroll_loops));
+    if (NULL == pipeline) {
+      return 1;
     }
   }
 
@@ -169,20 +219,13 @@ int main(int argc, char **argv) {
     }
   }
 
-  if (optimization >= 1) {
-    ir_start_optimization_1();
-
-    fprintf(stdout, "\n=============== IR OPTIMISED (1) ==============\n");
-    ir_print_section(stdout);
-
+  if (optimization) {
+    pass_manager_run(pipeline, stdout);
+    if (time_passes) {
+      pass_manager_print_statistics(stderr);
+    }
   }
-  if (optimization >= 2) {
-    ir_start_optimization_2();
 
-    fprintf(stdout, "\n=============== IR OPTIMISED (2) ==============\n");
-    ir_print_section(stdout);
-  }
-  
   if (!print_to_file && (0 == strcmp("mips", stage) || optimization)) {
     mips_print_program(stdout);
   }
@@ -0,0 +1,454 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "helpers/bit-vector.h"
+#include "constant-propagation.h"
+
+/***********
+ * FOLDING *
+ ***********/
+
+bool constant_propagation_fold(enum ir_instruction_kind kind, uint32_t left, uint32_t right, uint32_t *result) {
+	int32_t signed_left = (int32_t)left;
+	int32_t signed_right = (int32_t)right;
+
+	switch (kind) {
+		case IR_MULT_SIGNED_WORD:
+		case IR_MULT_UNSIGNED_WORD:
+			*result = left * right;
+			return true;
+		case IR_MULT_HIGH_SIGNED_WORD:
+			*result = (uint32_t)(((int64_t)signed_left * signed_right) >> 32);
+			return true;
+		case IR_MULT_HIGH_UNSIGNED_WORD:
+			*result = (uint32_t)(((uint64_t)left * right) >> 32);
+			return true;
+		case IR_DIV_SIGNED_WORD:
+			if (0 == right || (INT32_MIN == signed_left && -1 == signed_right)) return false;
+			*result = (uint32_t)(signed_left / signed_right);
+			return true;
+		case IR_DIV_UNSIGNED_WORD:
+			if (0 == right) return false;
+			*result = left / right;
+			return true;
+		case IR_REM_SIGNED_WORD:
+			if (0 == right || (INT32_MIN == signed_left && -1 == signed_right)) return false;
+			*result = (uint32_t)(signed_left % signed_right);
+			return true;
+		case IR_REM_UNSIGNED_WORD:
+			if (0 == right) return false;
+			*result = left % right;
+			return true;
+		case IR_ADD_SIGNED_WORD:
+		case IR_ADD_UNSIGNED_WORD:
+			*result = left + right;
+			return true;
+		case IR_SUB_SIGNED_WORD:
+		case IR_SUB_UNSIGNED_WORD:
+			*result = left - right;
+			return true;
+		/* sllv/srav/srlv only look at the low 5 bits of the amount */
+		case IR_LEFT_SHIFT_WORD:
+			*result = left << (right & 31);
+			return true;
+		case IR_RIGHT_SHIFT_SIGNED_WORD:
+			*result = (uint32_t)(signed_left >> (right & 31));
+			return true;
+		case IR_RIGHT_SHIFT_UNSIGNED_WORD:
+			*result = left >> (right & 31);
+			return true;
+		case IR_LT_SIGNED_WORD:
+			*result = signed_left < signed_right;
+			return true;
+		case IR_LT_UNSIGNED_WORD:
+			*result = left < right;
+			return true;
+		case IR_LE_SIGNED_WORD:
+			*result = signed_left <= signed_right;
+			return true;
+		case IR_LE_UNSIGNED_WORD:
+			*result = left <= right;
+			return true;
+		case IR_GE_SIGNED_WORD:
+			*result = signed_left >= signed_right;
+			return true;
+		case IR_GE_UNSIGNED_WORD:
+			*result = left >= right;
+			return true;
+		case IR_GT_SIGNED_WORD:
+			*result = signed_left > signed_right;
+			return true;
+		case IR_GT_UNSIGNED_WORD:
+			*result = left > right;
+			return true;
+		case IR_EQ_WORD:
+			*result = left == right;
+			return true;
+		case IR_NE_WORD:
+			*result = left != right;
+			return true;
+		case IR_BITWISE_AND_WORD:
+			*result = left & right;
+			return true;
+		case IR_BITWISE_XOR_WORD:
+			*result = left ^ right;
+			return true;
+		case IR_BITWISE_OR_WORD:
+			*result = left | right;
+			return true;
+		case IR_UNARY_MINUS:
+			*result = 0u - left;
+			return true;
+		case IR_UNARY_LOGICAL_NEGATION:
+			*result = 0 == left;
+			return true;
+		case IR_UNARY_BITWISE_NEGATION:
+			*result = ~left;
+			return true;
+		/* only the sign extensions, the other casts aren't exact in the backend */
+		case IR_CAST_SIGNED_HALF_WORD_TO_WORD:
+			*result = (uint32_t)(int32_t)(int16_t)left;
+			return true;
+		case IR_CAST_SIGNED_BYTE_TO_WORD:
+			*result = (uint32_t)(int32_t)(int8_t)left;
+			return true;
+		default:
+			return false;
+	}
+}
+
+/***************
+ * PROPAGATION *
+ ***************/
+
+/* what is known about the temporaries of the function being propagated */
+static int max_temporary;
+static bool *known;
+static uint32_t *values;
+static int *representatives;                   /* temporary -> the temporary its copies lead back to */
+static struct ir_list **temporary_definitions;
+
+/* variables -> whether their address is used for anything but a load or store */
+static int max_variable;
+static bool *escapes;
+static struct ir_list **last_stores;
+static int *last_store_blocks;
+static int *last_store_sequences;
+
+static bool constant_propagation_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static bool constant_propagation_operand_value(struct ir_operand *operand, uint32_t *value) {
+	if (!constant_propagation_is_temporary(operand) || !known[operand->data.temporary]) return false;
+	*value = values[operand->data.temporary];
+	return true;
+}
+
+static bool constant_propagation_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+static bool constant_propagation_is_load(struct ir_instruction *instruction) {
+	return (
+		IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind
+	);
+}
+
+/*
+ * Only word sized locals are tracked. Arguments and globals have a value
+ * nothing in the function stored, and a global can change in any call.
+ */
+static bool constant_propagation_is_tracked(struct ir_instruction *address) {
+	return (
+		IR_ADDRESS_OF == address->kind &&
+		!address->operands[2].data.is_string &&
+		4 == (int)address->operands[4].data.number &&
+		-1 == (long)address->operands[5].data.number &&
+		0 == address->operands[6].data.number
+	);
+}
+
+static struct ir_instruction *constant_propagation_address(struct ir_instruction *instruction) {
+	if (NULL != instruction->offset_variable) return instruction->offset_variable;
+
+	struct ir_operand *operand = &instruction->operands[constant_propagation_is_store(instruction) ? 0 : 1];
+	if (!constant_propagation_is_temporary(operand)) return NULL;
+
+	struct ir_list *definition = temporary_definitions[operand->data.temporary];
+	return NULL != definition ? definition->data : NULL;
+}
+
+/* the variable a load or store accesses, -1 if it isn't a tracked local */
+static int constant_propagation_variable(struct ir_instruction *instruction) {
+	struct ir_instruction *address = constant_propagation_address(instruction);
+	if (NULL == address || !constant_propagation_is_tracked(address)) return -1;
+	return address->operands[3].data.variable_id;
+}
+
+/* a local escapes once its address is used as anything but the address of a load or store */
+static void constant_propagation_find_escapes(struct cfg *cfg) {
+	struct ir_list *iter;
+
+	/* the addressOf of an offset_variable may already be gone from ir_list */
+	max_variable = 0;
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *address = NULL != iter->data->offset_variable ? iter->data->offset_variable : iter->data;
+		if (IR_ADDRESS_OF == address->kind && constant_propagation_is_tracked(address)) {
+			int variable = address->operands[3].data.variable_id;
+			if (variable > max_variable) max_variable = variable;
+		}
+		if (iter == cfg->proc_end) break;
+	}
+
+	escapes = calloc(max_variable + 1, sizeof(bool));
+	last_stores = calloc(max_variable + 1, sizeof(struct ir_list *));
+	last_store_blocks = malloc(sizeof(int) * (max_variable + 1));
+	last_store_sequences = calloc(max_variable + 1, sizeof(int));
+	assert(NULL != escapes && NULL != last_stores && NULL != last_store_blocks && NULL != last_store_sequences);
+	for (int v = 0; v <= max_variable; v++) last_store_blocks[v] = -1;
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (!constant_propagation_is_temporary(use)) continue;
+
+			struct ir_list *definition = temporary_definitions[use->data.temporary];
+			if (NULL == definition || !constant_propagation_is_tracked(definition->data)) continue;
+
+			bool is_address =
+				(constant_propagation_is_load(instruction) && use == &instruction->operands[1]) ||
+				(constant_propagation_is_store(instruction) && use == &instruction->operands[0]);
+			if (!is_address) {
+				escapes[definition->data->operands[3].data.variable_id] = true;
+			}
+		}
+		if (iter == cfg->proc_end) break;
+	}
+}
+
+static bool constant_propagation_stored_value(struct ir_list *store, uint32_t *value) {
+	if (IR_STORE_WORD != store->data->kind) return false;
+	return constant_propagation_operand_value(&store->data->operands[1], value);
+}
+
+/*
+ * A word load from a tracked local is constant when every store to it that
+ * reaches the load stores the same constant, and no call or pointer store
+ * can have written it in between.
+ */
+static bool constant_propagation_load_value(
+	struct ir_instruction *instruction, struct cfg_block *block, int sequence, int last_unknown_sequence,
+	struct dataflow_definitions *definitions, uint32_t *value
+) {
+	if (IR_LOAD_WORD != instruction->kind) return false;
+
+	int variable = constant_propagation_variable(instruction);
+	if (variable < 0) return false;
+
+	if (last_store_blocks[variable] == block->id) {
+		if (escapes[variable] && last_unknown_sequence > last_store_sequences[variable]) return false;
+		return constant_propagation_stored_value(last_stores[variable], value);
+	}
+	if (escapes[variable] && last_unknown_sequence >= 0) return false;
+
+	bool found = false;
+	struct bit_vector *in = definitions->flow->in[block->id];
+	for (int d = bit_vector_next(in, 0); d >= 0; d = bit_vector_next(in, d + 1)) {
+		int location = definitions->locations[d];
+		uint32_t stored;
+
+		if (DATAFLOW_UNKNOWN_LOCATION == location) {
+			if (escapes[variable]) return false;
+		} else if (-(variable + 1) == location) {
+			if (!constant_propagation_stored_value(definitions->sites[d], &stored)) return false;
+			if (found && stored != *value) return false;
+			*value = stored;
+			found = true;
+		}
+	}
+	return found;
+}
+
+static bool constant_propagation_phi_value(struct ir_instruction *instruction, uint32_t *value) {
+	bool found = false;
+
+	for (int i = 0; i < instruction->phi_argument_count; i++) {
+		struct ir_operand *argument = &instruction->phi_arguments[i];
+		uint32_t argument_value;
+
+		/* a phi argument that isn't a temporary is undefined on that edge */
+		if (OPERAND_TEMPORARY != argument->kind) continue;
+		if (!constant_propagation_operand_value(argument, &argument_value)) return false;
+		if (found && argument_value != *value) return false;
+		*value = argument_value;
+		found = true;
+	}
+	return found;
+}
+
+static bool constant_propagation_instruction_value(
+	struct ir_instruction *instruction, struct cfg_block *block, int sequence, int last_unknown_sequence,
+	struct dataflow_definitions *definitions, uint32_t *value
+) {
+	uint32_t left = 0, right = 0;
+
+	switch (instruction->kind) {
+		case IR_CONST_INT:
+			*value = (uint32_t)instruction->operands[1].data.number;
+			return true;
+		case IR_COPY:
+			return constant_propagation_operand_value(&instruction->operands[1], value);
+		case IR_PHI:
+			return NULL != instruction->phi_arguments && constant_propagation_phi_value(instruction, value);
+		case IR_LOAD_WORD:
+			return constant_propagation_load_value(instruction, block, sequence, last_unknown_sequence, definitions, value);
+		default:
+			break;
+	}
+
+	int use_count = ir_use_count(instruction);
+	if (use_count < 1 || use_count > 2 || !dataflow_is_expression(instruction)) return false;
+	if (!constant_propagation_operand_value(ir_use_operand(instruction, 0), &left)) return false;
+	if (2 == use_count && !constant_propagation_operand_value(ir_use_operand(instruction, 1), &right)) return false;
+
+	return constant_propagation_fold(instruction->kind, left, right, value);
+}
+
+bool constant_propagation_rewrite(struct ir_list *node, uint32_t value) {
+	struct ir_instruction *instruction = node->data;
+
+	if (IR_CONST_INT == instruction->kind) return false;
+	if (IR_PHI == instruction->kind && NULL != node->next && IR_PHI == node->next->data->kind) return false;
+
+	instruction->kind = IR_CONST_INT;
+	ir_operand_number(instruction, 1, value);
+	instruction->offset_variable = NULL;
+	instruction->phi_arguments = NULL;
+	instruction->phi_argument_count = 0;
+	instruction->is_used = true;
+	return true;
+}
+
+static int constant_propagation_representative(int temporary) {
+	while (representatives[temporary] != temporary) temporary = representatives[temporary];
+	return temporary;
+}
+
+static void constant_propagation_replace_copies(struct ir_instruction *instruction) {
+	int use_count = ir_use_count(instruction);
+
+	for (int i = 0; i < use_count; i++) {
+		struct ir_operand *use = ir_use_operand(instruction, i);
+		if (!constant_propagation_is_temporary(use)) continue;
+
+		int representative = constant_propagation_representative(use->data.temporary);
+		if (representative != use->data.temporary) {
+			use->data.temporary = representative;
+		}
+	}
+}
+
+void constant_propagation(struct cfg *cfg) {
+	struct ir_list *iter;
+
+	max_temporary = dataflow_max_temporary(cfg);
+	temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+	known = calloc(max_temporary + 1, sizeof(bool));
+	values = calloc(max_temporary + 1, sizeof(uint32_t));
+	representatives = malloc(sizeof(int) * (max_temporary + 1));
+	assert(NULL != known && NULL != values && NULL != representatives);
+	for (int t = 0; t <= max_temporary; t++) representatives[t] = t;
+
+	constant_propagation_find_escapes(cfg);
+	struct dataflow_definitions *definitions = dataflow_reaching_definitions(cfg);
+
+	/*
+	 * In reverse postorder every definition is seen before its uses, except
+	 * for the phi arguments coming in over back edges, which are assumed not
+	 * to be constant.
+	 */
+	int sequence = 0;
+	for (int b = 0; b < cfg->reachable_count; b++) {
+		struct cfg_block *block = cfg->reverse_postorder[b];
+		int last_unknown_sequence = -1;
+
+		for (iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *definition = ir_definition_operand(instruction);
+			uint32_t value;
+
+			sequence++;
+			if (NULL != definition && definition->data.temporary <= max_temporary) {
+				int temporary = definition->data.temporary;
+
+				if (constant_propagation_instruction_value(
+					instruction, block, sequence, last_unknown_sequence, definitions, &value
+				)) {
+					known[temporary] = true;
+					values[temporary] = value;
+					constant_propagation_rewrite(iter, value);
+				} else if (
+					IR_COPY == instruction->kind &&
+					constant_propagation_is_temporary(&instruction->operands[1])
+				) {
+					representatives[temporary] = constant_propagation_representative(instruction->operands[1].data.temporary);
+				}
+			}
+
+			if (constant_propagation_is_store(instruction)) {
+				int variable = constant_propagation_variable(instruction);
+				if (variable >= 0) {
+					last_stores[variable] = iter;
+					last_store_blocks[variable] = block->id;
+					last_store_sequences[variable] = sequence;
+				} else {
+					last_unknown_sequence = sequence;
+				}
+			} else if (IR_CALL == instruction->kind) {
+				last_unknown_sequence = sequence;
+			}
+
+			if (iter == block->last) break;
+		}
+	}
+
+	/* uses of a copy read its source, which dominates them in SSA form */
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		constant_propagation_replace_copies(iter->data);
+		if (iter == cfg->proc_end) break;
+	}
+
+	dataflow_definitions_destroy(definitions);
+	free(known);
+	free(values);
+	free(representatives);
+	free(temporary_definitions);
+	free(escapes);
+	free(last_stores);
+	free(last_store_blocks);
+	free(last_store_sequences);
+}
+
+void constant_propagation_program(struct cfg *cfgs) {
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		constant_propagation(cfg);
+	}
+}
@@ -0,0 +1,35 @@
+#ifndef _CONSTANT_PROPAGATION_H
+#define _CONSTANT_PROPAGATION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Global constant and copy propagation over a function in SSA form. Every
+ * temporary that is provably constant, including values stored into a local
+ * and loaded back, has its definition rewritten into a constInt, and every
+ * use of a copy reads the copy's source instead. The instructions left
+ * without uses are removed by the level 2 dead code pass.
+ */
+void constant_propagation(struct cfg *cfg);
+void constant_propagation_program(struct cfg *cfgs);
+
+/*
+ * Folds an arithmetic, comparison, unary or cast opcode on 32 bit operands
+ * (right is ignored by the unary ones). Returns false if the opcode isn't
+ * foldable or the result is undefined, e.g. a division by zero.
+ */
+bool constant_propagation_fold(enum ir_instruction_kind kind, uint32_t left, uint32_t right, uint32_t *result);
+
+/*
+ * Turns the definition into (constInt, t, value) in place. Returns false if
+ * it already was one, or if it is a phi followed by more phis of its block,
+ * which would leave a constInt in the middle of them.
+ */
+bool constant_propagation_rewrite(struct ir_list *node, uint32_t value);
+
+#endif
@@ -0,0 +1,668 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "helpers/bit-vector.h"
+
+/**********
+ * SOLVER *
+ **********/
+
+static struct bit_vector **dataflow_create_vectors(int count, int size) {
+	struct bit_vector **vectors = malloc(sizeof(struct bit_vector *) * (count > 0 ? count : 1));
+	assert(NULL != vectors);
+	for (int i = 0; i < count; i++) {
+		vectors[i] = bit_vector_create(size);
+	}
+	return vectors;
+}
+
+static void dataflow_free_vectors(struct bit_vector **vectors, int count) {
+	for (int i = 0; i < count; i++) {
+		bit_vector_free(vectors[i]);
+	}
+	free(vectors);
+}
+
+struct dataflow *dataflow_create(
+	struct cfg *cfg, int size, enum dataflow_direction direction, enum dataflow_meet meet
+) {
+	struct dataflow *dataflow = calloc(1, sizeof(struct dataflow));
+	assert(NULL != dataflow);
+
+	dataflow->cfg = cfg;
+	dataflow->block_count = cfg->block_count;
+	dataflow->size = size;
+	dataflow->direction = direction;
+	dataflow->meet = meet;
+	dataflow->gen = dataflow_create_vectors(cfg->block_count, size);
+	dataflow->kill = dataflow_create_vectors(cfg->block_count, size);
+	dataflow->in = dataflow_create_vectors(cfg->block_count, size);
+	dataflow->out = dataflow_create_vectors(cfg->block_count, size);
+
+	return dataflow;
+}
+
+void dataflow_destroy(struct dataflow *dataflow) {
+	if (NULL == dataflow) return;
+
+	int count = dataflow->block_count;
+	dataflow_free_vectors(dataflow->gen, count);
+	dataflow_free_vectors(dataflow->kill, count);
+	dataflow_free_vectors(dataflow->in, count);
+	dataflow_free_vectors(dataflow->out, count);
+	free(dataflow);
+}
+
+/*
+ * Round robin worklist solver. Blocks are queued in reverse postorder
+ * (postorder for backward problems) so most acyclic flow settles in one
+ * pass; a block is only requeued when one of its inputs changed.
+ */
+void dataflow_solve(struct dataflow *dataflow) {
+	struct cfg *cfg = dataflow->cfg;
+	bool forward = DATAFLOW_FORWARD == dataflow->direction;
+	bool intersection = DATAFLOW_INTERSECTION == dataflow->meet;
+
+	/* the side facing the meet and the side facing the transfer function */
+	struct bit_vector **meet_side = forward ? dataflow->in : dataflow->out;
+	struct bit_vector **result_side = forward ? dataflow->out : dataflow->in;
+
+	for (int i = 0; i < cfg->block_count; i++) {
+		bit_vector_clear_all(meet_side[i]);
+		if (intersection) {
+			bit_vector_set_all(result_side[i]);
+		} else {
+			bit_vector_clear_all(result_side[i]);
+		}
+	}
+
+	int capacity = cfg->reachable_count + 1;
+	struct cfg_block **queue = malloc(sizeof(struct cfg_block *) * capacity);
+	bool *queued = calloc(cfg->block_count, sizeof(bool));
+	assert(NULL != queue && NULL != queued);
+
+	int head = 0, count = 0;
+	for (int i = 0; i < cfg->reachable_count; i++) {
+		struct cfg_block *block = cfg->reverse_postorder[forward ? i : cfg->reachable_count - 1 - i];
+		queue[count++] = block;
+		queued[block->id] = true;
+	}
+
+	struct bit_vector *scratch = bit_vector_create(dataflow->size);
+	dataflow->evaluations = 0;
+
+	while (count > 0) {
+		struct cfg_block *block = queue[head];
+		head = (head + 1) % capacity;
+		count--;
+		queued[block->id] = false;
+		dataflow->evaluations++;
+
+		struct cfg_block **sources = forward ? block->predecessors : block->successors;
+		int source_count = forward ? block->predecessor_count : block->successor_count;
+		struct bit_vector *meet = meet_side[block->id];
+
+		/* meet over the reachable neighbours; the boundary (entry or exit) stays empty */
+		bool first = true;
+		for (int i = 0; i < source_count; i++) {
+			if (sources[i]->reverse_postorder < 0) continue;
+			if (first) {
+				bit_vector_copy(meet, result_side[sources[i]->id]);
+				first = false;
+			} else if (intersection) {
+				bit_vector_intersect(meet, result_side[sources[i]->id]);
+			} else {
+				bit_vector_union(meet, result_side[sources[i]->id]);
+			}
+		}
+		if (first) bit_vector_clear_all(meet);
+
+		/* result = gen | (meet - kill) */
+		bit_vector_copy(scratch, meet);
+		bit_vector_subtract(scratch, dataflow->kill[block->id]);
+		bit_vector_union(scratch, dataflow->gen[block->id]);
+		if (bit_vector_equals(scratch, result_side[block->id])) continue;
+		bit_vector_copy(result_side[block->id], scratch);
+
+		struct cfg_block **targets = forward ? block->successors : block->predecessors;
+		int target_count = forward ? block->successor_count : block->predecessor_count;
+		for (int i = 0; i < target_count; i++) {
+			struct cfg_block *target = targets[i];
+			if (target->reverse_postorder < 0 || queued[target->id]) continue;
+			queue[(head + count) % capacity] = target;
+			count++;
+			queued[target->id] = true;
+		}
+	}
+
+	bit_vector_free(scratch);
+	free(queue);
+	free(queued);
+}
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool dataflow_is_temporary(struct ir_operand *operand) {
+	return NULL != operand && OPERAND_TEMPORARY == operand->kind;
+}
+
+int dataflow_max_temporary(struct cfg *cfg) {
+	int max_temporary = 0;
+	struct ir_list *iter;
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		struct ir_operand *definition = ir_definition_operand(instruction);
+
+		if (dataflow_is_temporary(definition) && definition->data.temporary > max_temporary) {
+			max_temporary = definition->data.temporary;
+		}
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (dataflow_is_temporary(use) && use->data.temporary > max_temporary) {
+				max_temporary = use->data.temporary;
+			}
+		}
+		if (iter == cfg->proc_end) break;
+	}
+	return max_temporary;
+}
+
+/* temporary -> the (last) instruction writing it */
+struct ir_list **dataflow_temporary_definitions(struct cfg *cfg, int max_temporary) {
+	struct ir_list **definitions = calloc(max_temporary + 1, sizeof(struct ir_list *));
+	assert(NULL != definitions);
+
+	struct ir_list *iter;
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (dataflow_is_temporary(definition) && definition->data.temporary <= max_temporary) {
+			definitions[definition->data.temporary] = iter;
+		}
+		if (iter == cfg->proc_end) break;
+	}
+	return definitions;
+}
+
+/*
+ * The variable id a load or store accesses when its address comes straight
+ * from an addressOf, -1 otherwise.
+ */
+int dataflow_accessed_variable(struct ir_instruction *instruction, struct ir_list **temporary_definitions) {
+	struct ir_instruction *address = instruction->offset_variable;
+
+	if (NULL == address) {
+		int position = IR_STORE_WORD == instruction->kind ||
+			IR_STORE_HALF_WORD == instruction->kind ||
+			IR_STORE_BYTE == instruction->kind ? 0 : 1;
+		struct ir_operand *operand = &instruction->operands[position];
+		if (!dataflow_is_temporary(operand) || NULL == temporary_definitions) return -1;
+
+		struct ir_list *definition = temporary_definitions[operand->data.temporary];
+		if (NULL == definition) return -1;
+		address = definition->data;
+	}
+
+	if (IR_ADDRESS_OF != address->kind) return -1;
+	return address->operands[3].data.variable_id;
+}
+
+static bool dataflow_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+static bool dataflow_is_load(struct ir_instruction *instruction) {
+	return (
+		IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind
+	);
+}
+
+/* the addressOf of a named variable, NULL for strings and everything else */
+static struct ir_instruction *dataflow_variable_address(struct ir_instruction *instruction) {
+	if (IR_ADDRESS_OF != instruction->kind || instruction->operands[2].data.is_string) return NULL;
+	return instruction;
+}
+
+bool *dataflow_escaping_variables(struct cfg *cfg, struct ir_list **temporary_definitions, int *max_variable) {
+	struct ir_list *iter;
+
+	/* the addressOf of an offset_variable may already be gone from ir_list */
+	*max_variable = 0;
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *address = dataflow_variable_address(
+			NULL != iter->data->offset_variable ? iter->data->offset_variable : iter->data
+		);
+		if (NULL != address && address->operands[3].data.variable_id > *max_variable) {
+			*max_variable = address->operands[3].data.variable_id;
+		}
+		if (iter == cfg->proc_end) break;
+	}
+
+	bool *escapes = calloc(*max_variable + 1, sizeof(bool));
+	assert(NULL != escapes);
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (!dataflow_is_temporary(use)) continue;
+
+			struct ir_list *definition = temporary_definitions[use->data.temporary];
+			if (NULL == definition || NULL == dataflow_variable_address(definition->data)) continue;
+
+			bool is_address =
+				(dataflow_is_load(instruction) && use == &instruction->operands[1]) ||
+				(dataflow_is_store(instruction) && use == &instruction->operands[0]);
+			if (!is_address) {
+				escapes[definition->data->operands[3].data.variable_id] = true;
+			}
+		}
+		if (iter == cfg->proc_end) break;
+	}
+	return escapes;
+}
+
+/************
+ * LIVENESS *
+ ************/
+
+struct dataflow *dataflow_liveness(struct cfg *cfg) {
+	int max_temporary = dataflow_max_temporary(cfg);
+	struct dataflow *dataflow = dataflow_create(cfg, max_temporary + 1, DATAFLOW_BACKWARD, DATAFLOW_UNION);
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		struct bit_vector *gen = dataflow->gen[b];
+		struct bit_vector *kill = dataflow->kill[b];
+		struct ir_list *iter;
+
+		for (iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+
+			/* phi arguments are read in the predecessors, see below */
+			if (IR_PHI != instruction->kind) {
+				for (int i = 0; i < ir_use_count(instruction); i++) {
+					struct ir_operand *use = ir_use_operand(instruction, i);
+					if (!dataflow_is_temporary(use)) continue;
+					if (!bit_vector_test(kill, use->data.temporary)) {
+						bit_vector_set(gen, use->data.temporary);
+					}
+				}
+			}
+
+			struct ir_operand *definition = ir_definition_operand(instruction);
+			if (dataflow_is_temporary(definition)) {
+				bit_vector_set(kill, definition->data.temporary);
+			}
+
+			if (iter == block->last) break;
+		}
+	}
+
+	/* a phi argument is read at the very end of its predecessor */
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		struct ir_list *iter;
+
+		for (iter = block->first->next; NULL != iter && IR_PHI == iter->data->kind; iter = iter->next) {
+			struct ir_instruction *phi = iter->data;
+			for (int p = 0; p < phi->phi_argument_count && p < block->predecessor_count; p++) {
+				struct ir_operand *argument = &phi->phi_arguments[p];
+				int predecessor = block->predecessors[p]->id;
+				if (dataflow_is_temporary(argument) && !bit_vector_test(dataflow->kill[predecessor], argument->data.temporary)) {
+					bit_vector_set(dataflow->gen[predecessor], argument->data.temporary);
+				}
+			}
+		}
+	}
+
+	dataflow_solve(dataflow);
+
+	/* and so is live out of it, which the union over successors misses */
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		struct ir_list *iter;
+
+		for (iter = block->first->next; NULL != iter && IR_PHI == iter->data->kind; iter = iter->next) {
+			struct ir_instruction *phi = iter->data;
+			for (int p = 0; p < phi->phi_argument_count && p < block->predecessor_count; p++) {
+				if (dataflow_is_temporary(&phi->phi_arguments[p])) {
+					bit_vector_set(dataflow->out[block->predecessors[p]->id], phi->phi_arguments[p].data.temporary);
+				}
+			}
+		}
+	}
+
+	return dataflow;
+}
+
+/************************
+ * REACHING DEFINITIONS *
+ ************************/
+
+static int dataflow_definition_location(struct ir_instruction *instruction, struct ir_list **temporary_definitions) {
+	struct ir_operand *definition = ir_definition_operand(instruction);
+	if (dataflow_is_temporary(definition)) return definition->data.temporary;
+
+	if (dataflow_is_store(instruction)) {
+		int variable = dataflow_accessed_variable(instruction, temporary_definitions);
+		return variable >= 0 ? -(variable + 1) : DATAFLOW_UNKNOWN_LOCATION;
+	}
+	if (IR_CALL == instruction->kind) return DATAFLOW_UNKNOWN_LOCATION;
+
+	return 0;
+}
+
+static bool dataflow_is_definition(struct ir_instruction *instruction) {
+	return (
+		dataflow_is_temporary(ir_definition_operand(instruction)) ||
+		dataflow_is_store(instruction) ||
+		IR_CALL == instruction->kind
+	);
+}
+
+struct dataflow_definitions *dataflow_reaching_definitions(struct cfg *cfg) {
+	struct dataflow_definitions *definitions = calloc(1, sizeof(struct dataflow_definitions));
+	assert(NULL != definitions);
+
+	int max_temporary = dataflow_max_temporary(cfg);
+	struct ir_list **temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+
+	/* number the definitions of the reachable blocks */
+	int capacity = 64;
+	definitions->sites = malloc(sizeof(struct ir_list *) * capacity);
+	definitions->locations = malloc(sizeof(int) * capacity);
+	int *blocks = malloc(sizeof(int) * capacity);
+	assert(NULL != definitions->sites && NULL != definitions->locations && NULL != blocks);
+
+	for (int b = 0; b < cfg->reachable_count; b++) {
+		struct cfg_block *block = cfg->reverse_postorder[b];
+		struct ir_list *iter;
+
+		for (iter = block->first; ; iter = iter->next) {
+			if (dataflow_is_definition(iter->data)) {
+				if (definitions->count == capacity) {
+					capacity *= 2;
+					definitions->sites = realloc(definitions->sites, sizeof(struct ir_list *) * capacity);
+					definitions->locations = realloc(definitions->locations, sizeof(int) * capacity);
+					blocks = realloc(blocks, sizeof(int) * capacity);
+					assert(NULL != definitions->sites && NULL != definitions->locations && NULL != blocks);
+				}
+				definitions->sites[definitions->count] = iter;
+				definitions->locations[definitions->count] = dataflow_definition_location(iter->data, temporary_definitions);
+				blocks[definitions->count] = block->id;
+				definitions->count++;
+			}
+			if (iter == block->last) break;
+		}
+	}
+
+	/*
+	 * Group the definitions of each known location so a block's kill set is
+	 * built from the locations it writes, not by comparing every pair.
+	 */
+	int *order = malloc(sizeof(int) * (definitions->count + 1));
+	int *location_of_group = malloc(sizeof(int) * (definitions->count + 1));
+	int *group_start = malloc(sizeof(int) * (definitions->count + 2));
+	int *group_of = malloc(sizeof(int) * (definitions->count + 1));
+	assert(NULL != order && NULL != location_of_group && NULL != group_start && NULL != group_of);
+
+	int group_count = 0;
+	{
+		/* open addressing from location to group */
+		int table_size = 16;
+		while (table_size < definitions->count * 2) table_size *= 2;
+		int *table = malloc(sizeof(int) * table_size);
+		int *group_sizes = calloc(definitions->count + 1, sizeof(int));
+		assert(NULL != table && NULL != group_sizes);
+		for (int i = 0; i < table_size; i++) table[i] = -1;
+
+		for (int d = 0; d < definitions->count; d++) {
+			int location = definitions->locations[d];
+			unsigned int slot = ((unsigned int)location * 2654435761u) & (table_size - 1);
+			while (-1 != table[slot] && location_of_group[table[slot]] != location) {
+				slot = (slot + 1) & (table_size - 1);
+			}
+			if (-1 == table[slot]) {
+				table[slot] = group_count;
+				location_of_group[group_count++] = location;
+			}
+			group_of[d] = table[slot];
+			group_sizes[table[slot]]++;
+		}
+
+		group_start[0] = 0;
+		for (int g = 0; g < group_count; g++) group_start[g + 1] = group_start[g] + group_sizes[g];
+		memset(group_sizes, 0, sizeof(int) * (definitions->count + 1));
+		for (int d = 0; d < definitions->count; d++) {
+			order[group_start[group_of[d]] + group_sizes[group_of[d]]++] = d;
+		}
+
+		free(table);
+		free(group_sizes);
+	}
+
+	struct dataflow *dataflow = dataflow_create(cfg, definitions->count, DATAFLOW_FORWARD, DATAFLOW_UNION);
+	for (int d = 0; d < definitions->count; d++) {
+		int block = blocks[d];
+		int location = definitions->locations[d];
+
+		if (DATAFLOW_UNKNOWN_LOCATION != location) {
+			/* a later definition of the same location in this block replaces this one */
+			int group = group_of[d];
+			for (int i = group_start[group]; i < group_start[group + 1]; i++) {
+				int other = order[i];
+				if (blocks[other] == block && other != d) bit_vector_clear(dataflow->gen[block], other);
+				bit_vector_set(dataflow->kill[block], other);
+			}
+		}
+		bit_vector_set(dataflow->gen[block], d);
+	}
+	dataflow_solve(dataflow);
+	definitions->flow = dataflow;
+
+	free(order);
+	free(location_of_group);
+	free(group_start);
+	free(group_of);
+	free(blocks);
+	free(temporary_definitions);
+
+	return definitions;
+}
+
+void dataflow_definitions_destroy(struct dataflow_definitions *definitions) {
+	if (NULL == definitions) return;
+
+	dataflow_destroy(definitions->flow);
+	free(definitions->sites);
+	free(definitions->locations);
+	free(definitions);
+}
+
+/*************************
+ * AVAILABLE EXPRESSIONS *
+ *************************/
+
+bool dataflow_is_expression(struct ir_instruction *instruction) {
+	if (instruction->kind >= IR_MULT_SIGNED_WORD && instruction->kind <= IR_BITWISE_OR_WORD) return true;
+
+	switch (instruction->kind) {
+		case IR_MULT_HIGH_SIGNED_WORD:
+		case IR_MULT_HIGH_UNSIGNED_WORD:
+		case IR_UNARY_MINUS:
+		case IR_UNARY_LOGICAL_NEGATION:
+		case IR_UNARY_BITWISE_NEGATION:
+		case IR_CAST_WORD_TO_HALF_WORD:
+		case IR_CAST_WORD_TO_BYTE:
+		case IR_CAST_HALF_WORD_TO_BYTE:
+		case IR_CAST_UNSIGNED_HALF_WORD_TO_WORD:
+		case IR_CAST_SIGNED_HALF_WORD_TO_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_SIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_WORD:
+		case IR_CAST_SIGNED_BYTE_TO_WORD:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static bool dataflow_same_expression(struct ir_instruction *instruction_1, struct ir_instruction *instruction_2) {
+	if (instruction_1->kind != instruction_2->kind) return false;
+
+	for (int i = 0; i < ir_use_count(instruction_1); i++) {
+		if (!ir_operand_equals(ir_use_operand(instruction_1, i), ir_use_operand(instruction_2, i))) return false;
+	}
+	return true;
+}
+
+static unsigned int dataflow_hash_expression(struct ir_instruction *instruction) {
+	unsigned int hash = (unsigned int)instruction->kind * 2654435761u;
+	for (int i = 0; i < ir_use_count(instruction); i++) {
+		struct ir_operand *operand = ir_use_operand(instruction, i);
+		unsigned int value = OPERAND_TEMPORARY == operand->kind ? (unsigned int)operand->data.temporary : (unsigned int)operand->data.number;
+		hash = (hash ^ value) * 16777619u;
+	}
+	return hash;
+}
+
+int dataflow_expression_number(struct dataflow_expressions *expressions, struct ir_instruction *instruction) {
+	if (!dataflow_is_expression(instruction)) return -1;
+
+	unsigned int slot = dataflow_hash_expression(instruction) & (expressions->table_size - 1);
+	while (-1 != expressions->table[slot]) {
+		int number = expressions->table[slot];
+		if (dataflow_same_expression(expressions->representatives[number], instruction)) return number;
+		slot = (slot + 1) & (expressions->table_size - 1);
+	}
+	return -1;
+}
+
+static int dataflow_add_expression(struct dataflow_expressions *expressions, struct ir_instruction *instruction) {
+	int number = dataflow_expression_number(expressions, instruction);
+	if (number >= 0) return number;
+
+	unsigned int slot = dataflow_hash_expression(instruction) & (expressions->table_size - 1);
+	while (-1 != expressions->table[slot]) {
+		slot = (slot + 1) & (expressions->table_size - 1);
+	}
+	expressions->table[slot] = expressions->count;
+	expressions->representatives[expressions->count] = instruction;
+	return expressions->count++;
+}
+
+struct dataflow_expressions *dataflow_available_expressions(struct cfg *cfg) {
+	struct dataflow_expressions *expressions = calloc(1, sizeof(struct dataflow_expressions));
+	assert(NULL != expressions);
+
+	int max_temporary = dataflow_max_temporary(cfg);
+	int instruction_count = 0;
+	struct ir_list *iter;
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		instruction_count++;
+		if (iter == cfg->proc_end) break;
+	}
+
+	expressions->table_size = 16;
+	while (expressions->table_size < instruction_count * 2) expressions->table_size *= 2;
+	expressions->table = malloc(sizeof(int) * expressions->table_size);
+	expressions->representatives = malloc(sizeof(struct ir_instruction *) * instruction_count);
+	assert(NULL != expressions->table && NULL != expressions->representatives);
+	for (int i = 0; i < expressions->table_size; i++) expressions->table[i] = -1;
+
+	/* number the expressions and index them by the temporaries they read */
+	int *use_counts = calloc(max_temporary + 2, sizeof(int));
+	assert(NULL != use_counts);
+	for (int b = 0; b < cfg->reachable_count; b++) {
+		struct cfg_block *block = cfg->reverse_postorder[b];
+		for (iter = block->first; ; iter = iter->next) {
+			if (dataflow_is_expression(iter->data)) {
+				int count = expressions->count;
+				dataflow_add_expression(expressions, iter->data);
+				if (count != expressions->count) {
+					for (int i = 0; i < ir_use_count(iter->data); i++) {
+						struct ir_operand *use = ir_use_operand(iter->data, i);
+						if (dataflow_is_temporary(use)) use_counts[use->data.temporary + 1]++;
+					}
+				}
+			}
+			if (iter == block->last) break;
+		}
+	}
+	for (int t = 0; t <= max_temporary; t++) use_counts[t + 1] += use_counts[t];
+	int *users = malloc(sizeof(int) * (use_counts[max_temporary + 1] + 1));
+	int *fill = calloc(max_temporary + 1, sizeof(int));
+	assert(NULL != users && NULL != fill);
+	for (int e = 0; e < expressions->count; e++) {
+		struct ir_instruction *instruction = expressions->representatives[e];
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (dataflow_is_temporary(use)) {
+				users[use_counts[use->data.temporary] + fill[use->data.temporary]++] = e;
+			}
+		}
+	}
+
+	struct dataflow *dataflow = dataflow_create(cfg, expressions->count, DATAFLOW_FORWARD, DATAFLOW_INTERSECTION);
+	for (int b = 0; b < cfg->reachable_count; b++) {
+		struct cfg_block *block = cfg->reverse_postorder[b];
+		struct bit_vector *gen = dataflow->gen[block->id];
+		struct bit_vector *kill = dataflow->kill[block->id];
+
+		for (iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+
+			int number = dataflow_expression_number(expressions, instruction);
+			if (number >= 0) {
+				bit_vector_set(gen, number);
+				bit_vector_clear(kill, number);
+			}
+
+			/* writing a temporary kills every expression reading it */
+			struct ir_operand *definition = ir_definition_operand(instruction);
+			if (dataflow_is_temporary(definition) && definition->data.temporary <= max_temporary) {
+				int temporary = definition->data.temporary;
+				for (int i = use_counts[temporary]; i < use_counts[temporary + 1]; i++) {
+					bit_vector_clear(gen, users[i]);
+					bit_vector_set(kill, users[i]);
+				}
+			}
+			if (iter == block->last) break;
+		}
+	}
+	dataflow_solve(dataflow);
+	expressions->flow = dataflow;
+
+	free(use_counts);
+	free(users);
+	free(fill);
+
+	return expressions;
+}
+
+void dataflow_expressions_destroy(struct dataflow_expressions *expressions) {
+	if (NULL == expressions) return;
+
+	dataflow_destroy(expressions->flow);
+	free(expressions->table);
+	free(expressions->representatives);
+	free(expressions);
+}
@@ -0,0 +1,104 @@
+#ifndef _DATAFLOW_H
+#define _DATAFLOW_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+#include "helpers/bit-vector.h"
+
+enum dataflow_direction {
+  DATAFLOW_FORWARD,
+  DATAFLOW_BACKWARD
+};
+
+enum dataflow_meet {
+  DATAFLOW_UNION,          /* may problems: liveness, reaching definitions */
+  DATAFLOW_INTERSECTION    /* must problems: available expressions */
+};
+
+/*
+ * A gen/kill problem over the blocks of one cfg, with one bit vector of
+ * `size` bits per block and set, indexed by block id. Going forward
+ * out = gen | (in - kill) and in is the meet of the predecessors' out,
+ * going backward the roles of in and out swap.
+ */
+struct dataflow {
+  struct cfg *cfg;
+  int block_count;         /* blocks when created, the cfg may grow afterwards */
+  int size;
+  enum dataflow_direction direction;
+  enum dataflow_meet meet;
+
+  struct bit_vector **gen, **kill;
+  struct bit_vector **in, **out;
+
+  int evaluations;         /* blocks evaluated by the last solve */
+};
+
+struct dataflow *dataflow_create(
+  struct cfg *cfg, int size, enum dataflow_direction direction, enum dataflow_meet meet
+);
+void dataflow_solve(struct dataflow *dataflow);
+void dataflow_destroy(struct dataflow *dataflow);
+
+/* helpers shared by the clients */
+int dataflow_max_temporary(struct cfg *cfg);
+struct ir_list **dataflow_temporary_definitions(struct cfg *cfg, int max_temporary);
+int dataflow_accessed_variable(struct ir_instruction *instruction, struct ir_list **temporary_definitions);
+
+/*
+ * Named variables whose address is used as anything but the address of a
+ * load or store, indexed by variable id up to *max_variable. Stores through
+ * pointers and calls may write them.
+ */
+bool *dataflow_escaping_variables(struct cfg *cfg, struct ir_list **temporary_definitions, int *max_variable);
+
+/*
+ * Liveness: bit t is set in in[b] if temporary t is read on some path from
+ * the start of b before being written. Phi arguments count as read at the
+ * end of the matching predecessor.
+ */
+struct dataflow *dataflow_liveness(struct cfg *cfg);
+
+/*
+ * Reaching definitions. A definition is an instruction that writes a
+ * temporary or stores to a variable. The location of a definition is the
+ * temporary it writes, or -(variable id + 1) for a store to a named
+ * variable. Stores through pointers and calls may write any variable whose
+ * address escapes; they are recorded with DATAFLOW_UNKNOWN_LOCATION and
+ * kill nothing.
+ */
+#define DATAFLOW_UNKNOWN_LOCATION (-2147483647 - 1)
+
+struct dataflow_definitions {
+  int count;
+  struct ir_list **sites;          /* definition number -> instruction */
+  int *locations;                  /* definition number -> location */
+  struct dataflow *flow;
+};
+
+struct dataflow_definitions *dataflow_reaching_definitions(struct cfg *cfg);
+void dataflow_definitions_destroy(struct dataflow_definitions *definitions);
+
+/*
+ * Available expressions: an expression is a pure computation identified by
+ * its opcode and operands, e.g. (addSignedWord, r3, r4). It is available at
+ * a point if every path there computes it and none of its operands is
+ * written afterwards.
+ */
+struct dataflow_expressions {
+  int count;
+  struct ir_instruction **representatives;   /* expression number -> first instruction computing it */
+  int table_size;
+  int *table;                                /* hash table of expression numbers */
+  struct dataflow *flow;
+};
+
+bool dataflow_is_expression(struct ir_instruction *instruction);
+struct dataflow_expressions *dataflow_available_expressions(struct cfg *cfg);
+int dataflow_expression_number(struct dataflow_expressions *expressions, struct ir_instruction *instruction);
+void dataflow_expressions_destroy(struct dataflow_expressions *expressions);
+
+#endif
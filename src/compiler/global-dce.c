@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "symbol.h"
+#include "global-dce.h"
+
+struct global_dce_function {
+	struct ir_list *begin, *end;                /* procBegin and procEnd */
+	bool is_reachable;
+};
+
+static struct global_dce_function *functions;
+static int function_count;
+
+/* the globals and string literals something reachable takes the address of */
+static const char **names;
+static int name_count;
+
+/***********
+ * HELPERS *
+ ***********/
+
+/* an addressOf of a global variable or a string literal */
+static bool global_dce_is_global(struct ir_instruction *address) {
+	return IR_ADDRESS_OF == address->kind && (address->operands[2].data.is_string || address->operands[6].data.number);
+}
+
+static int global_dce_find_function(const char *name) {
+	for (int f = 0; f < function_count; f++) {
+		if (0 == strcmp(functions[f].begin->data->operands[0].data.name, name)) return f;
+	}
+	return -1;
+}
+
+static bool global_dce_is_referenced(const char *name) {
+	for (int n = 0; n < name_count; n++) {
+		if (0 == strcmp(names[n], name)) return true;
+	}
+	return false;
+}
+
+static void global_dce_find_functions(void) {
+	function_count = 0;
+	for (struct ir_list *iter = ir_get_ir_list(); NULL != iter; iter = iter->next) {
+		if (IR_PROC_BEGIN != iter->data->kind) continue;
+
+		functions = realloc(functions, sizeof(struct global_dce_function) * (function_count + 1));
+		assert(NULL != functions);
+		struct global_dce_function *function = &functions[function_count++];
+		function->begin = iter;
+		function->is_reachable = false;
+
+		while (IR_PROC_END != iter->data->kind) iter = iter->next;
+		function->end = iter;
+	}
+}
+
+/*********
+ * GRAPH *
+ *********/
+
+static void global_dce_visit(int f);
+
+static void global_dce_reference(const char *name) {
+	int f = global_dce_find_function(name);
+	if (f >= 0) {
+		global_dce_visit(f);
+	} else if (!global_dce_is_referenced(name)) {
+		names = realloc(names, sizeof(const char *) * (name_count + 1));
+		assert(NULL != names);
+		names[name_count++] = name;
+	}
+}
+
+/* the functions an instruction calls and the globals it takes the address of */
+static void global_dce_visit_instruction(struct ir_instruction *instruction) {
+	if (IR_CALL == instruction->kind) {
+		global_dce_reference(instruction->operands[0].data.name);
+	}
+	if (global_dce_is_global(instruction)) {
+		global_dce_reference(instruction->operands[1].data.name);
+	}
+	if (NULL != instruction->offset_variable && global_dce_is_global(instruction->offset_variable)) {
+		global_dce_reference(instruction->offset_variable->operands[1].data.name);
+	}
+}
+
+static void global_dce_visit(int f) {
+	struct global_dce_function *function = &functions[f];
+	if (function->is_reachable) return;
+
+	function->is_reachable = true;
+	for (struct ir_list *iter = function->begin->next; iter != function->end; iter = iter->next) {
+		global_dce_visit_instruction(iter->data);
+	}
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+void global_dce_program(void) {
+	global_dce_find_functions();
+	name_count = 0;
+
+	int root = global_dce_find_function("main");
+	if (root < 0) return;
+
+	/* anything outside a procedure is part of every program */
+	int f = 0;
+	for (struct ir_list *iter = ir_get_ir_list(); NULL != iter; iter = iter->next) {
+		if (f < function_count && iter == functions[f].begin) {
+			iter = functions[f++].end;
+		} else {
+			global_dce_visit_instruction(iter->data);
+		}
+	}
+	global_dce_visit(root);
+
+	for (f = 0; f < function_count; f++) {
+		if (functions[f].is_reachable) continue;
+
+		struct ir_list *iter = functions[f].begin;
+		while (true) {
+			struct ir_list *next = iter->next;
+			bool is_last = iter == functions[f].end;
+			ir_unlink(iter);
+			if (is_last) break;
+			iter = next;
+		}
+	}
+
+	for (
+		struct symbol_list *iter = symbol_get_global_symbol_table()->variables;
+		NULL != iter;
+		iter = iter->next
+	) {
+		iter->symbol.is_referenced = global_dce_is_referenced(iter->symbol.name);
+	}
+	for (struct string_symbol_list *iter = symbol_get_string_table(); NULL != iter; iter = iter->next) {
+		iter->string_symbol.is_referenced = global_dce_is_referenced(iter->string_symbol.id);
+	}
+}
@@ -0,0 +1,21 @@
+#ifndef _GLOBAL_DCE_H
+#define _GLOBAL_DCE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+
+/*
+ * Dead function and dead global elimination. The call and reference graph
+ * of ir_list is walked from main: a function nothing reachable calls (or
+ * takes the address of) is removed from ir_list, so later passes don't
+ * optimize it and mips.c doesn't print it, and a global variable or string
+ * literal nothing reachable takes the address of loses is_referenced, so
+ * the data section leaves it out.
+ *
+ * A program without main is left alone. Works on ir_list outside SSA form.
+ */
+void global_dce_program(void);
+
+#endif
@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <stdlib.h>
+
+#include "./bit-vector.h"
+
+#define BITS_PER_WORD 32
+
+struct bit_vector *bit_vector_create(int size) {
+  struct bit_vector *vector;
+
+  vector = malloc(sizeof(struct bit_vector));
+  assert(NULL != vector);
+
+  vector->size = size;
+  vector->word_count = (size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  vector->words = calloc(vector->word_count > 0 ? vector->word_count : 1, sizeof(unsigned int));
+  assert(NULL != vector->words);
+
+  return vector;
+}
+
+void bit_vector_free(struct bit_vector *vector) {
+  if (NULL == vector) return;
+  free(vector->words);
+  free(vector);
+}
+
+void bit_vector_set(struct bit_vector *vector, int bit) {
+  assert(bit >= 0 && bit < vector->size);
+  vector->words[bit / BITS_PER_WORD] |= 1u << (bit % BITS_PER_WORD);
+}
+
+void bit_vector_clear(struct bit_vector *vector, int bit) {
+  assert(bit >= 0 && bit < vector->size);
+  vector->words[bit / BITS_PER_WORD] &= ~(1u << (bit % BITS_PER_WORD));
+}
+
+bool bit_vector_test(const struct bit_vector *vector, int bit) {
+  if (bit < 0 || bit >= vector->size) return false;
+  return 0 != (vector->words[bit / BITS_PER_WORD] & (1u << (bit % BITS_PER_WORD)));
+}
+
+void bit_vector_clear_all(struct bit_vector *vector) {
+  memset(vector->words, 0, sizeof(unsigned int) * vector->word_count);
+}
+
+void bit_vector_set_all(struct bit_vector *vector) {
+  memset(vector->words, 0xff, sizeof(unsigned int) * vector->word_count);
+
+  /* keep the bits past the end clear so equality checks stay exact */
+  if (0 != vector->size % BITS_PER_WORD) {
+    vector->words[vector->word_count - 1] = (1u << (vector->size % BITS_PER_WORD)) - 1;
+  }
+}
+
+void bit_vector_copy(struct bit_vector *destination, const struct bit_vector *source) {
+  assert(destination->size == source->size);
+  memcpy(destination->words, source->words, sizeof(unsigned int) * source->word_count);
+}
+
+bool bit_vector_equals(const struct bit_vector *vector_1, const struct bit_vector *vector_2) {
+  assert(vector_1->size == vector_2->size);
+  return 0 == memcmp(vector_1->words, vector_2->words, sizeof(unsigned int) * vector_1->word_count);
+}
+
+bool bit_vector_union(struct bit_vector *destination, const struct bit_vector *source) {
+  assert(destination->size == source->size);
+
+  unsigned int changed = 0;
+  for (int i = 0; i < destination->word_count; i++) {
+    unsigned int word = destination->words[i] | source->words[i];
+    changed |= word ^ destination->words[i];
+    destination->words[i] = word;
+  }
+  return 0 != changed;
+}
+
+bool bit_vector_intersect(struct bit_vector *destination, const struct bit_vector *source) {
+  assert(destination->size == source->size);
+
+  unsigned int changed = 0;
+  for (int i = 0; i < destination->word_count; i++) {
+    unsigned int word = destination->words[i] & source->words[i];
+    changed |= word ^ destination->words[i];
+    destination->words[i] = word;
+  }
+  return 0 != changed;
+}
+
+bool bit_vector_subtract(struct bit_vector *destination, const struct bit_vector *source) {
+  assert(destination->size == source->size);
+
+  unsigned int changed = 0;
+  for (int i = 0; i < destination->word_count; i++) {
+    unsigned int word = destination->words[i] & ~source->words[i];
+    changed |= word ^ destination->words[i];
+    destination->words[i] = word;
+  }
+  return 0 != changed;
+}
+
+int bit_vector_next(const struct bit_vector *vector, int from) {
+  if (from < 0) from = 0;
+
+  for (int i = from / BITS_PER_WORD; i < vector->word_count; i++) {
+    unsigned int word = vector->words[i];
+    if (i == from / BITS_PER_WORD) {
+      word &= ~0u << (from % BITS_PER_WORD);
+    }
+    if (0 != word) {
+      int bit = i * BITS_PER_WORD + __builtin_ctz(word);
+      return bit < vector->size ? bit : -1;
+    }
+  }
+  return -1;
+}
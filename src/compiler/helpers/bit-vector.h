@@ -0,0 +1,32 @@
+#ifndef _BITVECTOR_H
+#define _BITVECTOR_H
+#include <stdbool.h>
+
+/* fixed size set of small integers, packed 32 to a word */
+struct bit_vector {
+  int size;
+  int word_count;
+  unsigned int *words;
+};
+
+struct bit_vector *bit_vector_create(int size);
+void bit_vector_free(struct bit_vector *vector);
+
+void bit_vector_set(struct bit_vector *vector, int bit);
+void bit_vector_clear(struct bit_vector *vector, int bit);
+bool bit_vector_test(const struct bit_vector *vector, int bit);
+
+void bit_vector_clear_all(struct bit_vector *vector);
+void bit_vector_set_all(struct bit_vector *vector);
+void bit_vector_copy(struct bit_vector *destination, const struct bit_vector *source);
+bool bit_vector_equals(const struct bit_vector *vector_1, const struct bit_vector *vector_2);
+
+/* these return true if destination changed */
+bool bit_vector_union(struct bit_vector *destination, const struct bit_vector *source);
+bool bit_vector_intersect(struct bit_vector *destination, const struct bit_vector *source);
+bool bit_vector_subtract(struct bit_vector *destination, const struct bit_vector *source);
+
+/* returns the first set bit at or after `from`, -1 if there is none */
+int bit_vector_next(const struct bit_vector *vector, int from);
+
+#endif /* _BITVECTOR_H */
@@ -11,37 +11,39 @@ struct hash_map *initialise_hash_map() {
   store = malloc(sizeof(struct hash_map));
   assert(NULL != store);
 
+  store->data = malloc(sizeof(struct hash_map_val) * HASH_MAP_INITIAL_CAPACITY);
+  assert(NULL != store->data);
   store->size = 0;
-  for (int i = 0; i < MAX_SIZE; i++) {
-    store->data[i].key = -1;
-    strcpy(store->data[i].value, "");
-  }
+  store->capacity = HASH_MAP_INITIAL_CAPACITY;
 
   return store;
 }
 
 void free_hash_map(struct hash_map *store) {
+  free(store->data);
   free(store);
   store = NULL;
 }
 
 void add_key_value(struct hash_map *store, const char *value, int key) {
-  if (store->size < MAX_SIZE) {
-    // check if key already exists
-    for (int i = 0; i < store->size; i++) {
-      if (store->data[i].key == key) {
-        strcpy(store->data[i].value, value);
-        return;
-      }
+  // check if key already exists
+  for (int i = 0; i < store->size; i++) {
+    if (store->data[i].key == key) {
+      strcpy(store->data[i].value, value);
+      return;
     }
-    // add new key/value pair
-    store->data[store->size].key = key;
-    strcpy(store->data[store->size].value, value);
-    store->size++;
-  } else {
-    printf("Error: Maximum size reached. Cannot add more key/value pairs.\n");
-    assert(0);
   }
+
+  if (store->size == store->capacity) {
+    store->capacity *= 2;
+    store->data = realloc(store->data, sizeof(struct hash_map_val) * store->capacity);
+    assert(NULL != store->data);
+  }
+
+  // add new key/value pair
+  store->data[store->size].key = key;
+  strcpy(store->data[store->size].value, value);
+  store->size++;
 }
 
 const char* get_value(const struct hash_map *store, int key) {
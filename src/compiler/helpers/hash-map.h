@@ -2,7 +2,8 @@
 #define _HASHMAP_H
 #include <stdbool.h>
 
-#define MAX_SIZE 100
+/* the pairs a map has room for at first, it doubles whenever it fills up */
+#define HASH_MAP_INITIAL_CAPACITY 100
 
 struct hash_map_val {
   int key;
@@ -10,8 +11,9 @@ struct hash_map_val {
 };
 
 struct hash_map {
-  struct hash_map_val data[MAX_SIZE];
+  struct hash_map_val *data;
   int size;
+  int capacity;
 };
 
 struct hash_map *initialise_hash_map();
@@ -10,12 +10,12 @@ make clean && make > /dev/null 2>&1
 STEP="mips"
 
 if [ $# -ne 2 ]; then
-   echo "Provide flag (s) with appropriate value (scanner, parser, symbol, ir, mips)";
+   echo "Provide flag (s) with appropriate value (scanner, parser, symbol, ir, mips, opt, run)";
 fi
 
 
 if [ "$1" != "-s" ]; then
-  echo "Provide correct flag (s) with appropriate value (scanner, parser, symbol, ir, mips)";
+  echo "Provide correct flag (s) with appropriate value (scanner, parser, symbol, ir, mips, opt, run)";
 fi
 
 STEP=$2
@@ -116,6 +116,48 @@ for file in "$input_dir"/*; do
       fi
     fi
 
+    # The first line of an optimizer test is a comment with the flags to compile it with,
+    # e.g. /* -s ir -O 2 -passes=mem2reg,constprop */
+    if [ "$STEP" == "opt" ]; then
+      flags=$(head -n 1 "$file" | sed -e 's#^/\*##' -e 's#\*/$##')
+      ./compiler $flags "$file" > "$temp_output"
+
+      expected_file=${file/"input"/"expected"}
+
+      if [ "$(cat $expected_file)" != "$(cat $temp_output)" ]; then
+        echo  "Output does not match for file: $file ❌"
+      else
+        echo "Output matches for file: $file ✅"
+      fi
+    fi
+
+    # A run test must print the expected output at every optimization level (set SPIM to use another simulator),
+    # and with the flag sets a first line comment lists, e.g. /* -O 2 -funroll-loops -unroll-factor 3; -O 2 -funroll-loops -unroll-factor 8 */
+    if [ "$STEP" == "run" ]; then
+      expected_file=${file/"input"/"expected"}
+
+      levels=("-O 1" "-O 2" "-O 2 -funroll-loops")
+      if head -n 1 "$file" | grep -q '^/\*'; then
+        IFS=';' read -ra extra_levels <<< "$(head -n 1 "$file" | sed -e 's#^/\*##' -e 's#\*/$##')"
+        levels+=("${extra_levels[@]}")
+      fi
+
+      for level in "${levels[@]}"; do
+        if ! ./compiler -s mips $level -o run_output.s "$file" > /dev/null 2>&1; then
+          echo "Compiler failed with $level for file: $file ❌"
+          continue
+        fi
+        ${SPIM:-spim} -quiet -file run_output.s < /dev/null > "$temp_output"
+
+        if [ "$(cat $expected_file)" != "$(cat $temp_output)" ]; then
+          echo  "Output does not match with $level for file: $file ❌"
+        else
+          echo "Output matches with $level for file: $file ✅"
+        fi
+      done
+      rm -f run_output.s
+    fi
+
     # Clean up the temporary output file
     rm "$temp_output"
 
@@ -0,0 +1,361 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "dataflow.h"
+#include "if-conversion.h"
+
+/* what a branch costs besides its instruction: the delay slot and, often enough, the instructions fetched after it */
+#define IF_CONVERSION_BRANCH_PENALTY 4
+
+/* one side of the branch: the arm block, if any, and the block the join is entered from */
+struct if_conversion_side {
+	struct cfg_block *arm;
+	struct cfg_block *predecessor;
+};
+
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+static bool *touched_blocks;                    /* block id -> changed by a conversion this run */
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool if_conversion_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+/* what an instruction costs once it runs on both paths, -1 if it mustn't */
+static int if_conversion_cost(enum ir_instruction_kind kind) {
+	switch (kind) {
+		case IR_COPY:
+			return 0;
+		case IR_UNARY_MINUS:
+			return 2;                               /* 0 - x */
+		case IR_CONST_INT:
+		case IR_ADDRESS_OF:
+		case IR_ADD_SIGNED_WORD:
+		case IR_ADD_UNSIGNED_WORD:
+		case IR_SUB_SIGNED_WORD:
+		case IR_SUB_UNSIGNED_WORD:
+		case IR_MULT_SIGNED_WORD:
+		case IR_MULT_UNSIGNED_WORD:
+		case IR_MULT_HIGH_SIGNED_WORD:
+		case IR_MULT_HIGH_UNSIGNED_WORD:
+		case IR_LEFT_SHIFT_WORD:
+		case IR_RIGHT_SHIFT_SIGNED_WORD:
+		case IR_RIGHT_SHIFT_UNSIGNED_WORD:
+		case IR_LT_SIGNED_WORD:
+		case IR_LT_UNSIGNED_WORD:
+		case IR_LE_SIGNED_WORD:
+		case IR_LE_UNSIGNED_WORD:
+		case IR_GE_SIGNED_WORD:
+		case IR_GE_UNSIGNED_WORD:
+		case IR_GT_SIGNED_WORD:
+		case IR_GT_UNSIGNED_WORD:
+		case IR_EQ_WORD:
+		case IR_NE_WORD:
+		case IR_BITWISE_AND_WORD:
+		case IR_BITWISE_XOR_WORD:
+		case IR_BITWISE_OR_WORD:
+		case IR_UNARY_LOGICAL_NEGATION:
+		case IR_UNARY_BITWISE_NEGATION:
+		case IR_CAST_WORD_TO_HALF_WORD:
+		case IR_CAST_WORD_TO_BYTE:
+		case IR_CAST_HALF_WORD_TO_BYTE:
+		case IR_CAST_UNSIGNED_HALF_WORD_TO_WORD:
+		case IR_CAST_SIGNED_HALF_WORD_TO_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_SIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_WORD:
+		case IR_CAST_SIGNED_BYTE_TO_WORD:
+			return 1;
+		default:
+			return -1;
+	}
+}
+
+/* a condition that is already 0 or 1 needs no != 0 for its mask */
+static bool if_conversion_is_boolean(int temporary) {
+	if (temporary > max_temporary || NULL == temporary_definitions[temporary]) return false;
+
+	switch (temporary_definitions[temporary]->data->kind) {
+		case IR_LT_SIGNED_WORD:
+		case IR_LT_UNSIGNED_WORD:
+		case IR_LE_SIGNED_WORD:
+		case IR_LE_UNSIGNED_WORD:
+		case IR_GE_SIGNED_WORD:
+		case IR_GE_UNSIGNED_WORD:
+		case IR_GT_SIGNED_WORD:
+		case IR_GT_UNSIGNED_WORD:
+		case IR_EQ_WORD:
+		case IR_NE_WORD:
+		case IR_UNARY_LOGICAL_NEGATION:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* the cost of running an arm's instructions unconditionally, -1 if it can't be */
+static int if_conversion_arm_cost(struct cfg_block *arm) {
+	struct ir_list *iter;
+	int cost = 0;
+
+	if (NULL == arm) return 0;
+
+	for (iter = arm->first; ; iter = iter->next) {
+		enum ir_instruction_kind kind = iter->data->kind;
+
+		if (IR_LABEL == kind && iter == arm->first) {
+			/* nothing */
+		} else if (IR_GOTO == kind && iter == arm->last) {
+			/* nothing */
+		} else {
+			int instruction_cost = if_conversion_cost(kind);
+			if (instruction_cost < 0) return -1;
+			cost += instruction_cost;
+		}
+		if (iter == arm->last) break;
+	}
+	return cost;
+}
+
+/* a block only the head enters and that only leaves to one other block */
+static bool if_conversion_is_arm(struct cfg_block *block, struct cfg_block *head) {
+	return (
+		!touched_blocks[block->id] &&
+		1 == block->predecessor_count && head == block->predecessors[0] &&
+		1 == block->successor_count && block != block->successors[0] && head != block->successors[0]
+	);
+}
+
+static int if_conversion_compute(struct ir_list *before, enum ir_instruction_kind kind, int left, int right) {
+	struct ir_instruction *instruction = ir_instruction(kind);
+	ir_operand_temporary(instruction, 0);
+	instruction->operands[1].kind = OPERAND_TEMPORARY;
+	instruction->operands[1].data.temporary = left;
+	instruction->operands[2].kind = OPERAND_TEMPORARY;
+	instruction->operands[2].data.temporary = right;
+	ir_insert_before(before, instruction);
+	return instruction->operands[0].data.temporary;
+}
+
+static int if_conversion_constant_before(struct ir_list *before, uint32_t value) {
+	struct ir_instruction *instruction = ir_instruction(IR_CONST_INT);
+	ir_operand_temporary(instruction, 0);
+	ir_operand_number(instruction, 1, value);
+	ir_insert_before(before, instruction);
+	return instruction->operands[0].data.temporary;
+}
+
+/**************
+ * CONVERSION *
+ **************/
+
+/* moves an arm's instruction in front of the branch, as its non-trapping version */
+static void if_conversion_speculate(struct ir_list *branch, struct ir_instruction *instruction) {
+	switch (instruction->kind) {
+		case IR_ADD_SIGNED_WORD:
+			instruction->kind = IR_ADD_UNSIGNED_WORD;
+			break;
+		case IR_SUB_SIGNED_WORD:
+			instruction->kind = IR_SUB_UNSIGNED_WORD;
+			break;
+		case IR_MULT_UNSIGNED_WORD:
+			instruction->kind = IR_MULT_SIGNED_WORD;    /* the low word of the product is the same */
+			break;
+		case IR_UNARY_MINUS:
+			instruction->kind = IR_SUB_UNSIGNED_WORD;
+			ir_operand_copy(instruction, 2, &instruction->operands[1]);
+			instruction->operands[1].kind = OPERAND_TEMPORARY;
+			instruction->operands[1].data.temporary = if_conversion_constant_before(branch, 0);
+			break;
+		default:
+			break;
+	}
+	ir_insert_before(branch, instruction);
+}
+
+/* runs the arm in front of the branch and removes what is left of it */
+static void if_conversion_flatten_arm(struct ir_list *branch, struct cfg_block *arm) {
+	struct ir_list *iter, *next;
+
+	if (NULL == arm) return;
+
+	for (iter = arm->first; ; iter = next) {
+		bool is_last = iter == arm->last;
+		enum ir_instruction_kind kind = iter->data->kind;
+
+		next = iter->next;
+		ir_unlink(iter);
+		if (IR_LABEL != kind && IR_GOTO != kind) if_conversion_speculate(branch, iter->data);
+		if (is_last) break;
+	}
+}
+
+/* the value of a phi on one side, the other side's if it is undefined there */
+static struct ir_operand *if_conversion_argument(
+	struct ir_instruction *phi, struct cfg_block *join, struct if_conversion_side *side, struct if_conversion_side *other
+) {
+	struct ir_operand *argument = &phi->phi_arguments[cfg_predecessor_index(join, side->predecessor)];
+	if (if_conversion_is_temporary(argument)) return argument;
+	return &phi->phi_arguments[cfg_predecessor_index(join, other->predecessor)];
+}
+
+static void if_conversion_convert(
+	struct cfg_block *head, struct cfg_block *join, struct if_conversion_side *then, struct if_conversion_side *otherwise
+) {
+	struct ir_list *branch = head->last;
+	struct ir_list *iter, *next;
+	int mask = -1;
+
+	if_conversion_flatten_arm(branch, then->arm);
+	if_conversion_flatten_arm(branch, otherwise->arm);
+
+	for (iter = join->first->next; NULL != iter && IR_PHI == iter->data->kind; iter = next) {
+		struct ir_instruction *phi = iter->data;
+		struct ir_operand *then_value = if_conversion_argument(phi, join, then, otherwise);
+		struct ir_operand *else_value = if_conversion_argument(phi, join, otherwise, then);
+		struct ir_instruction *select;
+
+		next = iter->next;
+		if (!if_conversion_is_temporary(then_value)) {
+			/* undefined either way */
+			select = ir_instruction(IR_CONST_INT);
+			ir_operand_number(select, 1, 0);
+		} else if (then_value->data.temporary == else_value->data.temporary) {
+			select = ir_instruction(IR_COPY);
+			ir_operand_copy(select, 1, then_value);
+		} else {
+			if (mask < 0) {
+				int condition = branch->data->operands[0].data.temporary;
+				int zero = if_conversion_constant_before(branch, 0);
+				if (!if_conversion_is_boolean(condition)) condition = if_conversion_compute(branch, IR_NE_WORD, condition, zero);
+				mask = if_conversion_compute(branch, IR_SUB_UNSIGNED_WORD, zero, condition);
+			}
+			int difference = if_conversion_compute(
+				branch, IR_BITWISE_XOR_WORD, then_value->data.temporary, else_value->data.temporary
+			);
+			int masked = if_conversion_compute(branch, IR_BITWISE_AND_WORD, difference, mask);
+
+			select = ir_instruction(IR_BITWISE_XOR_WORD);
+			ir_operand_copy(select, 1, else_value);
+			select->operands[2].kind = OPERAND_TEMPORARY;
+			select->operands[2].data.temporary = masked;
+		}
+		ir_operand_copy(select, 0, &phi->operands[0]);
+		ir_insert_before(branch, select);
+		ir_unlink(iter);
+	}
+
+	/* the condition was already used for the mask, the branch goes straight to the join */
+	branch->data->kind = IR_GOTO;
+	ir_operand_copy(branch->data, 0, &join->first->data->operands[0]);
+
+	touched_blocks[head->id] = true;
+	touched_blocks[join->id] = true;
+	if (NULL != then->arm) touched_blocks[then->arm->id] = true;
+	if (NULL != otherwise->arm) touched_blocks[otherwise->arm->id] = true;
+}
+
+/*
+ * Finds the diamond or triangle below a conditional branch: both successors
+ * are arms going to the same join, or one is an arm going to the other.
+ */
+static bool if_conversion_try(struct cfg_block *head) {
+	struct ir_instruction *branch = head->last->data;
+	struct if_conversion_side sides[2];
+	struct cfg_block *join;
+	struct ir_list *iter;
+
+	if (
+		touched_blocks[head->id] || 2 != head->successor_count ||
+		(IR_GOTO_IF_FALSE != branch->kind && IR_GOTO_IF_TRUE != branch->kind) ||
+		!if_conversion_is_temporary(&branch->operands[0])
+	) return false;
+
+	struct cfg_block *first = head->successors[0], *second = head->successors[1];
+	bool is_first_arm = if_conversion_is_arm(first, head), is_second_arm = if_conversion_is_arm(second, head);
+
+	if (is_first_arm && is_second_arm && first->successors[0] == second->successors[0]) {
+		join = first->successors[0];
+		sides[0] = (struct if_conversion_side){ first, first };
+		sides[1] = (struct if_conversion_side){ second, second };
+	} else if (is_first_arm && first->successors[0] == second) {
+		join = second;
+		sides[0] = (struct if_conversion_side){ first, first };
+		sides[1] = (struct if_conversion_side){ NULL, head };
+	} else if (is_second_arm && second->successors[0] == first) {
+		join = first;
+		sides[0] = (struct if_conversion_side){ NULL, head };
+		sides[1] = (struct if_conversion_side){ second, second };
+	} else {
+		return false;
+	}
+	if (
+		touched_blocks[join->id] || join == head || 2 != join->predecessor_count ||
+		IR_LABEL != join->first->data->kind
+	) return false;
+
+	/*
+	 * Both arms, the mask and 3 instructions per phi against the branch, the
+	 * goto at the end of a diamond's first arm and the longer arm.
+	 */
+	int select_cost = if_conversion_is_boolean(branch->operands[0].data.temporary) ? 2 : 3;
+	int branch_cost = 1 + IF_CONVERSION_BRANCH_PENALTY + (NULL != sides[0].arm && NULL != sides[1].arm);
+	int longest = 0;
+	for (int s = 0; s < 2; s++) {
+		int arm_cost = if_conversion_arm_cost(sides[s].arm);
+		if (arm_cost < 0) return false;
+		select_cost += arm_cost;
+		if (arm_cost > longest) longest = arm_cost;
+	}
+	for (iter = join->first->next; NULL != iter && IR_PHI == iter->data->kind; iter = iter->next) {
+		select_cost += 3;
+	}
+	if (select_cost > branch_cost + longest) return false;
+
+	/* a gotoIfFalse falls through when the condition holds, a gotoIfTrue when it doesn't */
+	int then = cfg_falls_through(head, sides[0].predecessor == head ? join : sides[0].arm) ? 0 : 1;
+	if (IR_GOTO_IF_TRUE == branch->kind) then = 1 - then;
+
+	if_conversion_convert(head, join, &sides[then], &sides[1 - then]);
+	return true;
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+void if_conversion(struct cfg *cfg) {
+	bool is_changed = false;
+
+	max_temporary = dataflow_max_temporary(cfg);
+	temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+	touched_blocks = calloc(cfg->block_count, sizeof(bool));
+	assert(NULL != touched_blocks);
+
+	/* in postorder, so an inner diamond goes before the one around it, which the next round can then convert */
+	for (int b = cfg->reachable_count - 1; b >= 0; b--) {
+		if (if_conversion_try(cfg->reverse_postorder[b])) is_changed = true;
+	}
+
+	if (is_changed) ssa_rebuild_cfg(cfg);
+
+	free(temporary_definitions);
+	free(touched_blocks);
+}
+
+void if_conversion_program(struct cfg *cfgs) {
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		if_conversion(cfg);
+	}
+}
@@ -0,0 +1,29 @@
+#ifndef _IF_CONVERSION_H
+#define _IF_CONVERSION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * If-conversion of small diamonds (if/else, ternaries) and triangles (an if
+ * without an else) whose arms only compute a few values without side
+ * effects and merge them at a phi. The arms run unconditionally in front of
+ * the branch, and each phi becomes an arithmetic select on the condition,
+ *
+ *   mask = 0 - (condition != 0)
+ *   x = else ^ ((then ^ else) & mask)
+ *
+ * which base MIPS I runs without a branch or its delay slot. Instructions
+ * that could trap once they run on the other path (add, sub, neg, mulou)
+ * are moved as addu, subu and mul; loads, stores, calls, division and
+ * remainder keep the branch.
+ *
+ * Works on a function in SSA form.
+ */
+void if_conversion(struct cfg *cfg);
+void if_conversion_program(struct cfg *cfgs);
+
+#endif
@@ -0,0 +1,810 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "induction-variables.h"
+
+extern int next_temporary;
+
+/* every pointer holds a register through the whole loop, more would only get spilled */
+#define INDUCTION_VARIABLE_MAX_POINTERS 4
+
+/* a variable whose only store in the loop is i = i + step */
+struct induction_variable {
+	int variable;
+	int step;
+	struct ir_list *store;
+	int increment;                          /* the temporary holding i + step */
+	int increment_load;                     /* the load of i it's computed from */
+	struct ir_instruction *load;            /* cloned to read i in the preheader */
+};
+
+/* base + i * size, kept up to date in a temporary of its own */
+struct induction_variable_pointer {
+	int induction;
+	struct ir_instruction *base_definition; /* an addressOf or load of the base, redone in the preheader */
+	int base_variable;                      /* the variable it addresses or loads */
+	int base;                               /* or a temporary defined before the loop */
+	int size;
+	int temporary;
+};
+
+/* a subscript reading a pointer, or a comparison of i moving to the end pointer */
+struct induction_variable_site {
+	struct ir_list *node;
+	int pointer;
+	int operand;                            /* the operand reading i, or the end value for comparisons */
+};
+
+static struct cfg *cfg;
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+static int *definition_counts;
+
+static int max_variable;
+static bool *escapes;
+
+/* temporary -> block of the loop defining it and position there, -1 outside the loop */
+static int *temporary_blocks;
+static int *temporary_positions;
+
+/* variable -> stores in the loop, and where the last one is */
+static int *store_counts;
+static struct ir_list **store_nodes;
+static int *store_blocks;
+static int *store_positions;
+
+static struct induction_variable *inductions;
+static int induction_count;
+static int *variable_inductions;                /* variable -> induction, -1 if it isn't one */
+
+static struct induction_variable_pointer pointers[INDUCTION_VARIABLE_MAX_POINTERS];
+static int pointer_count;
+
+static struct induction_variable_site *sites;
+static int site_count, site_capacity;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool induction_variable_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static bool induction_variable_is_load(struct ir_instruction *instruction) {
+	return (
+		IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind
+	);
+}
+
+static bool induction_variable_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+/* the only instruction writing the temporary */
+static struct ir_instruction *induction_variable_definition(struct ir_operand *operand) {
+	if (!induction_variable_is_temporary(operand)) return NULL;
+
+	int temporary = operand->data.temporary;
+	if (1 != definition_counts[temporary]) return NULL;
+	return temporary_definitions[temporary]->data;
+}
+
+/* the addressOf a load or store goes through, NULL if it isn't known */
+static struct ir_instruction *induction_variable_address(struct ir_instruction *instruction) {
+	if (NULL != instruction->offset_variable) return instruction->offset_variable;
+	return induction_variable_definition(&instruction->operands[induction_variable_is_store(instruction) ? 0 : 1]);
+}
+
+/* word locals whose address is never taken, only their own stores write them; -1 for the rest */
+static int induction_variable_variable(struct ir_instruction *instruction) {
+	struct ir_instruction *address = induction_variable_address(instruction);
+
+	if (
+		NULL == address ||
+		IR_ADDRESS_OF != address->kind ||
+		address->operands[2].data.is_string ||
+		4 != (int)address->operands[4].data.number ||
+		0 != address->operands[6].data.number
+	) {
+		return -1;
+	}
+
+	int variable = address->operands[3].data.variable_id;
+	return escapes[variable] ? -1 : variable;
+}
+
+/* the word load of a tracked variable defining the operand, -1 if it isn't one */
+static int induction_variable_loaded_variable(struct ir_operand *operand) {
+	struct ir_instruction *definition = induction_variable_definition(operand);
+	if (NULL == definition || IR_LOAD_WORD != definition->kind) return -1;
+	return induction_variable_variable(definition);
+}
+
+/* constants optimization 1 turned into immediates are only left in the constants map */
+static bool induction_variable_constant(struct ir_operand *operand, int *value) {
+	if (!induction_variable_is_temporary(operand)) return false;
+
+	int temporary = operand->data.temporary;
+	struct ir_instruction *definition = induction_variable_definition(operand);
+	if (NULL != definition && IR_CONST_INT == definition->kind) {
+		*value = (int)definition->operands[1].data.number;
+		return true;
+	}
+	if (0 == definition_counts[temporary] && NULL != ir_get_const_map_entry(temporary)) {
+		*value = (int)strtol(ir_get_const_map_entry(temporary), NULL, 10);
+		return true;
+	}
+	return false;
+}
+
+/* a load of the variable `variable` inside the block, with no store to it before `position` */
+static bool induction_variable_reads_current(struct ir_operand *operand, int variable, int block, int position) {
+	if (induction_variable_loaded_variable(operand) != variable) return false;
+
+	int temporary = operand->data.temporary;
+	if (temporary_blocks[temporary] != block) return false;
+	if (store_counts[variable] > 0 && store_blocks[variable] == block) {
+		if (temporary_positions[temporary] < store_positions[variable] && store_positions[variable] < position) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void induction_variable_set_temporary(struct ir_operand *operand, int temporary) {
+	operand->kind = OPERAND_TEMPORARY;
+	operand->data.temporary = temporary;
+}
+
+static struct ir_instruction *induction_variable_clone(struct ir_instruction *original) {
+	struct ir_instruction *instruction = ir_instruction(original->kind);
+	memcpy(instruction->operands, original->operands, sizeof(instruction->operands));
+	instruction->offset_variable = original->offset_variable;
+	ir_operand_temporary(instruction, 0);
+	return instruction;
+}
+
+/* loads the variable again right before the anchor */
+static int induction_variable_reload(struct ir_list *anchor, struct ir_instruction *load) {
+	struct ir_instruction *instruction = induction_variable_clone(load);
+
+	if (NULL == load->offset_variable) {
+		struct ir_instruction *address = induction_variable_clone(induction_variable_address(load));
+		ir_insert_before(anchor, address);
+		ir_operand_copy(instruction, 1, &address->operands[0]);
+	}
+	ir_insert_before(anchor, instruction);
+	return instruction->operands[0].data.temporary;
+}
+
+static int induction_variable_constant_before(struct ir_list *anchor, int value) {
+	struct ir_instruction *instruction = ir_instruction(IR_CONST_INT);
+	ir_operand_temporary(instruction, 0);
+	ir_operand_number(instruction, 1, value);
+	ir_insert_before(anchor, instruction);
+	return instruction->operands[0].data.temporary;
+}
+
+/* computes kind(operand_1, operand_2) into `result`, a new temporary if it's -1 */
+static int induction_variable_compute(
+	struct ir_list *anchor, enum ir_instruction_kind kind, int result, int operand_1, int operand_2
+) {
+	struct ir_instruction *instruction = ir_instruction(kind);
+	if (result < 0) {
+		ir_operand_temporary(instruction, 0);
+	} else {
+		induction_variable_set_temporary(&instruction->operands[0], result);
+	}
+	induction_variable_set_temporary(&instruction->operands[1], operand_1);
+	induction_variable_set_temporary(&instruction->operands[2], operand_2);
+	ir_insert_before(anchor, instruction);
+	return instruction->operands[0].data.temporary;
+}
+
+static void induction_variable_add_site(struct ir_list *node, int pointer, int operand) {
+	if (site_count == site_capacity) {
+		site_capacity = 0 == site_capacity ? 16 : site_capacity * 2;
+		sites = realloc(sites, sizeof(struct induction_variable_site) * site_capacity);
+		assert(NULL != sites);
+	}
+	sites[site_count].node = node;
+	sites[site_count].pointer = pointer;
+	sites[site_count].operand = operand;
+	site_count++;
+}
+
+/************
+ * ANALYSIS *
+ ************/
+
+/* numbers the definitions and stores of the loop by block and position */
+static void induction_variable_scan(struct cfg_loop *loop) {
+	for (int t = 0; t <= max_temporary; t++) temporary_blocks[t] = -1;
+	memset(store_counts, 0, sizeof(int) * (max_variable + 1));
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!loop->body[block->id]) continue;
+
+		int position = 0;
+		for (struct ir_list *iter = block->first; ; iter = iter->next, position++) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *definition = ir_definition_operand(instruction);
+
+			if (NULL != definition && induction_variable_is_temporary(definition)) {
+				temporary_blocks[definition->data.temporary] = block->id;
+				temporary_positions[definition->data.temporary] = position;
+			}
+			if (induction_variable_is_store(instruction)) {
+				int variable = induction_variable_variable(instruction);
+				if (variable >= 0) {
+					store_counts[variable]++;
+					store_nodes[variable] = iter;
+					store_blocks[variable] = block->id;
+					store_positions[variable] = position;
+				}
+			}
+			if (iter == block->last) break;
+		}
+	}
+}
+
+/* variables stored to once in the loop, with their own value plus a constant */
+static void induction_variable_find_inductions(void) {
+	induction_count = 0;
+
+	for (int v = 0; v <= max_variable; v++) {
+		variable_inductions[v] = -1;
+		if (1 != store_counts[v]) continue;
+
+		struct ir_list *store = store_nodes[v];
+		struct ir_operand *value = &store->data->operands[1];
+		struct ir_instruction *increment = induction_variable_definition(value);
+		if (NULL == increment || temporary_blocks[value->data.temporary] != store_blocks[v]) continue;
+
+		bool is_add = IR_ADD_SIGNED_WORD == increment->kind || IR_ADD_UNSIGNED_WORD == increment->kind;
+		bool is_sub = IR_SUB_SIGNED_WORD == increment->kind || IR_SUB_UNSIGNED_WORD == increment->kind;
+		if (!is_add && !is_sub) continue;
+
+		int step, load = -1;
+		for (int i = 1; i <= (is_add ? 2 : 1); i++) {
+			struct ir_operand *other = &increment->operands[3 - i];
+			if (
+				induction_variable_reads_current(&increment->operands[i], v, store_blocks[v], store_positions[v]) &&
+				induction_variable_constant(other, &step)
+			) {
+				load = increment->operands[i].data.temporary;
+				break;
+			}
+		}
+		if (load < 0 || 0 == step) continue;
+
+		variable_inductions[v] = induction_count;
+		inductions[induction_count].variable = v;
+		inductions[induction_count].step = is_sub ? -step : step;
+		inductions[induction_count].store = store;
+		inductions[induction_count].increment = value->data.temporary;
+		inductions[induction_count].increment_load = load;
+		inductions[induction_count].load = temporary_definitions[load]->data;
+		induction_count++;
+	}
+}
+
+/* a base defined in the loop is redone in the preheader, keyed by what it addresses or loads */
+static int induction_variable_find_pointer(
+	int induction, struct ir_instruction *base_definition, int base_variable, int base, int size
+) {
+	for (int p = 0; p < pointer_count; p++) {
+		struct induction_variable_pointer *pointer = &pointers[p];
+		if (pointer->induction != induction || pointer->size != size) continue;
+		if (NULL != base_definition) {
+			if (NULL != pointer->base_definition && base_definition->kind == pointer->base_definition->kind &&
+				base_variable == pointer->base_variable) {
+				return p;
+			}
+		} else if (NULL == pointer->base_definition && base == pointer->base) {
+			return p;
+		}
+	}
+
+	if (INDUCTION_VARIABLE_MAX_POINTERS == pointer_count) return -1;
+	pointers[pointer_count].induction = induction;
+	pointers[pointer_count].base_definition = base_definition;
+	pointers[pointer_count].base_variable = base_variable;
+	pointers[pointer_count].base = base;
+	pointers[pointer_count].size = size;
+	return pointer_count++;
+}
+
+/* add(base, mult(size, i)) with the operands of either in any order, or a shift for the multiply */
+static void induction_variable_find_subscript(struct ir_list *node, int block, int position) {
+	struct ir_instruction *instruction = node->data;
+	if (IR_ADD_SIGNED_WORD != instruction->kind && IR_ADD_UNSIGNED_WORD != instruction->kind) return;
+
+	for (int i = 1; i <= 2; i++) {
+		struct ir_operand *base = &instruction->operands[3 - i];
+		struct ir_instruction *scale = induction_variable_definition(&instruction->operands[i]);
+		if (NULL == scale || temporary_blocks[instruction->operands[i].data.temporary] != block) continue;
+
+		struct ir_operand *index = NULL;
+		int size = 0;
+		if (IR_MULT_SIGNED_WORD == scale->kind || IR_MULT_UNSIGNED_WORD == scale->kind) {
+			for (int j = 1; j <= 2; j++) {
+				if (induction_variable_constant(&scale->operands[3 - j], &size)) {
+					index = &scale->operands[j];
+					break;
+				}
+			}
+		} else if (IR_LEFT_SHIFT_WORD == scale->kind && induction_variable_constant(&scale->operands[2], &size)) {
+			index = &scale->operands[1];
+			size = size >= 0 && size < 16 ? 1 << size : 0;
+		}
+		if (NULL == index || size <= 0) continue;
+
+		int variable = induction_variable_loaded_variable(index);
+		if (variable < 0 || variable_inductions[variable] < 0) continue;
+		if (!induction_variable_reads_current(index, variable, block, position)) continue;
+
+		struct ir_instruction *base_definition = induction_variable_definition(base);
+		if (NULL == base_definition) continue;
+
+		int pointer, base_variable = induction_variable_loaded_variable(base);
+		int induction = variable_inductions[variable];
+		if (IR_ADDRESS_OF == base_definition->kind && !base_definition->operands[2].data.is_string) {
+			pointer = induction_variable_find_pointer(
+				induction, base_definition, base_definition->operands[3].data.variable_id, -1, size
+			);
+		} else if (temporary_blocks[base->data.temporary] < 0) {
+			pointer = induction_variable_find_pointer(induction, NULL, -1, base->data.temporary, size);
+		} else if (base_variable >= 0 && 0 == store_counts[base_variable]) {
+			pointer = induction_variable_find_pointer(induction, base_definition, base_variable, -1, size);
+		} else {
+			continue;
+		}
+		if (pointer >= 0) induction_variable_add_site(node, pointer, 0);
+		return;
+	}
+}
+
+static bool induction_variable_is_comparison(enum ir_instruction_kind kind) {
+	switch (kind) {
+		case IR_LT_SIGNED_WORD:
+		case IR_LE_SIGNED_WORD:
+		case IR_GT_SIGNED_WORD:
+		case IR_GE_SIGNED_WORD:
+		case IR_EQ_WORD:
+		case IR_NE_WORD:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* pointers compare as addresses */
+static enum ir_instruction_kind induction_variable_pointer_comparison(enum ir_instruction_kind kind) {
+	switch (kind) {
+		case IR_LT_SIGNED_WORD: return IR_LT_UNSIGNED_WORD;
+		case IR_LE_SIGNED_WORD: return IR_LE_UNSIGNED_WORD;
+		case IR_GT_SIGNED_WORD: return IR_GT_UNSIGNED_WORD;
+		case IR_GE_SIGNED_WORD: return IR_GE_UNSIGNED_WORD;
+		default: return kind;
+	}
+}
+
+/* the other side of a comparison can be computed in the preheader */
+static bool induction_variable_is_invariant(struct ir_operand *operand) {
+	int value;
+	if (induction_variable_constant(operand, &value)) return true;
+	if (NULL == induction_variable_definition(operand)) return false;
+	if (temporary_blocks[operand->data.temporary] < 0) return true;
+
+	int variable = induction_variable_loaded_variable(operand);
+	return variable >= 0 && 0 == store_counts[variable];
+}
+
+/* the variable may be read on some path leaving the loop before it's written */
+static bool induction_variable_is_live_after(struct cfg_loop *loop, int variable) {
+	bool *visited = calloc(cfg->block_count, sizeof(bool));
+	struct cfg_block **stack = malloc(sizeof(struct cfg_block *) * cfg->block_count);
+	assert(NULL != visited && NULL != stack);
+	int top = 0;
+	bool live = false;
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!loop->body[block->id]) continue;
+		for (int s = 0; s < block->successor_count; s++) {
+			struct cfg_block *successor = block->successors[s];
+			if (loop->body[successor->id] || visited[successor->id]) continue;
+			visited[successor->id] = true;
+			stack[top++] = successor;
+		}
+	}
+
+	while (top > 0 && !live) {
+		struct cfg_block *block = stack[--top];
+		bool written = false;
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			if (induction_variable_is_load(instruction) && induction_variable_variable(instruction) == variable) {
+				live = true;
+				break;
+			}
+			if (induction_variable_is_store(instruction) && induction_variable_variable(instruction) == variable) {
+				written = true;
+				break;
+			}
+			if (iter == block->last) break;
+		}
+		if (live || written) continue;
+
+		for (int s = 0; s < block->successor_count; s++) {
+			struct cfg_block *successor = block->successors[s];
+			if (visited[successor->id]) continue;
+			visited[successor->id] = true;
+			stack[top++] = successor;
+		}
+	}
+
+	free(visited);
+	free(stack);
+	return live;
+}
+
+/*
+ * After the subscripts read pointers, i can go if all that's left reading it
+ * (besides its own increment) are comparisons against invariant values.
+ * Those become sites of the induction's first pointer.
+ */
+static bool induction_variable_find_comparisons(struct cfg_loop *loop, int induction, int *use_counts, bool *dead) {
+	struct induction_variable *variable = &inductions[induction];
+	int pointer = -1;
+	for (int p = 0; p < pointer_count && pointer < 0; p++) {
+		if (pointers[p].induction == induction) pointer = p;
+	}
+	if (pointer < 0) return false;
+	if (1 != use_counts[variable->increment] || 1 != use_counts[variable->increment_load]) return false;
+
+	int first_site = site_count;
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!loop->body[block->id]) continue;
+
+		int position = 0;
+		for (struct ir_list *iter = block->first; ; iter = iter->next, position++) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *definition = ir_definition_operand(instruction);
+
+			/* a live read of i that isn't the increment */
+			if (
+				NULL != definition &&
+				induction_variable_is_temporary(definition) &&
+				!dead[definition->data.temporary] &&
+				definition->data.temporary != variable->increment_load &&
+				induction_variable_loaded_variable(definition) == variable->variable
+			) {
+				int temporary = definition->data.temporary;
+				struct ir_list *use_iter = iter;
+
+				/* the front end reads a load further on in the same block */
+				for (int position_after = position; use_counts[temporary] > 0; ) {
+					if (use_iter == block->last) {
+						site_count = first_site;
+						return false;
+					}
+					use_iter = use_iter->next;
+					position_after++;
+
+					struct ir_instruction *use = use_iter->data;
+					struct ir_operand *use_definition = ir_definition_operand(use);
+					if (
+						NULL != use_definition &&
+						induction_variable_is_temporary(use_definition) &&
+						dead[use_definition->data.temporary]
+					) {
+						continue;
+					}
+
+					int operand = 0;
+					if (induction_variable_is_comparison(use->kind)) {
+						if (induction_variable_is_temporary(&use->operands[1]) && temporary == use->operands[1].data.temporary) operand = 1;
+						if (induction_variable_is_temporary(&use->operands[2]) && temporary == use->operands[2].data.temporary) operand = 0 == operand ? 2 : -1;
+					}
+					if (
+						operand > 0 &&
+						induction_variable_reads_current(&use->operands[operand], variable->variable, block->id, position_after) &&
+						induction_variable_is_invariant(&use->operands[3 - operand])
+					) {
+						use_counts[temporary]--;
+						induction_variable_add_site(use_iter, pointer, operand);
+						continue;
+					}
+
+					for (int i = 0; i < ir_use_count(use); i++) {
+						struct ir_operand *other_use = ir_use_operand(use, i);
+						if (induction_variable_is_temporary(other_use) && temporary == other_use->data.temporary) {
+							site_count = first_site;
+							return false;
+						}
+					}
+				}
+			}
+			if (iter == block->last) break;
+		}
+	}
+
+	if (induction_variable_is_live_after(loop, variable->variable)) {
+		site_count = first_site;
+		return false;
+	}
+	return true;
+}
+
+/*
+ * What reads i once the subscripts read pointers: use counts without the
+ * subscripts, and the loop's pure definitions nothing reads any more.
+ */
+static void induction_variable_count_uses(struct cfg_loop *loop, int *use_counts, bool *dead) {
+	struct ir_list *iter;
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		for (int i = 0; i < ir_use_count(iter->data); i++) {
+			struct ir_operand *use = ir_use_operand(iter->data, i);
+			if (induction_variable_is_temporary(use)) use_counts[use->data.temporary]++;
+		}
+		if (iter == cfg->proc_end) break;
+	}
+	for (int s = 0; s < site_count; s++) {
+		struct ir_instruction *instruction = sites[s].node->data;
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (induction_variable_is_temporary(use)) use_counts[use->data.temporary]--;
+		}
+	}
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int b = 0; b < cfg->block_count; b++) {
+			struct cfg_block *block = cfg->blocks[b];
+			if (!loop->body[block->id]) continue;
+
+			for (iter = block->first; ; iter = iter->next) {
+				struct ir_instruction *instruction = iter->data;
+				struct ir_operand *definition = ir_definition_operand(instruction);
+				bool is_pure =
+					induction_variable_is_load(instruction) ||
+					IR_CONST_INT == instruction->kind ||
+					IR_ADDRESS_OF == instruction->kind ||
+					IR_COPY == instruction->kind ||
+					dataflow_is_expression(instruction);
+
+				if (
+					is_pure &&
+					NULL != definition &&
+					NULL != induction_variable_definition(definition) &&
+					!dead[definition->data.temporary] &&
+					0 == use_counts[definition->data.temporary]
+				) {
+					bool is_site = false;
+					for (int s = 0; s < site_count && !is_site; s++) is_site = sites[s].node == iter;
+					if (!is_site) {
+						dead[definition->data.temporary] = true;
+						changed = true;
+						for (int i = 0; i < ir_use_count(instruction); i++) {
+							struct ir_operand *use = ir_use_operand(instruction, i);
+							if (induction_variable_is_temporary(use)) use_counts[use->data.temporary]--;
+						}
+					}
+				}
+				if (iter == block->last) break;
+			}
+		}
+	}
+}
+
+/***********
+ * REWRITE *
+ ***********/
+
+/* computes the value of the invariant operand of a comparison right before the anchor */
+static int induction_variable_invariant_before(struct ir_list *anchor, struct ir_operand *operand) {
+	int value;
+	if (induction_variable_constant(operand, &value)) return induction_variable_constant_before(anchor, value);
+	if (temporary_blocks[operand->data.temporary] < 0) return operand->data.temporary;
+	return induction_variable_reload(anchor, induction_variable_definition(operand));
+}
+
+static void induction_variable_rewrite(struct ir_list *anchor, bool *removed) {
+	for (int p = 0; p < pointer_count; p++) {
+		struct induction_variable_pointer *pointer = &pointers[p];
+		struct induction_variable *induction = &inductions[pointer->induction];
+
+		/* base + i * size in the preheader */
+		if (NULL != pointer->base_definition && IR_ADDRESS_OF == pointer->base_definition->kind) {
+			struct ir_instruction *address = induction_variable_clone(pointer->base_definition);
+			ir_insert_before(anchor, address);
+			pointer->base = address->operands[0].data.temporary;
+		} else if (NULL != pointer->base_definition) {
+			pointer->base = induction_variable_reload(anchor, pointer->base_definition);
+		}
+		int index = induction_variable_reload(anchor, induction->load);
+		int size = induction_variable_constant_before(anchor, pointer->size);
+		int scaled = induction_variable_compute(anchor, IR_MULT_SIGNED_WORD, -1, size, index);
+		pointer->temporary = induction_variable_compute(anchor, IR_ADD_SIGNED_WORD, -1, pointer->base, scaled);
+
+		/* advanced along with i */
+		struct ir_list *after_store = induction->store->next;
+		int step = induction_variable_constant_before(after_store, induction->step * pointer->size);
+		induction_variable_compute(after_store, IR_ADD_SIGNED_WORD, pointer->temporary, pointer->temporary, step);
+	}
+
+	for (int s = 0; s < site_count; s++) {
+		struct induction_variable_site *site = &sites[s];
+		struct induction_variable_pointer *pointer = &pointers[site->pointer];
+		struct ir_instruction *instruction = site->node->data;
+
+		if (0 == site->operand) {
+			instruction->kind = IR_COPY;
+			induction_variable_set_temporary(&instruction->operands[1], pointer->temporary);
+			continue;
+		}
+
+		/* i < n becomes pointer < base + n * size */
+		struct ir_operand *other = &instruction->operands[3 - site->operand];
+		int bound = induction_variable_invariant_before(anchor, other);
+		int size = induction_variable_constant_before(anchor, pointer->size);
+		int scaled = induction_variable_compute(anchor, IR_MULT_SIGNED_WORD, -1, size, bound);
+		int end = induction_variable_compute(anchor, IR_ADD_SIGNED_WORD, -1, pointer->base, scaled);
+
+		instruction->kind = induction_variable_pointer_comparison(instruction->kind);
+		induction_variable_set_temporary(&instruction->operands[site->operand], pointer->temporary);
+		induction_variable_set_temporary(other, end);
+	}
+
+	/* the increments of removed variables, dead code removal takes what computed them */
+	for (int i = 0; i < induction_count; i++) {
+		if (removed[i]) ir_unlink(inductions[i].store);
+	}
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+static bool induction_variable_loop(struct cfg_loop *loop) {
+	induction_variable_scan(loop);
+	induction_variable_find_inductions();
+	if (0 == induction_count) return false;
+
+	pointer_count = 0;
+	site_count = 0;
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!loop->body[block->id]) continue;
+
+		int position = 0;
+		for (struct ir_list *iter = block->first; ; iter = iter->next, position++) {
+			induction_variable_find_subscript(iter, block->id, position);
+			if (iter == block->last) break;
+		}
+	}
+	if (0 == site_count) return false;
+
+	int *use_counts = calloc(max_temporary + 1, sizeof(int));
+	bool *dead = calloc(max_temporary + 1, sizeof(bool));
+	bool *removed = calloc(induction_count, sizeof(bool));
+	assert(NULL != use_counts && NULL != dead && NULL != removed);
+
+	induction_variable_count_uses(loop, use_counts, dead);
+	for (int i = 0; i < induction_count; i++) {
+		removed[i] = induction_variable_find_comparisons(loop, i, use_counts, dead);
+	}
+
+	struct ir_list *anchor = cfg_loop_preheader(cfg, loop);
+	if (NULL != anchor) induction_variable_rewrite(anchor, removed);
+
+	free(use_counts);
+	free(dead);
+	free(removed);
+	return NULL != anchor;
+}
+
+static void induction_variables(struct cfg *function) {
+	struct ir_list **done = NULL;
+	int done_count = 0;
+
+	cfg = function;
+
+	/* every rewrite changes the blocks, so the loops are found again; each is done once */
+	bool changed = true;
+	while (changed) {
+		changed = false;
+
+		max_temporary = dataflow_max_temporary(cfg);
+		temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+		definition_counts = calloc(max_temporary + 1, sizeof(int));
+		temporary_blocks = malloc(sizeof(int) * (max_temporary + 1));
+		temporary_positions = malloc(sizeof(int) * (max_temporary + 1));
+		assert(NULL != definition_counts && NULL != temporary_blocks && NULL != temporary_positions);
+
+		for (struct ir_list *iter = cfg->proc_begin; ; iter = iter->next) {
+			struct ir_operand *definition = ir_definition_operand(iter->data);
+			if (NULL != definition && induction_variable_is_temporary(definition)) {
+				definition_counts[definition->data.temporary]++;
+			}
+			if (iter == cfg->proc_end) break;
+		}
+
+		escapes = dataflow_escaping_variables(cfg, temporary_definitions, &max_variable);
+		store_counts = malloc(sizeof(int) * (max_variable + 1));
+		store_nodes = malloc(sizeof(struct ir_list *) * (max_variable + 1));
+		store_blocks = malloc(sizeof(int) * (max_variable + 1));
+		store_positions = malloc(sizeof(int) * (max_variable + 1));
+		inductions = malloc(sizeof(struct induction_variable) * (max_variable + 1));
+		variable_inductions = malloc(sizeof(int) * (max_variable + 1));
+		assert(NULL != store_counts && NULL != store_nodes && NULL != store_blocks && NULL != store_positions);
+		assert(NULL != inductions && NULL != variable_inductions);
+
+		cfg_compute_dominators(cfg);
+		int loop_count;
+		struct cfg_loop *loops = cfg_find_loops(cfg, &loop_count);
+
+		for (int l = 0; l < loop_count && !changed; l++) {
+			bool is_done = false;
+			for (int d = 0; d < done_count && !is_done; d++) is_done = done[d] == loops[l].header->first;
+			if (is_done) continue;
+
+			done = realloc(done, sizeof(struct ir_list *) * (done_count + 1));
+			assert(NULL != done);
+			done[done_count++] = loops[l].header->first;
+			changed = induction_variable_loop(&loops[l]);
+		}
+
+		cfg_destroy_loops(loops, loop_count);
+		free(temporary_definitions);
+		free(definition_counts);
+		free(temporary_blocks);
+		free(temporary_positions);
+		free(escapes);
+		free(store_counts);
+		free(store_nodes);
+		free(store_blocks);
+		free(store_positions);
+		free(inductions);
+		free(variable_inductions);
+
+		if (changed) cfg_rebuild(cfg);
+	}
+
+	free(done);
+}
+
+void induction_variables_program(void) {
+	struct cfg *cfgs = cfg_build_program();
+
+	for (struct cfg *function = cfgs; NULL != function; function = function->next) {
+		induction_variables(function);
+	}
+
+	free(sites);
+	sites = NULL;
+	site_capacity = 0;
+	cfg_destroy_program(cfgs);
+}
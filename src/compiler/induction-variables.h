@@ -0,0 +1,26 @@
+#ifndef _INDUCTION_VARIABLES_H
+#define _INDUCTION_VARIABLES_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Strength reduction of induction variables. A basic induction variable is
+ * a word local whose address is never taken and whose only store in a loop
+ * is i = i + step. Every subscript base + i * size in the loop reads a
+ * pointer instead, set up in the preheader and advanced by step * size
+ * right after the store to i. When i is then only compared against values
+ * computed outside the loop and isn't read after it, the comparisons are
+ * made against an end pointer and the store to i goes (linear function
+ * test replacement). Assumes subscripts don't wrap around the address
+ * space.
+ *
+ * Works on ir_list outside SSA form, since the pointers are written both
+ * in the preheader and in the loop.
+ */
+void induction_variables_program(void);
+
+#endif
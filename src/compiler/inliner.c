@@ -0,0 +1,480 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "symbol.h"
+#include "type.h"
+#include "helpers/type-tree.h"
+#include "inliner.h"
+
+extern int next_temporary;
+
+struct inliner_function {
+	struct ir_list *begin, *end;                /* procBegin and procEnd */
+	struct symbol_table *table;
+	int size;                                   /* instructions between begin and end, labels aside */
+	int call_count;                             /* calls to it in the program */
+	int parameter_count;
+	bool is_leaf;                               /* calls no other function */
+	bool has_return;
+	bool is_movable;                            /* all its variables can live in a caller's frame */
+	bool is_visiting, is_done;                  /* bottom-up walk: its own calls are inlined once done */
+};
+
+/* what one inlined call renamed: callee -> caller */
+struct inliner_variable {
+	int original;
+	struct symbol *copy;
+	struct ir_instruction *address;             /* an addressOf of the copy, to clone for the argument */
+};
+
+struct inliner_address {
+	struct ir_instruction *original, *copy;
+};
+
+struct inliner_label {
+	char *original, *copy;
+};
+
+static struct inliner_function *functions;
+static int function_count;
+
+static int *temporaries;
+static int temporary_count;
+static struct inliner_variable *variables;
+static int variable_count;
+static struct inliner_address *addresses;
+static int address_count;
+static struct inliner_label *labels;
+static int label_count;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool inliner_is_return(struct ir_instruction *instruction) {
+	return IR_RETURN_WORD == instruction->kind ||
+		IR_RETURN_HALF_WORD == instruction->kind ||
+		IR_RETURN_BYTE == instruction->kind;
+}
+
+static bool inliner_is_result(struct ir_instruction *instruction) {
+	return IR_RESULT_WORD == instruction->kind ||
+		IR_RESULT_HALF_WORD == instruction->kind ||
+		IR_RESULT_BYTE == instruction->kind;
+}
+
+static bool inliner_is_store(struct ir_instruction *instruction) {
+	return IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind;
+}
+
+/* an addressOf of a local or parameter, globals and string literals stay as they are */
+static bool inliner_is_local(struct ir_instruction *address) {
+	return IR_ADDRESS_OF == address->kind && !address->operands[2].data.is_string && !address->operands[6].data.number;
+}
+
+static struct ir_instruction *inliner_clone(struct ir_instruction *original) {
+	struct ir_instruction *instruction = ir_instruction(original->kind);
+	memcpy(instruction->operands, original->operands, sizeof(instruction->operands));
+	instruction->is_used = original->is_used;
+	instruction->offset_variable = original->offset_variable;
+	return instruction;
+}
+
+static int inliner_find_function(const char *name) {
+	for (int f = 0; f < function_count; f++) {
+		if (0 == strcmp(functions[f].begin->data->operands[0].data.name, name)) return f;
+	}
+	return -1;
+}
+
+static struct symbol *inliner_find_symbol(struct symbol_table *table, int id) {
+	for (struct symbol_list *iter = table->variables; NULL != iter; iter = iter->next) {
+		if (id == (int)iter->symbol.id) return &iter->symbol;
+	}
+	for (struct symbol_table_children *child = table->children; NULL != child && NULL != child->self; child = child->next) {
+		struct symbol *symbol = inliner_find_symbol(child->self, id);
+		if (NULL != symbol) return symbol;
+	}
+	return NULL;
+}
+
+/*************
+ * FUNCTIONS *
+ *************/
+
+/* the frame of a caller holds the variable at the size the addressOf says it has */
+static bool inliner_is_movable(struct inliner_function *function, struct ir_instruction *address) {
+	if (!inliner_is_local(address)) return true;
+
+	struct symbol *symbol = inliner_find_symbol(function->table, address->operands[3].data.variable_id);
+	if (NULL == symbol || NULL == symbol->type_tree || NULL == symbol->type_tree->type) return false;
+
+	struct type *type = symbol->type_tree->type;
+	return TYPE_ARRAY != symbol->type_tree->type_kind && TYPE_ARRAY != type->kind &&
+		type_get_basic_size(type) == (int)address->operands[4].data.number;
+}
+
+static void inliner_scan(struct inliner_function *function) {
+	function->size = 0;
+	function->is_leaf = true;
+	function->has_return = false;
+	function->is_movable = true;
+
+	for (struct ir_list *iter = function->begin->next; iter != function->end; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+
+		if (IR_LABEL != instruction->kind) function->size++;
+		if (IR_CALL == instruction->kind) function->is_leaf = false;
+		if (inliner_is_return(instruction)) function->has_return = true;
+
+		if (!inliner_is_movable(function, instruction) ||
+			(NULL != instruction->offset_variable && !inliner_is_movable(function, instruction->offset_variable))) {
+			function->is_movable = false;
+		}
+	}
+}
+
+static void inliner_find_functions(void) {
+	functions = NULL;
+	function_count = 0;
+
+	for (struct ir_list *iter = ir_get_ir_list(); NULL != iter; iter = iter->next) {
+		if (IR_PROC_BEGIN != iter->data->kind) continue;
+
+		functions = realloc(functions, sizeof(struct inliner_function) * (function_count + 1));
+		assert(NULL != functions);
+		struct inliner_function *function = &functions[function_count++];
+		memset(function, 0, sizeof(struct inliner_function));
+
+		function->begin = iter;
+		for (function->end = iter; IR_PROC_END != function->end->data->kind; function->end = function->end->next);
+		function->table = symbol_get_procedure_table(iter->data->operands[1].data.name);
+		assert(NULL != function->table);
+
+		for (struct symbol_list *variable = function->table->variables; NULL != variable; variable = variable->next) {
+			if (variable->symbol.arg_number + 1 > function->parameter_count) {
+				function->parameter_count = variable->symbol.arg_number + 1;
+			}
+		}
+		iter = function->end;
+	}
+
+	for (int f = 0; f < function_count; f++) {
+		inliner_scan(&functions[f]);
+		for (struct ir_list *iter = functions[f].begin; iter != functions[f].end; iter = iter->next) {
+			if (IR_CALL != iter->data->kind) continue;
+			int callee = inliner_find_function(iter->data->operands[0].data.name);
+			if (callee >= 0) functions[callee].call_count++;
+		}
+	}
+}
+
+/* whether a call chain leads from one function to the other, through the calls left in ir_list */
+static bool inliner_reaches(int from, int to, bool *visited) {
+	if (from == to) return true;
+	if (visited[from]) return false;
+	visited[from] = true;
+
+	for (struct ir_list *iter = functions[from].begin; iter != functions[from].end; iter = iter->next) {
+		if (IR_CALL != iter->data->kind) continue;
+		int callee = inliner_find_function(iter->data->operands[0].data.name);
+		if (callee >= 0 && inliner_reaches(callee, to, visited)) return true;
+	}
+	return false;
+}
+
+/*
+ * The body is no bigger than what the call costs, or the callee is a leaf
+ * and this is the only place it's called from.
+ */
+static bool inliner_should_inline(int caller, int callee) {
+	struct inliner_function *function = &functions[callee];
+
+	if (!function->is_done || !function->is_movable) return false;
+	if (functions[caller].size + function->size > INLINER_MAX_CALLER) return false;
+
+	if (function->size > INLINER_CALL_COST + 2 * function->parameter_count &&
+		!(function->is_leaf && 1 == function->call_count && function->size <= INLINER_MAX_SIZE)) {
+		return false;
+	}
+
+	bool *visited = calloc(function_count, sizeof(bool));
+	assert(NULL != visited);
+	bool is_recursive = inliner_reaches(callee, caller, visited);
+	free(visited);
+	return !is_recursive;
+}
+
+/***********
+ * RENAMES *
+ ***********/
+
+static void inliner_rename_temporary(struct ir_operand *operand) {
+	if (OPERAND_TEMPORARY != operand->kind) return;
+
+	int temporary = operand->data.temporary;
+	assert(temporary < temporary_count);
+	if (temporaries[temporary] < 0) temporaries[temporary] = next_temporary++;
+	operand->data.temporary = temporaries[temporary];
+}
+
+static void inliner_rename_temporaries(struct ir_instruction *instruction) {
+	struct ir_operand *definition = ir_definition_operand(instruction);
+	if (NULL != definition) inliner_rename_temporary(definition);
+	for (int i = 0; i < ir_use_count(instruction); i++) {
+		inliner_rename_temporary(ir_use_operand(instruction, i));
+	}
+}
+
+static struct inliner_variable *inliner_variable(struct symbol_table *caller, struct symbol_table *callee, int id) {
+	for (int v = 0; v < variable_count; v++) {
+		if (variables[v].original == id) return &variables[v];
+	}
+
+	struct symbol *symbol = inliner_find_symbol(callee, id);
+	assert(NULL != symbol);
+
+	variables = realloc(variables, sizeof(struct inliner_variable) * (variable_count + 1));
+	assert(NULL != variables);
+	struct inliner_variable *variable = &variables[variable_count++];
+	variable->original = id;
+	variable->copy = symbol_put_copy(caller, symbol);
+	variable->address = NULL;
+	return variable;
+}
+
+/* the copy of an addressOf, made once whether it's still in ir_list or only an offset_variable */
+static struct ir_instruction *inliner_address(
+	struct symbol_table *caller, struct symbol_table *callee, struct ir_instruction *original
+) {
+	for (int a = 0; a < address_count; a++) {
+		if (addresses[a].original == original) return addresses[a].copy;
+	}
+
+	struct ir_instruction *copy = inliner_clone(original);
+	inliner_rename_temporaries(copy);
+	if (inliner_is_local(copy)) {
+		struct inliner_variable *variable = inliner_variable(caller, callee, copy->operands[3].data.variable_id);
+		copy->operands[3].data.variable_id = variable->copy->id;
+		ir_operand_number(copy, 5, -1);
+		if (NULL == variable->address) variable->address = copy;
+	}
+
+	addresses = realloc(addresses, sizeof(struct inliner_address) * (address_count + 1));
+	assert(NULL != addresses);
+	addresses[address_count].original = original;
+	addresses[address_count].copy = copy;
+	address_count++;
+	return copy;
+}
+
+static char *inliner_label(const char *name) {
+	for (int l = 0; l < label_count; l++) {
+		if (0 == strcmp(labels[l].original, name)) return labels[l].copy;
+	}
+	assert(0);
+	return NULL;
+}
+
+static void inliner_reset(struct inliner_function *callee) {
+	temporary_count = next_temporary;
+	temporaries = malloc(sizeof(int) * temporary_count);
+	assert(NULL != temporaries);
+	for (int t = 0; t < temporary_count; t++) temporaries[t] = -1;
+
+	variable_count = 0;
+	address_count = 0;
+	label_count = 0;
+	for (struct ir_list *iter = callee->begin->next; iter != callee->end; iter = iter->next) {
+		if (IR_LABEL != iter->data->kind) continue;
+
+		labels = realloc(labels, sizeof(struct inliner_label) * (label_count + 1));
+		assert(NULL != labels);
+		labels[label_count].original = iter->data->operands[0].data.name;
+		labels[label_count].copy = ir_create_label_name();
+		label_count++;
+	}
+}
+
+static void inliner_release(void) {
+	free(temporaries);
+	for (int l = 0; l < label_count; l++) free(labels[l].copy);
+}
+
+/************
+ * INLINING *
+ ************/
+
+/* the parameter instructions of the call by index, if it passes exactly the callee's parameters */
+static bool inliner_find_parameters(struct ir_list *call, int count, struct ir_list **parameters) {
+	int expected = count - 1;
+
+	for (struct ir_list *iter = call->prev; expected >= 0; iter = iter->prev) {
+		struct ir_instruction *instruction = iter->data;
+
+		if (IR_CALL == instruction->kind || IR_SYS_CALL == instruction->kind || IR_PROC_BEGIN == instruction->kind) {
+			return false;
+		}
+		if (IR_PARAMETER != instruction->kind) continue;
+		if ((int)instruction->operands[0].data.number != expected) return false;
+
+		/* f(x = 3) passes the address it stored to, see mips_print_parameter */
+		struct ir_instruction *previous = iter->prev->data;
+		if (inliner_is_store(previous) && ir_operand_equals(&previous->operands[0], &instruction->operands[1])) {
+			return false;
+		}
+		parameters[expected--] = iter;
+	}
+
+	/* a callee without parameters can't take an argument either */
+	return count > 0 || IR_PARAMETER != call->prev->data->kind;
+}
+
+/* the argument goes into the copy of its parameter, where it was passed */
+static void inliner_pass_argument(struct ir_list *parameter, struct inliner_function *callee, int index) {
+	struct inliner_variable *variable = NULL;
+
+	for (int v = 0; v < variable_count && NULL == variable; v++) {
+		struct symbol *symbol = inliner_find_symbol(callee->table, variables[v].original);
+		if (index == symbol->arg_number) variable = &variables[v];
+	}
+
+	if (NULL != variable) {
+		struct ir_instruction *address = inliner_clone(variable->address);
+		ir_operand_temporary(address, 0);
+		address->is_used = true;
+		ir_insert_before(parameter, address);
+
+		int size = (int)address->operands[4].data.number;
+		struct ir_instruction *store = ir_instruction(
+			1 == size ? IR_STORE_BYTE : 2 == size ? IR_STORE_HALF_WORD : IR_STORE_WORD
+		);
+		ir_operand_copy(store, 0, &address->operands[0]);
+		ir_operand_copy(store, 1, &parameter->data->operands[1]);
+		ir_insert_before(parameter, store);
+	}
+	ir_unlink(parameter);
+}
+
+/* replaces call (and its result) by the body of callee, returning what comes after */
+static struct ir_list *inliner_inline(
+	struct inliner_function *caller, struct inliner_function *callee,
+	struct ir_list *call, struct ir_list **parameters
+) {
+	struct ir_list *result = inliner_is_result(call->next->data) ? call->next : NULL;
+	struct ir_list *next = NULL != result ? result->next : call->next;
+
+	inliner_reset(callee);
+
+	for (struct ir_list *iter = callee->begin->next; iter != callee->end; iter = iter->next) {
+		struct ir_instruction *instruction;
+
+		if (IR_ADDRESS_OF == iter->data->kind) {
+			instruction = inliner_address(caller->table, callee->table, iter->data);
+		} else {
+			instruction = inliner_clone(iter->data);
+			inliner_rename_temporaries(instruction);
+			if (NULL != instruction->offset_variable) {
+				instruction->offset_variable = inliner_address(caller->table, callee->table, instruction->offset_variable);
+			}
+		}
+
+		if (IR_LABEL == instruction->kind) {
+			strncpy(instruction->operands[0].data.name, inliner_label(iter->data->operands[0].data.name), IDENTIFIER_MAX + 1);
+		} else if (ir_is_branch(instruction)) {
+			char *target = ir_branch_target(instruction);
+			strncpy(target, inliner_label(target), IDENTIFIER_MAX + 1);
+		}
+
+		/* return leaves the value where the result instruction would have put it */
+		if (inliner_is_return(instruction)) {
+			if (NULL == result) {
+				free(instruction);
+				continue;
+			}
+			instruction->kind = IR_COPY;
+			instruction->operands[1] = instruction->operands[0];
+			ir_operand_copy(instruction, 0, &result->data->operands[0]);
+		}
+
+		ir_insert_before(call, instruction);
+	}
+
+	for (int p = 0; p < callee->parameter_count; p++) {
+		inliner_pass_argument(parameters[p], callee, p);
+	}
+
+	ir_unlink(call);
+	if (NULL != result) ir_unlink(result);
+
+	inliner_release();
+	caller->size += callee->size;
+	return next;
+}
+
+static bool inliner_can_inline(struct ir_list *call, struct inliner_function *callee, struct ir_list **parameters) {
+	if (!inliner_find_parameters(call, callee->parameter_count, parameters)) return false;
+
+	/* a void callee leaves nothing for the result to read */
+	return callee->has_return || !inliner_is_result(call->next->data);
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+static void inliner_function(int caller) {
+	struct inliner_function *function = &functions[caller];
+	if (function->is_done || function->is_visiting) return;
+	function->is_visiting = true;
+
+	/* callees first, so what gets copied already has its own calls inlined */
+	for (struct ir_list *iter = function->begin; iter != function->end; iter = iter->next) {
+		if (IR_CALL != iter->data->kind) continue;
+		int callee = inliner_find_function(iter->data->operands[0].data.name);
+		if (callee >= 0) inliner_function(callee);
+	}
+
+	for (struct ir_list *iter = function->begin->next; iter != function->end; ) {
+		int callee = IR_CALL == iter->data->kind ? inliner_find_function(iter->data->operands[0].data.name) : -1;
+
+		if (callee >= 0 && inliner_should_inline(caller, callee)) {
+			struct ir_list **parameters = malloc(sizeof(struct ir_list *) * (functions[callee].parameter_count + 1));
+			assert(NULL != parameters);
+
+			if (inliner_can_inline(iter, &functions[callee], parameters)) {
+				iter = inliner_inline(function, &functions[callee], iter, parameters);
+				free(parameters);
+				continue;
+			}
+			free(parameters);
+		}
+		iter = iter->next;
+	}
+
+	inliner_scan(function);
+	function->is_visiting = false;
+	function->is_done = true;
+}
+
+void inliner_program(void) {
+	inliner_find_functions();
+
+	for (int f = 0; f < function_count; f++) {
+		inliner_function(f);
+	}
+
+	free(functions);
+	free(variables);
+	free(addresses);
+	free(labels);
+	variables = NULL;
+	addresses = NULL;
+	labels = NULL;
+}
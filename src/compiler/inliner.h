@@ -0,0 +1,35 @@
+#ifndef _INLINER_H
+#define _INLINER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+
+/* instructions a call costs besides the body: frame, a/s/ra/fp saves and restores, t register saves */
+#define INLINER_CALL_COST 40
+/* a leaf with a single call site is inlined up to this size, its own copy is then dead */
+#define INLINER_MAX_SIZE 80
+/* callers don't grow past this, so the register allocator seldom has to spill */
+#define INLINER_MAX_CALLER 400
+
+/*
+ * Replaces calls to functions of the program by a copy of the callee's body.
+ * A call is inlined when the body is no bigger than the call overhead it
+ * saves (INLINER_CALL_COST plus the moves of its arguments), or when the
+ * callee is a leaf called from only that place. Functions are visited
+ * bottom-up in the call graph, so a callee's own calls are inlined before it
+ * gets copied; calls within a cycle of the call graph stay calls.
+ *
+ * The copy gets fresh temporaries and labels. The callee's variables become
+ * new locals of the caller (added to its procedure table, so its frame grows
+ * to hold them): each argument is stored into the copy of its parameter
+ * where the parameter instruction was, and return copies the value into the
+ * temporary the result instruction defined. Callees with array locals (or
+ * variables whose frame size isn't their type's size) are never inlined.
+ *
+ * Works on ir_list outside SSA form.
+ */
+void inliner_program(void);
+
+#endif
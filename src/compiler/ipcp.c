@@ -0,0 +1,652 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "symbol.h"
+#include "ipcp.h"
+
+struct ipcp_function {
+	struct ir_list *begin, *end;                /* procBegin and procEnd */
+	int parameter_count;
+	int *parameter_ids;                         /* arg number -> variable id */
+	int size;                                   /* instructions between begin and end, labels aside */
+	bool is_fixed;                              /* its parameters can't change */
+	int clone_count;
+};
+
+/* a call of a function of the program, with what it passes */
+struct ipcp_call {
+	struct ir_list *call;
+	int caller, callee;
+	int weight;
+	struct ir_list **parameters;                /* by index */
+	bool *is_constant;
+	uint32_t *constants;
+	bool *is_passed;                            /* a self call handing the parameter on as it got it */
+	bool is_specialized;
+};
+
+/* an addressOf and its copy in a specialized function */
+struct ipcp_address {
+	struct ir_instruction *original, *copy;
+};
+
+struct ipcp_label {
+	char *original, *copy;
+};
+
+static struct ipcp_function *functions;
+static int function_count;
+static struct ipcp_call *calls;
+static int call_count;
+
+static struct ipcp_address *addresses;
+static int address_count;
+static struct ipcp_label *labels;
+static int label_count;
+
+static int clone_number;
+static int growth;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool ipcp_is_load(struct ir_instruction *instruction) {
+	return IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind;
+}
+
+static bool ipcp_is_store(struct ir_instruction *instruction) {
+	return IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind;
+}
+
+/* an addressOf of a local or parameter, globals and string literals aside */
+static bool ipcp_is_local(struct ir_instruction *address) {
+	return IR_ADDRESS_OF == address->kind && !address->operands[2].data.is_string && !address->operands[6].data.number;
+}
+
+static struct ir_instruction *ipcp_clone_instruction(struct ir_instruction *original) {
+	struct ir_instruction *instruction = ir_instruction(original->kind);
+	memcpy(instruction->operands, original->operands, sizeof(instruction->operands));
+	instruction->is_used = original->is_used;
+	instruction->offset_variable = original->offset_variable;
+	return instruction;
+}
+
+static int ipcp_find_function(const char *name) {
+	for (int f = 0; f < function_count; f++) {
+		if (0 == strcmp(functions[f].begin->data->operands[0].data.name, name)) return f;
+	}
+	return -1;
+}
+
+/* the addressOf of a parameter somewhere in the body, NULL if the body never reads or writes it */
+static struct ir_instruction *ipcp_find_address(struct ipcp_function *function, int variable_id) {
+	for (struct ir_list *iter = function->begin->next; iter != function->end; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		if (NULL != instruction->offset_variable) instruction = instruction->offset_variable;
+
+		if (ipcp_is_local(instruction) && variable_id == (int)instruction->operands[3].data.variable_id) {
+			return instruction;
+		}
+	}
+	return NULL;
+}
+
+static bool ipcp_is_variable_address(struct ir_instruction *address, int variable_id) {
+	return NULL != address && ipcp_is_local(address) && variable_id == (int)address->operands[3].data.variable_id;
+}
+
+/* the only instruction of the function that defines the temporary, NULL if there are none or several */
+static struct ir_instruction *ipcp_definition(struct ipcp_function *function, int temporary) {
+	struct ir_instruction *definition = NULL;
+
+	for (struct ir_list *iter = function->begin->next; iter != function->end; iter = iter->next) {
+		struct ir_operand *operand = ir_definition_operand(iter->data);
+		if (NULL == operand || OPERAND_TEMPORARY != operand->kind || temporary != operand->data.temporary) continue;
+		if (NULL != definition) return NULL;
+		definition = iter->data;
+	}
+	return definition;
+}
+
+/*
+ * The number of stores to a variable that is only ever loaded and stored
+ * directly, the last of them in store, or -1 if its address gets away.
+ */
+static int ipcp_find_stores(struct ipcp_function *function, int variable_id, struct ir_instruction **store) {
+	int count = 0;
+
+	*store = NULL;
+	for (struct ir_list *iter = function->begin->next; iter != function->end; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		bool is_access = ipcp_is_variable_address(instruction->offset_variable, variable_id);
+
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (OPERAND_TEMPORARY != use->kind) continue;
+			if (!ipcp_is_variable_address(ipcp_definition(function, use->data.temporary), variable_id)) continue;
+
+			if (!(ipcp_is_load(instruction) && use == &instruction->operands[1]) &&
+				!(ipcp_is_store(instruction) && use == &instruction->operands[0])) {
+				return -1;
+			}
+			is_access = true;
+		}
+
+		if (!is_access) continue;
+		if (ipcp_is_store(instruction)) {
+			*store = instruction;
+			count++;
+		} else if (!ipcp_is_load(instruction)) {
+			return -1;
+		}
+	}
+	return count;
+}
+
+/*
+ * The value of a temporary the caller only ever sets to a constant, or
+ * loads from a local it only ever sets to one (an argument of a call the
+ * inliner copied).
+ */
+static bool ipcp_constant(struct ipcp_function *caller, int temporary, uint32_t *value) {
+	struct ir_instruction *definition = ipcp_definition(caller, temporary);
+	if (NULL == definition) return false;
+
+	if (IR_CONST_INT == definition->kind) {
+		*value = (uint32_t)definition->operands[1].data.number;
+		return true;
+	}
+
+	struct ir_instruction *address = definition->offset_variable, *store, *constant;
+	if (NULL == address && ipcp_is_load(definition) && OPERAND_TEMPORARY == definition->operands[1].kind) {
+		address = ipcp_definition(caller, definition->operands[1].data.temporary);
+	}
+	if (
+		!ipcp_is_load(definition) || NULL == address || !ipcp_is_local(address) ||
+		-1 != address->operands[5].data.number ||
+		1 != ipcp_find_stores(caller, (int)address->operands[3].data.variable_id, &store) ||
+		OPERAND_TEMPORARY != store->operands[1].kind
+	) {
+		return false;
+	}
+
+	constant = ipcp_definition(caller, store->operands[1].data.temporary);
+	if (NULL == constant || IR_CONST_INT != constant->kind) return false;
+
+	/* what a narrower store keeps reads back the same whether the load extends the sign or not */
+	*value = (uint32_t)constant->operands[1].data.number;
+	return (
+		IR_STORE_WORD == store->kind ? IR_LOAD_WORD == definition->kind :
+		IR_STORE_HALF_WORD == store->kind ? *value <= 0x7fff : *value <= 0x7f
+	);
+}
+
+/* the function only ever loads from the parameter, so it holds what the call passed throughout */
+static bool ipcp_is_read_only(struct ipcp_function *function, int variable_id) {
+	struct ir_instruction *store;
+	return 0 == ipcp_find_stores(function, variable_id, &store);
+}
+
+/* the argument of a call of the function from itself is the parameter, loaded and passed on unchanged */
+static bool ipcp_is_passed_through(struct ipcp_function *function, int parameter, int temporary) {
+	struct ir_instruction *load = ipcp_definition(function, temporary);
+	if (NULL == load || !ipcp_is_load(load)) return false;
+
+	struct ir_instruction *address = load->offset_variable;
+	if (NULL == address && OPERAND_TEMPORARY == load->operands[1].kind) {
+		address = ipcp_definition(function, load->operands[1].data.temporary);
+	}
+	return (
+		ipcp_is_variable_address(address, function->parameter_ids[parameter]) &&
+		ipcp_is_read_only(function, function->parameter_ids[parameter])
+	);
+}
+
+/* the parameter instructions of the call by index, if it passes exactly count of them */
+static bool ipcp_find_parameters(struct ir_list *call, int count, struct ir_list **parameters) {
+	int expected = count - 1;
+
+	for (struct ir_list *iter = call->prev; expected >= 0; iter = iter->prev) {
+		struct ir_instruction *instruction = iter->data;
+
+		if (IR_CALL == instruction->kind || IR_SYS_CALL == instruction->kind || IR_PROC_BEGIN == instruction->kind) {
+			return false;
+		}
+		if (IR_PARAMETER != instruction->kind) continue;
+		if ((int)instruction->operands[0].data.number != expected) return false;
+
+		/* f(x = 3) passes the address it stored to, see mips_print_parameter */
+		struct ir_instruction *previous = iter->prev->data;
+		if (ipcp_is_store(previous) && ir_operand_equals(&previous->operands[0], &instruction->operands[1])) {
+			return false;
+		}
+		parameters[expected--] = iter;
+	}
+
+	return count > 0 || IR_PARAMETER != call->prev->data->kind;
+}
+
+/**************
+ * CALL GRAPH *
+ **************/
+
+static void ipcp_find_functions(void) {
+	functions = NULL;
+	function_count = 0;
+
+	for (struct ir_list *iter = ir_get_ir_list(); NULL != iter; iter = iter->next) {
+		if (IR_PROC_BEGIN != iter->data->kind) continue;
+
+		functions = realloc(functions, sizeof(struct ipcp_function) * (function_count + 1));
+		assert(NULL != functions);
+		struct ipcp_function *function = &functions[function_count++];
+		memset(function, 0, sizeof(struct ipcp_function));
+
+		function->begin = iter;
+		for (function->end = iter; IR_PROC_END != function->end->data->kind; function->end = function->end->next);
+		for (struct ir_list *node = iter->next; node != function->end; node = node->next) {
+			if (IR_LABEL != node->data->kind) function->size++;
+		}
+		function->is_fixed = 0 == strcmp("main", iter->data->operands[0].data.name);
+
+		struct symbol_table *table = symbol_get_procedure_table(iter->data->operands[1].data.name);
+		assert(NULL != table);
+		for (struct symbol_list *variable = table->variables; NULL != variable; variable = variable->next) {
+			if (variable->symbol.arg_number + 1 > function->parameter_count) {
+				function->parameter_count = variable->symbol.arg_number + 1;
+			}
+		}
+		function->parameter_ids = malloc(sizeof(int) * (function->parameter_count + 1));
+		assert(NULL != function->parameter_ids);
+		for (struct symbol_list *variable = table->variables; NULL != variable; variable = variable->next) {
+			if (variable->symbol.arg_number >= 0) function->parameter_ids[variable->symbol.arg_number] = variable->symbol.id;
+		}
+		iter = function->end;
+	}
+}
+
+static void ipcp_add_call(struct ir_list *call, int caller, int depth) {
+	int callee = ipcp_find_function(call->data->operands[0].data.name);
+	if (callee < 0) return;
+
+	int count = functions[callee].parameter_count;
+	struct ir_list **parameters = malloc(sizeof(struct ir_list *) * (count + 1));
+	assert(NULL != parameters);
+	if (!ipcp_find_parameters(call, count, parameters)) {
+		functions[callee].is_fixed = true;
+		free(parameters);
+		return;
+	}
+
+	calls = realloc(calls, sizeof(struct ipcp_call) * (call_count + 1));
+	assert(NULL != calls);
+	struct ipcp_call *record = &calls[call_count++];
+	record->call = call;
+	record->caller = caller;
+	record->callee = callee;
+	record->weight = 1 << (3 * (depth < 3 ? depth : 3));
+	record->parameters = parameters;
+	record->is_constant = malloc(sizeof(bool) * (count + 1));
+	record->constants = malloc(sizeof(uint32_t) * (count + 1));
+	record->is_passed = malloc(sizeof(bool) * (count + 1));
+	record->is_specialized = false;
+	assert(NULL != record->is_constant && NULL != record->constants && NULL != record->is_passed);
+
+	for (int p = 0; p < count; p++) {
+		struct ir_operand *argument = &parameters[p]->data->operands[1];
+		record->is_constant[p] = (
+			OPERAND_TEMPORARY == argument->kind &&
+			ipcp_constant(&functions[caller], argument->data.temporary, &record->constants[p])
+		);
+		record->is_passed[p] = (
+			caller == callee && OPERAND_TEMPORARY == argument->kind &&
+			ipcp_is_passed_through(&functions[caller], p, argument->data.temporary)
+		);
+	}
+}
+
+/* every call of a function of the program, weighed by the loops around it */
+static void ipcp_find_calls(void) {
+	struct cfg *cfgs = cfg_build_program();
+	call_count = 0;
+
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		int caller = ipcp_find_function(cfg->proc_begin->data->operands[0].data.name);
+		assert(caller >= 0);
+
+		cfg_compute_dominators(cfg);
+		int loop_count;
+		struct cfg_loop *loops = cfg_find_loops(cfg, &loop_count);
+
+		for (int b = 0; b < cfg->block_count; b++) {
+			struct cfg_block *block = cfg->blocks[b];
+			int depth = 0;
+			for (int l = 0; l < loop_count; l++) depth += loops[l].body[b];
+
+			for (struct ir_list *iter = block->first; ; iter = iter->next) {
+				if (IR_CALL == iter->data->kind) ipcp_add_call(iter, caller, depth);
+				if (iter == block->last) break;
+			}
+		}
+		cfg_destroy_loops(loops, loop_count);
+	}
+	cfg_destroy_program(cfgs);
+}
+
+static void ipcp_release(void) {
+	for (int c = 0; c < call_count; c++) {
+		free(calls[c].parameters);
+		free(calls[c].is_constant);
+		free(calls[c].constants);
+		free(calls[c].is_passed);
+	}
+	for (int f = 0; f < function_count; f++) free(functions[f].parameter_ids);
+	free(calls);
+	free(functions);
+	calls = NULL;
+	functions = NULL;
+	call_count = 0;
+	function_count = 0;
+}
+
+/******************
+ * SPECIALIZATION *
+ ******************/
+
+static struct ir_instruction *ipcp_address(struct ir_instruction *original) {
+	for (int a = 0; a < address_count; a++) {
+		if (addresses[a].original == original) return addresses[a].copy;
+	}
+
+	addresses = realloc(addresses, sizeof(struct ipcp_address) * (address_count + 1));
+	assert(NULL != addresses);
+	addresses[address_count].original = original;
+	addresses[address_count].copy = ipcp_clone_instruction(original);
+	return addresses[address_count++].copy;
+}
+
+static char *ipcp_label(const char *name) {
+	for (int l = 0; l < label_count; l++) {
+		if (0 == strcmp(labels[l].original, name)) return labels[l].copy;
+	}
+	assert(0);
+	return NULL;
+}
+
+/* the call hands the function's parameter on to itself, so a copy taking a constant for it should call the copy */
+static bool ipcp_is_recursion(struct ir_list *call, int parameter) {
+	for (int c = 0; c < call_count; c++) {
+		if (call == calls[c].call) return calls[c].is_passed[parameter];
+	}
+	return false;
+}
+
+/*
+ * A copy of the function right after it, under a name of its own, for a
+ * constant the parameter takes; temporaries stay as they are.
+ */
+static void ipcp_clone_function(struct ipcp_function *function, const char *name, int parameter) {
+	struct ir_list *last = function->end;
+
+	address_count = 0;
+	label_count = 0;
+	for (struct ir_list *iter = function->begin->next; iter != function->end; iter = iter->next) {
+		if (IR_LABEL != iter->data->kind) continue;
+
+		labels = realloc(labels, sizeof(struct ipcp_label) * (label_count + 1));
+		assert(NULL != labels);
+		labels[label_count].original = iter->data->operands[0].data.name;
+		labels[label_count].copy = ir_create_label_name();
+		label_count++;
+	}
+
+	for (struct ir_list *iter = function->begin; ; iter = iter->next) {
+		struct ir_instruction *instruction;
+
+		if (IR_ADDRESS_OF == iter->data->kind) {
+			instruction = ipcp_address(iter->data);
+		} else {
+			instruction = ipcp_clone_instruction(iter->data);
+			if (NULL != instruction->offset_variable) instruction->offset_variable = ipcp_address(instruction->offset_variable);
+		}
+
+		if (IR_PROC_BEGIN == instruction->kind || IR_PROC_END == instruction->kind) {
+			strncpy(instruction->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+		} else if (IR_LABEL == instruction->kind) {
+			strncpy(instruction->operands[0].data.name, ipcp_label(iter->data->operands[0].data.name), IDENTIFIER_MAX + 1);
+		} else if (ir_is_branch(instruction)) {
+			char *target = ir_branch_target(instruction);
+			strncpy(target, ipcp_label(target), IDENTIFIER_MAX + 1);
+		} else if (IR_CALL == instruction->kind && ipcp_is_recursion(iter, parameter)) {
+			strncpy(instruction->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+		}
+
+		last = ir_insert_after(last, instruction);
+		if (iter == function->end) break;
+	}
+
+	for (int l = 0; l < label_count; l++) free(labels[l].copy);
+	growth += function->size;
+}
+
+/*
+ * The heaviest group of calls passing the same constant for a parameter the
+ * function reads. Recursive calls passing the parameter on go wherever the
+ * outer call went, so they don't count.
+ */
+static int ipcp_hot_group(int callee, int *parameter, uint32_t *constant) {
+	struct ipcp_function *function = &functions[callee];
+	int best = 0;
+
+	for (int p = 0; p < function->parameter_count; p++) {
+		if (NULL == ipcp_find_address(function, function->parameter_ids[p])) continue;
+
+		int total = 0;
+		for (int c = 0; c < call_count; c++) {
+			struct ipcp_call *call = &calls[c];
+			if (callee == call->callee && !call->is_specialized && !call->is_passed[p]) total += call->weight;
+		}
+
+		for (int c = 0; c < call_count; c++) {
+			struct ipcp_call *call = &calls[c];
+			if (callee != call->callee || call->is_specialized || !call->is_constant[p]) continue;
+
+			int weight = 0;
+			for (int d = 0; d < call_count; d++) {
+				struct ipcp_call *other = &calls[d];
+				if (
+					callee == other->callee && !other->is_specialized && other->is_constant[p] &&
+					other->constants[p] == call->constants[p]
+				) {
+					weight += other->weight;
+				}
+			}
+
+			/* when every call agrees the function itself takes the constant */
+			if (weight > best && weight < total) {
+				best = weight;
+				*parameter = p;
+				*constant = call->constants[p];
+			}
+		}
+	}
+	return best;
+}
+
+static void ipcp_specialize(int callee) {
+	struct ipcp_function *function = &functions[callee];
+	if (function->is_fixed || function->size > IPCP_MAX_CLONE_SIZE) return;
+
+	while (function->clone_count < IPCP_MAX_CLONES && growth + function->size <= IPCP_GROWTH_BUDGET) {
+		int parameter;
+		uint32_t constant;
+		if (ipcp_hot_group(callee, &parameter, &constant) < IPCP_HOT_WEIGHT) return;
+
+		/* the number keeps a name cut down to IDENTIFIER_MAX unique, and no function of the source starts with _Spec */
+		char name[2 * IDENTIFIER_MAX];
+		snprintf(name, sizeof(name), "_Spec%d_%s", ++clone_number, function->begin->data->operands[1].data.name);
+		name[IDENTIFIER_MAX] = '\0';
+		ipcp_clone_function(function, name, parameter);
+		function->clone_count++;
+
+		for (int c = 0; c < call_count; c++) {
+			struct ipcp_call *call = &calls[c];
+			if (
+				callee == call->callee && !call->is_specialized &&
+				call->is_constant[parameter] && constant == call->constants[parameter]
+			) {
+				strncpy(call->call->data->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+				call->is_specialized = true;
+			}
+		}
+	}
+}
+
+/***************
+ * PROPAGATION *
+ ***************/
+
+/* the constant the callee now stores into the parameter itself, which has become a local */
+static void ipcp_store_constant(struct ipcp_function *function, struct ir_instruction *original, uint32_t constant) {
+	struct ir_instruction *address = ipcp_clone_instruction(original);
+	ir_operand_temporary(address, 0);
+	address->is_used = true;
+	address->offset_variable = NULL;
+
+	struct ir_instruction *value = ir_instruction(IR_CONST_INT);
+	ir_operand_temporary(value, 0);
+	ir_operand_number(value, 1, constant);
+
+	int size = (int)address->operands[4].data.number;
+	struct ir_instruction *store = ir_instruction(
+		1 == size ? IR_STORE_BYTE : 2 == size ? IR_STORE_HALF_WORD : IR_STORE_WORD
+	);
+	ir_operand_copy(store, 0, &address->operands[0]);
+	ir_operand_copy(store, 1, &value->operands[0]);
+
+	struct ir_list *node = ir_insert_after(function->begin, address);
+	node = ir_insert_after(node, value);
+	ir_insert_after(node, store);
+}
+
+static void ipcp_renumber(struct ir_instruction *instruction, struct ipcp_function *function, int *numbers) {
+	if (!ipcp_is_local(instruction)) return;
+
+	for (int p = 0; p < function->parameter_count; p++) {
+		if (function->parameter_ids[p] == (int)instruction->operands[3].data.variable_id) {
+			ir_operand_number(instruction, 5, numbers[p]);
+		}
+	}
+}
+
+static bool ipcp_is_passed_only(int callee, int parameter) {
+	for (int c = 0; c < call_count; c++) {
+		if (callee == calls[c].callee && !calls[c].is_passed[parameter]) return false;
+	}
+	return true;
+}
+
+/*
+ * Drops the parameters every call passes the same constant, which the
+ * function then stores itself, and those it never reads, and moves the
+ * rest down on both sides.
+ */
+static void ipcp_propagate(int callee) {
+	struct ipcp_function *function = &functions[callee];
+	int count = function->parameter_count;
+	bool is_called = false, is_changed = false;
+
+	if (function->is_fixed) return;
+	for (int c = 0; c < call_count; c++) is_called = is_called || callee == calls[c].callee;
+	if (!is_called) return;
+
+	int *numbers = malloc(sizeof(int) * (count + 1));
+	assert(NULL != numbers);
+
+	for (int p = 0, next = 0; p < count; p++) {
+		struct ir_instruction *address = ipcp_find_address(function, function->parameter_ids[p]);
+		bool is_agreed = true;
+		uint32_t constant = 0;
+
+		for (int c = 0, seen = 0; c < call_count && is_agreed; c++) {
+			struct ipcp_call *call = &calls[c];
+			if (callee != call->callee || call->is_passed[p]) continue;
+			is_agreed = call->is_constant[p] && (!seen || constant == call->constants[p]);
+			constant = call->constants[p];
+			seen = 1;
+		}
+
+		/* calls passing the parameter on to itself agree with every constant, but some other call has to pass one */
+		if (is_agreed && NULL != address && !ipcp_is_passed_only(callee, p)) {
+			ipcp_store_constant(function, address, constant);
+			numbers[p] = -1;
+		} else if (NULL != address) {
+			numbers[p] = next++;
+			continue;
+		} else {
+			numbers[p] = -1;
+		}
+		is_changed = true;
+	}
+
+	if (is_changed) {
+		for (struct ir_list *iter = function->begin->next; iter != function->end; iter = iter->next) {
+			ipcp_renumber(iter->data, function, numbers);
+			if (NULL != iter->data->offset_variable) ipcp_renumber(iter->data->offset_variable, function, numbers);
+		}
+
+		for (int c = 0; c < call_count; c++) {
+			if (callee != calls[c].callee) continue;
+			for (int p = 0; p < count; p++) {
+				if (numbers[p] < 0) {
+					ir_unlink(calls[c].parameters[p]);
+				} else {
+					ir_operand_number(calls[c].parameters[p]->data, 0, numbers[p]);
+				}
+			}
+		}
+	}
+	free(numbers);
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+void ipcp_program(void) {
+	growth = 0;
+
+	/* the copies go to the calls first, so the calls of each copy agree on its constant below */
+	ipcp_find_functions();
+	ipcp_find_calls();
+	int original_count = function_count;
+	for (int f = 0; f < original_count; f++) {
+		ipcp_specialize(f);
+	}
+	ipcp_release();
+
+	ipcp_find_functions();
+	ipcp_find_calls();
+	for (int f = 0; f < function_count; f++) {
+		ipcp_propagate(f);
+	}
+	ipcp_release();
+
+	free(addresses);
+	free(labels);
+	addresses = NULL;
+	labels = NULL;
+}
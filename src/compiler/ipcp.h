@@ -0,0 +1,43 @@
+#ifndef _IPCP_H
+#define _IPCP_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+
+/* a constant argument is worth a specialized copy once its calls weigh this much (loops count 8 times per level) */
+#define IPCP_HOT_WEIGHT 8
+/* bodies bigger than this are never copied */
+#define IPCP_MAX_CLONE_SIZE 120
+/* the most instructions the copies may add to the whole program */
+#define IPCP_GROWTH_BUDGET 240
+/* the most specialized copies of one function */
+#define IPCP_MAX_CLONES 2
+
+/*
+ * Interprocedural constant propagation over the calls left after inlining.
+ *
+ *   - A parameter every call passes the same constant (or a local the
+ *     caller only sets to it, an inlined call's argument) becomes a local the
+ *     callee stores that constant into on entry, so constant propagation
+ *     folds it (if (flag) ...), and the calls stop passing it.
+ *   - A parameter the callee never reads isn't passed either.
+ *   - When the calls disagree, the constant a hot group of calls passes
+ *     gets a copy of the callee of its own (_Spec<n>_<name>) that
+ *     those calls go to instead, within IPCP_GROWTH_BUDGET.
+ *   - A recursive call handing a parameter on unchanged agrees with any
+ *     constant, and in a copy calls the copy.
+ *
+ * The remaining parameters are renumbered on both sides, so the a register
+ * and frame slot each one uses move down. main keeps its parameters, and so
+ * does a function with a call whose arguments can't be told apart (f(x = 3)
+ * passes an address). The procedure tables keep the parameters as declared
+ * (a copy shares the table of its original), so this runs after inline and
+ * tailrec, which read them.
+ *
+ * Works on ir_list outside SSA form.
+ */
+void ipcp_program(void);
+
+#endif
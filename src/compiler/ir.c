@@ -67,7 +67,7 @@ static char* ir_update_scope(char *new_scope) {
 	return previous_scope;
 }
 
-static char* ir_create_label_name() {
+char* ir_create_label_name() {
 	char base_label[] = "_GeneratedLabel_";
 	char label_count_char[100];
 	sprintf(label_count_char, "%d", label_count);
@@ -397,6 +397,64 @@ void ir_insert(
 	}
 }
 
+/*
+ * Unlike ir_insert these work directly on list nodes, so optimization passes
+ * that already hold the node don't pay for a walk from the head of ir_list.
+ * The new instruction joins the scope of the code around it so that the
+ * scope based block removal in optimization-2 still sees it.
+ */
+struct ir_list *ir_insert_before(struct ir_list *node, struct ir_instruction *instruction) {
+	assert(NULL != node);
+	assert(NULL != instruction);
+
+	struct ir_list *new_node = ir_list_create(instruction);
+	instruction->scope = node->data->scope;
+
+	new_node->prev = node->prev;
+	new_node->next = node;
+	if (NULL == node->prev) {
+		ir_list = new_node;
+	} else {
+		node->prev->next = new_node;
+	}
+	node->prev = new_node;
+
+	return new_node;
+}
+
+struct ir_list *ir_insert_after(struct ir_list *node, struct ir_instruction *instruction) {
+	assert(NULL != node);
+	assert(NULL != instruction);
+
+	struct ir_list *new_node = ir_list_create(instruction);
+	instruction->scope = node->data->scope;
+
+	new_node->prev = node;
+	new_node->next = node->next;
+	if (NULL != node->next) {
+		node->next->prev = new_node;
+	}
+	node->next = new_node;
+
+	return new_node;
+}
+
+/* removes the node without touching the operands of its neighbours */
+void ir_unlink(struct ir_list *node) {
+	assert(NULL != node);
+
+	if (NULL == node->prev) {
+		ir_list = node->next;
+	} else {
+		node->prev->next = node->next;
+	}
+	if (NULL != node->next) {
+		node->next->prev = node->prev;
+	}
+	node->prev = NULL;
+	node->next = NULL;
+}
+
 /*
  * An IR instruction represents a single 3-address statement.
  */
@@ -413,6 +471,8 @@ struct ir_instruction *ir_instruction(enum ir_instruction_kind kind) {
 	instruction->scope = current_scope;
 	instruction->is_used = true;
 	instruction->offset_variable = NULL;
+	instruction->phi_arguments = NULL;
+	instruction->phi_argument_count = 0;
 
 	return instruction;
 }
@@ -729,6 +789,21 @@ static void ir_generate_for_identifier(struct node *identifier) {
 	identifier->data.identifier.result.ir_operand = &instruction->operands[0];
 }
 
+/* the addressOf of a local the code generator adds, such as a spill slot, kept out of ir_list */
+struct ir_instruction *ir_address_of_local(struct symbol *symbol) {
+	struct ir_instruction *instruction = ir_instruction(IR_ADDRESS_OF);
+	ir_operand_temporary(instruction, 0);
+	ir_operand_string(instruction, 1, symbol->name);
+	ir_operand_bool(instruction, 2, false);
+	ir_operand_variable_id(instruction, 3, symbol->id);
+	ir_operand_size(instruction, 4, type_get_size(symbol->type_tree->type));
+	ir_operand_number(instruction, 5, -1);
+	ir_operand_number(instruction, 6, false);
+	instruction->is_used = false;
+
+	return instruction;
+}
+
 static void ir_generate_for_string(struct node *expression) {
 	assert(NODE_STRING == expression->kind);
 
@@ -736,7 +811,6 @@ static void ir_generate_for_string(struct node *expression) {
 	ir_operand_temporary(instruction, 0);
 	ir_operand_string(instruction, 1, search_string_literal_table(expression->data.string.value));
 	ir_operand_bool(instruction, 2, true);
-	ir_operand_string(instruction, 2, search_string_literal_table(expression->data.string.value));
 	
 	ir_append(expression, instruction);
 	
@@ -919,6 +993,71 @@ static void ir_generate_for_short_circuit_operations(enum node_binary_operation
 	binary_operation->data.binary_operation.result.ir_operand = &instruction_6->operands[0];
 }
 
+/* the && or || a condition comes down to, leaving out the expression statements around it */
+static struct node *ir_get_short_circuit_condition(struct node *condition) {
+	for (;;) {
+		if (NODE_EXPRESSION_STATEMENT == condition->kind) {
+			condition = condition->data.expression_statement.expression;
+		} else if (
+			NODE_EXPRESSION_LIST_STATEMENT == condition->kind &&
+			NULL == condition->data.expression_list_statement.next
+		) {
+			condition = condition->data.expression_list_statement.self;
+		} else {
+			break;
+		}
+	}
+
+	if (NODE_BINARY_OPERATION != condition->kind) return NULL;
+	if (
+		LOGICAL_AND != condition->data.binary_operation.operation &&
+		LOGICAL_OR != condition->data.binary_operation.operation
+	) {
+		return NULL;
+	}
+	return condition;
+}
+
+/*
+ * Jumps to label if the condition is true (or false), otherwise falls
+ * through. && and || become a chain of branches on their operands, without
+ * a 0/1 result. The jumps to label go into the statement's list, so break
+ * finds the loop's exit in it; the labels in between go into the operation's.
+ */
+static void ir_generate_for_branch(struct node *statement, struct node *condition, bool is_jump_if_true, char *label) {
+	struct node *short_circuit = ir_get_short_circuit_condition(condition);
+
+	if (NULL == short_circuit) {
+		ir_generate_for_expression(condition);
+		ir_convert_identifier_to_rval(condition);
+		ir_create_generated_label_instruction(
+			statement, condition,
+			is_jump_if_true ? IR_GOTO_IF_TRUE : IR_GOTO_IF_FALSE, label
+		);
+		return;
+	}
+
+	struct node *left_operand = short_circuit->data.binary_operation.left_operand;
+	struct node *right_operand = short_circuit->data.binary_operation.right_operand;
+	bool is_or = LOGICAL_OR == short_circuit->data.binary_operation.operation;
+
+	/* a && b jumps if false when either is, a || b if true when either is */
+	if (is_or == is_jump_if_true) {
+		ir_generate_for_branch(statement, left_operand, is_jump_if_true, label);
+		ir_generate_for_branch(statement, right_operand, is_jump_if_true, label);
+		return;
+	}
+
+	/* otherwise the left operand decides the other way past the right one */
+	char *right_block_end_label = ir_create_label_name();
+	ir_generate_for_branch(short_circuit, left_operand, is_or, right_block_end_label);
+	ir_generate_for_branch(statement, right_operand, is_jump_if_true, label);
+
+	struct ir_instruction *instruction = ir_instruction(IR_LABEL);
+	ir_operand_string(instruction, 0, right_block_end_label);
+	ir_append(short_circuit, instruction);
+}
+
 static void ir_generate_for_binary_operation(struct node *binary_operation) {
 	assert(NODE_BINARY_OPERATION == binary_operation->kind);
 
@@ -1298,14 +1437,22 @@ static void ir_generate_for_function_call(struct node *function) {
 static void ir_generate_for_conditional_statement(struct node *statement) {
 	assert(NODE_CONDITIONAL_STATEMENT == statement->kind);
 
-	ir_generate_for_expression(statement->data.conditional_statement.condition);
-	
-	// ir_reset_register();
+	char *label;
+	bool is_short_circuit = NULL != ir_get_short_circuit_condition(statement->data.conditional_statement.condition);
+
+	if (is_short_circuit) {
+		label = ir_create_label_name();
+		ir_generate_for_branch(statement, statement->data.conditional_statement.condition, false, label);
+	} else {
+		ir_generate_for_expression(statement->data.conditional_statement.condition);
+
+		// ir_reset_register();
 
-	ir_convert_identifier_to_rval(statement->data.conditional_statement.condition);
+		ir_convert_identifier_to_rval(statement->data.conditional_statement.condition);
 
-	/* goto if false */
-	char *label = ir_create_label_name();
+		/* goto if false */
+		label = ir_create_label_name();
+	}
 
 	/* create another label for the true block - for optimization purposes */
 	char *true_block_label = (char *)malloc(strlen(label) + strlen("_true") + 1);
@@ -1314,10 +1461,12 @@ static void ir_generate_for_conditional_statement(struct node *statement) {
 
 	char* previous_scope = ir_update_scope(true_block_label);
 
-	ir_create_generated_label_instruction(
-		statement, statement->data.conditional_statement.condition,
-		IR_GOTO_IF_FALSE, label
-	);
+	if (!is_short_circuit) {
+		ir_create_generated_label_instruction(
+			statement, statement->data.conditional_statement.condition,
+			IR_GOTO_IF_FALSE, label
+		);
+	}
 
 	/* go inside true block */
 	ir_generate_for_possible_statement(statement->data.conditional_statement.true_block);
@@ -1526,16 +1675,22 @@ static void ir_handle_while_loop(struct node *statement) {
 	ir_operand_string(instruction, 0, loop_block_label);
 	ir_append(statement->data.iterative_statement.expression, instruction);
 
-	ir_generate_for_expression_statement(statement->data.iterative_statement.expression);
+	char *outer_block_label;
+	if (NULL != ir_get_short_circuit_condition(statement->data.iterative_statement.expression)) {
+		outer_block_label = ir_create_label_name();
+		ir_generate_for_branch(statement, statement->data.iterative_statement.expression, false, outer_block_label);
+	} else {
+		ir_generate_for_expression_statement(statement->data.iterative_statement.expression);
 
-	ir_convert_identifier_to_rval(statement->data.iterative_statement.expression);
+		ir_convert_identifier_to_rval(statement->data.iterative_statement.expression);
 
-	/* goto if false */
-	char *outer_block_label = ir_create_label_name();
-	ir_create_generated_label_instruction(
-		statement, statement->data.iterative_statement.expression,
-		IR_GOTO_IF_FALSE, outer_block_label
-	);
+		/* goto if false */
+		outer_block_label = ir_create_label_name();
+		ir_create_generated_label_instruction(
+			statement, statement->data.iterative_statement.expression,
+			IR_GOTO_IF_FALSE, outer_block_label
+		);
+	}
 
 	ir_reset_register();
 
@@ -1574,18 +1729,25 @@ static void ir_handle_do_while_loop(struct node *statement) {
 		ir_generate_for_possible_statement(statement->data.iterative_statement.statement);
 	}
 
-	ir_generate_for_expression_statement(statement->data.iterative_statement.expression);
+	char *outer_block_label;
+	if (NULL != ir_get_short_circuit_condition(statement->data.iterative_statement.expression)) {
+		outer_block_label = ir_create_label_name();
+		ir_generate_for_branch(statement, statement->data.iterative_statement.expression, false, outer_block_label);
+		ir_reset_register();
+	} else {
+		ir_generate_for_expression_statement(statement->data.iterative_statement.expression);
 
-	ir_convert_identifier_to_rval(statement->data.iterative_statement.expression);
+		ir_convert_identifier_to_rval(statement->data.iterative_statement.expression);
 
-	ir_reset_register();
+		ir_reset_register();
 
-	/* goto if false */
-	char *outer_block_label = ir_create_label_name();
-	ir_create_generated_label_instruction(
-		statement, statement->data.iterative_statement.expression,
-		IR_GOTO_IF_FALSE, outer_block_label
-	);
+		/* goto if false */
+		outer_block_label = ir_create_label_name();
+		ir_create_generated_label_instruction(
+			statement, statement->data.iterative_statement.expression,
+			IR_GOTO_IF_FALSE, outer_block_label
+		);
+	}
 
 	
 	/* goto start of loop */
@@ -1621,16 +1783,17 @@ static void ir_handle_for_loop(struct node *statement) {
 
 	/* handle for expression */
 	char *outer_block_label = ir_create_label_name();
-	if (NULL != statement->data.iterative_statement.expression->data.for_expr.condition) {
-		ir_generate_for_expression_statement(statement->data.iterative_statement.expression->data.for_expr.condition);
+	struct node *condition = statement->data.iterative_statement.expression->data.for_expr.condition;
+	if (NULL != condition && NULL != ir_get_short_circuit_condition(condition)) {
+		ir_generate_for_branch(statement, condition, false, outer_block_label);
+		ir_reset_register();
+	} else if (NULL != condition) {
+		ir_generate_for_expression_statement(condition);
 		ir_reset_register();
-		ir_convert_identifier_to_rval(statement->data.iterative_statement.expression->data.for_expr.condition);
+		ir_convert_identifier_to_rval(condition);
 	
 		/* goto if false */
-		ir_create_generated_label_instruction(
-			statement, statement->data.iterative_statement.expression->data.for_expr.condition,
-			IR_GOTO_IF_FALSE, outer_block_label
-		);
+		ir_create_generated_label_instruction(statement, condition, IR_GOTO_IF_FALSE, outer_block_label);
 	}
 
 	/* enter loop body */
@@ -1913,6 +2076,9 @@ void ir_print_opcode(FILE *output, enum ir_instruction_kind kind) {
 		"resultHalfWord",
 		"resultByte",
 		"phi",
+		"copy",
+		"multHighSignedWord",
+		"multHighUnsignedWord",
 		"noOperation",
 		NULL
 	};
@@ -1967,8 +2133,19 @@ void ir_print_instruction(FILE *output, struct ir_instruction *instruction) {
 		case IR_NE_WORD:
 		case IR_BITWISE_AND_WORD:
 		case IR_BITWISE_XOR_WORD:
-		case IR_BITWISE_OR_WORD: 
+		case IR_MULT_HIGH_SIGNED_WORD:
+		case IR_MULT_HIGH_UNSIGNED_WORD:
 		case IR_PHI:
+			if (NULL != instruction->phi_arguments) {
+				ir_print_operand(output, &instruction->operands[0]);
+				for (int i = 0; i < instruction->phi_argument_count; i++) {
+					fprintf(output, ", ");
+					ir_print_operand(output, &instruction->phi_arguments[i]);
+				}
+				break;
+			}
+			/* fall through */
+		case IR_BITWISE_OR_WORD: 
 			ir_print_operand(output, &instruction->operands[0]);
 			fprintf(output, ", ");
 			ir_print_operand(output, &instruction->operands[1]);
@@ -2001,6 +2178,7 @@ void ir_print_instruction(FILE *output, struct ir_instruction *instruction) {
 		case IR_GOTO_IF_FALSE:
 		case IR_GOTO_IF_TRUE:
 		case IR_PARAMETER:
+		case IR_COPY:
 			ir_print_operand(output, &instruction->operands[0]);
 			fprintf(output, ", ");
 			ir_print_operand(output, &instruction->operands[1]);
@@ -2155,3 +2333,180 @@ void ir_mark_constant_as_obselete(int temporary) {
 struct ir_list* ir_get_ir_list() {
 	return ir_list;
 }
+
+/*****************
+ * OPERAND ROLES *
+ *****************/
+
+/*
+ * Returns the operand the instruction writes its result into, or NULL if the
+ * instruction doesn't produce a temporary.
+ */
+struct ir_operand *ir_definition_operand(struct ir_instruction *instruction) {
+	assert(NULL != instruction);
+
+	switch (instruction->kind) {
+		case IR_STORE_WORD:
+		case IR_STORE_HALF_WORD:
+		case IR_STORE_BYTE:
+		case IR_LABEL:
+		case IR_GOTO:
+		case IR_GOTO_IF_FALSE:
+		case IR_GOTO_IF_TRUE:
+		case IR_PROC_BEGIN:
+		case IR_PROC_END:
+		case IR_RETURN_WORD:
+		case IR_RETURN_HALF_WORD:
+		case IR_RETURN_BYTE:
+		case IR_CALL:
+		case IR_SYS_CALL:
+		case IR_PARAMETER:
+		case IR_NO_OPERATION:
+			return NULL;
+		default:
+			if (OPERAND_TEMPORARY != instruction->operands[0].kind) return NULL;
+			return &instruction->operands[0];
+	}
+}
+
+/*
+ * Loads and stores that were given an offset_variable in optimization-1 read
+ * the variable's frame slot directly, so their address temporary isn't used.
+ */
+static bool ir_uses_address_operand(struct ir_instruction *instruction) {
+	return NULL == instruction->offset_variable;
+}
+
+int ir_use_count(struct ir_instruction *instruction) {
+	assert(NULL != instruction);
+
+	switch (instruction->kind) {
+		case IR_LOAD_WORD:
+		case IR_LOAD_HALF_WORD:
+		case IR_LOAD_SIGNED_HALF_WORD:
+		case IR_LOAD_BYTE:
+		case IR_LOAD_SIGNED_BYTE:
+			return ir_uses_address_operand(instruction) ? 1 : 0;
+		case IR_STORE_WORD:
+		case IR_STORE_HALF_WORD:
+		case IR_STORE_BYTE:
+			return ir_uses_address_operand(instruction) ? 2 : 1;
+		case IR_MULT_SIGNED_WORD:
+		case IR_MULT_UNSIGNED_WORD:
+		case IR_DIV_SIGNED_WORD:
+		case IR_DIV_UNSIGNED_WORD:
+		case IR_ADD_SIGNED_WORD:
+		case IR_ADD_UNSIGNED_WORD:
+		case IR_SUB_SIGNED_WORD:
+		case IR_SUB_UNSIGNED_WORD:
+		case IR_REM_SIGNED_WORD:
+		case IR_REM_UNSIGNED_WORD:
+		case IR_LEFT_SHIFT_WORD:
+		case IR_RIGHT_SHIFT_SIGNED_WORD:
+		case IR_RIGHT_SHIFT_UNSIGNED_WORD:
+		case IR_LT_SIGNED_WORD:
+		case IR_LT_UNSIGNED_WORD:
+		case IR_LE_SIGNED_WORD:
+		case IR_LE_UNSIGNED_WORD:
+		case IR_GE_SIGNED_WORD:
+		case IR_GE_UNSIGNED_WORD:
+		case IR_GT_SIGNED_WORD:
+		case IR_GT_UNSIGNED_WORD:
+		case IR_EQ_WORD:
+		case IR_NE_WORD:
+		case IR_BITWISE_AND_WORD:
+		case IR_BITWISE_XOR_WORD:
+		case IR_BITWISE_OR_WORD:
+		case IR_MULT_HIGH_SIGNED_WORD:
+		case IR_MULT_HIGH_UNSIGNED_WORD:
+			return 2;
+		case IR_UNARY_MINUS:
+		case IR_UNARY_LOGICAL_NEGATION:
+		case IR_UNARY_BITWISE_NEGATION:
+		case IR_CAST_WORD_TO_HALF_WORD:
+		case IR_CAST_WORD_TO_BYTE:
+		case IR_CAST_HALF_WORD_TO_BYTE:
+		case IR_CAST_UNSIGNED_HALF_WORD_TO_WORD:
+		case IR_CAST_SIGNED_HALF_WORD_TO_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_SIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_WORD:
+		case IR_CAST_SIGNED_BYTE_TO_WORD:
+		case IR_GOTO_IF_FALSE:
+		case IR_GOTO_IF_TRUE:
+		case IR_RETURN_WORD:
+		case IR_RETURN_HALF_WORD:
+		case IR_RETURN_BYTE:
+		case IR_PARAMETER:
+		case IR_COPY:
+			return 1;
+		case IR_PHI:
+			return NULL != instruction->phi_arguments ? instruction->phi_argument_count : 2;
+		default:
+			return 0;
+	}
+}
+
+struct ir_operand *ir_use_operand(struct ir_instruction *instruction, int index) {
+	assert(index >= 0 && index < ir_use_count(instruction));
+
+	switch (instruction->kind) {
+		case IR_LOAD_WORD:
+		case IR_LOAD_HALF_WORD:
+		case IR_LOAD_SIGNED_HALF_WORD:
+		case IR_LOAD_BYTE:
+		case IR_LOAD_SIGNED_BYTE:
+			return &instruction->operands[1];
+		case IR_STORE_WORD:
+		case IR_STORE_HALF_WORD:
+		case IR_STORE_BYTE:
+			/* operand 0 is the address, operand 1 the value being stored */
+			if (!ir_uses_address_operand(instruction)) return &instruction->operands[1];
+			return &instruction->operands[index];
+		case IR_GOTO_IF_FALSE:
+		case IR_GOTO_IF_TRUE:
+		case IR_RETURN_WORD:
+		case IR_RETURN_HALF_WORD:
+		case IR_RETURN_BYTE:
+			return &instruction->operands[0];
+		case IR_PARAMETER:
+			return &instruction->operands[1];
+		case IR_PHI:
+			if (NULL != instruction->phi_arguments) return &instruction->phi_arguments[index];
+			return &instruction->operands[index + 1];
+		default:
+			return &instruction->operands[index + 1];
+	}
+}
+
+bool ir_is_branch(struct ir_instruction *instruction) {
+	return (
+		IR_GOTO == instruction->kind ||
+		IR_GOTO_IF_FALSE == instruction->kind ||
+		IR_GOTO_IF_TRUE == instruction->kind
+	);
+}
+
+char *ir_branch_target(struct ir_instruction *instruction) {
+	assert(ir_is_branch(instruction));
+
+	if (IR_GOTO == instruction->kind) return instruction->operands[0].data.name;
+	return instruction->operands[1].data.name;
+}
+
+/* compares only the union member the operand's kind says is in use */
+bool ir_operand_equals(struct ir_operand *operand_1, struct ir_operand *operand_2) {
+	if (operand_1->kind != operand_2->kind) return false;
+
+	switch (operand_1->kind) {
+		case OPERAND_TEMPORARY:
+			return operand_1->data.temporary == operand_2->data.temporary;
+		case OPERAND_NUMBER:
+			return operand_1->data.number == operand_2->data.number;
+		case OPERAND_STRING:
+			return 0 == strcmp(operand_1->data.name, operand_2->data.name);
+		case OPERAND_BOOL:
+			return operand_1->data.is_string == operand_2->data.is_string;
+	}
+	return false;
+}
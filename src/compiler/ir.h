@@ -114,6 +114,9 @@ enum ir_instruction_kind {
   IR_RESULT_HALF_WORD,
   IR_RESULT_BYTE,
   IR_PHI,
+  IR_COPY,
+  IR_MULT_HIGH_SIGNED_WORD,      /* upper word of the 64 bit product, for division by constants */
+  IR_MULT_HIGH_UNSIGNED_WORD,
 
 
   IR_NO_OPERATION,     /* 0 */
@@ -126,6 +129,8 @@ struct ir_instruction {
   int position;
   bool is_used;
   struct ir_instruction *offset_variable;      /* for store and load instructions */
+  struct ir_operand *phi_arguments;            /* SSA phis: one argument per cfg predecessor */
+  int phi_argument_count;
 };
 
 struct ir_section {
@@ -145,11 +150,16 @@ void ir_generate_for_expression(struct node *expression);
 void ir_generate_for_number(struct node *number);
 
 struct ir_instruction *ir_instruction(enum ir_instruction_kind kind);
+char* ir_create_label_name();
 void ir_operand_temporary(struct ir_instruction *instruction, int position);
 void ir_operand_copy(struct ir_instruction *instruction, int position, struct ir_operand *operand);
 void ir_operand_number(struct ir_instruction *instruction, int position, signed long number);
+struct ir_instruction *ir_address_of_local(struct symbol *symbol);
 void ir_append(struct node *node, struct ir_instruction *instruction);
 void ir_insert(struct ir_instruction *old_instruction, struct ir_instruction *new_instruction, struct ir_instruction *original_instruction);
+struct ir_list *ir_insert_before(struct ir_list *node, struct ir_instruction *instruction);
+struct ir_list *ir_insert_after(struct ir_list *node, struct ir_instruction *instruction);
+void ir_unlink(struct ir_list *node);
 
 void ir_print_section(FILE *output);
 void ir_print_instruction(FILE *output, struct ir_instruction *instruction);
@@ -169,4 +179,12 @@ void ir_update_constants_map(int key, int value);
 
 /* optimization */
 void ir_mark_constant_as_obselete(int temporary);
+
+/* operand roles */
+struct ir_operand *ir_definition_operand(struct ir_instruction *instruction);
+int ir_use_count(struct ir_instruction *instruction);
+struct ir_operand *ir_use_operand(struct ir_instruction *instruction, int index);
+bool ir_is_branch(struct ir_instruction *instruction);
+char *ir_branch_target(struct ir_instruction *instruction);
+bool ir_operand_equals(struct ir_operand *operand_1, struct ir_operand *operand_2);
 #endif
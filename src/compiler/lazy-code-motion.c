@@ -0,0 +1,671 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "helpers/bit-vector.h"
+#include "lazy-code-motion.h"
+
+extern int next_temporary;
+
+/***************
+ * EXPRESSIONS *
+ ***************/
+
+struct lazy_code_motion_leaf {
+	bool is_constant;
+	uint32_t value;                             /* the constant, or the variable id */
+};
+
+struct lazy_code_motion_expression {
+	enum ir_instruction_kind kind;
+	int leaf_count;
+	struct lazy_code_motion_leaf leaves[2];
+	struct ir_instruction *loads[2];            /* a load of each variable leaf, cloned to reload it */
+	struct ir_instruction *addresses[2];        /* the addressOf it loads from, NULL with an offset_variable */
+	bool deleted;                               /* some computation of it is redundant */
+	int home;                                   /* temporary holding its value */
+};
+
+/* a block in order: an expression is computed, or a variable stored to */
+struct lazy_code_motion_event {
+	struct ir_list *node;
+	int block;
+	int expression;                             /* -1 for a store */
+	int variable;
+	bool upward, downward;                      /* first computation before a store, last one after all stores */
+	bool deleted;
+};
+
+static struct cfg *cfg;
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+static int *definition_counts;
+
+static int max_variable;
+static bool *escapes;
+static int *variable_clocks;                    /* variable -> when it was last stored to */
+
+/* temporary -> the load of a tracked variable that defined it in the block being scanned */
+static int *leaf_blocks;
+static int *leaf_clocks;
+static struct ir_list **leaf_loads;
+
+static struct lazy_code_motion_expression *expressions;
+static int expression_count, expression_capacity;
+static int *table;
+static int table_capacity;
+
+static struct lazy_code_motion_event *events;
+static int event_count, event_capacity;
+
+static bool lazy_code_motion_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static bool lazy_code_motion_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+/* the addressOf a load or store goes through, NULL if it isn't known */
+static struct ir_instruction *lazy_code_motion_address(struct ir_instruction *instruction) {
+	if (NULL != instruction->offset_variable) return instruction->offset_variable;
+
+	struct ir_operand *operand = &instruction->operands[lazy_code_motion_is_store(instruction) ? 0 : 1];
+	if (!lazy_code_motion_is_temporary(operand)) return NULL;
+
+	struct ir_list *definition = temporary_definitions[operand->data.temporary];
+	return NULL != definition && 1 == definition_counts[operand->data.temporary] ? definition->data : NULL;
+}
+
+/* word locals whose address is never taken, only their own stores write them; -1 for the rest */
+static int lazy_code_motion_variable(struct ir_instruction *instruction) {
+	struct ir_instruction *address = lazy_code_motion_address(instruction);
+
+	if (
+		NULL == address ||
+		IR_ADDRESS_OF != address->kind ||
+		address->operands[2].data.is_string ||
+		4 != (int)address->operands[4].data.number ||
+		0 != address->operands[6].data.number
+	) {
+		return -1;
+	}
+
+	int variable = address->operands[3].data.variable_id;
+	return escapes[variable] ? -1 : variable;
+}
+
+static unsigned int lazy_code_motion_hash(struct lazy_code_motion_expression *expression) {
+	unsigned int hash = (unsigned int)expression->kind * 2654435761u;
+	for (int i = 0; i < expression->leaf_count; i++) {
+		hash = (hash ^ (unsigned int)expression->leaves[i].is_constant) * 16777619u;
+		hash = (hash ^ expression->leaves[i].value) * 16777619u;
+	}
+	return hash;
+}
+
+static bool lazy_code_motion_same(struct lazy_code_motion_expression *expression_1, struct lazy_code_motion_expression *expression_2) {
+	if (expression_1->kind != expression_2->kind || expression_1->leaf_count != expression_2->leaf_count) return false;
+	for (int i = 0; i < expression_1->leaf_count; i++) {
+		if (expression_1->leaves[i].is_constant != expression_2->leaves[i].is_constant) return false;
+		if (expression_1->leaves[i].value != expression_2->leaves[i].value) return false;
+	}
+	return true;
+}
+
+static int lazy_code_motion_add_expression(struct lazy_code_motion_expression *expression) {
+	unsigned int slot = lazy_code_motion_hash(expression) & (table_capacity - 1);
+
+	while (-1 != table[slot]) {
+		if (lazy_code_motion_same(&expressions[table[slot]], expression)) return table[slot];
+		slot = (slot + 1) & (table_capacity - 1);
+	}
+
+	if (expression_count == expression_capacity) {
+		expression_capacity = 0 == expression_capacity ? 16 : expression_capacity * 2;
+		expressions = realloc(expressions, sizeof(struct lazy_code_motion_expression) * expression_capacity);
+		assert(NULL != expressions);
+	}
+	expressions[expression_count] = *expression;
+	table[slot] = expression_count;
+	return expression_count++;
+}
+
+static void lazy_code_motion_add_event(struct ir_list *node, int block, int expression, int variable) {
+	if (event_count == event_capacity) {
+		event_capacity = 0 == event_capacity ? 64 : event_capacity * 2;
+		events = realloc(events, sizeof(struct lazy_code_motion_event) * event_capacity);
+		assert(NULL != events);
+	}
+	struct lazy_code_motion_event *event = &events[event_count++];
+	memset(event, 0, sizeof(struct lazy_code_motion_event));
+	event->node = node;
+	event->block = block;
+	event->expression = expression;
+	event->variable = variable;
+}
+
+/*
+ * A leaf is a word load of a tracked variable made earlier in the block with
+ * no store to the variable since, or a constant. Constants optimization 1
+ * turned into immediates are only left in the constants map.
+ */
+static bool lazy_code_motion_leaf(
+	struct ir_operand *operand, int block,
+	struct lazy_code_motion_leaf *leaf, struct ir_instruction **load, struct ir_instruction **address
+) {
+	if (!lazy_code_motion_is_temporary(operand)) return false;
+
+	int temporary = operand->data.temporary;
+	struct ir_list *definition = temporary_definitions[temporary];
+
+	if (leaf_blocks[temporary] == block) {
+		struct ir_instruction *instruction = leaf_loads[temporary]->data;
+		int variable = lazy_code_motion_variable(instruction);
+		if (leaf_clocks[temporary] <= variable_clocks[variable]) return false;
+
+		leaf->is_constant = false;
+		leaf->value = (uint32_t)variable;
+		*load = instruction;
+		*address = NULL != instruction->offset_variable ? NULL : lazy_code_motion_address(instruction);
+		return true;
+	}
+
+	if (NULL != definition && 1 == definition_counts[temporary] && IR_CONST_INT == definition->data->kind) {
+		leaf->is_constant = true;
+		leaf->value = (uint32_t)definition->data->operands[1].data.number;
+		return true;
+	}
+	if (NULL == definition && NULL != ir_get_const_map_entry(temporary)) {
+		leaf->is_constant = true;
+		leaf->value = (uint32_t)strtol(ir_get_const_map_entry(temporary), NULL, 10);
+		return true;
+	}
+	return false;
+}
+
+/* records the computations and stores of every reachable block, numbering the expressions */
+static void lazy_code_motion_scan(void) {
+	int clock = 0;
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (block->reverse_postorder < 0) continue;
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *definition = ir_definition_operand(instruction);
+			int use_count = ir_use_count(instruction);
+
+			clock++;
+			if (lazy_code_motion_is_store(instruction)) {
+				int variable = lazy_code_motion_variable(instruction);
+				if (variable >= 0) {
+					variable_clocks[variable] = clock;
+					lazy_code_motion_add_event(iter, b, -1, variable);
+				}
+			} else if (
+				dataflow_is_expression(instruction) && use_count >= 1 && use_count <= 2 &&
+				NULL != definition && lazy_code_motion_is_temporary(definition)
+			) {
+				struct lazy_code_motion_expression expression;
+				bool is_occurrence = true;
+
+				memset(&expression, 0, sizeof(struct lazy_code_motion_expression));
+				expression.kind = instruction->kind;
+				expression.leaf_count = use_count;
+				for (int i = 0; i < use_count && is_occurrence; i++) {
+					is_occurrence = lazy_code_motion_leaf(
+						ir_use_operand(instruction, i), b,
+						&expression.leaves[i], &expression.loads[i], &expression.addresses[i]
+					);
+				}
+
+				if (is_occurrence) {
+					lazy_code_motion_add_event(iter, b, lazy_code_motion_add_expression(&expression), -1);
+				}
+			}
+
+			if (NULL != definition && lazy_code_motion_is_temporary(definition)) {
+				int temporary = definition->data.temporary;
+				leaf_blocks[temporary] = -1;
+				if (IR_LOAD_WORD == instruction->kind && lazy_code_motion_variable(instruction) >= 0) {
+					leaf_blocks[temporary] = b;
+					leaf_clocks[temporary] = clock;
+					leaf_loads[temporary] = iter;
+				}
+			}
+
+			if (iter == block->last) break;
+		}
+	}
+}
+
+/****************
+ * LOCAL SETS *
+ ****************/
+
+static struct bit_vector **antloc, **comp, **transp;
+
+/* the blocks before the rewrite, which splits edges and adds more */
+static int block_count;
+
+static struct bit_vector **lazy_code_motion_create_vectors(bool set) {
+	struct bit_vector **vectors = malloc(sizeof(struct bit_vector *) * block_count);
+	assert(NULL != vectors);
+	for (int b = 0; b < block_count; b++) {
+		vectors[b] = bit_vector_create(expression_count);
+		if (set) bit_vector_set_all(vectors[b]);
+	}
+	return vectors;
+}
+
+static void lazy_code_motion_free_vectors(struct bit_vector **vectors) {
+	for (int b = 0; b < block_count; b++) bit_vector_free(vectors[b]);
+	free(vectors);
+}
+
+/*
+ * antloc: computed before any store to its variables (upward exposed)
+ * comp: computed after the last store to its variables (downward exposed)
+ * transp: none of its variables is stored to
+ */
+static void lazy_code_motion_local_sets(void) {
+	int *last_events = malloc(sizeof(int) * expression_count);
+	assert(NULL != last_events);
+
+	antloc = lazy_code_motion_create_vectors(false);
+	comp = lazy_code_motion_create_vectors(false);
+	transp = lazy_code_motion_create_vectors(true);
+	struct bit_vector *killed = bit_vector_create(expression_count);
+
+	for (int first = 0, last; first < event_count; first = last) {
+		int b = events[first].block;
+		for (last = first; last < event_count && events[last].block == b; last++);
+
+		bit_vector_clear_all(killed);
+		for (int i = first; i < last; i++) {
+			struct lazy_code_motion_event *event = &events[i];
+			int e = event->expression;
+
+			if (e >= 0) {
+				if (!bit_vector_test(killed, e) && !bit_vector_test(antloc[b], e)) {
+					bit_vector_set(antloc[b], e);
+					event->upward = true;
+				}
+				bit_vector_set(comp[b], e);
+				last_events[e] = i;
+				continue;
+			}
+
+			for (e = 0; e < expression_count; e++) {
+				struct lazy_code_motion_expression *expression = &expressions[e];
+				for (int l = 0; l < expression->leaf_count; l++) {
+					if (expression->leaves[l].is_constant || (int)expression->leaves[l].value != event->variable) continue;
+					bit_vector_set(killed, e);
+					bit_vector_clear(transp[b], e);
+					bit_vector_clear(comp[b], e);
+				}
+			}
+		}
+
+		for (int e = bit_vector_next(comp[b], 0); e >= 0; e = bit_vector_next(comp[b], e + 1)) {
+			events[last_events[e]].downward = true;
+		}
+	}
+
+	bit_vector_free(killed);
+	free(last_events);
+}
+
+/*************
+ * PLACEMENT *
+ *************/
+
+static struct dataflow *anticipated, *available;
+static struct bit_vector **later_in;
+
+/* earliest(i, j) = antin(j) - avout(i) - (transp(i) & antout(i)) */
+static void lazy_code_motion_earliest(struct cfg_block *from, struct cfg_block *to, struct bit_vector *result, struct bit_vector *scratch) {
+	bit_vector_copy(result, anticipated->in[to->id]);
+	bit_vector_subtract(result, available->out[from->id]);
+	bit_vector_copy(scratch, transp[from->id]);
+	bit_vector_intersect(scratch, anticipated->out[from->id]);
+	bit_vector_subtract(result, scratch);
+}
+
+/* later(i, j) = earliest(i, j) | (laterin(i) - antloc(i)) */
+static void lazy_code_motion_later(struct cfg_block *from, struct cfg_block *to, struct bit_vector *result, struct bit_vector *scratch) {
+	lazy_code_motion_earliest(from, to, result, scratch);
+	bit_vector_copy(scratch, later_in[from->id]);
+	bit_vector_subtract(scratch, antloc[from->id]);
+	bit_vector_union(result, scratch);
+}
+
+/* insert(i, j) = later(i, j) - laterin(j) */
+static void lazy_code_motion_insert(struct cfg_block *from, struct cfg_block *to, struct bit_vector *result, struct bit_vector *scratch) {
+	lazy_code_motion_later(from, to, result, scratch);
+	bit_vector_subtract(result, later_in[to->id]);
+}
+
+static void lazy_code_motion_solve(void) {
+	anticipated = dataflow_create(cfg, expression_count, DATAFLOW_BACKWARD, DATAFLOW_INTERSECTION);
+	available = dataflow_create(cfg, expression_count, DATAFLOW_FORWARD, DATAFLOW_INTERSECTION);
+	for (int b = 0; b < cfg->block_count; b++) {
+		bit_vector_copy(anticipated->gen[b], antloc[b]);
+		bit_vector_copy(available->gen[b], comp[b]);
+		bit_vector_set_all(anticipated->kill[b]);
+		bit_vector_subtract(anticipated->kill[b], transp[b]);
+		bit_vector_copy(available->kill[b], anticipated->kill[b]);
+	}
+	dataflow_solve(anticipated);
+	dataflow_solve(available);
+
+	/* laterin(j) = the meet of later(i, j) over the predecessors, antin(entry) at the entry */
+	later_in = lazy_code_motion_create_vectors(true);
+	bit_vector_copy(later_in[0], anticipated->in[0]);
+
+	struct bit_vector *meet = bit_vector_create(expression_count);
+	struct bit_vector *later = bit_vector_create(expression_count);
+	struct bit_vector *scratch = bit_vector_create(expression_count);
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int r = 1; r < cfg->reachable_count; r++) {
+			struct cfg_block *block = cfg->reverse_postorder[r];
+
+			bit_vector_set_all(meet);
+			for (int p = 0; p < block->predecessor_count; p++) {
+				struct cfg_block *predecessor = block->predecessors[p];
+				if (predecessor->reverse_postorder < 0) continue;
+				lazy_code_motion_later(predecessor, block, later, scratch);
+				bit_vector_intersect(meet, later);
+			}
+			if (!bit_vector_equals(meet, later_in[block->id])) {
+				bit_vector_copy(later_in[block->id], meet);
+				changed = true;
+			}
+		}
+	}
+
+	bit_vector_free(meet);
+	bit_vector_free(later);
+	bit_vector_free(scratch);
+}
+
+/***********
+ * REWRITE *
+ ***********/
+
+/* delete(k) = antloc(k) - laterin(k): those computations read the home instead */
+static bool lazy_code_motion_mark_deletions(void) {
+	bool found = false;
+
+	for (int i = 0; i < event_count; i++) {
+		struct lazy_code_motion_event *event = &events[i];
+		if (!event->upward || bit_vector_test(later_in[event->block], event->expression)) continue;
+
+		event->deleted = true;
+		expressions[event->expression].deleted = true;
+		found = true;
+	}
+	return found;
+}
+
+/*
+ * The home is needed at the end of a block if a deleted computation reads
+ * it further on before anything writes it again:
+ * used_out(b) = union over s of used_in(s) - insert(b, s)
+ * used_in(b) = delete(b) | (used_out(b) - comp(b))
+ */
+static struct bit_vector **lazy_code_motion_used_out(void) {
+	struct bit_vector **used_in = lazy_code_motion_create_vectors(false);
+	struct bit_vector **used_out = lazy_code_motion_create_vectors(false);
+	struct bit_vector *insert = bit_vector_create(expression_count);
+	struct bit_vector *scratch = bit_vector_create(expression_count);
+	struct bit_vector *vector = bit_vector_create(expression_count);
+
+	for (int i = 0; i < event_count; i++) {
+		if (events[i].deleted) bit_vector_set(used_in[events[i].block], events[i].expression);
+	}
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int r = cfg->reachable_count - 1; r >= 0; r--) {
+			struct cfg_block *block = cfg->reverse_postorder[r];
+
+			bit_vector_clear_all(vector);
+			for (int s = 0; s < block->successor_count; s++) {
+				lazy_code_motion_insert(block, block->successors[s], insert, scratch);
+				bit_vector_copy(scratch, used_in[block->successors[s]->id]);
+				bit_vector_subtract(scratch, insert);
+				bit_vector_union(vector, scratch);
+			}
+			if (!bit_vector_equals(vector, used_out[block->id])) {
+				bit_vector_copy(used_out[block->id], vector);
+				changed = true;
+			}
+
+			bit_vector_subtract(vector, comp[block->id]);
+			changed = bit_vector_union(used_in[block->id], vector) || changed;
+		}
+	}
+
+	lazy_code_motion_free_vectors(used_in);
+	bit_vector_free(insert);
+	bit_vector_free(scratch);
+	bit_vector_free(vector);
+	return used_out;
+}
+
+static struct ir_instruction *lazy_code_motion_clone(struct ir_instruction *original) {
+	struct ir_instruction *instruction = ir_instruction(original->kind);
+	memcpy(instruction->operands, original->operands, sizeof(instruction->operands));
+	instruction->offset_variable = original->offset_variable;
+	ir_operand_temporary(instruction, 0);
+	return instruction;
+}
+
+/* computes the expression into its home right before the anchor */
+static void lazy_code_motion_compute(struct ir_list *anchor, struct lazy_code_motion_expression *expression) {
+	struct ir_instruction *computation = ir_instruction(expression->kind);
+
+	computation->operands[0].kind = OPERAND_TEMPORARY;
+	computation->operands[0].data.temporary = expression->home;
+
+	for (int l = 0; l < expression->leaf_count; l++) {
+		struct ir_instruction *leaf;
+
+		if (expression->leaves[l].is_constant) {
+			leaf = ir_instruction(IR_CONST_INT);
+			ir_operand_temporary(leaf, 0);
+			ir_operand_number(leaf, 1, expression->leaves[l].value);
+		} else {
+			leaf = lazy_code_motion_clone(expression->loads[l]);
+			if (NULL != expression->addresses[l]) {
+				struct ir_instruction *address = lazy_code_motion_clone(expression->addresses[l]);
+				ir_insert_before(anchor, address);
+				ir_operand_copy(leaf, 1, &address->operands[0]);
+			}
+		}
+		ir_insert_before(anchor, leaf);
+		ir_operand_copy(computation, l + 1, &leaf->operands[0]);
+	}
+
+	ir_insert_before(anchor, computation);
+}
+
+/* where code placed on the edge goes (right before the returned node), splitting it if it's critical */
+static struct ir_list *lazy_code_motion_edge_anchor(struct cfg_block *from, struct cfg_block *to) {
+	if (1 == from->successor_count) {
+		return ir_is_branch(from->last->data) ? from->last : from->last->next;
+	}
+	if (1 == to->predecessor_count) {
+		return IR_LABEL == to->first->data->kind ? to->first->next : to->first;
+	}
+
+	struct cfg_block *block = cfg_split_edge(cfg, from, to);
+	return block->first->next;
+}
+
+static void lazy_code_motion_rewrite(void) {
+	for (int e = 0; e < expression_count; e++) {
+		if (expressions[e].deleted) expressions[e].home = next_temporary++;
+	}
+
+	/* downward computations keep the home up to date where it's read later */
+	struct bit_vector **used_out = lazy_code_motion_used_out();
+	for (int i = 0; i < event_count; i++) {
+		struct lazy_code_motion_event *event = &events[i];
+		if (!event->downward || event->deleted || !bit_vector_test(used_out[event->block], event->expression)) continue;
+
+		struct ir_instruction *copy = ir_instruction(IR_COPY);
+		copy->operands[0].kind = OPERAND_TEMPORARY;
+		copy->operands[0].data.temporary = expressions[event->expression].home;
+		ir_operand_copy(copy, 1, &event->node->data->operands[0]);
+		ir_insert_after(event->node, copy);
+	}
+	lazy_code_motion_free_vectors(used_out);
+
+	for (int i = 0; i < event_count; i++) {
+		struct lazy_code_motion_event *event = &events[i];
+		if (!event->deleted) continue;
+
+		struct ir_instruction *instruction = event->node->data;
+		instruction->kind = IR_COPY;
+		instruction->operands[1].kind = OPERAND_TEMPORARY;
+		instruction->operands[1].data.temporary = expressions[event->expression].home;
+	}
+
+	/* the insertions, edges are collected first since splitting one adds blocks */
+	struct bit_vector *insert = bit_vector_create(expression_count);
+	struct bit_vector *scratch = bit_vector_create(expression_count);
+	struct cfg_block **edges = NULL;
+	int edge_count = 0;
+
+	for (int r = 0; r < cfg->reachable_count; r++) {
+		struct cfg_block *block = cfg->reverse_postorder[r];
+		for (int s = 0; s < block->successor_count; s++) {
+			lazy_code_motion_insert(block, block->successors[s], insert, scratch);
+			if (bit_vector_next(insert, 0) < 0) continue;
+
+			edges = realloc(edges, sizeof(struct cfg_block *) * 2 * (edge_count + 1));
+			assert(NULL != edges);
+			edges[2 * edge_count] = block;
+			edges[2 * edge_count + 1] = block->successors[s];
+			edge_count++;
+		}
+	}
+
+	for (int i = 0; i < edge_count; i++) {
+		struct cfg_block *from = edges[2 * i], *to = edges[2 * i + 1];
+		struct ir_list *anchor = NULL;
+
+		lazy_code_motion_insert(from, to, insert, scratch);
+		for (int e = bit_vector_next(insert, 0); e >= 0; e = bit_vector_next(insert, e + 1)) {
+			if (!expressions[e].deleted) continue;
+			if (NULL == anchor) anchor = lazy_code_motion_edge_anchor(from, to);
+			lazy_code_motion_compute(anchor, &expressions[e]);
+		}
+	}
+
+	free(edges);
+	bit_vector_free(insert);
+	bit_vector_free(scratch);
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+static void lazy_code_motion(struct cfg *function) {
+	struct ir_list *iter;
+
+	cfg = function;
+	max_temporary = dataflow_max_temporary(cfg);
+	temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+	definition_counts = calloc(max_temporary + 1, sizeof(int));
+	leaf_blocks = malloc(sizeof(int) * (max_temporary + 1));
+	leaf_clocks = calloc(max_temporary + 1, sizeof(int));
+	leaf_loads = calloc(max_temporary + 1, sizeof(struct ir_list *));
+	assert(NULL != definition_counts && NULL != leaf_blocks && NULL != leaf_clocks && NULL != leaf_loads);
+	for (int t = 0; t <= max_temporary; t++) leaf_blocks[t] = -1;
+
+	int instruction_count = 0;
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL != definition && lazy_code_motion_is_temporary(definition)) {
+			definition_counts[definition->data.temporary]++;
+		}
+		instruction_count++;
+		if (iter == cfg->proc_end) break;
+	}
+
+	escapes = dataflow_escaping_variables(cfg, temporary_definitions, &max_variable);
+	variable_clocks = calloc(max_variable + 1, sizeof(int));
+	assert(NULL != variable_clocks);
+
+	table_capacity = 16;
+	while (table_capacity < instruction_count * 2) table_capacity *= 2;
+	table = malloc(sizeof(int) * table_capacity);
+	assert(NULL != table);
+	for (int slot = 0; slot < table_capacity; slot++) table[slot] = -1;
+
+	expression_count = 0;
+	event_count = 0;
+	lazy_code_motion_scan();
+
+	if (expression_count > 0) {
+		block_count = cfg->block_count;
+		lazy_code_motion_local_sets();
+		lazy_code_motion_solve();
+
+		if (lazy_code_motion_mark_deletions()) {
+			lazy_code_motion_rewrite();
+		}
+
+		lazy_code_motion_free_vectors(antloc);
+		lazy_code_motion_free_vectors(comp);
+		lazy_code_motion_free_vectors(transp);
+		lazy_code_motion_free_vectors(later_in);
+		dataflow_destroy(anticipated);
+		dataflow_destroy(available);
+	}
+
+	free(temporary_definitions);
+	free(definition_counts);
+	free(leaf_blocks);
+	free(leaf_clocks);
+	free(leaf_loads);
+	free(escapes);
+	free(variable_clocks);
+	free(table);
+	free(expressions);
+	free(events);
+	expressions = NULL;
+	events = NULL;
+	expression_capacity = 0;
+	event_capacity = 0;
+}
+
+void lazy_code_motion_program(void) {
+	struct cfg *cfgs = cfg_build_program();
+
+	for (struct cfg *function = cfgs; NULL != function; function = function->next) {
+		lazy_code_motion(function);
+	}
+
+	cfg_destroy_program(cfgs);
+}
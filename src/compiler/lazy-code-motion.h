@@ -0,0 +1,24 @@
+#ifndef _LAZY_CODE_MOTION_H
+#define _LAZY_CODE_MOTION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Partial redundancy elimination by lazy code motion (Knoop, Rüthing and
+ * Steffen, in the edge based form of Drechsler and Stadel). An expression
+ * is an opcode applied to constants and word locals whose address is never
+ * taken, like x * y or i + 1, so it is killed exactly by the stores to those
+ * locals. Every expression ends up computed at most once along any path, as
+ * late as possible, and no path computes it more often than before.
+ * Computations made redundant read the expression's home temporary instead.
+ *
+ * Works on ir_list outside SSA form, since the home is written on several
+ * paths.
+ */
+void lazy_code_motion_program(void);
+
+#endif
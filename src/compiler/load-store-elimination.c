@@ -0,0 +1,266 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "alias-analysis.h"
+#include "load-store-elimination.h"
+
+/* a value some temporary holds of a location, read by a load or written by a word store */
+struct load_store_elimination_value {
+	struct alias_location location;
+	enum ir_instruction_kind kind;          /* the load it saves */
+	int temporary;
+};
+
+/* a store nothing has read yet */
+struct load_store_elimination_store {
+	struct alias_location location;
+	struct ir_list *node;
+};
+
+static struct alias_analysis *analysis;
+static struct cfg_block *block;
+
+static struct load_store_elimination_value *values;
+static int value_count, value_capacity;
+
+static struct load_store_elimination_store *stores;
+static int store_count, store_capacity;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool load_store_elimination_is_load(struct ir_instruction *instruction) {
+	return (
+		IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind
+	);
+}
+
+static bool load_store_elimination_is_call(struct ir_instruction *instruction) {
+	return IR_CALL == instruction->kind || IR_SYS_CALL == instruction->kind;
+}
+
+/* a temporary that is really in a register: constants optimization 1 folded away aren't */
+static bool load_store_elimination_is_held(struct ir_operand *operand) {
+	if (OPERAND_TEMPORARY != operand->kind || operand->data.temporary > analysis->max_temporary) return false;
+
+	int temporary = operand->data.temporary;
+	if (1 != analysis->definition_counts[temporary]) return false;
+	return analysis->temporary_definitions[temporary]->data->is_used;
+}
+
+/* nodes at the edge of a block stay where they are, the cfg refers to them */
+static bool load_store_elimination_remove(struct ir_list *node) {
+	if (node == block->first || node == block->last) return false;
+	ir_unlink(node);
+	return true;
+}
+
+/**********
+ * TABLES *
+ **********/
+
+static void load_store_elimination_add_value(struct alias_location *location, enum ir_instruction_kind kind, int temporary) {
+	if (value_count == value_capacity) {
+		value_capacity = 0 == value_capacity ? 16 : value_capacity * 2;
+		values = realloc(values, sizeof(struct load_store_elimination_value) * value_capacity);
+		assert(NULL != values);
+	}
+	values[value_count].location = *location;
+	values[value_count].kind = kind;
+	values[value_count].temporary = temporary;
+	value_count++;
+}
+
+static void load_store_elimination_add_store(struct alias_location *location, struct ir_list *node) {
+	if (store_count == store_capacity) {
+		store_capacity = 0 == store_capacity ? 16 : store_capacity * 2;
+		stores = realloc(stores, sizeof(struct load_store_elimination_store) * store_capacity);
+		assert(NULL != stores);
+	}
+	stores[store_count].location = *location;
+	stores[store_count].node = node;
+	store_count++;
+}
+
+/* forgets the values a write to the location may change (all that can be reached from outside for NULL) */
+static void load_store_elimination_forget_values(struct alias_location *location) {
+	int kept = 0;
+	for (int i = 0; i < value_count; i++) {
+		bool is_changed = NULL == location ?
+			!alias_is_private(analysis, &values[i].location) :
+			alias_may_alias(analysis, &values[i].location, location);
+		if (!is_changed) values[kept++] = values[i];
+	}
+	value_count = kept;
+}
+
+/* the stores a read of the location may see are needed (all that can be reached from outside for NULL) */
+static void load_store_elimination_read_stores(struct alias_location *location) {
+	int kept = 0;
+	for (int i = 0; i < store_count; i++) {
+		bool is_read = NULL == location ?
+			!alias_is_private(analysis, &stores[i].location) :
+			alias_may_alias(analysis, &stores[i].location, location);
+		if (!is_read) stores[kept++] = stores[i];
+	}
+	store_count = kept;
+}
+
+/*********
+ * BLOCK *
+ *********/
+
+static void load_store_elimination_load(struct ir_instruction *instruction, struct alias_location *location) {
+	for (int i = 0; i < value_count; i++) {
+		if (values[i].kind != instruction->kind || !alias_must_alias(&values[i].location, location)) continue;
+
+		/* the memory isn't read any more, so the stores before stay unread */
+		instruction->kind = IR_COPY;
+		instruction->operands[1].kind = OPERAND_TEMPORARY;
+		instruction->operands[1].data.temporary = values[i].temporary;
+		instruction->offset_variable = NULL;
+		return;
+	}
+
+	load_store_elimination_read_stores(location);
+	load_store_elimination_add_value(location, instruction->kind, instruction->operands[0].data.temporary);
+}
+
+static void load_store_elimination_store(struct ir_list *node, struct alias_location *location) {
+	struct ir_instruction *instruction = node->data;
+
+	/* written again before anything could read it */
+	int kept = 0;
+	for (int i = 0; i < store_count; i++) {
+		if (alias_must_alias(&stores[i].location, location) && load_store_elimination_remove(stores[i].node)) continue;
+		stores[kept++] = stores[i];
+	}
+	store_count = kept;
+
+	load_store_elimination_forget_values(location);
+	if (IR_STORE_WORD == instruction->kind && load_store_elimination_is_held(&instruction->operands[1])) {
+		load_store_elimination_add_value(location, IR_LOAD_WORD, instruction->operands[1].data.temporary);
+	}
+	load_store_elimination_add_store(location, node);
+}
+
+static void load_store_elimination_block(void) {
+	struct ir_list *iter, *next;
+
+	value_count = 0;
+	store_count = 0;
+
+	for (iter = block->first; ; iter = next) {
+		struct ir_instruction *instruction = iter->data;
+		bool is_last = iter == block->last;
+		struct alias_location location;
+
+		next = iter->next;
+		if (alias_location(analysis, instruction, &location)) {
+			if (load_store_elimination_is_load(instruction)) {
+				load_store_elimination_load(instruction, &location);
+			} else {
+				load_store_elimination_store(iter, &location);
+			}
+		} else if (load_store_elimination_is_call(instruction)) {
+			load_store_elimination_forget_values(NULL);
+			load_store_elimination_read_stores(NULL);
+		}
+
+		if (is_last) break;
+	}
+}
+
+/***************
+ * DEAD STORES *
+ ***************/
+
+/*
+ * Nothing but the function's own loads can read a private local, so a
+ * store to one that no load can follow is dead. Liveness of the locals,
+ * with a load reading the whole variable and no store killing it.
+ */
+static void load_store_elimination_dead_stores(struct cfg *cfg) {
+	struct dataflow *liveness = dataflow_create(cfg, analysis->max_variable + 1, DATAFLOW_BACKWARD, DATAFLOW_UNION);
+	struct alias_location location;
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		for (struct ir_list *iter = cfg->blocks[b]->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			if (
+				load_store_elimination_is_load(instruction) &&
+				alias_location(analysis, instruction, &location) &&
+				alias_is_private(analysis, &location)
+			) {
+				bit_vector_set(liveness->gen[b], location.base);
+			}
+			if (iter == cfg->blocks[b]->last) break;
+		}
+	}
+	dataflow_solve(liveness);
+
+	struct bit_vector *live = bit_vector_create(analysis->max_variable + 1);
+	for (int b = 0; b < cfg->block_count; b++) {
+		block = cfg->blocks[b];
+		bit_vector_copy(live, liveness->out[b]);
+
+		for (struct ir_list *iter = block->last, *previous; ; iter = previous) {
+			struct ir_instruction *instruction = iter->data;
+			bool is_first = iter == block->first;
+
+			previous = iter->prev;
+			if (alias_location(analysis, instruction, &location) && alias_is_private(analysis, &location)) {
+				if (load_store_elimination_is_load(instruction)) {
+					bit_vector_set(live, location.base);
+				} else if (!bit_vector_test(live, location.base)) {
+					load_store_elimination_remove(iter);
+				}
+			}
+			if (is_first) break;
+		}
+	}
+
+	bit_vector_free(live);
+	dataflow_destroy(liveness);
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+void load_store_elimination(struct cfg *cfg) {
+	analysis = alias_analysis_create(cfg);
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		block = cfg->blocks[b];
+		load_store_elimination_block();
+	}
+	load_store_elimination_dead_stores(cfg);
+
+	alias_analysis_destroy(analysis);
+	analysis = NULL;
+}
+
+void load_store_elimination_program(struct cfg *cfgs) {
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		load_store_elimination(cfg);
+	}
+
+	free(values);
+	free(stores);
+	values = NULL;
+	stores = NULL;
+	value_capacity = 0;
+	store_capacity = 0;
+}
@@ -0,0 +1,25 @@
+#ifndef _LOAD_STORE_ELIMINATION_H
+#define _LOAD_STORE_ELIMINATION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Redundant load and dead store elimination on top of alias-analysis.c.
+ * Within a basic block a load of a location that an earlier word store
+ * wrote, or an earlier load of the same kind read, with no store that may
+ * alias it or call in between, becomes a copy of that value (store to load
+ * forwarding). A store overwritten by a store to exactly the same bytes
+ * before anything that may read them goes, and so does a store to a local
+ * whose address doesn't escape when no load of that local can follow.
+ *
+ * Works on a function in SSA form, where the value a store wrote is still
+ * in its temporary wherever the store is.
+ */
+void load_store_elimination(struct cfg *cfg);
+void load_store_elimination_program(struct cfg *cfgs);
+
+#endif
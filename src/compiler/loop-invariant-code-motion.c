@@ -0,0 +1,322 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "dataflow.h"
+#include "loop-invariant-code-motion.h"
+
+/*
+ * Everything hoisted out of a loop holds a register through all of it, and
+ * what doesn't fit gets spilled to the stack.
+ */
+#define LOOP_INVARIANT_MAX_HOISTED 6
+
+/* how much already left the loop with this header, across cfg rebuilds */
+struct loop_invariant_budget {
+	struct ir_list *header;                 /* the label starting the header */
+	int hoisted;
+};
+
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+
+static int max_variable;
+static bool *escapes;                           /* variable -> pointer stores and calls may write it */
+
+static struct loop_invariant_budget *budgets;
+static int budget_count;
+
+/*********
+ * LOOPS *
+ *********/
+
+/* what the body of a loop may write */
+struct loop_invariant_memory {
+	bool *stored;                           /* variable -> stored to by name */
+	bool has_pointer_store;
+	bool has_call;
+};
+
+static bool loop_invariant_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static bool loop_invariant_is_load(struct ir_instruction *instruction) {
+	return (
+		IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind
+	);
+}
+
+static bool loop_invariant_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+/* the addressOf a load or store goes through, NULL for pointers */
+static struct ir_instruction *loop_invariant_address(struct ir_instruction *instruction) {
+	struct ir_instruction *address = instruction->offset_variable;
+
+	if (NULL == address) {
+		struct ir_operand *operand = &instruction->operands[loop_invariant_is_store(instruction) ? 0 : 1];
+		if (!loop_invariant_is_temporary(operand)) return NULL;
+
+		struct ir_list *definition = temporary_definitions[operand->data.temporary];
+		if (NULL == definition) return NULL;
+		address = definition->data;
+	}
+
+	if (IR_ADDRESS_OF != address->kind || address->operands[2].data.is_string) return NULL;
+	return address;
+}
+
+static void loop_invariant_scan_memory(struct cfg *cfg, struct cfg_loop *loop, struct loop_invariant_memory *memory) {
+	memory->stored = calloc(max_variable + 1, sizeof(bool));
+	assert(NULL != memory->stored);
+	memory->has_pointer_store = false;
+	memory->has_call = false;
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!loop->body[block->id]) continue;
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+
+			if (loop_invariant_is_store(instruction)) {
+				struct ir_instruction *address = loop_invariant_address(instruction);
+				if (NULL == address) {
+					memory->has_pointer_store = true;
+				} else {
+					memory->stored[address->operands[3].data.variable_id] = true;
+				}
+			} else if (IR_CALL == instruction->kind || IR_SYS_CALL == instruction->kind) {
+				memory->has_call = true;
+			}
+			if (iter == block->last) break;
+		}
+	}
+}
+
+/* the operation itself gives the same result anywhere and never traps */
+static bool loop_invariant_is_hoistable(struct ir_instruction *instruction, struct loop_invariant_memory *memory) {
+	if (loop_invariant_is_load(instruction)) {
+		struct ir_instruction *address = loop_invariant_address(instruction);
+		if (NULL == address) return false;
+
+		int variable = address->operands[3].data.variable_id;
+		if (memory->stored[variable]) return false;
+		if (escapes[variable] || 0 != address->operands[6].data.number) {
+			return !memory->has_pointer_store && !memory->has_call;
+		}
+		return true;
+	}
+
+	switch (instruction->kind) {
+		case IR_ADDRESS_OF:
+		case IR_CONST_INT:
+		case IR_COPY:
+			return true;
+
+		/* these trap on overflow or on a zero divisor */
+		case IR_SUB_SIGNED_WORD:
+		case IR_MULT_UNSIGNED_WORD:
+		case IR_DIV_SIGNED_WORD:
+		case IR_DIV_UNSIGNED_WORD:
+		case IR_REM_SIGNED_WORD:
+		case IR_REM_UNSIGNED_WORD:
+			return false;
+
+		default:
+			return dataflow_is_expression(instruction);
+	}
+}
+
+/*
+ * ssa_rebuild_cfg finds the blocks phi arguments come from by their first
+ * node, so a block whose first instruction leaves gets a label to keep.
+ */
+static void loop_invariant_keep_first(struct cfg_block *block) {
+	struct ir_instruction *label = ir_instruction(IR_LABEL);
+	char *name = ir_create_label_name();
+	label->operands[0].kind = OPERAND_STRING;
+	strncpy(label->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+	free(name);
+	block->first = ir_insert_before(block->first, label);
+}
+
+static struct loop_invariant_budget *loop_invariant_budget(struct cfg_loop *loop) {
+	for (int i = 0; i < budget_count; i++) {
+		if (budgets[i].header == loop->header->first) return &budgets[i];
+	}
+
+	budgets = realloc(budgets, sizeof(struct loop_invariant_budget) * (budget_count + 1));
+	assert(NULL != budgets);
+	budgets[budget_count].header = loop->header->first;
+	budgets[budget_count].hoisted = 0;
+	return &budgets[budget_count++];
+}
+
+/*
+ * Picks the invariant instructions of the loop in reverse postorder, so
+ * definitions come before their uses, and moves them to the preheader.
+ */
+static bool loop_invariant_hoist(struct cfg *cfg, struct cfg_loop *loop) {
+	struct loop_invariant_budget *budget = loop_invariant_budget(loop);
+	if (budget->hoisted >= LOOP_INVARIANT_MAX_HOISTED) return false;
+
+	bool *defined_inside = calloc(max_temporary + 1, sizeof(bool));
+	bool *invariant = calloc(max_temporary + 1, sizeof(bool));
+	bool *hoisted = calloc(max_temporary + 1, sizeof(bool));
+	assert(NULL != defined_inside && NULL != invariant && NULL != hoisted);
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!loop->body[block->id]) continue;
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_operand *definition = ir_definition_operand(iter->data);
+			if (NULL != definition && loop_invariant_is_temporary(definition)) {
+				defined_inside[definition->data.temporary] = true;
+			}
+			if (iter == block->last) break;
+		}
+	}
+
+	struct loop_invariant_memory memory;
+	loop_invariant_scan_memory(cfg, loop, &memory);
+
+	/* constants move only along with an instruction reading them */
+	int chosen = 0;
+	for (int r = 0; r < cfg->reachable_count; r++) {
+		struct cfg_block *block = cfg->reverse_postorder[r];
+		if (!loop->body[block->id]) continue;
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *definition = ir_definition_operand(instruction);
+
+			if (
+				NULL != definition &&
+				loop_invariant_is_temporary(definition) &&
+				temporary_definitions[definition->data.temporary] == iter &&
+				loop_invariant_is_hoistable(instruction, &memory)
+			) {
+				bool operands_invariant = true;
+				for (int i = 0; i < ir_use_count(instruction); i++) {
+					struct ir_operand *use = ir_use_operand(instruction, i);
+					if (!loop_invariant_is_temporary(use)) continue;
+					if (defined_inside[use->data.temporary] && !invariant[use->data.temporary]) {
+						operands_invariant = false;
+					}
+				}
+
+				if (IR_CONST_INT == instruction->kind) {
+					invariant[definition->data.temporary] = true;
+				} else if (operands_invariant && budget->hoisted + chosen < LOOP_INVARIANT_MAX_HOISTED) {
+					invariant[definition->data.temporary] = true;
+					hoisted[definition->data.temporary] = true;
+					chosen++;
+					for (int i = 0; i < ir_use_count(instruction); i++) {
+						struct ir_operand *use = ir_use_operand(instruction, i);
+						if (loop_invariant_is_temporary(use) && defined_inside[use->data.temporary]) {
+							hoisted[use->data.temporary] = true;
+						}
+					}
+				}
+			}
+			if (iter == block->last) break;
+		}
+	}
+
+	struct ir_list *anchor = 0 != chosen ? cfg_loop_preheader(cfg, loop) : NULL;
+	if (NULL != anchor) {
+		/* collect first, moving a block's first or last node invalidates the walk */
+		struct ir_list **moves = malloc(sizeof(struct ir_list *) * (max_temporary + 1));
+		assert(NULL != moves);
+		int move_count = 0;
+
+		for (int r = 0; r < cfg->reachable_count; r++) {
+			struct cfg_block *block = cfg->reverse_postorder[r];
+			if (!loop->body[block->id]) continue;
+
+			for (struct ir_list *iter = block->first; ; iter = iter->next) {
+				struct ir_operand *definition = ir_definition_operand(iter->data);
+				if (
+					NULL != definition &&
+					loop_invariant_is_temporary(definition) &&
+					temporary_definitions[definition->data.temporary] == iter &&
+					hoisted[definition->data.temporary]
+				) {
+					if (iter == block->first) loop_invariant_keep_first(block);
+					moves[move_count++] = iter;
+				}
+				if (iter == block->last) break;
+			}
+		}
+
+		for (int m = 0; m < move_count; m++) {
+			struct ir_instruction *instruction = moves[m]->data;
+			char *scope = instruction->scope;
+			ir_unlink(moves[m]);
+			ir_insert_before(anchor, instruction)->data->scope = scope;
+		}
+		free(moves);
+		budget->hoisted += chosen;
+	}
+
+	free(defined_inside);
+	free(invariant);
+	free(hoisted);
+	free(memory.stored);
+	return NULL != anchor;
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+void loop_invariant_code_motion(struct cfg *cfg) {
+	budgets = NULL;
+	budget_count = 0;
+
+	/* every hoist changes the blocks, so the loops are found again */
+	bool changed = true;
+	while (changed) {
+		changed = false;
+
+		max_temporary = dataflow_max_temporary(cfg);
+		temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+		escapes = dataflow_escaping_variables(cfg, temporary_definitions, &max_variable);
+
+		int loop_count;
+		struct cfg_loop *loops = cfg_find_loops(cfg, &loop_count);
+		for (int l = 0; l < loop_count && !changed; l++) {
+			changed = loop_invariant_hoist(cfg, &loops[l]);
+		}
+		cfg_destroy_loops(loops, loop_count);
+
+		free(temporary_definitions);
+		free(escapes);
+		if (changed) ssa_rebuild_cfg(cfg);
+	}
+
+	free(budgets);
+}
+
+void loop_invariant_code_motion_program(struct cfg *cfgs) {
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		loop_invariant_code_motion(cfg);
+	}
+}
@@ -0,0 +1,23 @@
+#ifndef _LOOP_INVARIANT_CODE_MOTION_H
+#define _LOOP_INVARIANT_CODE_MOTION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Loop-invariant code motion over a function in SSA form. Every natural
+ * loop with a single way in gets a preheader, and instructions whose value
+ * is the same on every iteration move there: addresses of variables and
+ * string literals, loads of variables the loop never writes, and arithmetic
+ * that can't trap on operands defined outside the loop. Inner loops go
+ * first, so code can move out of a whole nest step by step. Only a few
+ * instructions leave each loop, since everything hoisted holds a register
+ * for the length of the loop.
+ */
+void loop_invariant_code_motion(struct cfg *cfg);
+void loop_invariant_code_motion_program(struct cfg *cfgs);
+
+#endif
@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "loop-rotation.h"
+
+extern int next_temporary;
+
+static struct cfg *cfg;
+static int max_temporary;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool loop_rotation_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static bool loop_rotation_is_conditional(struct ir_instruction *instruction) {
+	return IR_GOTO_IF_FALSE == instruction->kind || IR_GOTO_IF_TRUE == instruction->kind;
+}
+
+static struct ir_instruction *loop_rotation_clone(struct ir_instruction *original) {
+	struct ir_instruction *instruction = ir_instruction(original->kind);
+	memcpy(instruction->operands, original->operands, sizeof(instruction->operands));
+	instruction->offset_variable = original->offset_variable;
+	return instruction;
+}
+
+static struct ir_instruction *loop_rotation_label(const char *name) {
+	struct ir_instruction *instruction = ir_instruction(IR_LABEL);
+	instruction->operands[0].kind = OPERAND_STRING;
+	strncpy(instruction->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+	return instruction;
+}
+
+static struct ir_instruction *loop_rotation_goto(const char *name) {
+	struct ir_instruction *instruction = ir_instruction(IR_GOTO);
+	instruction->operands[0].kind = OPERAND_STRING;
+	strncpy(instruction->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+	return instruction;
+}
+
+/*********
+ * LOOPS *
+ *********/
+
+/* the header is label, test, branch out of the loop, and falls into the body */
+static bool loop_rotation_is_rotatable(struct cfg_loop *loop) {
+	struct cfg_block *header = loop->header;
+	struct ir_instruction *branch = header->last->data;
+
+	if (IR_LABEL != header->first->data->kind || !loop_rotation_is_conditional(branch)) return false;
+	if (2 != header->successor_count) return false;
+
+	for (int s = 0; s < header->successor_count; s++) {
+		struct cfg_block *successor = header->successors[s];
+		if (successor == header || loop->body[successor->id] != cfg_falls_through(header, successor)) return false;
+	}
+
+	int size = 0;
+	for (struct ir_list *iter = header->first->next; iter != header->last; iter = iter->next) size++;
+	return size <= LOOP_ROTATION_MAX_HEADER;
+}
+
+/* the latch closing the loop with goto header, the last one in ir_list if there are several */
+static struct cfg_block *loop_rotation_find_latch(struct cfg_loop *loop) {
+	struct cfg_block *latch = NULL;
+
+	for (int l = 0; l < loop->latch_count; l++) {
+		struct cfg_block *candidate = loop->latches[l];
+		if (candidate == loop->header || IR_GOTO != candidate->last->data->kind) continue;
+		if (NULL == latch || candidate->id > latch->id) latch = candidate;
+	}
+	return latch;
+}
+
+/* temporaries the header defines and nothing outside it reads get new names in the guard */
+static int *loop_rotation_guard_names(struct cfg_block *header) {
+	int *renames = malloc(sizeof(int) * (max_temporary + 1));
+	assert(NULL != renames);
+	for (int t = 0; t <= max_temporary; t++) renames[t] = -1;
+
+	for (struct ir_list *iter = header->first; ; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL != definition && loop_rotation_is_temporary(definition)) renames[definition->data.temporary] = 0;
+		if (iter == header->last) break;
+	}
+
+	bool inside = false;
+	for (struct ir_list *iter = cfg->proc_begin; ; iter = iter->next) {
+		if (iter == header->first) inside = true;
+
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (!inside && NULL != definition && loop_rotation_is_temporary(definition)) {
+			renames[definition->data.temporary] = -1;
+		}
+		for (int i = 0; i < ir_use_count(iter->data) && !inside; i++) {
+			struct ir_operand *use = ir_use_operand(iter->data, i);
+			if (loop_rotation_is_temporary(use)) renames[use->data.temporary] = -1;
+		}
+
+		if (iter == header->last) inside = false;
+		if (iter == cfg->proc_end) break;
+	}
+
+	for (int t = 0; t <= max_temporary; t++) {
+		if (0 == renames[t]) renames[t] = next_temporary++;
+	}
+	return renames;
+}
+
+static void loop_rotation_rename(struct ir_operand *operand, int *renames) {
+	if (loop_rotation_is_temporary(operand) && renames[operand->data.temporary] >= 0) {
+		operand->data.temporary = renames[operand->data.temporary];
+	}
+}
+
+/*
+ * The header's code is copied to the bottom of the latch, under the
+ * header's label, and its branch turned around to go back to the body.
+ * What's left at the top loses the label and becomes the guard.
+ */
+static struct ir_list *loop_rotation_rotate(struct cfg_loop *loop, struct cfg_block *latch) {
+	struct cfg_block *header = loop->header;
+	struct ir_list *back_edge = latch->last;
+	struct ir_instruction *branch = header->last->data;
+	char exit[IDENTIFIER_MAX + 1];
+	strncpy(exit, ir_branch_target(branch), IDENTIFIER_MAX + 1);
+	int *renames = loop_rotation_guard_names(header);
+
+	/* the body gets a label of its own for the branch at the bottom */
+	char *body = ir_create_label_name();
+	struct ir_list *body_label = ir_insert_after(header->last, loop_rotation_label(body));
+
+	for (struct ir_list *iter = header->first; ; iter = iter->next) {
+		struct ir_list *copy = ir_insert_before(back_edge, loop_rotation_clone(iter->data));
+		if (iter == header->last) {
+			copy->data->kind = IR_GOTO_IF_FALSE == branch->kind ? IR_GOTO_IF_TRUE : IR_GOTO_IF_FALSE;
+			strncpy(copy->data->operands[1].data.name, body, IDENTIFIER_MAX + 1);
+			break;
+		}
+	}
+
+	/* the bottom leaves the loop where the header did */
+	if (NULL == back_edge->next || IR_LABEL != back_edge->next->data->kind ||
+		0 != strcmp(back_edge->next->data->operands[0].data.name, exit)) {
+		ir_insert_before(back_edge, loop_rotation_goto(exit));
+	}
+	ir_unlink(back_edge);
+
+	for (struct ir_list *iter = header->first->next; ; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL != definition) loop_rotation_rename(definition, renames);
+		for (int i = 0; i < ir_use_count(iter->data); i++) {
+			loop_rotation_rename(ir_use_operand(iter->data, i), renames);
+		}
+		if (iter == header->last) break;
+	}
+	ir_unlink(header->first);
+
+	free(renames);
+	free(body);
+	return body_label;
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+static void loop_rotation(struct cfg *function) {
+	struct ir_list **done = NULL;
+	int done_count = 0;
+
+	cfg = function;
+
+	/* every rotated loop changes the blocks, so the loops are found again; each is done once */
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		max_temporary = dataflow_max_temporary(cfg);
+
+		cfg_compute_dominators(cfg);
+		int loop_count;
+		struct cfg_loop *loops = cfg_find_loops(cfg, &loop_count);
+
+		for (int l = 0; l < loop_count && !changed; l++) {
+			bool is_done = false;
+			for (int d = 0; d < done_count && !is_done; d++) is_done = done[d] == loops[l].header->first;
+			if (is_done || !loop_rotation_is_rotatable(&loops[l])) continue;
+
+			struct cfg_block *latch = loop_rotation_find_latch(&loops[l]);
+			if (NULL == latch) continue;
+
+			done = realloc(done, sizeof(struct ir_list *) * (done_count + 1));
+			assert(NULL != done);
+			done[done_count++] = loop_rotation_rotate(&loops[l], latch);
+			changed = true;
+		}
+
+		cfg_destroy_loops(loops, loop_count);
+		if (changed) cfg_rebuild(cfg);
+	}
+
+	free(done);
+}
+
+void loop_rotation_program(void) {
+	struct cfg *cfgs = cfg_build_program();
+
+	for (struct cfg *function = cfgs; NULL != function; function = function->next) {
+		loop_rotation(function);
+	}
+
+	cfg_destroy_program(cfgs);
+}
@@ -0,0 +1,31 @@
+#ifndef _LOOP_ROTATION_H
+#define _LOOP_ROTATION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/* the headers copied into the guard are kept short, they're code size paid once per loop */
+#define LOOP_ROTATION_MAX_HEADER 12
+
+/*
+ * Rotates while and for loops, whose header tests the condition and leaves
+ * the loop while the body ends in a goto back to it:
+ *
+ *   header: test; if !c goto exit          if !c goto exit    (guard)
+ *           body                     =>    body: body
+ *           goto header                    header: test; if c goto body
+ *   exit:                                  exit:
+ *
+ * so an iteration runs one branch instead of two. The guard is a copy of
+ * the header's code with fresh temporaries for the values only the header
+ * reads; branches to the header (continue) reach the test at the bottom.
+ *
+ * Works on ir_list outside SSA form, since the temporaries the body reads
+ * are then written both by the guard and by the test at the bottom.
+ */
+void loop_rotation_program(void);
+
+#endif
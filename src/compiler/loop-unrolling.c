@@ -0,0 +1,799 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <limits.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "loop-unrolling.h"
+
+extern int next_temporary;
+
+static int factor = LOOP_UNROLLING_DEFAULT_FACTOR;
+static int budget = LOOP_UNROLLING_DEFAULT_BUDGET;
+
+/* the header's test: i compared against n, left through `exit` once it fails */
+struct loop_unrolling_test {
+	struct ir_instruction *comparison;
+	int induction_operand;                  /* 1 or 2 */
+	struct ir_instruction *load;            /* the header's load of i, NULL when i is a temporary */
+	int variable;
+	int step;
+	struct ir_list *branch;
+};
+
+static struct cfg *cfg;
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+static int *definition_counts;
+
+static int max_variable;
+static bool *escapes;
+
+static struct dataflow *liveness;
+
+static int *temporary_blocks;                   /* temporary -> block of the loop defining it, -1 outside */
+static int *temporary_loop_counts;              /* temporary -> definitions in the loop */
+static struct ir_list **temporary_nodes;
+static int *store_counts;                       /* variable -> stores to it in the loop */
+static struct ir_list **store_nodes;
+static struct cfg_block **store_blocks;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool loop_unrolling_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static bool loop_unrolling_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+static struct ir_instruction *loop_unrolling_definition(struct ir_operand *operand) {
+	if (!loop_unrolling_is_temporary(operand)) return NULL;
+
+	int temporary = operand->data.temporary;
+	if (1 != definition_counts[temporary]) return NULL;
+	return temporary_definitions[temporary]->data;
+}
+
+static struct ir_instruction *loop_unrolling_address(struct ir_instruction *instruction) {
+	if (NULL != instruction->offset_variable) return instruction->offset_variable;
+	return loop_unrolling_definition(&instruction->operands[loop_unrolling_is_store(instruction) ? 0 : 1]);
+}
+
+/* word locals whose address is never taken, only their own stores write them; -1 for the rest */
+static int loop_unrolling_variable(struct ir_instruction *instruction) {
+	struct ir_instruction *address = loop_unrolling_address(instruction);
+
+	if (
+		NULL == address ||
+		IR_ADDRESS_OF != address->kind ||
+		address->operands[2].data.is_string ||
+		4 != (int)address->operands[4].data.number ||
+		0 != address->operands[6].data.number
+	) {
+		return -1;
+	}
+
+	int variable = address->operands[3].data.variable_id;
+	return escapes[variable] ? -1 : variable;
+}
+
+static int loop_unrolling_loaded_variable(struct ir_operand *operand) {
+	struct ir_instruction *definition = loop_unrolling_definition(operand);
+	if (NULL == definition || IR_LOAD_WORD != definition->kind) return -1;
+	return loop_unrolling_variable(definition);
+}
+
+/* constants optimization 1 turned into immediates are only left in the constants map */
+static bool loop_unrolling_constant(struct ir_operand *operand, int *value) {
+	if (!loop_unrolling_is_temporary(operand)) return false;
+
+	int temporary = operand->data.temporary;
+	struct ir_instruction *definition = loop_unrolling_definition(operand);
+	if (NULL != definition && IR_CONST_INT == definition->kind) {
+		*value = (int)definition->operands[1].data.number;
+		return true;
+	}
+	if (0 == definition_counts[temporary] && NULL != ir_get_const_map_entry(temporary)) {
+		*value = (int)strtol(ir_get_const_map_entry(temporary), NULL, 10);
+		return true;
+	}
+	return false;
+}
+
+static struct ir_instruction *loop_unrolling_clone(struct ir_instruction *original) {
+	struct ir_instruction *instruction = ir_instruction(original->kind);
+	memcpy(instruction->operands, original->operands, sizeof(instruction->operands));
+	instruction->offset_variable = original->offset_variable;
+	return instruction;
+}
+
+static struct ir_list *loop_unrolling_insert_branch(
+	struct ir_list *anchor, enum ir_instruction_kind kind, int condition, const char *target
+) {
+	struct ir_instruction *instruction = ir_instruction(kind);
+	int position = 0;
+	if (IR_GOTO != kind) {
+		instruction->operands[0].kind = OPERAND_TEMPORARY;
+		instruction->operands[0].data.temporary = condition;
+		position = 1;
+	}
+	instruction->operands[position].kind = OPERAND_STRING;
+	strncpy(instruction->operands[position].data.name, target, IDENTIFIER_MAX + 1);
+	return ir_insert_before(anchor, instruction);
+}
+
+/* the operand's value on entry to the loop, computed right before the anchor */
+static int loop_unrolling_value_before(struct ir_list *anchor, struct ir_operand *operand) {
+	int value;
+	struct ir_instruction *instruction;
+
+	if (loop_unrolling_constant(operand, &value)) {
+		instruction = ir_instruction(IR_CONST_INT);
+		ir_operand_temporary(instruction, 0);
+		ir_operand_number(instruction, 1, value);
+	} else if (temporary_blocks[operand->data.temporary] < 0) {
+		return operand->data.temporary;
+	} else {
+		/* a load of a variable, again */
+		struct ir_instruction *load = loop_unrolling_definition(operand);
+		instruction = loop_unrolling_clone(load);
+		ir_operand_temporary(instruction, 0);
+		if (NULL == load->offset_variable) {
+			struct ir_instruction *address = loop_unrolling_clone(loop_unrolling_address(load));
+			ir_operand_temporary(address, 0);
+			ir_insert_before(anchor, address);
+			ir_operand_copy(instruction, 1, &address->operands[0]);
+		}
+	}
+	ir_insert_before(anchor, instruction);
+	return instruction->operands[0].data.temporary;
+}
+
+/************
+ * ANALYSIS *
+ ************/
+
+static void loop_unrolling_scan(struct cfg_loop *loop) {
+	for (int t = 0; t <= max_temporary; t++) temporary_blocks[t] = -1;
+	memset(temporary_loop_counts, 0, sizeof(int) * (max_temporary + 1));
+	memset(store_counts, 0, sizeof(int) * (max_variable + 1));
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!loop->body[block->id]) continue;
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *definition = ir_definition_operand(instruction);
+
+			if (NULL != definition && loop_unrolling_is_temporary(definition)) {
+				temporary_blocks[definition->data.temporary] = block->id;
+				temporary_loop_counts[definition->data.temporary]++;
+				temporary_nodes[definition->data.temporary] = iter;
+			}
+			if (loop_unrolling_is_store(instruction)) {
+				int variable = loop_unrolling_variable(instruction);
+				if (variable >= 0) {
+					store_counts[variable]++;
+					store_nodes[variable] = iter;
+					store_blocks[variable] = block;
+				}
+			}
+			if (iter == block->last) break;
+		}
+	}
+}
+
+/* the header computes its test and nothing else, so skipping it changes nothing */
+static bool loop_unrolling_is_pure(struct ir_instruction *instruction) {
+	switch (instruction->kind) {
+		case IR_LOAD_WORD:
+		case IR_LOAD_HALF_WORD:
+		case IR_LOAD_SIGNED_HALF_WORD:
+		case IR_LOAD_BYTE:
+		case IR_LOAD_SIGNED_BYTE:
+		case IR_CONST_INT:
+		case IR_ADDRESS_OF:
+		case IR_COPY:
+			return true;
+		case IR_DIV_SIGNED_WORD:
+		case IR_DIV_UNSIGNED_WORD:
+		case IR_REM_SIGNED_WORD:
+		case IR_REM_UNSIGNED_WORD:
+			return false;
+		default:
+			return dataflow_is_expression(instruction);
+	}
+}
+
+/* the step is taken on every way round the loop */
+static bool loop_unrolling_is_every_iteration(struct cfg_loop *loop, struct cfg_block *block) {
+	for (int l = 0; l < loop->latch_count; l++) {
+		if (!cfg_dominates(block, loop->latches[l])) return false;
+	}
+	return true;
+}
+
+/* increment is i + step or i - step, with i the operand `is_current` accepts */
+static bool loop_unrolling_increment(
+	struct ir_instruction *increment, bool (*is_current)(struct ir_operand *operand, int induction), int induction, int *step
+) {
+	bool is_add = IR_ADD_SIGNED_WORD == increment->kind || IR_ADD_UNSIGNED_WORD == increment->kind;
+	bool is_sub = IR_SUB_SIGNED_WORD == increment->kind || IR_SUB_UNSIGNED_WORD == increment->kind;
+	if (!is_add && !is_sub) return false;
+
+	for (int i = 1; i <= (is_add ? 2 : 1); i++) {
+		if (is_current(&increment->operands[i], induction) && loop_unrolling_constant(&increment->operands[3 - i], step)) {
+			if (is_sub) *step = -*step;
+			return 0 != *step;
+		}
+	}
+	return false;
+}
+
+static bool loop_unrolling_loads(struct ir_operand *operand, int variable) {
+	return loop_unrolling_loaded_variable(operand) == variable && temporary_blocks[operand->data.temporary] >= 0;
+}
+
+static bool loop_unrolling_reads(struct ir_operand *operand, int temporary) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary == temporary;
+}
+
+/* the only store to the variable in the loop is i = i + step */
+static bool loop_unrolling_variable_step(struct cfg_loop *loop, int variable, int *step) {
+	if (1 != store_counts[variable]) return false;
+	if (!loop_unrolling_is_every_iteration(loop, store_blocks[variable])) return false;
+
+	struct ir_operand *value = &store_nodes[variable]->data->operands[1];
+	struct ir_instruction *increment = loop_unrolling_definition(value);
+	if (NULL == increment || temporary_blocks[value->data.temporary] < 0) return false;
+	return loop_unrolling_increment(increment, loop_unrolling_loads, variable, step);
+}
+
+/* a temporary set before the loop and only by i = i + step in it, like the pointers of induction-variables.c */
+static bool loop_unrolling_temporary_step(struct cfg_loop *loop, int temporary, int *step) {
+	if (1 != temporary_loop_counts[temporary] || definition_counts[temporary] < 2) return false;
+	if (!loop_unrolling_is_every_iteration(loop, cfg->blocks[temporary_blocks[temporary]])) return false;
+	return loop_unrolling_increment(temporary_nodes[temporary]->data, loop_unrolling_reads, temporary, step);
+}
+
+/* n is the same on every iteration */
+static bool loop_unrolling_is_invariant(struct ir_operand *operand) {
+	int value;
+	if (loop_unrolling_constant(operand, &value)) return true;
+	if (!loop_unrolling_is_temporary(operand)) return false;
+	if (temporary_blocks[operand->data.temporary] < 0) return 0 != definition_counts[operand->data.temporary];
+
+	int variable = loop_unrolling_loaded_variable(operand);
+	return variable >= 0 && 0 == store_counts[variable];
+}
+
+/*
+ * The header is a label, pure code and gotoIfFalse test, exit, where test
+ * compares i with n so that it stays true while i moves towards n.
+ */
+static bool loop_unrolling_find_test(struct cfg_loop *loop, struct loop_unrolling_test *test) {
+	struct cfg_block *header = loop->header;
+	struct ir_instruction *branch = header->last->data;
+
+	if (IR_LABEL != header->first->data->kind || IR_GOTO_IF_FALSE != branch->kind) return false;
+	if (2 != header->successor_count || header->successors[0] == header->successors[1]) return false;
+	for (int s = 0; s < header->successor_count; s++) {
+		struct cfg_block *successor = header->successors[s];
+		if (loop->body[successor->id] != cfg_falls_through(header, successor)) return false;
+	}
+	test->branch = header->last;
+
+	/* nothing the header computes is read elsewhere */
+	for (struct ir_list *iter = header->first->next; iter != header->last; iter = iter->next) {
+		if (!loop_unrolling_is_pure(iter->data)) return false;
+	}
+	bool inside = false;
+	for (struct ir_list *iter = cfg->proc_begin; ; iter = iter->next) {
+		if (iter == header->first) inside = true;
+		for (int i = 0; i < ir_use_count(iter->data) && !inside; i++) {
+			struct ir_operand *use = ir_use_operand(iter->data, i);
+			if (loop_unrolling_is_temporary(use) && temporary_blocks[use->data.temporary] == header->id) return false;
+		}
+		if (iter == header->last) inside = false;
+		if (iter == cfg->proc_end) break;
+	}
+
+	struct ir_instruction *comparison = loop_unrolling_definition(&branch->operands[0]);
+	if (NULL == comparison || temporary_blocks[branch->operands[0].data.temporary] != header->id) return false;
+
+	bool ascending, is_signed = true;
+	switch (comparison->kind) {
+		case IR_LT_UNSIGNED_WORD:
+		case IR_LE_UNSIGNED_WORD:
+			is_signed = false;
+			/* fall through */
+		case IR_LT_SIGNED_WORD:
+		case IR_LE_SIGNED_WORD:
+			ascending = true;
+			break;
+		case IR_GT_UNSIGNED_WORD:
+		case IR_GE_UNSIGNED_WORD:
+			is_signed = false;
+			/* fall through */
+		case IR_GT_SIGNED_WORD:
+		case IR_GE_SIGNED_WORD:
+			ascending = false;
+			break;
+		default:
+			return false;
+	}
+
+	for (int i = 1; i <= 2; i++) {
+		struct ir_operand *operand = &comparison->operands[i];
+		if (!loop_unrolling_is_temporary(operand) || !loop_unrolling_is_invariant(&comparison->operands[3 - i])) continue;
+
+		int variable = loop_unrolling_loaded_variable(operand);
+		if (is_signed && variable >= 0 && temporary_blocks[operand->data.temporary] == header->id) {
+			if (!loop_unrolling_variable_step(loop, variable, &test->step)) continue;
+			test->load = loop_unrolling_definition(operand);
+		} else if (!is_signed && temporary_blocks[operand->data.temporary] != header->id) {
+			if (!loop_unrolling_temporary_step(loop, operand->data.temporary, &test->step)) continue;
+			test->load = NULL;
+		} else {
+			continue;
+		}
+
+		/* n < i is i > n */
+		if ((test->step > 0) != (1 == i ? ascending : !ascending)) continue;
+
+		test->comparison = comparison;
+		test->induction_operand = i;
+		test->variable = variable;
+		return true;
+	}
+	return false;
+}
+
+/* i's value on entry when the block entering the loop stores a constant to it, -1 iterations otherwise */
+static int loop_unrolling_trip_count(struct cfg_block *entry, struct loop_unrolling_test *test) {
+	int start, bound;
+	bool known = false;
+
+	if (NULL == test->load) return -1;
+	if (!loop_unrolling_constant(&test->comparison->operands[3 - test->induction_operand], &bound)) return -1;
+
+	for (struct ir_list *iter = entry->first; ; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		if (loop_unrolling_is_store(instruction) && loop_unrolling_variable(instruction) == test->variable) {
+			known = loop_unrolling_constant(&instruction->operands[1], &start);
+		}
+		if (iter == entry->last) break;
+	}
+	if (!known) return -1;
+
+	int count = 0;
+	for (int i = start; count <= budget; i += test->step, count++) {
+		int left = 1 == test->induction_operand ? i : bound;
+		int right = 1 == test->induction_operand ? bound : i;
+		bool holds;
+		switch (test->comparison->kind) {
+			case IR_LT_SIGNED_WORD: holds = left < right; break;
+			case IR_LE_SIGNED_WORD: holds = left <= right; break;
+			case IR_GT_SIGNED_WORD: holds = left > right; break;
+			default: holds = left >= right; break;
+		}
+		if (!holds) return count;
+	}
+	return -1;
+}
+
+/***********
+ * COPYING *
+ ***********/
+
+/* the loop body without its test and back edge, as a range of ir_list */
+struct loop_unrolling_body {
+	struct ir_list *first, *last;
+	int size;
+	bool *local;                            /* temporary -> only defined and read in the body */
+	char **labels;                          /* the labels defined in the body */
+	int label_count;
+};
+
+static void loop_unrolling_find_locals(struct loop_unrolling_body *body) {
+	int *body_definitions = calloc(max_temporary + 1, sizeof(int));
+	bool *read_outside = calloc(max_temporary + 1, sizeof(bool));
+	body->local = calloc(max_temporary + 1, sizeof(bool));
+	assert(NULL != body_definitions && NULL != read_outside && NULL != body->local);
+
+	bool inside = false;
+	for (struct ir_list *iter = cfg->proc_begin; ; iter = iter->next) {
+		if (iter == body->first) inside = true;
+
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (inside && NULL != definition && loop_unrolling_is_temporary(definition)) {
+			body_definitions[definition->data.temporary]++;
+		}
+		for (int i = 0; i < ir_use_count(iter->data) && !inside; i++) {
+			struct ir_operand *use = ir_use_operand(iter->data, i);
+			if (loop_unrolling_is_temporary(use)) read_outside[use->data.temporary] = true;
+		}
+
+		if (iter == body->last) inside = false;
+		if (iter == cfg->proc_end) break;
+	}
+
+	for (int t = 0; t <= max_temporary; t++) {
+		body->local[t] = 0 != body_definitions[t] && body_definitions[t] == definition_counts[t] && !read_outside[t];
+	}
+	free(body_definitions);
+	free(read_outside);
+}
+
+static void loop_unrolling_rename(struct ir_operand *operand, struct loop_unrolling_body *body, int *renames) {
+	if (!loop_unrolling_is_temporary(operand) || !body->local[operand->data.temporary]) return;
+
+	if (renames[operand->data.temporary] < 0) renames[operand->data.temporary] = next_temporary++;
+	operand->data.temporary = renames[operand->data.temporary];
+}
+
+/*
+ * Puts a copy of the body before the anchor. Temporaries that live only in
+ * the body and its labels get fresh names, everything else is shared.
+ */
+static void loop_unrolling_copy(struct loop_unrolling_body *body, struct ir_list *anchor) {
+	int *renames = malloc(sizeof(int) * (max_temporary + 1));
+	char **labels = malloc(sizeof(char *) * (body->label_count + 1));
+	assert(NULL != renames && NULL != labels);
+	for (int t = 0; t <= max_temporary; t++) renames[t] = -1;
+	for (int l = 0; l < body->label_count; l++) labels[l] = ir_create_label_name();
+
+	for (struct ir_list *iter = body->first; ; iter = iter->next) {
+		struct ir_instruction *instruction = loop_unrolling_clone(iter->data);
+		struct ir_operand *definition = ir_definition_operand(instruction);
+
+		if (NULL != definition) loop_unrolling_rename(definition, body, renames);
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			loop_unrolling_rename(ir_use_operand(instruction, i), body, renames);
+		}
+
+		char *name = NULL;
+		if (IR_LABEL == instruction->kind) {
+			name = instruction->operands[0].data.name;
+		} else if (ir_is_branch(instruction)) {
+			name = ir_branch_target(instruction);
+		}
+		for (int l = 0; NULL != name && l < body->label_count; l++) {
+			if (0 == strcmp(name, body->labels[l])) {
+				strncpy(name, labels[l], IDENTIFIER_MAX + 1);
+				break;
+			}
+		}
+
+		ir_insert_before(anchor, instruction);
+		if (iter == body->last) break;
+	}
+
+	for (int l = 0; l < body->label_count; l++) free(labels[l]);
+	free(labels);
+	free(renames);
+}
+
+static int loop_unrolling_count_live(struct bit_vector *live) {
+	int count = 0;
+	for (int t = bit_vector_next(live, 0); t >= 0; t = bit_vector_next(live, t + 1)) count++;
+	return count;
+}
+
+/*
+ * How many copies of the body fit in the registers. The original loop,
+ * which runs the iterations left, needs as many as the body at its
+ * busiest. An exit out of the middle of the body reads values every copy
+ * has its own of, and the exits' copies end up after the loop in the
+ * layout, so each copy adds the values live into those exits for the rest
+ * of the loop. The variables the loop stores to count as such values too,
+ * since mem2reg gives them temporaries after unrolling.
+ */
+static int loop_unrolling_fitting_count(struct cfg_loop *loop) {
+	struct bit_vector *live = bit_vector_create(liveness->size);
+	struct bit_vector *exits = bit_vector_create(liveness->size);
+	bool has_exit = false;
+	int busiest = 0;
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!loop->body[block->id]) continue;
+
+		for (int s = 0; s < block->successor_count && block != loop->header; s++) {
+			struct cfg_block *successor = block->successors[s];
+			if (loop->body[successor->id]) continue;
+
+			bit_vector_union(exits, liveness->in[successor->id]);
+			has_exit = true;
+		}
+
+		bit_vector_copy(live, liveness->out[block->id]);
+		for (struct ir_list *iter = block->last; ; iter = iter->prev) {
+			struct ir_operand *definition = ir_definition_operand(iter->data);
+			if (NULL != definition && loop_unrolling_is_temporary(definition)) {
+				bit_vector_clear(live, definition->data.temporary);
+			}
+			for (int i = 0; i < ir_use_count(iter->data); i++) {
+				struct ir_operand *use = ir_use_operand(iter->data, i);
+				if (loop_unrolling_is_temporary(use)) bit_vector_set(live, use->data.temporary);
+			}
+
+			int count = loop_unrolling_count_live(live);
+			if (count > busiest) busiest = count;
+			if (iter == block->first) break;
+		}
+	}
+
+	int exit_count = loop_unrolling_count_live(exits);
+	bit_vector_free(live);
+	bit_vector_free(exits);
+	if (!has_exit) return INT_MAX;
+
+	for (int v = 0; v <= max_variable; v++) {
+		if (0 == store_counts[v] || escapes[v]) continue;
+		busiest++;
+		exit_count++;
+	}
+	if (0 == exit_count) return INT_MAX;
+	return (LOOP_UNROLLING_REGISTERS - busiest) / exit_count;
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+/*
+ * The loop's blocks follow each other in ir_list from the header to its
+ * only latch, which jumps back with a goto, and the block entering the
+ * loop falls into the header.
+ */
+static bool loop_unrolling_find_body(struct cfg_loop *loop, struct loop_unrolling_body *body) {
+	struct cfg_block *header = loop->header;
+	if (1 != loop->latch_count) return false;
+
+	struct cfg_block *latch = loop->latches[0];
+	if (latch == header || IR_GOTO != latch->last->data->kind) return false;
+	if (latch->id - header->id + 1 != loop->block_count) return false;
+	for (int b = header->id; b <= latch->id; b++) {
+		if (!loop->body[b]) return false;
+	}
+
+	struct cfg_block *entry = cfg_loop_entry(loop);
+	if (NULL == entry || !cfg_falls_through(entry, header)) return false;
+
+	body->first = header->last->next;
+	body->last = latch->last->prev;
+	if (body->first == latch->last) return false;
+
+	body->size = 0;
+	body->label_count = 0;
+	body->labels = NULL;
+	for (struct ir_list *iter = body->first; ; iter = iter->next) {
+		body->size++;
+		if (IR_LABEL == iter->data->kind) {
+			body->labels = realloc(body->labels, sizeof(char *) * (body->label_count + 1));
+			assert(NULL != body->labels);
+			body->labels[body->label_count++] = iter->data->operands[0].data.name;
+		}
+		if (iter == body->last) break;
+	}
+	return true;
+}
+
+/* the body jumps back to the header only through the latch */
+static bool loop_unrolling_is_straight(struct loop_unrolling_body *body, struct cfg_loop *loop) {
+	const char *header = loop->header->first->data->operands[0].data.name;
+
+	for (struct ir_list *iter = body->first; ; iter = iter->next) {
+		if (ir_is_branch(iter->data) && 0 == strcmp(ir_branch_target(iter->data), header)) return false;
+		if (iter == body->last) break;
+	}
+	return true;
+}
+
+/* trip_count copies of the body replace the loop */
+static void loop_unrolling_unroll_fully(struct cfg_loop *loop, struct loop_unrolling_body *body, struct loop_unrolling_test *test, int trip_count) {
+	struct ir_list *header = loop->header->first;
+	struct ir_list *back_edge = body->last->next;
+
+	for (int i = 0; i < trip_count; i++) loop_unrolling_copy(body, header);
+	loop_unrolling_insert_branch(header, IR_GOTO, 0, ir_branch_target(test->branch->data));
+
+	struct ir_list *iter = header, *next;
+	while (true) {
+		next = iter->next;
+		ir_unlink(iter);
+		if (iter == back_edge) break;
+		iter = next;
+	}
+}
+
+/*
+ * In front of the loop:
+ *   unrolled: if !(i + (factor - 1) * step < n) goto header
+ *             body ... body
+ *             goto unrolled
+ * and the original loop runs the iterations left.
+ */
+static void loop_unrolling_unroll(struct loop_unrolling_body *body, struct loop_unrolling_test *test, int count, struct ir_list *header) {
+	struct ir_instruction *label = ir_instruction(IR_LABEL);
+	char *name = ir_create_label_name();
+	label->operands[0].kind = OPERAND_STRING;
+	strncpy(label->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+	ir_insert_before(header, label);
+
+	int current = test->comparison->operands[test->induction_operand].data.temporary;
+	if (NULL != test->load) current = loop_unrolling_value_before(header, &test->comparison->operands[test->induction_operand]);
+
+	struct ir_instruction *distance = ir_instruction(IR_CONST_INT);
+	ir_operand_temporary(distance, 0);
+	ir_operand_number(distance, 1, (count - 1) * test->step);
+	ir_insert_before(header, distance);
+
+	struct ir_instruction *last = ir_instruction(NULL != test->load ? IR_ADD_SIGNED_WORD : IR_ADD_UNSIGNED_WORD);
+	ir_operand_temporary(last, 0);
+	last->operands[1].kind = OPERAND_TEMPORARY;
+	last->operands[1].data.temporary = current;
+	ir_operand_copy(last, 2, &distance->operands[0]);
+	ir_insert_before(header, last);
+
+	struct ir_instruction *comparison = ir_instruction(test->comparison->kind);
+	ir_operand_temporary(comparison, 0);
+	ir_operand_copy(comparison, test->induction_operand, &last->operands[0]);
+	int bound = loop_unrolling_value_before(header, &test->comparison->operands[3 - test->induction_operand]);
+	comparison->operands[3 - test->induction_operand].kind = OPERAND_TEMPORARY;
+	comparison->operands[3 - test->induction_operand].data.temporary = bound;
+	ir_insert_before(header, comparison);
+
+	loop_unrolling_insert_branch(
+		header, IR_GOTO_IF_FALSE, comparison->operands[0].data.temporary, header->data->operands[0].data.name
+	);
+	for (int i = 0; i < count; i++) loop_unrolling_copy(body, header);
+	loop_unrolling_insert_branch(header, IR_GOTO, 0, name);
+	free(name);
+}
+
+static bool loop_unrolling_loop(struct cfg_loop *loop) {
+	struct loop_unrolling_test test;
+	struct loop_unrolling_body body;
+
+	loop_unrolling_scan(loop);
+	if (!loop_unrolling_find_body(loop, &body)) return false;
+	if (!loop_unrolling_find_test(loop, &test)) {
+		free(body.labels);
+		return false;
+	}
+
+	int trip_count = loop_unrolling_trip_count(cfg_loop_entry(loop), &test);
+	int fitting_count = loop_unrolling_fitting_count(loop);
+	bool full = (
+		trip_count > 0 && trip_count * body.size <= budget && trip_count <= fitting_count &&
+		loop_unrolling_is_straight(&body, loop)
+	);
+
+	int count = factor < fitting_count ? factor : fitting_count;
+	while (count >= 2 && count * body.size > budget) count--;
+	if (trip_count >= 0 && count >= trip_count) count = 0;
+
+	if (full || count >= 2) {
+		loop_unrolling_find_locals(&body);
+		if (full) {
+			loop_unrolling_unroll_fully(loop, &body, &test, trip_count);
+		} else {
+			loop_unrolling_unroll(&body, &test, count, loop->header->first);
+		}
+		free(body.local);
+	}
+
+	free(body.labels);
+	return full || count >= 2;
+}
+
+static void loop_unrolling(struct cfg *function) {
+	struct ir_list **done = NULL;
+	int done_count = 0;
+
+	cfg = function;
+
+	/* every unrolled loop changes the blocks, so the loops are found again; each is done once */
+	bool changed = true;
+	while (changed) {
+		changed = false;
+
+		max_temporary = dataflow_max_temporary(cfg);
+		temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+		definition_counts = calloc(max_temporary + 1, sizeof(int));
+		temporary_blocks = malloc(sizeof(int) * (max_temporary + 1));
+		temporary_loop_counts = malloc(sizeof(int) * (max_temporary + 1));
+		temporary_nodes = malloc(sizeof(struct ir_list *) * (max_temporary + 1));
+		assert(NULL != definition_counts && NULL != temporary_blocks && NULL != temporary_loop_counts && NULL != temporary_nodes);
+
+		for (struct ir_list *iter = cfg->proc_begin; ; iter = iter->next) {
+			struct ir_operand *definition = ir_definition_operand(iter->data);
+			if (NULL != definition && loop_unrolling_is_temporary(definition)) {
+				definition_counts[definition->data.temporary]++;
+			}
+			if (iter == cfg->proc_end) break;
+		}
+
+		escapes = dataflow_escaping_variables(cfg, temporary_definitions, &max_variable);
+		store_counts = malloc(sizeof(int) * (max_variable + 1));
+		store_nodes = malloc(sizeof(struct ir_list *) * (max_variable + 1));
+		store_blocks = malloc(sizeof(struct cfg_block *) * (max_variable + 1));
+		assert(NULL != store_counts && NULL != store_nodes && NULL != store_blocks);
+
+		liveness = dataflow_liveness(cfg);
+		cfg_compute_dominators(cfg);
+		int loop_count;
+		struct cfg_loop *loops = cfg_find_loops(cfg, &loop_count);
+
+		for (int l = 0; l < loop_count && !changed; l++) {
+			/* innermost loops only */
+			bool is_innermost = true;
+			for (int m = 0; m < loop_count && is_innermost; m++) {
+				is_innermost = m == l || !loops[l].body[loops[m].header->id];
+			}
+
+			bool is_done = false;
+			for (int d = 0; d < done_count && !is_done; d++) is_done = done[d] == loops[l].header->first;
+			if (!is_innermost || is_done) continue;
+
+			done = realloc(done, sizeof(struct ir_list *) * (done_count + 2));
+			assert(NULL != done);
+			done[done_count++] = loops[l].header->first;
+
+			struct ir_list *before = loops[l].header->first->prev;
+			changed = loop_unrolling_loop(&loops[l]);
+
+			/* the unrolled loop's label */
+			if (changed && IR_LABEL == before->next->data->kind) done[done_count++] = before->next;
+		}
+
+		cfg_destroy_loops(loops, loop_count);
+		free(temporary_definitions);
+		free(definition_counts);
+		free(temporary_blocks);
+		free(temporary_loop_counts);
+		free(temporary_nodes);
+		free(escapes);
+		free(store_counts);
+		free(store_nodes);
+		free(store_blocks);
+		dataflow_destroy(liveness);
+
+		if (changed) cfg_rebuild(cfg);
+	}
+
+	free(done);
+}
+
+void loop_unrolling_set_factor(int new_factor) {
+	factor = new_factor > 1 ? new_factor : 1;
+}
+
+void loop_unrolling_set_budget(int new_budget) {
+	budget = new_budget > 0 ? new_budget : 0;
+}
+
+void loop_unrolling_program(void) {
+	struct cfg *cfgs = cfg_build_program();
+
+	for (struct cfg *function = cfgs; NULL != function; function = function->next) {
+		loop_unrolling(function);
+	}
+
+	cfg_destroy_program(cfgs);
+}
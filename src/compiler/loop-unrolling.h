@@ -0,0 +1,34 @@
+#ifndef _LOOP_UNROLLING_H
+#define _LOOP_UNROLLING_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+#define LOOP_UNROLLING_DEFAULT_FACTOR 4
+#define LOOP_UNROLLING_DEFAULT_BUDGET 160
+/* registers mips.c hands out to temporaries, which the copies' live values must fit in */
+#define LOOP_UNROLLING_REGISTERS 17
+
+/*
+ * Unrolls counted innermost loops of the shape ir_handle_for_loop and
+ * ir_handle_while_loop produce: a header that only tests i < n (or >, <=,
+ * >=) and a body that adds a constant to i once, with n the same on every
+ * iteration. A loop whose trip count is a known constant and whose copies
+ * fit in the budget is replaced by that many copies of its body. Any other
+ * such loop gets an unrolled copy in front of it that runs `factor` bodies
+ * per test while at least that many iterations are left; the original loop
+ * runs the rest. The budget caps the instructions in the unrolled body,
+ * and fewer copies are made when the values they keep live at once would
+ * not fit in the registers.
+ *
+ * Works on ir_list outside SSA form, since the copies write the same
+ * variables and temporaries that live past the loop.
+ */
+void loop_unrolling_set_factor(int factor);
+void loop_unrolling_set_budget(int budget);
+void loop_unrolling_program(void);
+
+#endif
@@ -4,7 +4,10 @@
 #include <string.h>
 
 #include "mips.h"
+#include "cfg.h"
+#include "dataflow.h"
 #include "helpers/hash-map.h"
+#include "helpers/bit-vector.h"
 
 #define REG_EXHAUSTED   -1
 
@@ -15,6 +18,7 @@
 extern struct symbol_table *file_scope_table;
 
 extern int optimization;
+extern int next_temporary;
 
 static char* registers_list[] = {
 	"", "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
@@ -51,6 +55,16 @@ struct hash_map *variable_address_map;
 /* consts registers map */
 extern struct hash_map *const_registers_map;
 
+/* the function being printed may leave its frame for a tail call, see mips_is_tail_call */
+bool tail_calls_allowed = false;
+
+/* temporary - registers_list index, filled per function from liveness */
+int *allocated_registers = NULL;
+int allocated_registers_size = 0;
+
+/* reads of each temporary in the function, so a comparison is only fused into the branch that is its one reader */
+int *use_counts = NULL;
+
 
 /****************************
  * MIPS TEXT SECTION OUTPUT *
@@ -78,16 +92,13 @@ static int mips_round_up_to_double_word_boundry(int size) {
 	return ((size+7) >> 3) << 3;
 }
 
+/* the variable ends below fp_offset, so its start is rounded down after stepping over it */
 static int mips_round_variable_address(int fp_offset, int size) {
 	switch (size) {
-		case 4: {
-			if (fp_offset % 4 == 0) return fp_offset - 4;
-			return  (fp_offset >> 2) << 2;
-		}
-		case 2: {
-			if (fp_offset % 2 == 0) return fp_offset - 2;
-			return (fp_offset >> 1) << 1;
-		}
+		case 4:
+			return ((fp_offset - 4) >> 2) << 2;
+		case 2:
+			return ((fp_offset - 2) >> 1) << 1;
 		default:
 			return fp_offset - 1;
 	}
@@ -98,15 +109,19 @@ static void mips_calculate_offset(int size) {
 }
 
 static const char* mips_get_next_available_register(int temp_number) {
-	int length = (sizeof(registers_list) / sizeof(char*));
-	if (register_count >= (length - 1)) {
-		assert(0);
+	if (temp_number >= 0 && temp_number < allocated_registers_size && allocated_registers[temp_number] > 0) {
+		return registers_list[allocated_registers[temp_number]];
 	}
 
 	const char* reg = get_value(temp_register_map, temp_number);
 	if (NULL != reg) {
 		return reg;
 	}
+
+	int length = (sizeof(registers_list) / sizeof(char*));
+	if (register_count >= (length - 1)) {
+		assert(0);
+	}
 	register_count++;
 	/* map which temp gets matched to which actual register */
 	add_key_value(temp_register_map, registers_list[register_count], temp_number);
@@ -130,11 +145,285 @@ char* mips_get_next_available_argument_register() {
 }
 
 const char* mips_get_register_from_temp(int temp_number) {
-	return get_value(temp_register_map, temp_number);  
+	if (temp_number >= 0 && temp_number < allocated_registers_size && allocated_registers[temp_number] > 0) {
+		return registers_list[allocated_registers[temp_number]];
+	}
+
+	const char* reg = get_value(temp_register_map, temp_number);
+	if (NULL != reg) return reg;
+
+	/*
+	 * out of SSA form a temporary can be read in a block laid out above the
+	 * copy that defines it (e.g. a loop header reading the copy at the end of
+	 * its latch) so it gets its register on first sight
+	 */
+	return mips_get_next_available_register(temp_number);
+}
+
+/*
+ * Linear scan over the function's instructions in layout order. Each
+ * temporary gets one interval from the first to the last position where it
+ * is defined, read or live (block boundaries come from the liveness
+ * analysis, so values live around a loop cover the whole loop). Registers
+ * of temporaries whose interval ended are handed out again. Intervals are
+ * stretched by one instruction because a comparison fused into the branch
+ * after it reads its operands at the branch.
+ *
+ * When no register is free, whichever of the temporary and those holding a
+ * register lives longest is marked in the returned array (NULL if none was)
+ * to be spilled. Temporaries from first_spill on were made by spilling and
+ * live for an instruction or two, so they are never picked.
+ */
+static bool *mips_scan_registers(struct ir_list *proc_begin, int first_spill) {
+	struct cfg *cfg = cfg_build(proc_begin);
+	struct dataflow *liveness = dataflow_liveness(cfg);
+	int temporaries = liveness->size;
+
+	int *starts = malloc(sizeof(int) * temporaries);
+	int *ends = malloc(sizeof(int) * temporaries);
+	free(use_counts);
+	use_counts = calloc(temporaries, sizeof(int));
+	assert(NULL != starts && NULL != ends && NULL != use_counts);
+	for (int t = 0; t < temporaries; t++) {
+		starts[t] = -1;
+		ends[t] = -1;
+	}
+
+	/* blocks of a freshly built cfg are in layout order */
+	int position = 0;
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		int first_position = position;
+		struct ir_list *iter;
+
+		for (iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *operands[7];
+			int operand_count = 0;
+
+			for (int i = 0; i < ir_use_count(instruction); i++) {
+				operands[operand_count++] = ir_use_operand(instruction, i);
+				if (OPERAND_TEMPORARY == operands[i]->kind) use_counts[operands[i]->data.temporary]++;
+			}
+			operands[operand_count++] = ir_definition_operand(instruction);
+
+			for (int i = 0; i < operand_count; i++) {
+				if (NULL == operands[i] || OPERAND_TEMPORARY != operands[i]->kind) continue;
+				int temporary = operands[i]->data.temporary;
+				if (-1 == starts[temporary]) starts[temporary] = position;
+				ends[temporary] = position;
+			}
+
+			position++;
+			if (iter == block->last) break;
+		}
+
+		int last_position = position - 1;
+		for (int t = bit_vector_next(liveness->in[b], 0); t >= 0; t = bit_vector_next(liveness->in[b], t + 1)) {
+			if (-1 == starts[t] || starts[t] > first_position) starts[t] = first_position;
+			if (ends[t] < first_position) ends[t] = first_position;
+		}
+		for (int t = bit_vector_next(liveness->out[b], 0); t >= 0; t = bit_vector_next(liveness->out[b], t + 1)) {
+			if (-1 == starts[t] || starts[t] > last_position) starts[t] = last_position;
+			if (ends[t] < last_position) ends[t] = last_position;
+		}
+	}
+
+	/* bucket the temporaries by interval start */
+	int *bucket_starts = calloc(position + 2, sizeof(int));
+	int *sorted = malloc(sizeof(int) * (temporaries + 1));
+	assert(NULL != bucket_starts && NULL != sorted);
+	for (int t = 0; t < temporaries; t++) {
+		if (-1 != starts[t]) bucket_starts[starts[t] + 1]++;
+	}
+	for (int i = 0; i < position; i++) bucket_starts[i + 1] += bucket_starts[i];
+	for (int t = 0; t < temporaries; t++) {
+		if (-1 != starts[t]) sorted[bucket_starts[starts[t]]++] = t;
+	}
+
+	free(allocated_registers);
+	allocated_registers = calloc(temporaries, sizeof(int));
+	allocated_registers_size = temporaries;
+	assert(NULL != allocated_registers);
+
+	int length = (sizeof(registers_list) / sizeof(char*));
+	int *owners = malloc(sizeof(int) * length);
+	assert(NULL != owners);
+	for (int r = 0; r < length; r++) owners[r] = -1;
+
+	int interval_count = 0;
+	for (int t = 0; t < temporaries; t++) {
+		if (-1 != starts[t]) interval_count++;
+	}
+	bool *is_spilled = NULL;
+	for (int i = 0; i < interval_count; i++) {
+		int temporary = sorted[i];
+
+		/* hand out the lowest free register, freeing the expired ones on the way */
+		int chosen = -1;
+		for (int r = 1; r < length - 1; r++) {
+			if (-1 != owners[r] && ends[owners[r]] + 1 < starts[temporary]) owners[r] = -1;
+			if (-1 == chosen && -1 == owners[r]) chosen = r;
+		}
+
+		if (-1 == chosen) {
+			int spilled = temporary < first_spill ? temporary : -1;
+			for (int r = 1; r < length - 1; r++) {
+				if (owners[r] < first_spill && (-1 == spilled || ends[owners[r]] > ends[spilled])) spilled = owners[r];
+			}
+			assert(-1 != spilled);
+
+			if (NULL == is_spilled) is_spilled = calloc(temporaries, sizeof(bool));
+			assert(NULL != is_spilled);
+			is_spilled[spilled] = true;
+			if (spilled == temporary) continue;
+
+			chosen = allocated_registers[spilled];
+			allocated_registers[spilled] = 0;
+		}
+
+		owners[chosen] = temporary;
+		allocated_registers[temporary] = chosen;
+		if (chosen > register_count) register_count = chosen;
+	}
+
+	free(starts);
+	free(ends);
+	free(bucket_starts);
+	free(sorted);
+	free(owners);
+	dataflow_destroy(liveness);
+	cfg_destroy(cfg);
+	return is_spilled;
+}
+
+static bool mips_is_spilled(struct ir_operand *operand, bool *is_spilled) {
+	return (
+		NULL != operand && OPERAND_TEMPORARY == operand->kind &&
+		operand->data.temporary < allocated_registers_size && is_spilled[operand->data.temporary]
+	);
+}
+
+/*
+ * Spills everywhere: every definition of a spilled temporary gets a fresh
+ * one stored to the temporary's stack slot right after it, and every read a
+ * fresh one loaded right before it (shared with the instruction just above
+ * when that read it too, which keeps an assignment passed as an argument
+ * next to its parameter). Temporaries only ever set to one constant are
+ * loaded with that constant again instead of going through a slot.
+ */
+static void mips_spill_temporaries(struct ir_list *proc_begin, bool *is_spilled) {
+	int temporaries = allocated_registers_size;
+	struct symbol_table *table = symbol_get_procedure_table(proc_begin->data->operands[1].data.name);
+	struct ir_instruction **slots = calloc(temporaries, sizeof(struct ir_instruction *));
+	struct ir_instruction **constants = calloc(temporaries, sizeof(struct ir_instruction *));
+	int *definition_counts = calloc(temporaries, sizeof(int));
+	struct ir_list **readers = calloc(temporaries, sizeof(struct ir_list *));
+	int *reloads = calloc(temporaries, sizeof(int));
+	assert(NULL != table && NULL != slots && NULL != constants && NULL != definition_counts);
+	assert(NULL != readers && NULL != reloads);
+
+	for (struct ir_list *iter = proc_begin; IR_PROC_END != iter->data->kind; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (!mips_is_spilled(definition, is_spilled)) continue;
+
+		int temporary = definition->data.temporary;
+		definition_counts[temporary]++;
+		if (IR_CONST_INT == iter->data->kind) constants[temporary] = iter->data;
+	}
+	for (int t = 0; t < temporaries; t++) {
+		if (!is_spilled[t]) continue;
+		if (1 != definition_counts[t]) constants[t] = NULL;
+		if (NULL == constants[t]) slots[t] = ir_address_of_local(symbol_put_spill(table));
+	}
+
+	for (struct ir_list *iter = proc_begin->next; IR_PROC_END != iter->data->kind; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		struct ir_list *previous = iter->prev;
+		if (!instruction->is_used) continue;
+
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (!mips_is_spilled(use, is_spilled)) continue;
+
+			int temporary = use->data.temporary;
+			if (readers[temporary] != previous && readers[temporary] != iter) {
+				struct ir_instruction *reload;
+				if (NULL != constants[temporary]) {
+					reload = ir_instruction(IR_CONST_INT);
+					ir_operand_temporary(reload, 0);
+					ir_operand_copy(reload, 1, &constants[temporary]->operands[1]);
+					reload->is_used = constants[temporary]->is_used;
+					if (NULL != ir_get_const_map_entry(temporary)) {
+						ir_update_constants_map(reload->operands[0].data.temporary, reload->operands[1].data.number);
+					}
+				} else {
+					reload = ir_instruction(IR_LOAD_WORD);
+					ir_operand_temporary(reload, 0);
+					ir_operand_copy(reload, 1, &slots[temporary]->operands[0]);
+					reload->offset_variable = slots[temporary];
+				}
+				ir_insert_before(iter, reload);
+				reloads[temporary] = reload->operands[0].data.temporary;
+			}
+			readers[temporary] = iter;
+			use->data.temporary = reloads[temporary];
+		}
+
+		struct ir_operand *definition = ir_definition_operand(instruction);
+		if (!mips_is_spilled(definition, is_spilled)) continue;
+
+		int temporary = definition->data.temporary;
+		definition->data.temporary = next_temporary++;
+		if (NULL != constants[temporary]) continue;
+
+		struct ir_instruction *store = ir_instruction(IR_STORE_WORD);
+		ir_operand_copy(store, 0, &slots[temporary]->operands[0]);
+		ir_operand_copy(store, 1, definition);
+		store->offset_variable = slots[temporary];
+		iter = ir_insert_after(iter, store);
+	}
+
+	/* every read loads its constant itself now */
+	for (int t = 0; t < temporaries; t++) {
+		if (NULL != constants[t]) constants[t]->is_used = false;
+	}
+
+	free(slots);
+	free(constants);
+	free(definition_counts);
+	free(readers);
+	free(reloads);
+}
+
+/* scans again after each round of spilling; the spill slots join the function's frame */
+static void mips_allocate_registers(struct ir_list *proc_begin) {
+	int first_spill = next_temporary;
+	while (true) {
+		bool *is_spilled = mips_scan_registers(proc_begin, first_spill);
+		if (NULL == is_spilled) break;
+
+		mips_spill_temporaries(proc_begin, is_spilled);
+		free(is_spilled);
+	}
+}
+
+static void mips_release_registers(void) {
+	free(allocated_registers);
+	allocated_registers = NULL;
+	allocated_registers_size = 0;
+	free(use_counts);
+	use_counts = NULL;
 }
 
 static const char* mips_get_address_of_variable(struct ir_instruction *instruction) {
 	assert(NULL != instruction);
+
+	/* globals and string literals are at their label, not in the frame */
+	if (instruction->operands[2].data.is_string || instruction->operands[6].data.number) {
+		return instruction->operands[1].data.name;
+	}
+
 	const char *address =
 		get_value(variable_address_map, instruction->operands[3].data.variable_id);
 
@@ -239,11 +528,126 @@ static void mips_restore_t_registers(FILE *output) {
 	}
 }
 
+/*
+ * A comparison is only folded into the branch after it when that branch
+ * tests the comparison's own result and nothing else reads it; anything
+ * placed in between (e.g. the copies inserted when leaving SSA form) keeps
+ * them as separate instructions, and so does a result read again later,
+ * which needs its register set.
+ */
+static bool mips_is_fused_comparison(struct ir_list *ir_list) {
+	if (!mips_is_optimization_mid()) return false;
+	if (NULL == ir_list || NULL == ir_list->next) return false;
+
+	struct ir_instruction *comparison = ir_list->data;
+	struct ir_instruction *branch = ir_list->next->data;
+
+	if (comparison->kind < IR_LT_SIGNED_WORD || comparison->kind > IR_NE_WORD) return false;
+	if (IR_GOTO_IF_FALSE != branch->kind && IR_GOTO_IF_TRUE != branch->kind) return false;
+
+	int temporary = comparison->operands[0].data.temporary;
+	return (
+		branch->operands[0].data.temporary == temporary &&
+		NULL != use_counts && temporary < allocated_registers_size && 1 == use_counts[temporary]
+	);
+}
+
+/*
+ * A tail call pops the caller's frame before jumping to the callee, so no
+ * argument may point into it: the function only loads and stores through
+ * the addresses of its variables.
+ */
+static bool mips_allows_tail_calls(struct ir_list *proc_begin) {
+	bool *addresses = calloc(next_temporary, sizeof(bool));
+	assert(NULL != addresses);
+	bool allowed = true;
+
+	for (struct ir_list *iter = proc_begin; IR_PROC_END != iter->data->kind; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		if (
+			IR_ADDRESS_OF == instruction->kind &&
+			!instruction->operands[2].data.is_string &&
+			!instruction->operands[6].data.number
+		) {
+			addresses[instruction->operands[0].data.temporary] = true;
+		}
+	}
+
+	for (struct ir_list *iter = proc_begin; IR_PROC_END != iter->data->kind && allowed; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		bool is_load = instruction->kind >= IR_LOAD_WORD && instruction->kind <= IR_LOAD_SIGNED_BYTE;
+		bool is_store = instruction->kind >= IR_STORE_WORD && instruction->kind <= IR_STORE_BYTE;
+
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (OPERAND_TEMPORARY != use->kind || !addresses[use->data.temporary]) continue;
+			if (is_load && use == &instruction->operands[1]) continue;
+			if (is_store && use == &instruction->operands[0]) continue;
+			allowed = false;
+		}
+	}
+
+	free(addresses);
+	return allowed;
+}
+
+/*
+ * A call is a tail call when all that follows it returns its result: result
+ * r, return r, then a goto to the label before procEnd (or that label right
+ * away). The callee then returns straight to our caller.
+ */
+static bool mips_is_tail_call(struct ir_list *ir_list) {
+	if (!mips_is_optimization_mid() || !tail_calls_allowed) return false;
+	if (IR_CALL != ir_list->data->kind) return false;
+
+	struct ir_list *iter = ir_list->next;
+	struct ir_operand *result = NULL;
+
+	if (IR_RESULT_WORD <= iter->data->kind && IR_RESULT_BYTE >= iter->data->kind) {
+		result = &iter->data->operands[0];
+		iter = iter->next;
+	}
+	if (IR_RETURN_WORD <= iter->data->kind && IR_RETURN_BYTE >= iter->data->kind) {
+		if (NULL == result || !ir_operand_equals(result, &iter->data->operands[0])) return false;
+		iter = iter->next;
+	}
+
+	if (IR_GOTO == iter->data->kind) {
+		char *exit = iter->data->operands[0].data.name;
+		while (IR_PROC_END != iter->data->kind) iter = iter->next;
+		return IR_LABEL == iter->prev->data->kind && 0 == strcmp(exit, iter->prev->data->operands[0].data.name);
+	}
+
+	/* or it falls through labels into procEnd */
+	while (IR_LABEL == iter->data->kind) iter = iter->next;
+	return IR_PROC_END == iter->data->kind;
+}
+
+/* the result, return and goto of a tail call never run */
+static bool mips_is_after_tail_call(struct ir_list *ir_list) {
+	enum ir_instruction_kind kind = ir_list->data->kind;
+	if (IR_GOTO != kind && !(IR_RESULT_WORD <= kind && IR_RESULT_BYTE >= kind) &&
+		!(IR_RETURN_WORD <= kind && IR_RETURN_BYTE >= kind)) {
+		return false;
+	}
+
+	for (struct ir_list *iter = ir_list->prev; NULL != iter; iter = iter->prev) {
+		kind = iter->data->kind;
+		if (IR_CALL == kind) return mips_is_tail_call(iter);
+		if (!(IR_RESULT_WORD <= kind && IR_RESULT_BYTE >= kind) && !(IR_RETURN_WORD <= kind && IR_RETURN_BYTE >= kind)) {
+			return false;
+		}
+	}
+	return false;
+}
+
 static bool mips_convert_to_branch_instructions(
 	FILE *output,
 	struct ir_instruction *instruction,
 	struct ir_list *ir_list
 ) {
+	if (NULL == ir_list->prev || !mips_is_fused_comparison(ir_list->prev)) return false;
+
 	// get type of parent instruction
 	struct ir_instruction parent_insrtuction = *ir_list->prev->data;
 	enum ir_instruction_kind parent_kind = parent_insrtuction.kind;
@@ -261,67 +665,94 @@ static bool mips_convert_to_branch_instructions(
 		IR_NE_WORD
 	*/
 
+	/* taken when the comparison holds (gotoIfTrue) */
 	static char *opcodes[] = {
-	  "ble",       /* branch on less than signed */
+	  "blt",       /* branch on less than signed */
 	  "bltu",      /* branch on less than unsigned */
 	  "ble",       /* branch on less than equal signed */
 	  "bleu",      /* branch on less than equal unsigned */
 	  "bge",       /* branch on great than equal signed */
 	  "bgeu",      /* branch on great than equal unsigned */
-	  "bgt",       /* branch on great than unsigned */
+	  "bgt",       /* branch on great than signed */
 	  "bgtu",      /* branch on great than unsigned */
 	  "beq",       /* branch on equal */
 	  "bne"        /* branch on not equal */
 	};
 
+	/* taken when the comparison fails (gotoIfFalse) */
+	static char *opcodes_negated[] = {
+	  "bge",       /* branch on great than equal signed */
+	  "bgeu",      /* branch on great than equal unsigned */
+	  "bgt",       /* branch on great than signed */
+	  "bgtu",      /* branch on great than unsigned */
+	  "blt",       /* branch on less than signed */
+	  "bltu",      /* branch on less than unsigned */
+	  "ble",       /* branch on less than equal signed */
+	  "bleu",      /* branch on less than equal unsigned */
+	  "bne",       /* branch on not equal */
+	  "beq"        /* branch on equal */
+	};
+
+	/* register compared against zero, NULL for the unsigned orderings */
 	static char *opcodes_immediate[] = {
 	  "bltz",      /* branch on less than zero */
-	  "bltz",      /* branch on less than zero */
-	  "blez",      /* branch on less than equal zero */
+	  NULL,
 	  "blez",      /* branch on less than equal zero */
+	  NULL,
 	  "bgez",      /* branch on great than equal zero */
-	  "bgez",      /* branch on great than equal zero */
-	  "bgtz",      /* branch on great than zero */
+	  NULL,
 	  "bgtz",      /* branch on great than zero */
+	  NULL,
 	  "beqz",      /* branch on equal zero */
 	  "bnez",      /* branch on not equal zero */
 	};
 
+	/* the same comparison with its operands swapped: a < b is b > a */
+	static enum ir_instruction_kind swapped[] = {
+		IR_GT_SIGNED_WORD, IR_GT_UNSIGNED_WORD, IR_GE_SIGNED_WORD, IR_GE_UNSIGNED_WORD,
+		IR_LE_SIGNED_WORD, IR_LE_UNSIGNED_WORD, IR_LT_SIGNED_WORD, IR_LT_UNSIGNED_WORD,
+		IR_EQ_WORD, IR_NE_WORD
+	};
+
+	/* the opposite comparison: a < b fails exactly when a >= b */
+	static enum ir_instruction_kind negated[] = {
+		IR_GE_SIGNED_WORD, IR_GE_UNSIGNED_WORD, IR_GT_SIGNED_WORD, IR_GT_UNSIGNED_WORD,
+		IR_LT_SIGNED_WORD, IR_LT_UNSIGNED_WORD, IR_LE_SIGNED_WORD, IR_LE_UNSIGNED_WORD,
+		IR_NE_WORD, IR_EQ_WORD
+	};
+
 	/* check if any value in comparison is a 0 */
 	const char *constant_1 = ir_get_const_map_entry(parent_insrtuction.operands[1].data.temporary);
 	const char *constant_2 = ir_get_const_map_entry(parent_insrtuction.operands[2].data.temporary);
 
-	if (NULL != constant_1 && NULL == constant_2) {
-		/* constant_1 is a constant and constant_2 is not */
-		int constant = atoi(constant_1);
-		if (constant == 0) {
-			fprintf(output, "\t%s\t$%s, %s\n",
-				/* subtracting 22 to remove the offset comning from ir_instruction_kind */
-				opcodes_immediate[parent_kind - 22],
-				mips_get_register_from_temp(parent_insrtuction.operands[2].data.temporary),
-				instruction->operands[1].data.name
-			);
-			return true;
-		}
-	} else if (NULL != constant_2 && NULL == constant_1) {
-		/* constant_2 is a constant and constant_1 is not */
-		int constant = atoi(constant_2);
-		if (constant == 0) {
-			fprintf(output, "\t%s\t$%s, %s\n",
-				/* subtracting 22 to remove the offset comning from ir_instruction_kind */
-				opcodes_immediate[parent_kind - 22],
-				mips_get_register_from_temp(parent_insrtuction.operands[1].data.temporary),
-				instruction->operands[1].data.name
-			);
-			return true;
-		}
+	int register_operand = 0;
+	enum ir_instruction_kind zero_kind = parent_kind;
+	if (NULL != constant_2 && NULL == constant_1 && 0 == atoi(constant_2)) {
+		/* x op 0 */
+		register_operand = 1;
+	} else if (NULL != constant_1 && NULL == constant_2 && 0 == atoi(constant_1)) {
+		/* 0 op x is x op' 0 */
+		register_operand = 2;
+		zero_kind = swapped[parent_kind - IR_LT_SIGNED_WORD];
+	}
+	if (IR_GOTO_IF_FALSE == instruction->kind) {
+		zero_kind = negated[zero_kind - IR_LT_SIGNED_WORD];
+	}
+
+	if (0 != register_operand && NULL != opcodes_immediate[zero_kind - IR_LT_SIGNED_WORD]) {
+		fprintf(output, "\t%s\t$%s, %s\n",
+			opcodes_immediate[zero_kind - IR_LT_SIGNED_WORD],
+			mips_get_register_from_temp(parent_insrtuction.operands[register_operand].data.temporary),
+			instruction->operands[1].data.name
+		);
+		return true;
 	}
 
 	fprintf(output, "\t%s\t$%s, $%s, %s\n",
 	  /* subtracting 22 to remove the offset comning from ir_instruction_kind */
-	  opcodes[parent_kind - 22],
-	  mips_get_register_from_temp(parent_insrtuction.operands[2].data.temporary),
+	  IR_GOTO_IF_FALSE == instruction->kind ? opcodes_negated[parent_kind - 22] : opcodes[parent_kind - 22],
 	  mips_get_register_from_temp(parent_insrtuction.operands[1].data.temporary),
+	  mips_get_register_from_temp(parent_insrtuction.operands[2].data.temporary),
 	  instruction->operands[1].data.name
 	);
 
@@ -394,13 +825,27 @@ static bool mips_use_load_offset(FILE *output, struct ir_instruction *instructio
 	if (NULL == instruction->offset_variable) return false;
 
 	switch (instruction->kind) {
-		case IR_LOAD_WORD:
+		case IR_LOAD_WORD: {
+			fprintf(output,
+				"\tlw\t$%s, %s\n",
+				mips_get_next_available_register(instruction->operands[0].data.temporary),
+				mips_get_address_of_variable(instruction->offset_variable)
+			);
+			return true;
+		}
 		case IR_LOAD_HALF_WORD:
-		case IR_LOAD_SIGNED_HALF_WORD:
+		case IR_LOAD_SIGNED_HALF_WORD: {
+			fprintf(output,
+				"\tlh\t$%s, %s\n",
+				mips_get_next_available_register(instruction->operands[0].data.temporary),
+				mips_get_address_of_variable(instruction->offset_variable)
+			);
+			return true;
+		}
 		case IR_LOAD_BYTE:
 		case IR_LOAD_SIGNED_BYTE: {
 			fprintf(output,
-				"\tlw\t$%s, %s\n",
+				"\tlb\t$%s, %s\n",
 				mips_get_next_available_register(instruction->operands[0].data.temporary),
 				mips_get_address_of_variable(instruction->offset_variable)
 			);
@@ -543,6 +988,21 @@ void mips_print_arithmetic(FILE *output, struct ir_instruction *instruction) {
 	}
 }
 
+/* mult/multu leave the 64 bit product in hi:lo, the upper word is the result */
+void mips_print_mult_high(FILE *output, struct ir_instruction *instruction) {
+	assert(IR_MULT_HIGH_SIGNED_WORD == instruction->kind || IR_MULT_HIGH_UNSIGNED_WORD == instruction->kind);
+
+	fprintf(output, "\t%s\t$%s, $%s\n",
+		IR_MULT_HIGH_SIGNED_WORD == instruction->kind ? "mult" : "multu",
+		mips_get_register_from_temp(instruction->operands[1].data.temporary),
+		mips_get_register_from_temp(instruction->operands[2].data.temporary)
+	);
+	fprintf(output,
+		"\tmfhi\t$%s\n",
+		mips_get_next_available_register(instruction->operands[0].data.temporary)
+	);
+}
+
 static int mips_get_max_block_size(struct symbol_table *table, int size) {
 	if (NULL == table->children->self) return mips_round_up_to_double_word_boundry(size);
 
@@ -579,7 +1039,7 @@ void mips_print_load_address(FILE *output, struct ir_instruction *instruction) {
 		fprintf(output,
 			"\tla\t$%s, %s\n",
 			mips_get_next_available_register(instruction->operands[0].data.temporary),
-			instruction->operands[2].data.name
+			instruction->operands[1].data.name
 		);
 	} else {
 		bool is_global = instruction->operands[6].data.number;
@@ -879,6 +1339,16 @@ void mips_print_result(FILE *output, struct ir_instruction *instruction) {
 	);
 }
 
+void mips_print_copy(FILE *output, struct ir_instruction *instruction) {
+	assert(IR_COPY == instruction->kind);
+
+	fprintf(output,
+		"\tmove\t$%s, $%s\n",
+		mips_get_next_available_register(instruction->operands[0].data.temporary),
+		mips_get_register_from_temp(instruction->operands[1].data.temporary)
+	);
+}
+
 void mips_print_function(FILE *output, struct ir_instruction *instruction) {
 	assert(IR_PROC_BEGIN == instruction->kind);
 
@@ -898,7 +1368,7 @@ void mips_print_function(FILE *output, struct ir_instruction *instruction) {
 	
 	/* create pair of (variable,size) so that we can save them in the stack */
 	int initial_size = 30;
-	char** variables_names = malloc(sizeof(char) * initial_size);
+	char** variables_names = malloc(sizeof(char *) * initial_size);
 	int* variables_sizes = malloc(sizeof(int) * initial_size);
 	int variables_count = 0;
 
@@ -907,10 +1377,10 @@ void mips_print_function(FILE *output, struct ir_instruction *instruction) {
 		size += variable_size;
 
 		/* populate pairs */
-		if (variables_count > initial_size) {
+		if (variables_count == initial_size) {
 			initial_size *= 2;
-			variables_names = malloc(sizeof(char) * initial_size);
-			variables_sizes = malloc(sizeof(int) * initial_size);
+			variables_names = realloc(variables_names, sizeof(char *) * initial_size);
+			variables_sizes = realloc(variables_sizes, sizeof(int) * initial_size);
 		}
 		variables_names[variables_count] = iter->symbol.name;
 		variables_sizes[variables_count] = variable_size;
@@ -970,21 +1440,20 @@ void mips_print_function(FILE *output, struct ir_instruction *instruction) {
 	free(iter);
 }
 
-void mips_print_function_reset(FILE *output, struct ir_instruction *instruction) {
-	assert(IR_PROC_END == instruction->kind);
-
-	fprintf(output, "\n");
+/* restores what the prologue saved and pops the frame, leaving fp_offset_low as it was */
+static void mips_print_epilogue(FILE *output) {
+	int offset = fp_offset_low;
 
 	/* restore 'ra' register */
-	fp_offset_low -= 4;
-	fprintf(output, "\tlw\t$ra, %d($fp)\n", fp_offset_low);
+	offset -= 4;
+	fprintf(output, "\tlw\t$ra, %d($fp)\n", offset);
 
-	fp_offset_low -= 4;
+	offset -= 4;
 
 	/* restore 's' registers */
 	for(int j = 7; j >= 0; j--) {
-		fp_offset_low -= 4;
-		fprintf(output, "\tlw\t$s%d, %d($fp)\n", j, fp_offset_low);
+		offset -= 4;
+		fprintf(output, "\tlw\t$s%d, %d($fp)\n", j, offset);
 	}
 
 	/* restore old fp */
@@ -992,11 +1461,20 @@ void mips_print_function_reset(FILE *output, struct ir_instruction *instruction)
 
 	/* pop off our stack frame */
 	fprintf(output, "\taddiu\t$sp, $sp, %d\n", total_stack_size);
+}
+
+void mips_print_function_reset(FILE *output, struct ir_instruction *instruction) {
+	assert(IR_PROC_END == instruction->kind);
+
+	fprintf(output, "\n");
+
+	mips_print_epilogue(output);
 
 	/* return to caller */
 	fprintf(output, "\tjr\t$ra\n");
 
 	free_hash_map(temp_register_map);
+	mips_release_registers();
 	register_count = 0;
 	free_hash_map(variable_address_map);
 }
@@ -1017,6 +1495,17 @@ void mips_print_function_call(FILE *output, struct ir_instruction *instruction)
 	mips_restore_t_registers(output);
 }
 
+/* the arguments are in the a registers already: leave the frame and let the callee return for us */
+void mips_print_tail_call(FILE *output, struct ir_instruction *instruction) {
+	assert(IR_CALL == instruction->kind);
+
+	/* reset a registers */
+	arg_register_count = 0;
+
+	mips_print_epilogue(output);
+	fprintf(output, "\tj\t%s\n", instruction->operands[0].data.name);
+}
+
 void mips_print_sys_function_call(FILE *output, struct ir_instruction *instruction) {
 	assert(IR_SYS_CALL == instruction->kind);
 
@@ -1039,10 +1528,15 @@ void mips_print_parameter(FILE *output, struct ir_instruction *instruction, stru
 
 	printf("\n");
 
+	/* an assignment as the argument, f(x = 3), passes the address it stored to */
 	if (
-		IR_STORE_WORD  == parent_instruction.kind ||
-		IR_STORE_HALF_WORD == parent_instruction.kind ||
-		IR_STORE_BYTE == parent_instruction.kind
+		(
+			IR_STORE_WORD  == parent_instruction.kind ||
+			IR_STORE_HALF_WORD == parent_instruction.kind ||
+			IR_STORE_BYTE == parent_instruction.kind
+		) &&
+		OPERAND_TEMPORARY == parent_instruction.operands[0].kind &&
+		parent_instruction.operands[0].data.temporary == instruction->operands[1].data.temporary
 	) {
 		fprintf(output,
 			"\tlw\t$%s, 0($%s)\n",
@@ -1088,17 +1582,8 @@ void mips_print_comparison(FILE *output, struct ir_instruction *instruction, str
 		IR_BITWISE_OR_WORD
 	*/
 
-	if (mips_is_optimization_mid()) {
-		/* check if its followed by an if/loop condition */
-		if (NULL != ir_list->next) {
-			if (
-				IR_GOTO_IF_FALSE == ir_list->next->data->kind ||
-				IR_GOTO_IF_TRUE == ir_list->next->data->kind
-			) {
-				return;
-			}
-		}
-	}
+	/* check if its followed by an if/loop condition */
+	if (mips_is_fused_comparison(ir_list)) return;
 
 	static char *opcodes[] = {
 		"slt",       /* set less than signed */
@@ -1149,7 +1634,7 @@ void mips_print_branch_instruction(FILE *output, struct ir_instruction *instruct
 			);
 		}
 		if (IR_GOTO_IF_TRUE == instruction->kind) {
-			fprintf(output, "\n\tbgtz\t$%s %s\n",
+			fprintf(output, "\n\tbnez\t$%s %s\n",
 				mips_get_register_from_temp(instruction->operands[0].data.number),
 				instruction->operands[1].data.name
 			);
@@ -1161,10 +1646,16 @@ void mips_print_instruction(FILE *output, struct ir_list *ir_list) {
 	struct ir_instruction *instruction = ir_list->data;
 
 	if (!instruction->is_used) return;
+	if (mips_is_after_tail_call(ir_list)) return;
 
 	switch (instruction->kind) {
 		case IR_PROC_BEGIN: 
+			/* before the prologue, which sizes the frame with any spill slots */
+			if (mips_is_optimization_low()) {
+				mips_allocate_registers(ir_list);
+			}
 			mips_print_function(output, instruction);
+			tail_calls_allowed = mips_is_optimization_mid() && mips_allows_tail_calls(ir_list);
 			break;
 		case IR_PROC_END: 
 			mips_print_function_reset(output, instruction);
@@ -1173,7 +1664,11 @@ void mips_print_instruction(FILE *output, struct ir_list *ir_list) {
 			mips_print_parameter(output, instruction, ir_list);
 			break;
 		case IR_CALL: 
-			mips_print_function_call(output, instruction);
+			if (mips_is_tail_call(ir_list)) {
+				mips_print_tail_call(output, instruction);
+			} else {
+				mips_print_function_call(output, instruction);
+			}
 			break;
 		case IR_SYS_CALL: 
 			mips_print_sys_function_call(output, instruction);
@@ -1204,6 +1699,10 @@ void mips_print_instruction(FILE *output, struct ir_list *ir_list) {
 		case IR_RIGHT_SHIFT_UNSIGNED_WORD:
 			mips_print_arithmetic(output, instruction);
 			break;
+		case IR_MULT_HIGH_SIGNED_WORD:
+		case IR_MULT_HIGH_UNSIGNED_WORD:
+			mips_print_mult_high(output, instruction);
+			break;
 		case IR_LOAD_WORD:
 		case IR_LOAD_HALF_WORD:
 		case IR_LOAD_SIGNED_HALF_WORD:
@@ -1227,6 +1726,9 @@ void mips_print_instruction(FILE *output, struct ir_list *ir_list) {
 		case IR_RESULT_BYTE:
 			mips_print_result(output, instruction);
 			break;
+		case IR_COPY:
+			mips_print_copy(output, instruction);
+			break;
 		case IR_LT_SIGNED_WORD:
 		case IR_LT_UNSIGNED_WORD:
 		case IR_LE_SIGNED_WORD:
@@ -1282,7 +1784,7 @@ void mips_print_data_section(FILE *output) {
 		global_table_iter != NULL;
 		global_table_iter = global_table_iter->next
 	) {
-		if (!global_table_iter->symbol.is_only_for_saving_type) {
+		if (!global_table_iter->symbol.is_only_for_saving_type && global_table_iter->symbol.is_referenced) {
 			int kind = global_table_iter->symbol.type_tree->type->kind;
 			int datatype = global_table_iter->symbol.type_tree->type->data.basic.datatype;
 			if (datatype == TYPE_BASIC_CHAR || kind == TYPE_FUNCTION) continue;
@@ -1294,6 +1796,7 @@ void mips_print_data_section(FILE *output) {
 	/* traverse string_table and print each string */
 	struct string_symbol_list *iter;
 	for (iter = string_table; iter != NULL; iter = iter->next) {
+		if (!iter->string_symbol.is_referenced) continue;
 		fprintf(output, "%s:\t.asciiz\t%s\n", iter->string_symbol.id, iter->string_symbol.string);
 	}
 
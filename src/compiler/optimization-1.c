@@ -3,6 +3,7 @@
 #include <assert.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
 
 #include "mips.h"
 #include "type.h"
@@ -18,362 +19,445 @@ extern int next_temporary;
 
 static void ir_update_const_value(struct ir_instruction *instruction, int new_value) {
 	assert(IR_CONST_INT == instruction->kind);
-	ir_operand_number(instruction, 1, new_value);
+	/* kept as the 32 bit pattern, li takes it as is */
+	ir_operand_number(instruction, 1, (uint32_t)new_value);
 	ir_update_constants_map(instruction->operands[0].data.temporary, new_value);
 }
 
-static struct ir_instruction *ir_create_shift_instruction(
-	struct ir_instruction *original_instruction, struct ir_instruction *old_instruction,
-	int constant, int is_add, enum ir_instruction_kind kind
-) {
-	struct ir_instruction *const_instruction = ir_instruction(IR_CONST_INT);
-	ir_operand_temporary(const_instruction, 0);
-	ir_operand_number(const_instruction, 1, mylog2(constant));
-	ir_insert(old_instruction, const_instruction, NULL);
-
-	struct ir_instruction *shift_instruction = ir_instruction(kind);
-	ir_operand_temporary(shift_instruction, 0);
-	ir_operand_copy(shift_instruction, 1, &original_instruction->operands[1]);
-	ir_operand_copy(shift_instruction, 2, &const_instruction->operands[0]);
-	ir_insert(const_instruction, shift_instruction, NULL);
-
-	struct ir_instruction *add_instruction = ir_instruction(is_add ? IR_ADD_SIGNED_WORD : IR_SUB_SIGNED_WORD);
-	ir_operand_temporary(add_instruction, 0);
-	ir_operand_copy(add_instruction, 1, &old_instruction->operands[0]);
-	ir_operand_copy(add_instruction, 2, &shift_instruction->operands[0]);
-	ir_insert(shift_instruction, add_instruction, old_instruction);
-	
-	return add_instruction;
+/*
+ * The rules of identity.rules, compiled into identity-rules.h, rewrite an
+ * instruction in place: into a copy, a constant, or the last of a few
+ * cheaper instructions expanded in front of it, which takes over the
+ * original instruction and its temporary.
+ */
+static uint32_t ir_constant_value(const char *constant) {
+	return (uint32_t)atoi(constant);
 }
 
-static void ir_change_instruction_to_shift(struct ir_instruction *instruction, enum ir_instruction_kind new_kind) {
-	assert(NULL != instruction);
-	assert(NULL != ir_list);
-
-	instruction->kind = new_kind;
+static void ir_rewrite_copy(struct ir_instruction *instruction, struct ir_operand *operand) {
+	ir_operand_copy(instruction, 1, operand);
+	instruction->kind = IR_COPY;
 }
 
-static void ir_convert_mult_to_shift(struct ir_instruction *instruction, int constant) {
-	/* find nearest power of two and adjust the remaining with add/sub */
-	int power_of_two = find_nearest_power_of_two(constant);
-	int remaining = abs(constant - power_of_two);
-	bool is_add = power_of_two < constant;
-	ir_change_instruction_to_shift(instruction, IR_LEFT_SHIFT_WORD);
-	struct ir_instruction *instruction_1 = ir_get_instruction_by_temporary(
-		instruction->operands[2].data.temporary
-	);
-	ir_update_const_value(instruction_1, mylog2(power_of_two));
-	struct ir_instruction *old_instruction = instruction;
-	/*
-	 * Here we apply the same left-shift logic to the leftover of 2^n
-	 * we do this until we reach 0
-	 * for example: a*50 => (a*64) - (a*14) => (a << 6) - (a*16 - (a*2)) => (a << 6) - ((a << 4) - (a << 1))
-	*/
-	while (remaining > 0) {
-		power_of_two = find_nearest_power_of_two(remaining);
-		remaining = abs(remaining - power_of_two);
-		if (!power_of_two) break;
-		struct ir_instruction *new_instruction = ir_create_shift_instruction(
-			instruction,
-			old_instruction,
-			power_of_two,
-			is_add,
-			IR_LEFT_SHIFT_WORD
-		);
-		old_instruction = new_instruction;
-		is_add = true;
-	}
+static void ir_rewrite_constant(struct ir_instruction *instruction, uint32_t value) {
+	instruction->kind = IR_CONST_INT;
+	ir_update_const_value(instruction, (int)value);
 }
 
-static void ir_perform_identity_sub_optimization(struct ir_instruction *instruction) {
-	assert(NULL != instruction);
-	assert(NULL != ir_list);
-
-	bool is_unsigned = IR_SUB_UNSIGNED_WORD == instruction->kind;
+/* temporary -> how many instructions write it, counted before the rewrites start */
+static int *definition_counts;
+static int definition_count_size;
 
-	const char *constant_1 = ir_get_const_map_entry(instruction->operands[1].data.temporary);
-	const char *constant_2 = ir_get_const_map_entry(instruction->operands[2].data.temporary);
+static void ir_count_definitions(void) {
+	definition_count_size = next_temporary;
+	definition_counts = calloc(definition_count_size, sizeof(int));
+	assert(NULL != definition_counts);
 
-	if (NULL != constant_1 && NULL == constant_2) {
-		int constant = atoi(constant_1);
+	for (struct ir_list *iter = ir_list; NULL != iter; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL == definition || OPERAND_TEMPORARY != definition->kind) continue;
+		if (definition->data.temporary < definition_count_size) definition_counts[definition->data.temporary]++;
+	}
+}
 
-		/* remove a +/- 0 */
-		if (constant == 0) {
-			ir_remove_instruction_from_list(instruction);
-		}
-	} 
-	if (NULL != constant_2 && NULL == constant_1) {
-		int constant = atoi(constant_2);
+/* the two arms of a ternary write the same temporary, neither of them is its only value */
+static bool ir_is_redefined(int temporary) {
+	return temporary < definition_count_size && definition_counts[temporary] > 1;
+}
 
-		/* remove a +/- 0 */
-		if (constant == 0) {
-			ir_remove_instruction_from_list(instruction);
+/* nothing reads the temporary */
+static bool ir_is_unused(int temporary) {
+	for (struct ir_list *iter = ir_list; NULL != iter; iter = iter->next) {
+		for (int i = 0; i < ir_use_count(iter->data); i++) {
+			struct ir_operand *operand = ir_use_operand(iter->data, i);
+			if (OPERAND_TEMPORARY == operand->kind && temporary == operand->data.temporary) return false;
 		}
 	}
-	if (NULL != constant_2 && NULL != constant_1) {
-		/* you don't need these constants now */
-		ir_mark_constant_as_obselete(instruction->operands[1].data.temporary);		
-		ir_mark_constant_as_obselete(instruction->operands[2].data.temporary);
-	
-		/* just compute the expression */
-		unsigned int constant_u = atoi(constant_1) - atoi(constant_2);
-		int constant_s = atoi(constant_1) - atoi(constant_2);
-		instruction->kind = IR_CONST_INT;
-		ir_update_const_value(instruction, is_unsigned ? constant_u : constant_s);
-	}
+	return true;
 }
 
-static void ir_perform_identity_add_optimization(struct ir_instruction *instruction) {
-	assert(NULL != instruction);
-	assert(NULL != ir_list);
-
-	const char *constant_1 = ir_get_const_map_entry(instruction->operands[1].data.temporary);
-	const char *constant_2 = ir_get_const_map_entry(instruction->operands[2].data.temporary);
-
-	if (NULL != constant_1 && NULL == constant_2) {
-		int constant = atoi(constant_1);
+static bool ir_is_power_of_two(uint32_t value) {
+	return 0 != value && 0 == (value & (value - 1));
+}
 
-		/* remove a +/- 0 */
-		if (constant == 0) {
-			ir_remove_instruction_from_list(instruction);
-		}
-	} 
-	if (NULL != constant_2 && NULL == constant_1) {
-		int constant = atoi(constant_2);
+static struct ir_operand *ir_expand_constant(struct ir_list *node, uint32_t value) {
+	struct ir_instruction *instruction = ir_instruction(IR_CONST_INT);
+	ir_operand_temporary(instruction, 0);
+	ir_operand_number(instruction, 1, value);
+	ir_insert_before(node, instruction);
+	return &instruction->operands[0];
+}
 
-		/* remove a +/- 0 */
-		if (constant == 0) {
-			ir_remove_instruction_from_list(instruction);
-		}
-	}
-	if (NULL != constant_2 && NULL != constant_1) {
-		/* you don't need these constants now */
-		ir_mark_constant_as_obselete(instruction->operands[1].data.temporary);		
-		ir_mark_constant_as_obselete(instruction->operands[2].data.temporary);
-	
-		/* just compute the expression */
-		int constant = atoi(constant_1) + atoi(constant_2);
-		instruction->kind = IR_CONST_INT;
-		ir_update_const_value(instruction, constant);
+/* kind(left, right) into a new temporary before the node, or into the instruction at the node as its last step */
+static struct ir_operand *ir_expand_step(
+	struct ir_list *node, bool is_last,
+	enum ir_instruction_kind kind, struct ir_operand *left, struct ir_operand *right
+) {
+	struct ir_operand left_operand = *left, right_operand;
+	struct ir_instruction *instruction = node->data;
+
+	if (NULL != right) right_operand = *right;
+	if (!is_last) {
+		instruction = ir_instruction(kind);
+		ir_operand_temporary(instruction, 0);
+		ir_insert_before(node, instruction);
 	}
+	instruction->kind = kind;
+	ir_operand_copy(instruction, 1, &left_operand);
+	if (NULL != right) ir_operand_copy(instruction, 2, &right_operand);
+	return &instruction->operands[0];
+}
 
+static struct ir_operand *ir_expand_shift(
+	struct ir_list *node, bool is_last, enum ir_instruction_kind kind, struct ir_operand *value, int amount
+) {
+	return ir_expand_step(node, is_last, kind, value, ir_expand_constant(node, amount));
 }
 
-static void ir_perform_identity_multiply_optimization(struct ir_instruction *instruction) {
-	assert(NULL != instruction);
-	assert(NULL != ir_list);
+/*
+ * Multiplication by a constant as a chain of shifts, additions and
+ * subtractions, found by Bernstein's search: each step takes the product so
+ * far t and the operand x to t << k, t + x, t - x, (t << k) + t or
+ * (t << k) - t (or 0 - t for a negative multiplier). The cheapest chain by
+ * the cycle costs below replaces the mult if it is cheaper than the mult and
+ * the wait for its product in lo.
+ */
+#define IR_COST_ADD                 1     /* addu, subu */
+#define IR_COST_SHIFT               2     /* li of the amount and sll, a shift by 1 is an addu */
+#define IR_COST_NEGATE              2     /* li of 0 and subu */
+#define IR_COST_MULT                10    /* mult and mflo, which stalls until the product is there */
+#define IR_MULTIPLY_MAX_STEPS       16
+
+enum ir_multiply_step_kind {
+	IR_MULTIPLY_SHIFT,
+	IR_MULTIPLY_ADD,
+	IR_MULTIPLY_SUB,
+	IR_MULTIPLY_SHIFT_ADD,
+	IR_MULTIPLY_SHIFT_SUB,
+	IR_MULTIPLY_NEGATE
+};
+
+struct ir_multiply_step {
+	enum ir_multiply_step_kind kind;
+	int shift;
+};
+
+struct ir_multiply_chain {
+	struct ir_multiply_step steps[IR_MULTIPLY_MAX_STEPS];
+	int step_count;
+	int cost;
+};
+
+static bool ir_multiply_search(uint32_t multiplier, int limit, struct ir_multiply_chain *best);
+
+static int ir_multiply_shift_cost(int shift) {
+	return 1 == shift ? IR_COST_ADD : IR_COST_SHIFT;
+}
 
-	bool is_unsigned = IR_MULT_UNSIGNED_WORD == instruction->kind;
+/* a chain for x * multiplier followed by the step, if that is cheaper than the limit, which it becomes */
+static bool ir_multiply_extend(
+	uint32_t multiplier, enum ir_multiply_step_kind kind, int shift, int step_cost,
+	int *limit, struct ir_multiply_chain *best
+) {
+	struct ir_multiply_chain chain;
 
-	const char *constant_1 = ir_get_const_map_entry(instruction->operands[1].data.temporary);
-	const char *constant_2 = ir_get_const_map_entry(instruction->operands[2].data.temporary);
+	if (step_cost >= *limit || !ir_multiply_search(multiplier, *limit - step_cost, &chain)) return false;
+	if (IR_MULTIPLY_MAX_STEPS == chain.step_count) return false;
 
-	if (NULL != constant_1 && NULL == constant_2) {
-		int constant = atoi(constant_1);
+	chain.steps[chain.step_count].kind = kind;
+	chain.steps[chain.step_count].shift = shift;
+	chain.step_count++;
+	chain.cost += step_cost;
 
-		/* change a*2 => a << 1 */
-		if (is_power_of_two(constant)) {
-			ir_change_instruction_to_shift(instruction, IR_LEFT_SHIFT_WORD);
-			struct ir_instruction *instruction_1 = ir_get_instruction_by_temporary(
-				instruction->operands[2].data.temporary
-			);
-			ir_update_const_value(instruction_1, mylog2(constant));
-			return;
-		} else {
-			/* find nearest power of two and adjust the remaining with add/sub */
-			ir_convert_mult_to_shift(instruction, constant);
-			return;
-		}
+	*best = chain;
+	*limit = chain.cost;
+	return true;
+}
 
-		/* remove a*1 */
-		if (constant == 1) {
-			ir_remove_instruction_from_list(instruction);
-			return;
-		}
-	} 
-	if (NULL != constant_2 && NULL == constant_1) {
-		int constant = atoi(constant_2);
-
-		/* change a*2 => a << 1 */
-		if (is_power_of_two(constant)) {
-			instruction->kind = IR_LEFT_SHIFT_WORD;
-			struct ir_instruction *instruction_1 = ir_get_instruction_by_temporary(
-				instruction->operands[2].data.temporary
-			);
-			ir_update_const_value(instruction_1, mylog2(constant));
-			return;
-		} else {
-			/* find nearest power of two and adjust the remaining with add/sub */
-			ir_convert_mult_to_shift(instruction, constant);
-			return;
-		}
+/* the cheapest chain for x * multiplier that costs less than the limit */
+static bool ir_multiply_search(uint32_t multiplier, int limit, struct ir_multiply_chain *best) {
+	bool is_found = false;
 
-		/* remove a*1 */
-		if (constant == 1) {
-			ir_remove_instruction_from_list(instruction);
-			return;
+	if (1 == multiplier) {
+		best->step_count = 0;
+		best->cost = 0;
+		return limit > 0;
+	}
+
+	if (0 == (multiplier & 1)) {
+		int shift = 0;
+		while (0 == (multiplier & 1)) {
+			multiplier >>= 1;
+			shift++;
 		}
+		return ir_multiply_extend(multiplier, IR_MULTIPLY_SHIFT, shift, ir_multiply_shift_cost(shift), &limit, best);
+	}
+
+	is_found |= ir_multiply_extend(multiplier - 1, IR_MULTIPLY_ADD, 0, IR_COST_ADD, &limit, best);
+	if (0xffffffffu != multiplier) {
+		is_found |= ir_multiply_extend(multiplier + 1, IR_MULTIPLY_SUB, 0, IR_COST_ADD, &limit, best);
 	}
-	if (NULL != constant_2 && NULL != constant_1) {
-		/* you don't need these constants now */
-		ir_mark_constant_as_obselete(instruction->operands[1].data.temporary);		
-		ir_mark_constant_as_obselete(instruction->operands[2].data.temporary);
-	
-		/* just compute the expression */
-		unsigned int constant_u = atoi(constant_1) * atoi(constant_2);
-		int constant_s = atoi(constant_1) * atoi(constant_2);
-		instruction->kind = IR_CONST_INT;
-		ir_update_const_value(instruction, is_unsigned ? constant_u : constant_s);
+
+	/* factors 2^k + 1 and 2^k - 1 */
+	for (int shift = 1; shift < 32; shift++) {
+		int step_cost = ir_multiply_shift_cost(shift) + IR_COST_ADD;
+		uint32_t factor = (1u << shift) + 1;
+		if (factor < multiplier && 0 == multiplier % factor) {
+			is_found |= ir_multiply_extend(multiplier / factor, IR_MULTIPLY_SHIFT_ADD, shift, step_cost, &limit, best);
+		}
+		factor = (1u << shift) - 1;
+		if (shift > 1 && factor < multiplier && 0 == multiplier % factor) {
+			is_found |= ir_multiply_extend(multiplier / factor, IR_MULTIPLY_SHIFT_SUB, shift, step_cost, &limit, best);
+		}
 	}
 
-	return;
+	return is_found;
 }
 
-static void ir_perform_identity_gt_optimization(struct ir_instruction *instruction) {
-	assert(NULL != instruction);
+/* the chain for x * multiplier (negative multipliers wrap around) if one is cheaper than a mult */
+static bool ir_multiply_find_chain(uint32_t multiplier, struct ir_multiply_chain *chain) {
+	int limit = IR_COST_MULT;
+	bool is_found = ir_multiply_search(multiplier, limit, chain);
 
-	bool is_unsigned = IR_GT_UNSIGNED_WORD == instruction->kind || IR_GE_UNSIGNED_WORD == instruction->kind;
-	bool is_equal = IR_GE_UNSIGNED_WORD == instruction->kind || IR_GE_SIGNED_WORD == instruction->kind;
-
-	const char *constant_1 = ir_get_const_map_entry(instruction->operands[1].data.temporary);
-	const char *constant_2 = ir_get_const_map_entry(instruction->operands[2].data.temporary);
-
-	if (NULL != constant_2 && NULL != constant_1) {
-		/* you don't need these constants now */
-		ir_mark_constant_as_obselete(instruction->operands[1].data.temporary);		
-		ir_mark_constant_as_obselete(instruction->operands[2].data.temporary);
-	
-		/* just compute the expression */
-		unsigned int constant_u = is_equal ? atoi(constant_1) >= atoi(constant_2) : atoi(constant_1) > atoi(constant_2);
-		int constant_s = is_equal ? atoi(constant_1) >= atoi(constant_2) : atoi(constant_1) > atoi(constant_2);
-		instruction->kind = IR_CONST_INT;
-		ir_update_const_value(instruction, is_unsigned ? constant_u : constant_s);
+	if (is_found) limit = chain->cost;
+	if (0 != multiplier) {
+		is_found |= ir_multiply_extend(0u - multiplier, IR_MULTIPLY_NEGATE, 0, IR_COST_NEGATE, &limit, chain);
 	}
+	return is_found;
 }
 
-static void ir_perform_identity_lt_optimization(struct ir_instruction *instruction) {
-	assert(NULL != instruction);
+/* t << shift */
+static struct ir_operand *ir_multiply_shift(struct ir_list *node, bool is_last, struct ir_operand *value, int shift) {
+	if (1 == shift) return ir_expand_step(node, is_last, IR_ADD_UNSIGNED_WORD, value, value);
+	return ir_expand_shift(node, is_last, IR_LEFT_SHIFT_WORD, value, shift);
+}
+
+static struct ir_operand *ir_multiply_emit(
+	struct ir_list *node, bool is_last, struct ir_operand *value, struct ir_multiply_chain *chain
+) {
+	struct ir_operand operand = *value;
+	struct ir_operand *product = &operand;
+
+	if (0 == chain->step_count && is_last) return ir_expand_step(node, true, IR_COPY, &operand, NULL);
+
+	for (int i = 0; i < chain->step_count; i++) {
+		struct ir_multiply_step *step = &chain->steps[i];
+		bool is_step_last = is_last && i == chain->step_count - 1;
+		struct ir_operand *shifted;
 
-	bool is_unsigned = IR_LT_UNSIGNED_WORD == instruction->kind || IR_LE_UNSIGNED_WORD == instruction->kind;
-	bool is_equal = IR_LE_UNSIGNED_WORD == instruction->kind || IR_LE_SIGNED_WORD == instruction->kind;
-
-	const char *constant_1 = ir_get_const_map_entry(instruction->operands[1].data.temporary);
-	const char *constant_2 = ir_get_const_map_entry(instruction->operands[2].data.temporary);
-
-	if (NULL != constant_2 && NULL != constant_1) {
-		/* you don't need these constants now */
-		ir_mark_constant_as_obselete(instruction->operands[1].data.temporary);		
-		ir_mark_constant_as_obselete(instruction->operands[2].data.temporary);
-	
-		/* just compute the expression */
-		unsigned int constant_u = is_equal ? atoi(constant_1) <= atoi(constant_2) : atoi(constant_1) < atoi(constant_2);
-		int constant_s = is_equal ? atoi(constant_1) <= atoi(constant_2) : atoi(constant_1) < atoi(constant_2);
-		instruction->kind = IR_CONST_INT;
-		ir_update_const_value(instruction, is_unsigned ? constant_u : constant_s);
+		switch (step->kind) {
+			case IR_MULTIPLY_SHIFT:
+				product = ir_multiply_shift(node, is_step_last, product, step->shift);
+				break;
+			case IR_MULTIPLY_ADD:
+				product = ir_expand_step(node, is_step_last, IR_ADD_UNSIGNED_WORD, product, &operand);
+				break;
+			case IR_MULTIPLY_SUB:
+				product = ir_expand_step(node, is_step_last, IR_SUB_UNSIGNED_WORD, product, &operand);
+				break;
+			case IR_MULTIPLY_SHIFT_ADD:
+				shifted = ir_multiply_shift(node, false, product, step->shift);
+				product = ir_expand_step(node, is_step_last, IR_ADD_UNSIGNED_WORD, shifted, product);
+				break;
+			case IR_MULTIPLY_SHIFT_SUB:
+				shifted = ir_multiply_shift(node, false, product, step->shift);
+				product = ir_expand_step(node, is_step_last, IR_SUB_UNSIGNED_WORD, shifted, product);
+				break;
+			case IR_MULTIPLY_NEGATE:
+				product = ir_expand_step(node, is_step_last, IR_SUB_UNSIGNED_WORD, ir_expand_constant(node, 0), product);
+				break;
+		}
 	}
+
+	return product;
 }
 
-static void ir_perform_identity_divide_optimization(struct ir_instruction *instruction) {
-	assert(NULL != instruction);
+/* value * multiplier */
+static struct ir_operand *ir_multiply_by_constant(struct ir_list *node, bool is_last, struct ir_operand *value, uint32_t multiplier) {
+	struct ir_multiply_chain chain;
 
-	bool is_unsigned = IR_DIV_UNSIGNED_WORD == instruction->kind;
+	if (ir_multiply_find_chain(multiplier, &chain)) return ir_multiply_emit(node, is_last, value, &chain);
+	/* the low word of the product is the same signed or unsigned, and mul doesn't trap */
+	return ir_expand_step(node, is_last, IR_MULT_SIGNED_WORD, value, ir_expand_constant(node, multiplier));
+}
 
-	const char *constant_1 = ir_get_const_map_entry(instruction->operands[1].data.temporary);
-	const char *constant_2 = ir_get_const_map_entry(instruction->operands[2].data.temporary);
+/* x * c, if a chain beats the mult */
+static bool ir_rewrite_multiply(struct ir_list *node, struct ir_operand *value, uint32_t multiplier) {
+	struct ir_multiply_chain chain;
 
-	if (NULL != constant_1 && NULL == constant_2) {
-		int constant = atoi(constant_1);
+	if (!ir_multiply_find_chain(multiplier, &chain)) return false;
+	ir_multiply_emit(node, true, value, &chain);
+	return true;
+}
 
-		/* change a/2 => a >> 1 */
-		if (is_unsigned) {
-			if (is_power_of_two(constant)) {
-				instruction->kind = IR_RIGHT_SHIFT_UNSIGNED_WORD;
-				struct ir_instruction *instruction_1 = ir_get_instruction_by_temporary(
-					instruction->operands[1].data.temporary
-				);
-				ir_update_const_value(instruction_1, mylog2(constant));
-			}
+/*
+ * Division by a constant that isn't a power of two becomes a multiplication
+ * by a "magic" reciprocal (Granlund and Montgomery, as worked out in Hacker's
+ * Delight, chapter 10): the upper word of the 64 bit product x * magic,
+ * corrected and shifted, is x / d for every 32 bit x. A mult and mfhi take a
+ * few cycles where div takes dozens. The remainder is x - (x / d) * d.
+ */
+struct ir_signed_magic {
+	uint32_t magic;
+	int shift;
+};
+
+struct ir_unsigned_magic {
+	uint32_t magic;
+	int shift;
+	bool is_add;          /* the magic number needs 33 bits, the dividend is added back in */
+};
+
+/* for 2 <= |divisor|, not a power of two */
+static struct ir_signed_magic ir_signed_magic(int32_t divisor) {
+	const uint32_t two_31 = 0x80000000u;
+	uint32_t absolute = divisor < 0 ? 0u - (uint32_t)divisor : (uint32_t)divisor;
+	uint32_t limit = two_31 + ((uint32_t)divisor >> 31);
+	uint32_t absolute_nc = limit - 1 - limit % absolute;
+	uint32_t q1 = two_31 / absolute_nc, r1 = two_31 - q1 * absolute_nc;
+	uint32_t q2 = two_31 / absolute, r2 = two_31 - q2 * absolute;
+	uint32_t delta;
+	int p = 31;
+
+	/* the smallest 2^p for which the error of the rounded up reciprocal can't show */
+	do {
+		p++;
+		q1 *= 2;
+		r1 *= 2;
+		if (r1 >= absolute_nc) {
+			q1++;
+			r1 -= absolute_nc;
 		}
-
-		/* change a/1 => a */
-		if (constant == 1) {
-			ir_remove_instruction_from_list(instruction);
+		q2 *= 2;
+		r2 *= 2;
+		if (r2 >= absolute) {
+			q2++;
+			r2 -= absolute;
 		}
-	}
+		delta = absolute - r2;
+	} while (q1 < delta || (q1 == delta && 0 == r1));
 
-	if (NULL != constant_2 && NULL == constant_1) {
-		int constant = atoi(constant_2);
-
-		/* change a/2 => a >> 1 */
-		if (is_unsigned) {
-			if (is_power_of_two(constant)) {
-				instruction->kind = IR_RIGHT_SHIFT_UNSIGNED_WORD;
-				struct ir_instruction *instruction_1 = ir_get_instruction_by_temporary(
-					instruction->operands[2].data.temporary
-				);
-				ir_update_const_value(instruction_1, mylog2(constant));
-			}
-		}
+	struct ir_signed_magic magic;
+	magic.magic = divisor < 0 ? 0u - (q2 + 1) : q2 + 1;
+	magic.shift = p - 32;
+	return magic;
+}
 
-		/* change a/1 => a */
-		if (constant == 1) {
-			ir_remove_instruction_from_list(instruction);
+/* for 2 <= divisor < 2^31, not a power of two */
+static struct ir_unsigned_magic ir_unsigned_magic(uint32_t divisor) {
+	uint32_t nc = 0xffffffffu - (0u - divisor) % divisor;
+	uint32_t q1 = 0x80000000u / nc, r1 = 0x80000000u - q1 * nc;
+	uint32_t q2 = 0x7fffffffu / divisor, r2 = 0x7fffffffu - q2 * divisor;
+	uint32_t delta;
+	int p = 31;
+	struct ir_unsigned_magic magic;
+
+	magic.is_add = false;
+	do {
+		p++;
+		if (r1 >= nc - r1) {
+			q1 = 2 * q1 + 1;
+			r1 = 2 * r1 - nc;
+		} else {
+			q1 = 2 * q1;
+			r1 = 2 * r1;
 		}
-	}
+		if (r2 + 1 >= divisor - r2) {
+			if (q2 >= 0x7fffffffu) magic.is_add = true;
+			q2 = 2 * q2 + 1;
+			r2 = 2 * r2 + 1 - divisor;
+		} else {
+			if (q2 >= 0x80000000u) magic.is_add = true;
+			q2 = 2 * q2;
+			r2 = 2 * r2 + 1;
+		}
+		delta = divisor - 1 - r2;
+	} while (p < 64 && (q1 < delta || (q1 == delta && 0 == r1)));
 
-	if (NULL != constant_2 && NULL != constant_1) {
-		/* you don't need these constants now */
-		ir_mark_constant_as_obselete(instruction->operands[1].data.temporary);		
-		ir_mark_constant_as_obselete(instruction->operands[2].data.temporary);
-	
-		/* just compute the expression */
-		unsigned int constant_u = atoi(constant_1) / atoi(constant_2);
-		int constant_s = atoi(constant_1) / atoi(constant_2);
-		instruction->kind = IR_CONST_INT;
-		ir_update_const_value(instruction, is_unsigned ? constant_u : constant_s);
-	}
+	magic.magic = q2 + 1;
+	magic.shift = p - 32;
+	return magic;
 }
 
-static void ir_perform_identity_remainder_optimization(struct ir_instruction *instruction) {
-	assert(IR_REM_SIGNED_WORD == instruction->kind || IR_REM_UNSIGNED_WORD == instruction->kind);
+static struct ir_operand *ir_divide_signed(struct ir_list *node, bool is_last, struct ir_operand *dividend, int32_t divisor) {
+	uint32_t absolute = divisor < 0 ? 0u - (uint32_t)divisor : (uint32_t)divisor;
+	struct ir_operand *quotient;
+
+	if (ir_is_power_of_two(absolute)) {
+		/* the shift rounds down, so 2^shift - 1 goes onto negative dividends first */
+		int shift = mylog2(absolute);
+		struct ir_operand *bias = dividend;
+		if (shift > 1) bias = ir_expand_shift(node, false, IR_RIGHT_SHIFT_SIGNED_WORD, bias, 31);
+		bias = ir_expand_shift(node, false, IR_RIGHT_SHIFT_UNSIGNED_WORD, bias, 32 - shift);
+		quotient = ir_expand_step(node, false, IR_ADD_UNSIGNED_WORD, dividend, bias);
+		quotient = ir_expand_shift(node, is_last && divisor > 0, IR_RIGHT_SHIFT_SIGNED_WORD, quotient, shift);
+		if (divisor > 0) return quotient;
+		return ir_expand_step(node, is_last, IR_UNARY_MINUS, quotient, NULL);
+	}
 
-	bool is_unsigned = IR_REM_UNSIGNED_WORD == instruction->kind;
+	struct ir_signed_magic magic = ir_signed_magic(divisor);
+	quotient = ir_expand_step(node, false, IR_MULT_HIGH_SIGNED_WORD, dividend, ir_expand_constant(node, magic.magic));
+	if (divisor > 0 && (int32_t)magic.magic < 0) {
+		quotient = ir_expand_step(node, false, IR_ADD_UNSIGNED_WORD, quotient, dividend);
+	} else if (divisor < 0 && (int32_t)magic.magic > 0) {
+		quotient = ir_expand_step(node, false, IR_SUB_UNSIGNED_WORD, quotient, dividend);
+	}
+	if (magic.shift > 0) quotient = ir_expand_shift(node, false, IR_RIGHT_SHIFT_SIGNED_WORD, quotient, magic.shift);
 
-	const char *constant_1 = ir_get_const_map_entry(instruction->operands[1].data.temporary);
-	const char *constant_2 = ir_get_const_map_entry(instruction->operands[2].data.temporary);
+	/* a negative quotient came out one too small */
+	struct ir_operand *sign = ir_expand_shift(node, false, IR_RIGHT_SHIFT_UNSIGNED_WORD, quotient, 31);
+	return ir_expand_step(node, is_last, IR_ADD_UNSIGNED_WORD, quotient, sign);
+}
 
-	if (NULL != constant_1 && NULL == constant_2) {
-		int constant = atoi(constant_1);
-		/* change a%1 => 0 */
-		if (constant == 1) {
-			instruction->kind = IR_CONST_INT;
-			ir_update_const_value(instruction, 0);
-		}
+static struct ir_operand *ir_divide_unsigned(struct ir_list *node, bool is_last, struct ir_operand *dividend, uint32_t divisor) {
+	if (ir_is_power_of_two(divisor)) {
+		return ir_expand_shift(node, is_last, IR_RIGHT_SHIFT_UNSIGNED_WORD, dividend, mylog2(divisor));
 	}
 
-	if (NULL != constant_2 && NULL == constant_1) {
-		int constant = atoi(constant_2);
-		/* change a%1 => 0 */
-		if (constant == 1) {
-			instruction->kind = IR_CONST_INT;
-			ir_update_const_value(instruction, 0);
-		}
+	/* the quotient is 0 or 1 */
+	if (divisor >= 0x80000000u) {
+		return ir_expand_step(node, is_last, IR_GE_UNSIGNED_WORD, dividend, ir_expand_constant(node, divisor));
 	}
 
-	if (NULL != constant_2 && NULL != constant_1) {
-		/* you don't need these constants now */
-		ir_mark_constant_as_obselete(instruction->operands[1].data.temporary);		
-		ir_mark_constant_as_obselete(instruction->operands[2].data.temporary);
-	
-		/* just compute the expression */
-		unsigned int constant_u = atoi(constant_1) % atoi(constant_2);
-		int constant_s = atoi(constant_1) % atoi(constant_2);
-		instruction->kind = IR_CONST_INT;
-		ir_update_const_value(instruction, is_unsigned ? constant_u : constant_s);
+	struct ir_unsigned_magic magic = ir_unsigned_magic(divisor);
+	if (!magic.is_add) {
+		struct ir_operand *quotient = ir_expand_step(
+			node, is_last && 0 == magic.shift,
+			IR_MULT_HIGH_UNSIGNED_WORD, dividend, ir_expand_constant(node, magic.magic)
+		);
+		if (0 == magic.shift) return quotient;
+		return ir_expand_shift(node, is_last, IR_RIGHT_SHIFT_UNSIGNED_WORD, quotient, magic.shift);
 	}
 
+	/* x / d is (((x - high) >> 1) + high) >> (shift - 1), which can't overflow like x + high */
+	struct ir_operand *high = ir_expand_step(
+		node, false, IR_MULT_HIGH_UNSIGNED_WORD, dividend, ir_expand_constant(node, magic.magic)
+	);
+	struct ir_operand *quotient = ir_expand_step(node, false, IR_SUB_UNSIGNED_WORD, dividend, high);
+	quotient = ir_expand_shift(node, false, IR_RIGHT_SHIFT_UNSIGNED_WORD, quotient, 1);
+	quotient = ir_expand_step(node, is_last && 1 == magic.shift, IR_ADD_UNSIGNED_WORD, quotient, high);
+	if (1 == magic.shift) return quotient;
+	return ir_expand_shift(node, is_last, IR_RIGHT_SHIFT_UNSIGNED_WORD, quotient, magic.shift - 1);
 }
 
+/* x / d or x % d for a constant d other than 0, 1 and -1 */
+static bool ir_rewrite_divide(struct ir_list *node, struct ir_operand *dividend, uint32_t divisor, bool is_unsigned, bool is_remainder) {
+	if (is_remainder) {
+		struct ir_operand *quotient = is_unsigned ?
+			ir_divide_unsigned(node, false, dividend, divisor) :
+			ir_divide_signed(node, false, dividend, (int32_t)divisor);
+		struct ir_operand *product = ir_multiply_by_constant(node, false, quotient, divisor);
+		ir_expand_step(node, true, IR_SUB_UNSIGNED_WORD, dividend, product);
+	} else if (is_unsigned) {
+		ir_divide_unsigned(node, true, dividend, divisor);
+	} else {
+		ir_divide_signed(node, true, dividend, (int32_t)divisor);
+	}
+	return true;
+}
+
+#include "identity-rules.h"
+
 static void ir_use_offset_for_load_store(struct ir_instruction *instruction, bool is_load) {
 	assert(NULL != instruction);
 
@@ -398,6 +482,12 @@ static void ir_use_offset_for_load_store(struct ir_instruction *instruction, boo
 			break;
 		}
 
+		/* the address comes from pointer arithmetic or a loaded pointer, there is no offset to use */
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL != definition && OPERAND_TEMPORARY == definition->kind && temp == definition->data.temporary) {
+			return;
+		}
+
 		for (int i = 0; i < 6; i++) {
 			if (iter->data->operands[i].kind == OPERAND_TEMPORARY) {
 				/* return + result instruction do use the 0th temporary! */
@@ -427,6 +517,8 @@ static void ir_use_offset_for_load_store(struct ir_instruction *instruction, boo
 		}
 	}
 
+	if (NULL == iter) return;
+
 	if (can_use_offset) {
 		/* mark the addressOf instruction as obselete */
 		assert(NULL != iter);
@@ -439,80 +531,63 @@ static void ir_use_offset_for_load_store(struct ir_instruction *instruction, boo
 	}
 }
 
-static void ir_perform_optimizations(struct ir_instruction *instruction) {
+static void ir_perform_optimizations(struct ir_list *node) {
+	struct ir_instruction *instruction = node->data;
 	assert(NULL != instruction);
 	assert(NULL != ir_list);
 
 	switch (instruction->kind) {
-			case IR_ADD_SIGNED_WORD:
-			case IR_ADD_UNSIGNED_WORD:
-				ir_perform_identity_add_optimization(instruction);
-				break;
-			case IR_SUB_SIGNED_WORD:
-			case IR_SUB_UNSIGNED_WORD:
-				ir_perform_identity_sub_optimization(instruction);
-				break;
-			case IR_MULT_SIGNED_WORD:
-			case IR_MULT_UNSIGNED_WORD: 
-				ir_perform_identity_multiply_optimization(instruction);
-				break;
-			case IR_DIV_SIGNED_WORD: 
-			case IR_DIV_UNSIGNED_WORD: 
-				ir_perform_identity_divide_optimization(instruction);
-				break;
-			case IR_GT_SIGNED_WORD:
-			case IR_GT_UNSIGNED_WORD:
-			case IR_GE_SIGNED_WORD:
-			case IR_GE_UNSIGNED_WORD:
-				ir_perform_identity_gt_optimization(instruction);
-				break;
-			case IR_LT_SIGNED_WORD:
-			case IR_LT_UNSIGNED_WORD:
-			case IR_LE_SIGNED_WORD:
-			case IR_LE_UNSIGNED_WORD:
-				ir_perform_identity_lt_optimization(instruction);
-				break;
-			case IR_REM_SIGNED_WORD:
-			case IR_REM_UNSIGNED_WORD:
-				ir_perform_identity_remainder_optimization(instruction);
-				break;
 			case IR_LOAD_WORD:
 			case IR_LOAD_HALF_WORD:
 			case IR_LOAD_SIGNED_HALF_WORD:
 			case IR_LOAD_BYTE:
 			case IR_LOAD_SIGNED_BYTE:
 				ir_use_offset_for_load_store(instruction, true);
-				break;
+				return;
 			case IR_STORE_WORD:
 			case IR_STORE_HALF_WORD:
 			case IR_STORE_BYTE:
 				ir_use_offset_for_load_store(instruction, false);
-				break;
+				return;
 			default:
 				break;
 	}
+
+	/* a constant folded into it would stand for the other definitions too */
+	struct ir_operand *definition = ir_definition_operand(instruction);
+	if (NULL != definition && OPERAND_TEMPORARY == definition->kind && ir_is_redefined(definition->data.temporary)) return;
+
+	/* the constants it reads (the rules match one or two operands), in case the rewrite leaves them without a use */
+	int constants[2], constant_count = 0;
+	for (int i = 0; i < ir_use_count(instruction) && constant_count < 2; i++) {
+		struct ir_operand *operand = ir_use_operand(instruction, i);
+		if (
+			OPERAND_TEMPORARY == operand->kind && !ir_is_redefined(operand->data.temporary) &&
+			NULL != ir_get_const_map_entry(operand->data.temporary)
+		) {
+			constants[constant_count++] = operand->data.temporary;
+		}
+	}
+
+	if (!ir_rewrite_by_rules(node)) return;
+
+	for (int i = 0; i < constant_count; i++) {
+		if (ir_is_unused(constants[i])) ir_mark_constant_as_obselete(constants[i]);
+	}
 }
 
 void ir_start_optimization_1(void) {
 	struct ir_list *iter = NULL;
-	struct ir_instruction *instruction_iter = NULL;
+
+	ir_count_definitions();
 
 	/* iterate ir_list */
 	for (iter = ir_list; NULL != iter; iter = iter->next) {
 		assert(NULL != iter->data);
-		instruction_iter = iter->data;
-		while (NULL != instruction_iter) {
-			ir_perform_optimizations(instruction_iter);
-
-			instruction_iter = instruction_iter->next;
-		}
+		ir_perform_optimizations(iter);
 	}
 
-	// ir_mark_registers_as_dead_or_live();
-
-	/* cleanup */
-	iter = NULL;
-	free(iter);
-	instruction_iter = NULL;
-	free(instruction_iter);
+	free(definition_counts);
+	definition_counts = NULL;
+	definition_count_size = 0;
 }
@@ -4,179 +4,338 @@
 #include <string.h>
 #include <math.h>
 
+#include "compiler.h"
 #include "mips.h"
 #include "type.h"
 #include "helpers/type-tree.h"
 #include "ir.h"
+#include "dataflow.h"
 
-extern struct hash_map *const_registers_map;
 extern struct ir_list *ir_list;
 
 bool optimization_applied = false;
 
-static void ir_remove_dead_label_uncalled(struct ir_instruction *instruction) {
-	assert(IR_GOTO_IF_FALSE == instruction->kind || IR_GOTO_IF_TRUE == instruction->kind);
+/*
+ * Level 2 is a single worklist pass. Every label knows how many branches
+ * target it and every temporary how many instructions read it, so removing
+ * an instruction only has to revisit the label or definition whose count
+ * just dropped to zero, and the whole pass stays linear in the size of the IR.
+ */
 
-	const char *constant_1 = ir_get_const_map_entry(instruction->operands[0].data.temporary);
+/* labels -> the label instruction and the number of branches targeting it */
+struct ir_label_references {
+	char **names;
+	struct ir_list **labels;
+	int *counts;
+	int capacity;
+};
 
-	struct ir_list *iter = NULL;
+static struct ir_label_references label_references;
 
-	if (NULL != constant_1) {
-		int constant = atoi(constant_1);
-
-		if (IR_GOTO_IF_FALSE == instruction->kind && constant == 1) {
-			char label_scope[strlen(instruction->operands[0].data.name) + 1];
-			strcpy(label_scope, instruction->operands[1].data.name);
-			
-			/* the label mentioned in this instruction will never be called */
-			/* remove all instructions in that block */
-			bool instructions_deleted = false;
-			for (iter = ir_list; NULL != iter; iter = iter->next) {
-				if (strcmp(iter->data->scope, label_scope) == 0) {
-					ir_remove_instruction_from_list(iter->data);
-					instructions_deleted = true;
-				}
-			}
-			ir_remove_instruction_from_list(instruction);
-			optimization_applied = instructions_deleted;
-
-			/* cleanup */
-			iter = NULL;
-			free(iter);
-		} else {
-			/* remove true block */
-			/* for this, you remove */
-			char label_scope[strlen(instruction->operands[0].data.name) + 5 + 1];  /* 5 is coming from '_true' */
-			strcpy(label_scope, instruction->operands[1].data.name);
-			strcat(label_scope, "_true");
-
-			bool instructions_deleted = false;
-			for (iter = ir_list; NULL != iter; iter = iter->next) {
-				if (strcmp(iter->data->scope, label_scope) == 0) {
-					ir_remove_instruction_from_list(iter->data);
-					instructions_deleted = true;
-				}
-			}
-			ir_remove_instruction_from_list(instruction);
-			optimization_applied = instructions_deleted;
-		}
+/* temporaries -> number of reads, number of writes, defining constInt and side effect free definition */
+static int *temporary_uses = NULL;
+static int *temporary_definitions = NULL;
+static struct ir_list **constant_definitions = NULL;
+static struct ir_list **removable_definitions = NULL;
+static int max_temporary = 0;
+
+static struct ir_list **worklist = NULL;
+static int worklist_size = 0;
+static int worklist_capacity = 0;
+
+static unsigned int ir_hash_label(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; '\0' != *name; name++) {
+		hash = (hash ^ (unsigned char)*name) * 16777619u;
 	}
+	return hash;
+}
 
-	/* cleanup */
-	iter = NULL;
-	free(iter);
+/* returns the slot of the label, claiming an empty one if it isn't there yet */
+static int ir_label_slot(char *name) {
+	unsigned int slot = ir_hash_label(name) & (label_references.capacity - 1);
+	while (NULL != label_references.names[slot]) {
+		if (0 == strcmp(label_references.names[slot], name)) return slot;
+		slot = (slot + 1) & (label_references.capacity - 1);
+	}
+	label_references.names[slot] = name;
+	return slot;
 }
 
-static void ir_remove_dead_label(struct ir_instruction *instruction) {
-	assert(IR_LABEL == instruction->kind);
-	/* remove label block if its got no goto statement */
-	struct ir_list *iter = NULL;
+static void ir_push_worklist(struct ir_list *node) {
+	if (worklist_size == worklist_capacity) {
+		worklist_capacity = 0 == worklist_capacity ? 64 : worklist_capacity * 2;
+		worklist = realloc(worklist, sizeof(struct ir_list *) * worklist_capacity);
+		assert(NULL != worklist);
+	}
+	worklist[worklist_size++] = node;
+}
+
+/* nodes leave ir_list through ir_unlink, which clears both links */
+static bool ir_is_in_list(struct ir_list *node) {
+	return ir_list == node || NULL != node->prev;
+}
+
+/* definitions that can go once nothing reads them */
+static bool ir_is_removable_definition(struct ir_instruction *instruction) {
+	switch (instruction->kind) {
+		case IR_CONST_INT:
+		case IR_ADDRESS_OF:
+		case IR_COPY:
+		case IR_LOAD_WORD:
+		case IR_LOAD_HALF_WORD:
+		case IR_LOAD_SIGNED_HALF_WORD:
+		case IR_LOAD_BYTE:
+		case IR_LOAD_SIGNED_BYTE:
+			return true;
+		default:
+			return dataflow_is_expression(instruction);
+	}
+}
+
+static bool ir_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
 
-	bool goto_found = false;
+/* counts label references and temporary uses/definitions in one scan */
+static void ir_count_references(void) {
+	struct ir_list *iter;
+	int label_count = 0;         /* labels and branches, an upper bound on the names */
+
+	max_temporary = 0;
 	for (iter = ir_list; NULL != iter; iter = iter->next) {
-		/* search entire list for a goto_statement */
-		if (
-			(IR_GOTO == iter->data->kind && strcmp(iter->data->operands[0].data.name, instruction->operands[0].data.name) == 0) ||
-			(IR_GOTO_IF_FALSE == iter->data->kind && strcmp(iter->data->operands[1].data.name, instruction->operands[0].data.name) == 0) ||
-			(IR_GOTO_IF_TRUE == iter->data->kind && strcmp(iter->data->operands[1].data.name, instruction->operands[0].data.name) == 0)
-		) {
-			goto_found = true;
-			break;
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL != definition && definition->data.temporary > max_temporary) {
+			max_temporary = definition->data.temporary;
+		}
+		for (int i = 0; i < ir_use_count(iter->data); i++) {
+			struct ir_operand *use = ir_use_operand(iter->data, i);
+			if (OPERAND_TEMPORARY == use->kind && use->data.temporary > max_temporary) {
+				max_temporary = use->data.temporary;
+			}
 		}
+		if (IR_LABEL == iter->data->kind || ir_is_branch(iter->data)) label_count++;
 	}
 
-	if (!goto_found) {
-		/* remove all instructions in that block */
-		char label_scope[strlen(instruction->scope) + 1];
-		strcpy(label_scope, instruction->scope);
-		for (iter = ir_list; NULL != iter; iter = iter->next) {
-			if (strcmp(iter->data->scope, label_scope) == 0) {
-				ir_remove_instruction_from_list(iter->data);
+	temporary_uses = calloc(max_temporary + 1, sizeof(int));
+	temporary_definitions = calloc(max_temporary + 1, sizeof(int));
+	constant_definitions = calloc(max_temporary + 1, sizeof(struct ir_list *));
+	removable_definitions = calloc(max_temporary + 1, sizeof(struct ir_list *));
+	assert(NULL != temporary_uses && NULL != temporary_definitions);
+	assert(NULL != constant_definitions && NULL != removable_definitions);
+
+	label_references.capacity = 16;
+	while (label_references.capacity < label_count * 2) label_references.capacity *= 2;
+	label_references.names = calloc(label_references.capacity, sizeof(char *));
+	label_references.labels = calloc(label_references.capacity, sizeof(struct ir_list *));
+	label_references.counts = calloc(label_references.capacity, sizeof(int));
+	assert(NULL != label_references.names && NULL != label_references.labels && NULL != label_references.counts);
+
+	for (iter = ir_list; NULL != iter; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		struct ir_operand *definition = ir_definition_operand(instruction);
+
+		if (NULL != definition) {
+			temporary_definitions[definition->data.temporary]++;
+			if (IR_CONST_INT == instruction->kind) {
+				constant_definitions[definition->data.temporary] = iter;
+			}
+			if (ir_is_removable_definition(instruction)) {
+				removable_definitions[definition->data.temporary] = iter;
 			}
 		}
-		optimization_applied = true;
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (ir_is_temporary(use)) temporary_uses[use->data.temporary]++;
+		}
+
+		if (IR_LABEL == instruction->kind) {
+			label_references.labels[ir_label_slot(instruction->operands[0].data.name)] = iter;
+		} else if (ir_is_branch(instruction)) {
+			label_references.counts[ir_label_slot(ir_branch_target(instruction))]++;
+		}
+	}
+}
+
+static void ir_free_references(void) {
+	free(temporary_uses);
+	free(temporary_definitions);
+	free(constant_definitions);
+	free(removable_definitions);
+	free(label_references.names);
+	free(label_references.labels);
+	free(label_references.counts);
+	free(worklist);
+	temporary_uses = NULL;
+	temporary_definitions = NULL;
+	constant_definitions = NULL;
+	removable_definitions = NULL;
+	worklist = NULL;
+	worklist_size = 0;
+	worklist_capacity = 0;
+}
+
+static void ir_release_temporary(struct ir_operand *operand) {
+	if (!ir_is_temporary(operand)) return;
+
+	int temporary = operand->data.temporary;
+	temporary_uses[temporary]--;
+	if (0 == temporary_uses[temporary] && NULL != removable_definitions[temporary]) {
+		ir_push_worklist(removable_definitions[temporary]);
 	}
+}
 
-	/* cleanup */
-	iter = NULL;
-	free(iter);
+static void ir_release_label(char *name) {
+	int slot = ir_label_slot(name);
+	label_references.counts[slot]--;
+	if (0 == label_references.counts[slot] && NULL != label_references.labels[slot]) {
+		ir_push_worklist(label_references.labels[slot]);
+	}
 }
 
-static void ir_remove_dead_goto(struct ir_instruction *instruction) {
+/* unlinks the instruction and lets go of everything it referenced */
+static void ir_delete_instruction(struct ir_list *node) {
+	struct ir_instruction *instruction = node->data;
+
+	for (int i = 0; i < ir_use_count(instruction); i++) {
+		ir_release_temporary(ir_use_operand(instruction, i));
+	}
+	if (ir_is_branch(instruction)) {
+		ir_release_label(ir_branch_target(instruction));
+	}
+
+	ir_unlink(node);
+	optimization_applied = true;
+}
+
+/* returns the value of a temporary whose only definition is a constInt */
+static bool ir_constant_value(struct ir_operand *operand, long *value) {
+	if (!ir_is_temporary(operand)) return false;
+
+	int temporary = operand->data.temporary;
+	if (1 != temporary_definitions[temporary] || NULL == constant_definitions[temporary]) return false;
+	*value = (long)constant_definitions[temporary]->data->operands[1].data.number;
+	return true;
+}
+
+static void ir_remove_dead_label_uncalled(struct ir_list *node) {
+	struct ir_instruction *instruction = node->data;
+	assert(IR_GOTO_IF_FALSE == instruction->kind || IR_GOTO_IF_TRUE == instruction->kind);
+
+	long constant;
+	if (!ir_constant_value(&instruction->operands[0], &constant)) return;
+
+	bool taken = IR_GOTO_IF_FALSE == instruction->kind ? 0 == constant : 0 != constant;
+
+	if (!taken) {
+		/* the label mentioned in this instruction will never be called from here */
+		ir_delete_instruction(node);
+		return;
+	}
+
+	/* always taken: turn it into a goto, which makes the code after it dead */
+	ir_release_temporary(&instruction->operands[0]);
+	instruction->kind = IR_GOTO;
+	ir_operand_copy(instruction, 0, &instruction->operands[1]);
+	optimization_applied = true;
+	ir_push_worklist(node);
+}
+
+static void ir_remove_dead_label(struct ir_list *node) {
+	struct ir_instruction *instruction = node->data;
+	assert(IR_LABEL == instruction->kind);
+
+	/* remove the label if it's got no goto statement, the code after it is still reached by falling through */
+	if (0 != label_references.counts[ir_label_slot(instruction->operands[0].data.name)]) return;
+
+	struct ir_list *previous = node->prev;
+	ir_delete_instruction(node);
+
+	/* unless the code before it never falls through, then it's all dead up to the next label */
+	if (NULL != previous && IR_GOTO == previous->data->kind) {
+		ir_push_worklist(previous);
+	}
+}
+
+static void ir_remove_dead_goto(struct ir_list *node) {
+	struct ir_instruction *instruction = node->data;
 	assert(IR_GOTO == instruction->kind);
-	assert(NULL != ir_list);
-	struct ir_instruction *next_instruction = ir_get_next_instruction(instruction);
-	assert(NULL != next_instruction);
-
-	/* remove both goto and label if they immediately follow eachother */
-	if (IR_LABEL == next_instruction->kind) {
-		/* compare labels */
-		if (strcmp(instruction->operands[0].data.name, next_instruction->operands[0].data.name) == 0) {
-			/* remove both instructions */
-			ir_remove_instruction_from_list(instruction);
-			ir_remove_instruction_from_list(next_instruction);
-
-			optimization_applied = true;
-		}
+
+	/* nothing between a goto and the next label can be reached */
+	while (
+		NULL != node->next &&
+		IR_LABEL != node->next->data->kind &&
+		IR_PROC_END != node->next->data->kind
+	) {
+		ir_delete_instruction(node->next);
+	}
+
+	/* remove the goto if its label immediately follows it */
+	if (
+		NULL != node->next &&
+		IR_LABEL == node->next->data->kind &&
+		0 == strcmp(instruction->operands[0].data.name, node->next->data->operands[0].data.name)
+	) {
+		ir_delete_instruction(node);
 	}
 }
 
-static void ir_remove_unused_const(struct ir_instruction *instruction) {
-	assert(IR_CONST_INT == instruction->kind);
-	if (!instruction->is_used) {
-		ir_remove_instruction_from_list(instruction);
-		optimization_applied = true;
+static void ir_remove_unused_definition(struct ir_list *node) {
+	struct ir_instruction *instruction = node->data;
+	assert(ir_is_removable_definition(instruction));
+
+	struct ir_operand *definition = ir_definition_operand(instruction);
+	if (NULL == definition || !ir_is_temporary(definition)) return;
+
+	/* constants optimization 1 folded into their users are marked unused */
+	if (
+		(IR_CONST_INT == instruction->kind && !instruction->is_used) ||
+		0 == temporary_uses[definition->data.temporary]
+	) {
+		ir_delete_instruction(node);
 	}
 }
 
-static void ir_perform_optimizations(struct ir_instruction *instruction) {
-	assert(NULL != instruction);
-	assert(NULL != ir_list);
+static void ir_perform_optimizations(struct ir_list *node) {
+	assert(NULL != node);
 
-	switch (instruction->kind) {
+	switch (node->data->kind) {
 		case IR_GOTO:
-			ir_remove_dead_goto(instruction);
+			ir_remove_dead_goto(node);
 			break;
 		case IR_LABEL:
-			ir_remove_dead_label(instruction);
+			ir_remove_dead_label(node);
 			break;
-		case IR_GOTO_IF_FALSE: 
-		case IR_GOTO_IF_TRUE: 
-			ir_remove_dead_label_uncalled(instruction);
-			break;
-		case IR_CONST_INT: 
-			ir_remove_unused_const(instruction);
+		case IR_GOTO_IF_FALSE:
+		case IR_GOTO_IF_TRUE:
+			ir_remove_dead_label_uncalled(node);
 			break;
 		default:
+			if (ir_is_removable_definition(node->data)) {
+				ir_remove_unused_definition(node);
+			}
 			break;
 	}
 }
 
-void ir_start_optimization_round(void) {
+void ir_start_optimization_2(void) {
 	struct ir_list *iter = NULL;
-	struct ir_instruction *instruction_iter = NULL;
 
-	/* iterate ir_list */
 	optimization_applied = false;
-	for (iter = ir_list; NULL != iter; iter = iter->next) {
-		assert(NULL != iter->data);
-		instruction_iter = iter->data;
-		ir_perform_optimizations(instruction_iter);
-		if (optimization_applied) break;
-	}
-
-	/* cleanup */
-	iter = NULL;
-	free(iter);
-	instruction_iter = NULL;
-	free(instruction_iter);
-}
+	ir_count_references();
 
-void ir_start_optimization_2(void) {
-
-	ir_start_optimization_round();
+	/* seed the worklist in reverse so it's popped in program order */
+	for (iter = ir_list; NULL != iter && NULL != iter->next; iter = iter->next);
+	for (; NULL != iter; iter = iter->prev) {
+		ir_push_worklist(iter);
+	}
 
-	while (optimization_applied) {
-		ir_start_optimization_round();
+	while (worklist_size > 0) {
+		struct ir_list *node = worklist[--worklist_size];
+		if (ir_is_in_list(node)) {
+			ir_perform_optimizations(node);
+		}
 	}
+
+	ir_free_references();
 }
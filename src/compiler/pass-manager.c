@@ -0,0 +1,508 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "constant-propagation.h"
+#include "sccp.h"
+#include "value-numbering.h"
+#include "lazy-code-motion.h"
+#include "loop-invariant-code-motion.h"
+#include "induction-variables.h"
+#include "loop-unrolling.h"
+#include "loop-rotation.h"
+#include "block-layout.h"
+#include "inliner.h"
+#include "tail-recursion.h"
+#include "register-promotion.h"
+#include "load-store-elimination.h"
+#include "reassociation.h"
+#include "value-range.h"
+#include "if-conversion.h"
+#include "ipcp.h"
+#include "global-dce.h"
+#include "pass-manager.h"
+#include "optimization-1.h"
+#include "optimization-2.h"
+
+/**********
+ * PASSES *
+ **********/
+
+static void pass_manager_run_identity(struct cfg *cfgs) {
+	ir_start_optimization_1();
+}
+
+static void pass_manager_run_dce(struct cfg *cfgs) {
+	ir_start_optimization_2();
+}
+
+static void pass_manager_run_constant_propagation(struct cfg *cfgs) {
+	constant_propagation_program(cfgs);
+}
+
+static void pass_manager_run_sccp(struct cfg *cfgs) {
+	sccp_program(cfgs);
+}
+
+static void pass_manager_run_value_numbering(struct cfg *cfgs) {
+	value_numbering_program(cfgs);
+}
+
+static void pass_manager_run_lazy_code_motion(struct cfg *cfgs) {
+	lazy_code_motion_program();
+}
+
+static void pass_manager_run_loop_invariant_code_motion(struct cfg *cfgs) {
+	loop_invariant_code_motion_program(cfgs);
+}
+
+static void pass_manager_run_induction_variables(struct cfg *cfgs) {
+	induction_variables_program();
+}
+
+static void pass_manager_run_loop_unrolling(struct cfg *cfgs) {
+	loop_unrolling_program();
+}
+
+static void pass_manager_run_loop_rotation(struct cfg *cfgs) {
+	loop_rotation_program();
+}
+
+static void pass_manager_run_block_layout(struct cfg *cfgs) {
+	block_layout_program();
+}
+
+static void pass_manager_run_inliner(struct cfg *cfgs) {
+	inliner_program();
+}
+
+static void pass_manager_run_tail_recursion(struct cfg *cfgs) {
+	tail_recursion_program();
+}
+
+static void pass_manager_run_register_promotion(struct cfg *cfgs) {
+	register_promotion_program();
+}
+
+static void pass_manager_run_load_store_elimination(struct cfg *cfgs) {
+	load_store_elimination_program(cfgs);
+}
+
+static void pass_manager_run_reassociation(struct cfg *cfgs) {
+	reassociation_program(cfgs);
+}
+
+static void pass_manager_run_value_range(struct cfg *cfgs) {
+	value_range_program(cfgs);
+}
+
+static void pass_manager_run_if_conversion(struct cfg *cfgs) {
+	if_conversion_program(cfgs);
+}
+
+static void pass_manager_run_ipcp(struct cfg *cfgs) {
+	ipcp_program();
+}
+
+static void pass_manager_run_global_dce(struct cfg *cfgs) {
+	global_dce_program();
+}
+
+static struct pass passes[] = {
+	{ "identity", "identity rewrites and constant folding (level 1)", pass_manager_run_identity, false },
+	{ "dce", "dead label, goto and unused definition removal (level 2)", pass_manager_run_dce, false },
+	{ "constprop", "global constant and copy propagation", pass_manager_run_constant_propagation, true },
+	{ "sccp", "sparse conditional constant propagation and unreachable code removal", pass_manager_run_sccp, true },
+	{ "cse", "local value numbering and common subexpression elimination", pass_manager_run_value_numbering, true },
+	{ "pre", "partial redundancy elimination by lazy code motion", pass_manager_run_lazy_code_motion, false },
+	{ "licm", "loop-invariant code motion into loop preheaders", pass_manager_run_loop_invariant_code_motion, true },
+	{ "iv", "induction variable strength reduction and exit test replacement", pass_manager_run_induction_variables, false },
+	{ "unroll", "unrolling of counted innermost loops", pass_manager_run_loop_unrolling, false },
+	{ "rotate", "loop rotation, testing the condition at the bottom of the loop", pass_manager_run_loop_rotation, false },
+	{ "layout", "static block placement from predicted branch probabilities", pass_manager_run_block_layout, false },
+	{ "inline", "inlining of small and single-call functions", pass_manager_run_inliner, false },
+	{ "tailrec", "self tail calls turned into loops", pass_manager_run_tail_recursion, false },
+	{ "mem2reg", "word locals whose address isn't taken kept in temporaries", pass_manager_run_register_promotion, false },
+	{ "lse", "store to load forwarding, redundant load and dead store elimination", pass_manager_run_load_store_elimination, true },
+	{ "reassociate", "reassociation of add, multiply and bitwise chains, folding their constants", pass_manager_run_reassociation, true },
+	{ "vrp", "value range and known bits: redundant casts and masks, decided comparisons", pass_manager_run_value_range, true },
+	{ "select", "small if/else and ternary diamonds turned into branchless selects", pass_manager_run_if_conversion, true },
+	{ "ipcp", "interprocedural constants, dead arguments and specialized copies of functions", pass_manager_run_ipcp, false },
+	{ "globaldce", "functions and globals unreachable from main removed", pass_manager_run_global_dce, false },
+};
+
+#define PASS_COUNT ((int)(sizeof(passes) / sizeof(passes[0])))
+
+/* the default pipeline of each -O level */
+static const char *default_pipelines[] = {
+	"",
+	"identity",
+	"globaldce,identity,inline,tailrec,ipcp,globaldce,dce,fixpoint(constprop,sccp,vrp),reassociate,cse,licm,iv,dce,mem2reg,fixpoint(constprop,sccp,vrp,select),lse,rotate,pre,dce,layout",
+};
+
+/* the same with -funroll-loops, after iv so the copies share its pointers */
+static const char *unrolling_pipelines[] = {
+	"",
+	"identity,unroll",
+	"globaldce,identity,inline,tailrec,ipcp,globaldce,dce,fixpoint(constprop,sccp,vrp),reassociate,cse,licm,iv,unroll,dce,mem2reg,fixpoint(constprop,sccp,vrp,select),lse,rotate,pre,dce,layout",
+};
+
+/************
+ * PIPELINE *
+ ************/
+
+struct pass_pipeline_step {
+	struct pass *pass;                     /* NULL for a fixpoint group */
+	struct pass_pipeline *group;
+};
+
+struct pass_pipeline {
+	struct pass_pipeline_step *steps;
+	int step_count;
+};
+
+static int budget = PASS_MANAGER_DEFAULT_BUDGET;
+
+static struct pass *pass_manager_find_pass(const char *name, int length) {
+	for (int i = 0; i < PASS_COUNT; i++) {
+		if ((int)strlen(passes[i].name) == length && 0 == strncmp(passes[i].name, name, length)) {
+			return &passes[i];
+		}
+	}
+	return NULL;
+}
+
+static void pass_manager_add_step(struct pass_pipeline *pipeline, struct pass *pass, struct pass_pipeline *group) {
+	pipeline->steps = realloc(pipeline->steps, sizeof(struct pass_pipeline_step) * (pipeline->step_count + 1));
+	assert(NULL != pipeline->steps);
+	pipeline->steps[pipeline->step_count].pass = pass;
+	pipeline->steps[pipeline->step_count].group = group;
+	pipeline->step_count++;
+}
+
+static bool pass_manager_is_name_character(char c) {
+	return ('a' <= c && c <= 'z') || ('0' <= c && c <= '9') || '-' == c || '_' == c;
+}
+
+/* parses a comma separated list up to `closing` ('\0' or ')') */
+static struct pass_pipeline *pass_manager_parse_list(const char **cursor, char closing) {
+	struct pass_pipeline *pipeline = calloc(1, sizeof(struct pass_pipeline));
+	assert(NULL != pipeline);
+
+	while (true) {
+		while (' ' == **cursor) (*cursor)++;
+		if (closing == **cursor && 0 == pipeline->step_count) break;
+
+		const char *name = *cursor;
+		while (pass_manager_is_name_character(**cursor)) (*cursor)++;
+		int length = *cursor - name;
+
+		if (0 == length) {
+			fprintf(stdout, "Expected a pass name at \"%s\".\n", name);
+			return NULL;
+		}
+
+		if (8 == length && 0 == strncmp("fixpoint", name, length) && '(' == **cursor) {
+			(*cursor)++;
+			struct pass_pipeline *group = pass_manager_parse_list(cursor, ')');
+			if (NULL == group) return NULL;
+			(*cursor)++;
+			pass_manager_add_step(pipeline, NULL, group);
+		} else {
+			struct pass *pass = pass_manager_find_pass(name, length);
+			if (NULL == pass) {
+				fprintf(stdout, "Unknown pass \"%.*s\".\n", length, name);
+				pass_manager_print_passes(stdout);
+				return NULL;
+			}
+			pass_manager_add_step(pipeline, pass, NULL);
+		}
+
+		while (' ' == **cursor) (*cursor)++;
+		if (',' == **cursor) {
+			(*cursor)++;
+			continue;
+		}
+		if (closing == **cursor) break;
+
+		fprintf(stdout, "Unexpected \"%c\" in pass pipeline.\n", **cursor);
+		return NULL;
+	}
+	return pipeline;
+}
+
+struct pass_pipeline *pass_manager_parse(const char *description) {
+	assert(NULL != description);
+	return pass_manager_parse_list(&description, '\0');
+}
+
+const char *pass_manager_default_pipeline(int optimization_level, bool unroll_loops) {
+	int count = sizeof(default_pipelines) / sizeof(default_pipelines[0]);
+	if (optimization_level < 0) optimization_level = 0;
+	if (optimization_level >= count) optimization_level = count - 1;
+	return (unroll_loops ? unrolling_pipelines : default_pipelines)[optimization_level];
+}
+
+void pass_manager_set_budget(int new_budget) {
+	budget = new_budget > 0 ? new_budget : 1;
+}
+
+void pass_manager_print_passes(FILE *output) {
+	fprintf(output, "Available passes:\n");
+	for (int i = 0; i < PASS_COUNT; i++) {
+		fprintf(output, "  %-12s %s\n", passes[i].name, passes[i].description);
+	}
+	fprintf(output, "  %-12s %s\n", "fixpoint(..)", "rerun the passes inside until nothing changes");
+}
+
+/**************
+ * STATISTICS *
+ **************/
+
+struct pass_statistics {
+	const char *name;
+	int runs;
+	int changes;
+	double milliseconds;
+	long added;
+	long removed;
+};
+
+/* one entry per pass, plus going in and out of SSA form */
+static struct pass_statistics statistics[PASS_COUNT + 2];
+static int budget_exhausted = 0;
+
+static struct pass_statistics *pass_manager_statistics(const char *name) {
+	for (int i = 0; i < PASS_COUNT + 2; i++) {
+		if (NULL == statistics[i].name) statistics[i].name = name;
+		if (0 == strcmp(statistics[i].name, name)) return &statistics[i];
+	}
+	assert(0);
+	return NULL;
+}
+
+/* instructions in ir_list, sorted by address so two snapshots can be diffed */
+struct pass_snapshot {
+	struct ir_instruction **instructions;
+	int count;
+	unsigned long fingerprint;
+};
+
+static int pass_manager_compare_pointers(const void *pointer_1, const void *pointer_2) {
+	uintptr_t address_1 = (uintptr_t)*(struct ir_instruction * const *)pointer_1;
+	uintptr_t address_2 = (uintptr_t)*(struct ir_instruction * const *)pointer_2;
+	return address_1 < address_2 ? -1 : address_1 > address_2;
+}
+
+static unsigned long pass_manager_hash(unsigned long hash, unsigned long value) {
+	return (hash ^ value) * 1099511628211ul;
+}
+
+static unsigned long pass_manager_hash_operand(unsigned long hash, struct ir_operand *operand) {
+	hash = pass_manager_hash(hash, operand->kind);
+	switch (operand->kind) {
+		case OPERAND_TEMPORARY:
+			return pass_manager_hash(hash, operand->data.temporary);
+		case OPERAND_NUMBER:
+			return pass_manager_hash(hash, operand->data.number);
+		case OPERAND_BOOL:
+			return pass_manager_hash(hash, operand->data.is_string);
+		case OPERAND_STRING:
+			for (const char *c = operand->data.name; '\0' != *c; c++) hash = pass_manager_hash(hash, *c);
+			return hash;
+	}
+	return hash;
+}
+
+/*
+ * The fingerprint covers the order, opcodes and operands of the whole list,
+ * so a pass counts as having changed something even if it only rewrote an
+ * operand in place.
+ */
+static void pass_manager_snapshot(struct pass_snapshot *snapshot) {
+	struct ir_list *iter;
+	int capacity = 64;
+
+	snapshot->count = 0;
+	snapshot->fingerprint = 14695981039346656037ul;
+	snapshot->instructions = malloc(sizeof(struct ir_instruction *) * capacity);
+	assert(NULL != snapshot->instructions);
+
+	for (iter = ir_get_ir_list(); NULL != iter; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+
+		if (snapshot->count == capacity) {
+			capacity *= 2;
+			snapshot->instructions = realloc(snapshot->instructions, sizeof(struct ir_instruction *) * capacity);
+			assert(NULL != snapshot->instructions);
+		}
+		snapshot->instructions[snapshot->count++] = instruction;
+
+		unsigned long hash = snapshot->fingerprint;
+		hash = pass_manager_hash(hash, (uintptr_t)instruction);
+		hash = pass_manager_hash(hash, instruction->kind);
+		hash = pass_manager_hash(hash, instruction->is_used);
+		hash = pass_manager_hash(hash, (uintptr_t)instruction->offset_variable);
+		for (int i = 0; i < 7; i++) {
+			hash = pass_manager_hash_operand(hash, &instruction->operands[i]);
+		}
+		for (int i = 0; NULL != instruction->phi_arguments && i < instruction->phi_argument_count; i++) {
+			hash = pass_manager_hash_operand(hash, &instruction->phi_arguments[i]);
+		}
+		snapshot->fingerprint = hash;
+	}
+
+	qsort(snapshot->instructions, snapshot->count, sizeof(struct ir_instruction *), pass_manager_compare_pointers);
+}
+
+/* counts the instructions only in `before` (removed) and only in `after` (added) */
+static void pass_manager_diff(
+	struct pass_snapshot *before, struct pass_snapshot *after, long *added, long *removed
+) {
+	int i = 0, j = 0;
+	*added = 0;
+	*removed = 0;
+	while (i < before->count || j < after->count) {
+		if (j == after->count) {
+			(*removed)++;
+			i++;
+		} else if (i == before->count) {
+			(*added)++;
+			j++;
+		} else if (before->instructions[i] == after->instructions[j]) {
+			i++;
+			j++;
+		} else if ((uintptr_t)before->instructions[i] < (uintptr_t)after->instructions[j]) {
+			(*removed)++;
+			i++;
+		} else {
+			(*added)++;
+			j++;
+		}
+	}
+}
+
+/* runs `work` and records it under `name`, returns true if the IR changed */
+static bool pass_manager_measure(const char *name, void (*work)(struct cfg *), struct cfg *cfgs) {
+	struct pass_statistics *entry = pass_manager_statistics(name);
+	struct pass_snapshot before, after;
+	long added, removed;
+
+	pass_manager_snapshot(&before);
+	clock_t start = clock();
+
+	work(cfgs);
+
+	clock_t end = clock();
+	pass_manager_snapshot(&after);
+	pass_manager_diff(&before, &after, &added, &removed);
+
+	bool changed = before.fingerprint != after.fingerprint;
+	entry->runs++;
+	entry->changes += changed;
+	entry->milliseconds += 1000.0 * (end - start) / CLOCKS_PER_SEC;
+	entry->added += added;
+	entry->removed += removed;
+
+	free(before.instructions);
+	free(after.instructions);
+
+	return changed;
+}
+
+void pass_manager_print_statistics(FILE *output) {
+	double total_milliseconds = 0;
+	long total_added = 0, total_removed = 0;
+
+	fprintf(output, "\n=============== PASS STATISTICS ==============\n");
+	fprintf(output, "%-16s %6s %8s %12s %8s %8s\n", "pass", "runs", "changed", "time (ms)", "added", "removed");
+	for (int i = 0; i < PASS_COUNT + 2 && NULL != statistics[i].name; i++) {
+		struct pass_statistics *entry = &statistics[i];
+		fprintf(output, "%-16s %6d %8d %12.3f %8ld %8ld\n",
+			entry->name, entry->runs, entry->changes, entry->milliseconds, entry->added, entry->removed);
+		total_milliseconds += entry->milliseconds;
+		total_added += entry->added;
+		total_removed += entry->removed;
+	}
+	fprintf(output, "%-16s %6s %8s %12.3f %8ld %8ld\n", "total", "", "", total_milliseconds, total_added, total_removed);
+	if (budget_exhausted > 0) {
+		fprintf(output, "fixpoint budget of %d rounds ran out %d time(s)\n", budget, budget_exhausted);
+	}
+}
+
+/*************
+ * EXECUTION *
+ *************/
+
+/* the cfgs of the program while it is in SSA form */
+static struct cfg *ssa_cfgs = NULL;
+
+static void pass_manager_enter_ssa(struct cfg *cfgs) {
+	ssa_cfgs = ssa_construct_program();
+}
+
+static void pass_manager_leave_ssa(struct cfg *cfgs) {
+	ssa_destruct_program(ssa_cfgs);
+	ssa_cfgs = NULL;
+}
+
+static bool pass_manager_run_pass(struct pass *pass) {
+	if (pass->needs_ssa && NULL == ssa_cfgs) {
+		pass_manager_measure("(enter ssa)", pass_manager_enter_ssa, NULL);
+	} else if (!pass->needs_ssa && NULL != ssa_cfgs) {
+		pass_manager_measure("(leave ssa)", pass_manager_leave_ssa, NULL);
+	}
+
+	return pass_manager_measure(pass->name, pass->run, ssa_cfgs);
+}
+
+static bool pass_manager_run_steps(struct pass_pipeline *pipeline, FILE *output) {
+	bool changed = false;
+
+	for (int i = 0; i < pipeline->step_count; i++) {
+		struct pass_pipeline_step *step = &pipeline->steps[i];
+
+		if (NULL != step->pass) {
+			changed |= pass_manager_run_pass(step->pass);
+		} else {
+			int round = 0;
+			bool group_changed = true;
+			while (group_changed && round < budget) {
+				group_changed = pass_manager_run_steps(step->group, NULL);
+				changed |= group_changed;
+				round++;
+			}
+			if (group_changed) budget_exhausted++;
+		}
+
+		if (NULL != output) {
+			fprintf(output, "\n=============== IR OPTIMISED (%s) ==============\n",
+				NULL != step->pass ? step->pass->name : "fixpoint");
+			ir_print_section(output);
+		}
+	}
+	return changed;
+}
+
+/*
+ * Runs the pipeline over ir_list, printing the IR after every top level
+ * step when output is given. The program is back out of SSA form (and has
+ * no front end phis left) when this returns, ready for the MIPS backend.
+ */
+void pass_manager_run(struct pass_pipeline *pipeline, FILE *output) {
+	assert(NULL != pipeline);
+
+	ssa_lower_front_end_phis_program();
+	pass_manager_run_steps(pipeline, output);
+
+	if (NULL != ssa_cfgs) {
+		pass_manager_measure("(leave ssa)", pass_manager_leave_ssa, NULL);
+	}
+}
@@ -0,0 +1,38 @@
+#ifndef _PASS_MANAGER_H
+#define _PASS_MANAGER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "cfg.h"
+
+/*
+ * An optimization pass over the whole program. Passes that need SSA form get
+ * the per function cfgs built by ssa_construct_program (and must keep them
+ * up to date); every other pass gets NULL and works on ir_list directly.
+ */
+struct pass {
+  const char *name;
+  const char *description;
+  void (*run)(struct cfg *cfgs);
+  bool needs_ssa;
+};
+
+struct pass_pipeline;
+
+#define PASS_MANAGER_DEFAULT_BUDGET 8
+
+/*
+ * Pipelines are comma separated pass names, e.g. "identity,fixpoint(dce,constprop)".
+ * The passes inside fixpoint(...) are rerun until none of them changes the
+ * IR, or the budget of rounds runs out.
+ */
+struct pass_pipeline *pass_manager_parse(const char *description);
+const char *pass_manager_default_pipeline(int optimization_level, bool unroll_loops);
+void pass_manager_set_budget(int budget);
+
+void pass_manager_run(struct pass_pipeline *pipeline, FILE *output);
+void pass_manager_print_statistics(FILE *output);
+void pass_manager_print_passes(FILE *output);
+
+#endif
@@ -0,0 +1,567 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "reassociation.h"
+
+enum reassociation_class {
+	REASSOCIATION_NONE,
+	REASSOCIATION_ADD,                      /* additions, subtractions and negations */
+	REASSOCIATION_MULT,
+	REASSOCIATION_AND,
+	REASSOCIATION_OR,
+	REASSOCIATION_XOR
+};
+
+/* an operand of a chain: a temporary, negated for a subtracted one, or the folded constant */
+struct reassociation_term {
+	int temporary;
+	bool is_negated;
+	bool is_constant;
+	uint32_t value;
+	int rank;
+};
+
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+static int *definition_counts;
+static int *use_counts;
+static int *definition_blocks;                  /* temporary -> block id of its definition */
+static int *ranks;                              /* temporary -> rank, 0 until known */
+static int next_rank;
+
+static struct reassociation_term *terms;
+static int term_count, term_capacity;
+
+static struct reassociation_term *shape;        /* the chain as it is, to see if anything changes */
+static int shape_count, shape_capacity;
+
+static struct ir_list **inner_nodes;
+static int inner_count, inner_capacity;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool reassociation_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static struct ir_list *reassociation_definition(int temporary) {
+	if (temporary > max_temporary || 1 != definition_counts[temporary]) return NULL;
+	return temporary_definitions[temporary];
+}
+
+static bool reassociation_constant(int temporary, uint32_t *value) {
+	struct ir_list *definition = reassociation_definition(temporary);
+	if (NULL == definition || IR_CONST_INT != definition->data->kind) return false;
+	*value = (uint32_t)definition->data->operands[1].data.number;
+	return true;
+}
+
+static enum reassociation_class reassociation_class(enum ir_instruction_kind kind) {
+	switch (kind) {
+		case IR_ADD_SIGNED_WORD:
+		case IR_ADD_UNSIGNED_WORD:
+		case IR_SUB_SIGNED_WORD:
+		case IR_SUB_UNSIGNED_WORD:
+		case IR_UNARY_MINUS:
+			return REASSOCIATION_ADD;
+		case IR_MULT_SIGNED_WORD:
+		case IR_MULT_UNSIGNED_WORD:
+			return REASSOCIATION_MULT;
+		case IR_BITWISE_AND_WORD:
+			return REASSOCIATION_AND;
+		case IR_BITWISE_OR_WORD:
+			return REASSOCIATION_OR;
+		case IR_BITWISE_XOR_WORD:
+			return REASSOCIATION_XOR;
+		default:
+			return REASSOCIATION_NONE;
+	}
+}
+
+static bool reassociation_is_subtraction(enum ir_instruction_kind kind) {
+	return IR_SUB_SIGNED_WORD == kind || IR_SUB_UNSIGNED_WORD == kind;
+}
+
+static uint32_t reassociation_identity(enum reassociation_class class) {
+	switch (class) {
+		case REASSOCIATION_MULT: return 1;
+		case REASSOCIATION_AND: return 0xffffffffu;
+		default: return 0;
+	}
+}
+
+static uint32_t reassociation_fold(enum reassociation_class class, uint32_t left, uint32_t right) {
+	switch (class) {
+		case REASSOCIATION_ADD: return left + right;
+		case REASSOCIATION_MULT: return left * right;
+		case REASSOCIATION_AND: return left & right;
+		case REASSOCIATION_OR: return left | right;
+		case REASSOCIATION_XOR: return left ^ right;
+		default:
+			assert(0);
+			return 0;
+	}
+}
+
+/* a constant that decides the chain on its own: x * 0, x & 0, x | -1 */
+static bool reassociation_is_absorbing(enum reassociation_class class, uint32_t value) {
+	return (
+		((REASSOCIATION_MULT == class || REASSOCIATION_AND == class) && 0 == value) ||
+		(REASSOCIATION_OR == class && 0xffffffffu == value)
+	);
+}
+
+/*
+ * Constants rank 0, values that aren't computed from others (parameters,
+ * loads, phis, calls) by where they are defined in reverse postorder, and
+ * computed values as their latest operand, so what is ready early (loop
+ * invariants included) is combined first.
+ */
+static int reassociation_rank(int temporary) {
+	if (temporary > max_temporary) return next_rank;
+	if (0 != ranks[temporary]) return ranks[temporary];
+
+	uint32_t value;
+	if (reassociation_constant(temporary, &value)) return 0;
+
+	struct ir_list *definition = reassociation_definition(temporary);
+	int rank = 1;
+	if (NULL != definition && dataflow_is_expression(definition->data)) {
+		for (int i = 0; i < ir_use_count(definition->data); i++) {
+			struct ir_operand *use = ir_use_operand(definition->data, i);
+			if (reassociation_is_temporary(use) && use->data.temporary != temporary) {
+				int operand_rank = reassociation_rank(use->data.temporary);
+				if (operand_rank > rank) rank = operand_rank;
+			}
+		}
+	}
+	ranks[temporary] = rank;
+	return rank;
+}
+
+static void reassociation_number(struct cfg *cfg) {
+	next_rank = 1;
+	for (int b = 0; b < cfg->reachable_count; b++) {
+		struct cfg_block *block = cfg->reverse_postorder[b];
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_operand *definition = ir_definition_operand(iter->data);
+			if (
+				NULL != definition && reassociation_is_temporary(definition) &&
+				!dataflow_is_expression(iter->data) && IR_CONST_INT != iter->data->kind
+			) {
+				ranks[definition->data.temporary] = ++next_rank;
+			}
+			if (iter == block->last) break;
+		}
+	}
+	next_rank++;
+}
+
+/*********
+ * TERMS *
+ *********/
+
+static void reassociation_add_term(struct reassociation_term **array, int *count, int *capacity, struct reassociation_term *term) {
+	if (*count == *capacity) {
+		*capacity = 0 == *capacity ? 16 : *capacity * 2;
+		*array = realloc(*array, sizeof(struct reassociation_term) * *capacity);
+		assert(NULL != *array);
+	}
+	(*array)[(*count)++] = *term;
+}
+
+static void reassociation_add_inner(struct ir_list *node) {
+	if (inner_count == inner_capacity) {
+		inner_capacity = 0 == inner_capacity ? 16 : inner_capacity * 2;
+		inner_nodes = realloc(inner_nodes, sizeof(struct ir_list *) * inner_capacity);
+		assert(NULL != inner_nodes);
+	}
+	inner_nodes[inner_count++] = node;
+}
+
+/* an operand the chain can open up: of its class, in its block and read by nothing else */
+static struct ir_list *reassociation_inner(struct cfg_block *block, enum reassociation_class class, struct ir_operand *operand) {
+	if (!reassociation_is_temporary(operand) || 1 != use_counts[operand->data.temporary]) return NULL;
+
+	struct ir_list *definition = reassociation_definition(operand->data.temporary);
+	if (NULL == definition || definition == block->first || definition == block->last) return NULL;
+	if (definition_blocks[operand->data.temporary] != block->id) return NULL;
+	if (class != reassociation_class(definition->data->kind)) return NULL;
+	return definition;
+}
+
+/* the terms of the operand into `terms`, the constants folded into *constant */
+static void reassociation_collect(
+	struct cfg_block *block, enum reassociation_class class, struct ir_operand *operand, bool is_negated,
+	uint32_t *constant, int *constant_count
+) {
+	struct ir_list *inner = reassociation_inner(block, class, operand);
+	uint32_t value;
+
+	if (NULL != inner) {
+		struct ir_instruction *instruction = inner->data;
+		reassociation_add_inner(inner);
+		reassociation_collect(block, class, &instruction->operands[1], is_negated ^ (IR_UNARY_MINUS == instruction->kind), constant, constant_count);
+		if (IR_UNARY_MINUS != instruction->kind) {
+			bool is_subtracted = reassociation_is_subtraction(instruction->kind);
+			reassociation_collect(block, class, &instruction->operands[2], is_negated ^ is_subtracted, constant, constant_count);
+		}
+		return;
+	}
+
+	if (reassociation_constant(operand->data.temporary, &value)) {
+		*constant = reassociation_fold(class, *constant, is_negated ? 0u - value : value);
+		(*constant_count)++;
+		return;
+	}
+
+	struct reassociation_term term;
+	term.temporary = operand->data.temporary;
+	term.is_negated = is_negated;
+	term.is_constant = false;
+	term.rank = reassociation_rank(term.temporary);
+	reassociation_add_term(&terms, &term_count, &term_capacity, &term);
+}
+
+/* x - x, x ^ x and x & x, x | x */
+static void reassociation_simplify(enum reassociation_class class) {
+	if (REASSOCIATION_MULT == class) return;
+
+	for (int i = 0; i < term_count; i++) {
+		for (int j = i + 1; j < term_count; j++) {
+			if (terms[i].temporary != terms[j].temporary) continue;
+
+			bool is_cancelled =
+				(REASSOCIATION_ADD == class && terms[i].is_negated != terms[j].is_negated) ||
+				REASSOCIATION_XOR == class;
+			bool is_repeated = REASSOCIATION_AND == class || REASSOCIATION_OR == class;
+			if (!is_cancelled && !is_repeated) continue;
+
+			terms[j] = terms[--term_count];
+			if (is_cancelled) {
+				terms[i] = terms[--term_count];
+				i--;
+			} else {
+				j--;
+			}
+			break;
+		}
+	}
+}
+
+/* added terms before subtracted ones, then by rank */
+static int reassociation_compare(const void *left, const void *right) {
+	const struct reassociation_term *term_1 = left, *term_2 = right;
+
+	if (term_1->is_negated != term_2->is_negated) return term_1->is_negated ? 1 : -1;
+	if (term_1->rank != term_2->rank) return term_1->rank < term_2->rank ? -1 : 1;
+	return term_1->temporary - term_2->temporary;
+}
+
+/*
+ * The chain as a left leaning list of operands, the way it will be rebuilt,
+ * false if it isn't one.
+ */
+static bool reassociation_shape(struct cfg_block *block, enum reassociation_class class, struct ir_instruction *root) {
+	struct ir_instruction *instruction = root;
+	struct reassociation_term term;
+
+	shape_count = 0;
+	memset(&term, 0, sizeof(struct reassociation_term));
+	for (;;) {
+		if (IR_UNARY_MINUS == instruction->kind) return false;
+		if (NULL != reassociation_inner(block, class, &instruction->operands[2])) return false;
+
+		term.temporary = instruction->operands[2].data.temporary;
+		term.is_negated = reassociation_is_subtraction(instruction->kind);
+		term.is_constant = reassociation_constant(term.temporary, &term.value);
+		reassociation_add_term(&shape, &shape_count, &shape_capacity, &term);
+
+		struct ir_list *inner = reassociation_inner(block, class, &instruction->operands[1]);
+		if (NULL == inner) break;
+		instruction = inner->data;
+	}
+
+	term.temporary = instruction->operands[1].data.temporary;
+	term.is_negated = false;
+	term.is_constant = reassociation_constant(term.temporary, &term.value);
+	reassociation_add_term(&shape, &shape_count, &shape_capacity, &term);
+	return true;
+}
+
+static bool reassociation_is_shape(int index, struct reassociation_term *term) {
+	struct reassociation_term *existing = &shape[shape_count - 1 - index];
+
+	if (existing->is_negated != term->is_negated || existing->is_constant != term->is_constant) return false;
+	if (term->is_constant) return existing->value == term->value;
+	return existing->temporary == term->temporary;
+}
+
+/***********
+ * REBUILD *
+ ***********/
+
+static int reassociation_compute(
+	struct ir_list *node, bool is_last, enum ir_instruction_kind kind, int left, int right
+) {
+	struct ir_instruction *instruction = is_last ? node->data : ir_instruction(kind);
+
+	instruction->kind = kind;
+	if (!is_last) ir_operand_temporary(instruction, 0);
+	instruction->operands[1].kind = OPERAND_TEMPORARY;
+	instruction->operands[1].data.temporary = left;
+	instruction->operands[2].kind = OPERAND_TEMPORARY;
+	instruction->operands[2].data.temporary = right;
+	if (!is_last) ir_insert_before(node, instruction);
+	return instruction->operands[0].data.temporary;
+}
+
+static int reassociation_constant_before(struct ir_list *node, uint32_t value) {
+	struct ir_instruction *instruction = ir_instruction(IR_CONST_INT);
+	ir_operand_temporary(instruction, 0);
+	ir_operand_number(instruction, 1, value);
+	ir_insert_before(node, instruction);
+	return instruction->operands[0].data.temporary;
+}
+
+static enum ir_instruction_kind reassociation_kind(enum reassociation_class class, bool is_negated) {
+	switch (class) {
+		case REASSOCIATION_ADD: return is_negated ? IR_SUB_UNSIGNED_WORD : IR_ADD_UNSIGNED_WORD;
+		case REASSOCIATION_MULT: return IR_MULT_SIGNED_WORD;
+		case REASSOCIATION_AND: return IR_BITWISE_AND_WORD;
+		case REASSOCIATION_OR: return IR_BITWISE_OR_WORD;
+		case REASSOCIATION_XOR: return IR_BITWISE_XOR_WORD;
+		default:
+			assert(0);
+			return IR_NO_OPERATION;
+	}
+}
+
+/* the root becomes the last instruction of the new chain, or a copy or constant if there is no chain left */
+static void reassociation_rebuild(struct ir_list *node, enum reassociation_class class) {
+	struct ir_instruction *root = node->data;
+	int step_count = term_count - 1;
+	int i = 0, result;
+
+	if (0 == term_count) {
+		root->kind = IR_CONST_INT;
+		ir_operand_number(root, 1, terms[0].value);
+		return;
+	}
+
+	/* only subtracted terms: c - x - y, the constant taken from the end */
+	if (terms[0].is_negated) {
+		result = reassociation_constant_before(node, terms[term_count - 1].value);
+	} else {
+		result = terms[i++].temporary;
+	}
+
+	if (0 == step_count) {
+		root->kind = IR_COPY;
+		root->operands[1].kind = OPERAND_TEMPORARY;
+		root->operands[1].data.temporary = result;
+		return;
+	}
+
+	for (int step = 0; step < step_count; step++, i++) {
+		bool is_last = step == step_count - 1;
+		int operand = terms[i].is_constant ?
+			reassociation_constant_before(node, terms[i].value) :
+			terms[i].temporary;
+		result = reassociation_compute(node, is_last, reassociation_kind(class, terms[i].is_negated), result, operand);
+	}
+}
+
+/***********
+ * CHAINS *
+ ***********/
+
+static bool reassociation_is_root(struct cfg_block *block, enum reassociation_class class, struct ir_instruction *instruction) {
+	if (REASSOCIATION_NONE == class || IR_UNARY_MINUS == instruction->kind) return false;
+	if (!reassociation_is_temporary(&instruction->operands[1]) || !reassociation_is_temporary(&instruction->operands[2])) return false;
+
+	/* not opened up by the chain that reads it */
+	int temporary = instruction->operands[0].data.temporary;
+	if (temporary > max_temporary || 1 != use_counts[temporary]) return true;
+	for (struct ir_list *iter = block->first; ; iter = iter->next) {
+		if (class == reassociation_class(iter->data->kind)) {
+			for (int i = 0; i < ir_use_count(iter->data); i++) {
+				struct ir_operand *use = ir_use_operand(iter->data, i);
+				if (OPERAND_TEMPORARY == use->kind && temporary == use->data.temporary) return false;
+			}
+		}
+		if (iter == block->last) break;
+	}
+	return true;
+}
+
+static void reassociation_chain(struct cfg_block *block, struct ir_list *node) {
+	struct ir_instruction *root = node->data;
+	enum reassociation_class class = reassociation_class(root->kind);
+	uint32_t constant = reassociation_identity(class);
+	int constant_count = 0;
+
+	term_count = 0;
+	inner_count = 0;
+	reassociation_collect(block, class, &root->operands[1], false, &constant, &constant_count);
+	reassociation_collect(block, class, &root->operands[2], reassociation_is_subtraction(root->kind), &constant, &constant_count);
+	reassociation_simplify(class);
+
+	if (reassociation_is_absorbing(class, constant)) term_count = 0;
+	qsort(terms, term_count, sizeof(struct reassociation_term), reassociation_compare);
+
+	/* the constant goes last, or first if there is nothing to subtract it from */
+	bool is_constant_used = constant != reassociation_identity(class) || 0 == term_count || terms[0].is_negated;
+	if (is_constant_used) {
+		struct reassociation_term term;
+		memset(&term, 0, sizeof(struct reassociation_term));
+		term.is_constant = true;
+		term.value = constant;
+		reassociation_add_term(&terms, &term_count, &term_capacity, &term);
+	}
+
+	/* as it is already */
+	bool is_same = reassociation_shape(block, class, root) && shape_count == term_count;
+	if (is_same && terms[0].is_negated) {
+		is_same = reassociation_is_shape(0, &terms[term_count - 1]);
+		for (int i = 1; i < term_count && is_same; i++) is_same = reassociation_is_shape(i, &terms[i - 1]);
+	} else {
+		for (int i = 0; i < term_count && is_same; i++) is_same = reassociation_is_shape(i, &terms[i]);
+	}
+	if (is_same) return;
+
+	if (1 == term_count && terms[0].is_constant) {
+		term_count = 0;
+		terms[0].value = constant;
+	}
+	reassociation_rebuild(node, class);
+	for (int i = 0; i < inner_count; i++) ir_unlink(inner_nodes[i]);
+}
+
+/* (x << a) << b => x << (a + b) */
+static void reassociation_shift(struct cfg_block *block, struct ir_list *node) {
+	struct ir_instruction *instruction = node->data;
+	uint32_t amount;
+
+	if (!reassociation_is_temporary(&instruction->operands[2])) return;
+	if (!reassociation_constant(instruction->operands[2].data.temporary, &amount)) return;
+
+	for (;;) {
+		struct ir_operand *operand = &instruction->operands[1];
+		if (!reassociation_is_temporary(operand) || 1 != use_counts[operand->data.temporary]) return;
+
+		struct ir_list *inner = reassociation_definition(operand->data.temporary);
+		uint32_t inner_amount;
+		if (NULL == inner || inner == block->first || inner == block->last) return;
+		if (definition_blocks[operand->data.temporary] != block->id || inner->data->kind != instruction->kind) return;
+		if (!reassociation_is_temporary(&inner->data->operands[2])) return;
+		if (!reassociation_constant(inner->data->operands[2].data.temporary, &inner_amount)) return;
+
+		/* sllv, srav and srlv only look at the low 5 bits of the amount */
+		uint32_t total = (amount & 31) + (inner_amount & 31);
+		if (total > 31) {
+			if (IR_RIGHT_SHIFT_SIGNED_WORD != instruction->kind) {
+				instruction->kind = IR_CONST_INT;
+				ir_operand_number(instruction, 1, 0);
+				ir_unlink(inner);
+				return;
+			}
+			total = 31;
+		}
+
+		instruction->operands[1] = inner->data->operands[1];
+		instruction->operands[2].data.temporary = reassociation_constant_before(node, total);
+		amount = total;
+		ir_unlink(inner);
+	}
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+void reassociation(struct cfg *cfg) {
+	struct ir_list *iter;
+
+	max_temporary = dataflow_max_temporary(cfg);
+	temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+	definition_counts = calloc(max_temporary + 1, sizeof(int));
+	use_counts = calloc(max_temporary + 1, sizeof(int));
+	definition_blocks = calloc(max_temporary + 1, sizeof(int));
+	ranks = calloc(max_temporary + 1, sizeof(int));
+	assert(NULL != definition_counts && NULL != use_counts && NULL != definition_blocks && NULL != ranks);
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL != definition && reassociation_is_temporary(definition)) definition_counts[definition->data.temporary]++;
+		for (int i = 0; i < ir_use_count(iter->data); i++) {
+			struct ir_operand *use = ir_use_operand(iter->data, i);
+			if (reassociation_is_temporary(use)) use_counts[use->data.temporary]++;
+		}
+		if (iter == cfg->proc_end) break;
+	}
+	for (int b = 0; b < cfg->block_count; b++) {
+		for (iter = cfg->blocks[b]->first; ; iter = iter->next) {
+			struct ir_operand *definition = ir_definition_operand(iter->data);
+			if (NULL != definition && reassociation_is_temporary(definition)) {
+				definition_blocks[definition->data.temporary] = b;
+			}
+			if (iter == cfg->blocks[b]->last) break;
+		}
+	}
+	reassociation_number(cfg);
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		struct ir_list *next;
+
+		for (iter = block->first; ; iter = next) {
+			struct ir_instruction *instruction = iter->data;
+			bool is_last = iter == block->last;
+			enum reassociation_class class = reassociation_class(instruction->kind);
+
+			next = iter->next;
+			if (
+				IR_LEFT_SHIFT_WORD == instruction->kind ||
+				IR_RIGHT_SHIFT_SIGNED_WORD == instruction->kind ||
+				IR_RIGHT_SHIFT_UNSIGNED_WORD == instruction->kind
+			) {
+				reassociation_shift(block, iter);
+			} else if (reassociation_is_root(block, class, instruction)) {
+				reassociation_chain(block, iter);
+			}
+			if (is_last) break;
+		}
+	}
+
+	free(temporary_definitions);
+	free(definition_counts);
+	free(use_counts);
+	free(definition_blocks);
+	free(ranks);
+}
+
+void reassociation_program(struct cfg *cfgs) {
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		reassociation(cfg);
+	}
+
+	free(terms);
+	free(shape);
+	free(inner_nodes);
+	terms = NULL;
+	shape = NULL;
+	inner_nodes = NULL;
+	term_capacity = 0;
+	shape_capacity = 0;
+	inner_capacity = 0;
+}
@@ -0,0 +1,30 @@
+#ifndef _REASSOCIATION_H
+#define _REASSOCIATION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Reassociation of the chains of additions and subtractions, multiplications
+ * and bitwise ands, ors and xors within a basic block. Every operand of the
+ * chain whose value only the chain reads is opened up, the constants are
+ * folded into one, terms that cancel out (x - x, x ^ x) or repeat (x & x)
+ * go, and the rest are put back together in order of rank: values that are
+ * ready earlier, like loop invariants, first and the constant last. So
+ * a + 1 + b + 2 is (a + b) + 3, and the same sum written in another order
+ * is the same expression for value numbering. Chains of shifts by constant
+ * amounts become one shift.
+ *
+ * The new chain computes with addu, subu and mul, which wrap around where
+ * add, sub and mulou trap, as the result modulo 2^32 is the same in any
+ * order.
+ *
+ * Works on a function in SSA form.
+ */
+void reassociation(struct cfg *cfg);
+void reassociation_program(struct cfg *cfgs);
+
+#endif
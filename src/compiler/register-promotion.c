@@ -0,0 +1,452 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "register-promotion.h"
+
+extern int next_temporary;
+
+/* a word local or parameter that could live in a temporary */
+struct register_promotion_variable {
+	int variable;
+	struct ir_instruction *address;         /* one of its addressOfs, cloned for a parameter's entry load */
+	int weight;                             /* accesses, those in loops counting 8 times per level */
+	int start, end;                         /* where the temporary would be live, in layout positions */
+	bool is_promoted;
+	int temporary;
+};
+
+static struct cfg *cfg;
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+static int *definition_counts;
+
+static int max_variable;
+static bool *escapes;
+static bool *is_excluded;                       /* variable -> accessed as something else than a word */
+
+static struct register_promotion_variable *variables;
+static int variable_count;
+static int *variable_candidates;                /* variable -> index in variables, -1 if it isn't one */
+static bool *is_header;                         /* block -> a loop header */
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool register_promotion_is_temporary(struct ir_operand *operand) {
+	return NULL != operand && OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static bool register_promotion_is_load(struct ir_instruction *instruction) {
+	return (
+		IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind
+	);
+}
+
+static bool register_promotion_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+/* the addressOf of a local or parameter, NULL for globals, strings and everything else */
+static struct ir_instruction *register_promotion_local(struct ir_instruction *address) {
+	if (
+		NULL == address ||
+		IR_ADDRESS_OF != address->kind ||
+		address->operands[2].data.is_string ||
+		0 != address->operands[6].data.number ||
+		address->operands[3].data.variable_id > max_variable
+	) {
+		return NULL;
+	}
+	return address;
+}
+
+/* the local a load or store goes through, NULL if it isn't known */
+static struct ir_instruction *register_promotion_address(struct ir_instruction *instruction) {
+	if (NULL != instruction->offset_variable) return register_promotion_local(instruction->offset_variable);
+
+	struct ir_operand *operand = &instruction->operands[register_promotion_is_store(instruction) ? 0 : 1];
+	if (!register_promotion_is_temporary(operand) || 1 != definition_counts[operand->data.temporary]) return NULL;
+	return register_promotion_local(temporary_definitions[operand->data.temporary]->data);
+}
+
+/* the candidate a load or store accesses, -1 if it isn't one */
+static int register_promotion_candidate(struct ir_instruction *instruction) {
+	if (!register_promotion_is_load(instruction) && !register_promotion_is_store(instruction)) return -1;
+
+	struct ir_instruction *address = register_promotion_address(instruction);
+	if (NULL == address) return -1;
+	return variable_candidates[address->operands[3].data.variable_id];
+}
+
+/**************
+ * CANDIDATES *
+ **************/
+
+static void register_promotion_exclude(struct ir_instruction *instruction) {
+	struct ir_operand *definition = ir_definition_operand(instruction);
+
+	/* an address that is also written by something else can't be followed */
+	if (
+		NULL != register_promotion_local(instruction) &&
+		register_promotion_is_temporary(definition) &&
+		1 != definition_counts[definition->data.temporary]
+	) {
+		is_excluded[instruction->operands[3].data.variable_id] = true;
+	}
+
+	if (!register_promotion_is_load(instruction) && !register_promotion_is_store(instruction)) return;
+
+	struct ir_instruction *address = register_promotion_address(instruction);
+	if (NULL == address) return;
+
+	if (
+		4 != (int)address->operands[4].data.number ||
+		(IR_LOAD_WORD != instruction->kind && IR_STORE_WORD != instruction->kind)
+	) {
+		is_excluded[address->operands[3].data.variable_id] = true;
+	}
+}
+
+static void register_promotion_add(struct ir_instruction *instruction, int depth) {
+	if (!register_promotion_is_load(instruction) && !register_promotion_is_store(instruction)) return;
+
+	struct ir_instruction *address = register_promotion_address(instruction);
+	if (NULL == address) return;
+
+	int variable = address->operands[3].data.variable_id;
+	if (escapes[variable] || is_excluded[variable]) return;
+
+	if (-1 == variable_candidates[variable]) {
+		variable_candidates[variable] = variable_count;
+		variables[variable_count].variable = variable;
+		variables[variable_count].address = address;
+		variables[variable_count].weight = 0;
+		variables[variable_count].start = -1;
+		variables[variable_count].end = -1;
+		variables[variable_count].is_promoted = false;
+		variable_count++;
+	}
+	variables[variable_candidates[variable]].weight += 1 << (3 * (depth < 3 ? depth : 3));
+}
+
+static void register_promotion_find_candidates(void) {
+	for (struct ir_list *iter = cfg->proc_begin; ; iter = iter->next) {
+		register_promotion_exclude(iter->data);
+		if (iter == cfg->proc_end) break;
+	}
+
+	cfg_compute_dominators(cfg);
+	int loop_count;
+	struct cfg_loop *loops = cfg_find_loops(cfg, &loop_count);
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		int depth = 0;
+		for (int l = 0; l < loop_count; l++) depth += loops[l].body[b];
+		is_header[b] = false;
+		for (int l = 0; l < loop_count; l++) is_header[b] = is_header[b] || loops[l].header == block;
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			register_promotion_add(iter->data, depth);
+			if (iter == block->last) break;
+		}
+	}
+
+	cfg_destroy_loops(loops, loop_count);
+}
+
+/************
+ * PRESSURE *
+ ************/
+
+/*
+ * Liveness of the temporaries and of the candidates, the latter as bits
+ * past max_temporary: their loads read them and their stores write them,
+ * as the copies replacing them will.
+ */
+static struct dataflow *register_promotion_liveness(void) {
+	struct dataflow *liveness = dataflow_create(
+		cfg, max_temporary + 1 + variable_count, DATAFLOW_BACKWARD, DATAFLOW_UNION
+	);
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		struct bit_vector *gen = liveness->gen[b];
+		struct bit_vector *kill = liveness->kill[b];
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			int candidate = register_promotion_candidate(instruction);
+
+			for (int i = 0; i < ir_use_count(instruction); i++) {
+				struct ir_operand *use = ir_use_operand(instruction, i);
+				if (register_promotion_is_temporary(use) && !bit_vector_test(kill, use->data.temporary)) {
+					bit_vector_set(gen, use->data.temporary);
+				}
+			}
+			if (-1 != candidate && register_promotion_is_load(instruction)) {
+				if (!bit_vector_test(kill, max_temporary + 1 + candidate)) {
+					bit_vector_set(gen, max_temporary + 1 + candidate);
+				}
+			}
+
+			struct ir_operand *definition = ir_definition_operand(instruction);
+			if (register_promotion_is_temporary(definition)) {
+				bit_vector_set(kill, definition->data.temporary);
+			}
+			if (-1 != candidate && register_promotion_is_store(instruction)) {
+				bit_vector_set(kill, max_temporary + 1 + candidate);
+			}
+
+			if (iter == block->last) break;
+		}
+	}
+
+	dataflow_solve(liveness);
+	return liveness;
+}
+
+static void register_promotion_extend(int *starts, int *ends, int index, int position) {
+	if (-1 == starts[index] || starts[index] > position) starts[index] = position;
+	if (ends[index] < position) ends[index] = position;
+}
+
+/* the candidate whose address the temporary holds, -1 if it isn't one */
+static int register_promotion_address_candidate(int temporary) {
+	if (1 != definition_counts[temporary]) return -1;
+
+	struct ir_instruction *address = register_promotion_local(temporary_definitions[temporary]->data);
+	if (NULL == address) return -1;
+	return variable_candidates[address->operands[3].data.variable_id];
+}
+
+/* an interval holds its register one position past its end */
+static void register_promotion_cover(int *pressure, int start, int end, int delta) {
+	if (-1 == start) return;
+	for (int p = start; p <= end + 1; p++) pressure[p] += delta;
+}
+
+/*
+ * The intervals mips_allocate_registers will see: from the first to the
+ * last position where a value is written, read or live, with blocks in
+ * layout order. A register is only handed out again one instruction after
+ * the interval ends, so each one covers one more position.
+ */
+static void register_promotion_choose(void) {
+	struct dataflow *liveness = register_promotion_liveness();
+	int size = max_temporary + 1 + variable_count;
+	int *starts = malloc(sizeof(int) * size);
+	int *ends = malloc(sizeof(int) * size);
+	assert(NULL != starts && NULL != ends);
+	for (int i = 0; i < size; i++) {
+		starts[i] = -1;
+		ends[i] = -1;
+	}
+
+	int position = 0;
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		int first_position = position;
+
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			int candidate = register_promotion_candidate(instruction);
+
+			for (int i = 0; i < ir_use_count(instruction); i++) {
+				struct ir_operand *use = ir_use_operand(instruction, i);
+				if (register_promotion_is_temporary(use)) register_promotion_extend(starts, ends, use->data.temporary, position);
+			}
+			struct ir_operand *definition = ir_definition_operand(instruction);
+			if (register_promotion_is_temporary(definition)) {
+				register_promotion_extend(starts, ends, definition->data.temporary, position);
+			}
+			if (-1 != candidate) register_promotion_extend(starts, ends, max_temporary + 1 + candidate, position);
+
+			position++;
+			if (iter == block->last) break;
+		}
+
+		int last_position = position - 1;
+		for (int i = bit_vector_next(liveness->in[b], 0); i >= 0; i = bit_vector_next(liveness->in[b], i + 1)) {
+			register_promotion_extend(starts, ends, i, first_position);
+		}
+		for (int i = bit_vector_next(liveness->out[b], 0); i >= 0; i = bit_vector_next(liveness->out[b], i + 1)) {
+			register_promotion_extend(starts, ends, i, last_position);
+		}
+	}
+
+	int *pressure = calloc(position + 2, sizeof(int));
+	assert(NULL != pressure);
+	for (int t = 0; t <= max_temporary; t++) {
+		register_promotion_cover(pressure, starts[t], ends[t], 1);
+	}
+
+	/* the most accessed first */
+	int *order = malloc(sizeof(int) * (variable_count + 1));
+	assert(NULL != order);
+	for (int c = 0; c < variable_count; c++) {
+		int o = c;
+		for (; o > 0 && variables[order[o - 1]].weight < variables[c].weight; o--) order[o] = order[o - 1];
+		order[o] = c;
+	}
+
+	/* the temporary takes the place of the addresses, which go with the loads and stores */
+	int limit = REGISTER_PROMOTION_REGISTERS - REGISTER_PROMOTION_SPARE_REGISTERS;
+	for (int o = 0; o < variable_count; o++) {
+		struct register_promotion_variable *candidate = &variables[order[o]];
+		int index = max_temporary + 1 + order[o];
+		candidate->start = starts[index];
+		candidate->end = ends[index];
+
+		for (int t = 0; t <= max_temporary; t++) {
+			if (order[o] == register_promotion_address_candidate(t)) register_promotion_cover(pressure, starts[t], ends[t], -1);
+		}
+
+		/* in and out of SSA form, the value merged at a loop header and the one coming around don't share a temporary */
+		int cost = 1;
+		for (int b = 0; b < cfg->block_count; b++) {
+			if (is_header[b] && bit_vector_test(liveness->in[b], index)) cost = 2;
+		}
+
+		bool fits = true;
+		for (int p = candidate->start; p <= candidate->end + 1 && fits; p++) fits = pressure[p] + cost <= limit;
+
+		if (fits) {
+			register_promotion_cover(pressure, candidate->start, candidate->end, cost);
+			candidate->is_promoted = true;
+			candidate->temporary = next_temporary++;
+		} else {
+			for (int t = 0; t <= max_temporary; t++) {
+				if (order[o] == register_promotion_address_candidate(t)) register_promotion_cover(pressure, starts[t], ends[t], 1);
+			}
+		}
+	}
+
+	/* a parameter read before it's written needs its value from the slot */
+	for (int c = 0; c < variable_count; c++) {
+		if (!bit_vector_test(liveness->in[0], max_temporary + 1 + c)) variables[c].address = NULL;
+	}
+
+	free(order);
+	free(pressure);
+	free(starts);
+	free(ends);
+	dataflow_destroy(liveness);
+}
+
+/***********
+ * REWRITE *
+ ***********/
+
+/* loads become copies from the variable's temporary and stores copies into it */
+static void register_promotion_rewrite(void) {
+	for (struct ir_list *iter = cfg->proc_begin->next, *next; iter != cfg->proc_end; iter = next) {
+		struct ir_instruction *instruction = iter->data;
+		next = iter->next;
+
+		/* every use of its address is one of the accesses rewritten here */
+		struct ir_instruction *address = register_promotion_local(instruction);
+		if (NULL != address && -1 != variable_candidates[address->operands[3].data.variable_id]) {
+			if (variables[variable_candidates[address->operands[3].data.variable_id]].is_promoted) ir_unlink(iter);
+			continue;
+		}
+
+		int candidate = register_promotion_candidate(instruction);
+		if (-1 == candidate || !variables[candidate].is_promoted) continue;
+
+		if (register_promotion_is_store(instruction)) {
+			instruction->operands[0].kind = OPERAND_TEMPORARY;
+			instruction->operands[0].data.temporary = variables[candidate].temporary;
+		} else {
+			instruction->operands[1].kind = OPERAND_TEMPORARY;
+			instruction->operands[1].data.temporary = variables[candidate].temporary;
+		}
+		instruction->kind = IR_COPY;
+		instruction->offset_variable = NULL;
+	}
+
+	for (int c = 0; c < variable_count; c++) {
+		struct register_promotion_variable *variable = &variables[c];
+		if (!variable->is_promoted || NULL == variable->address) continue;
+		if (-1 == (int)variable->address->operands[5].data.number) continue;
+
+		struct ir_instruction *address = ir_instruction(IR_ADDRESS_OF);
+		memcpy(address->operands, variable->address->operands, sizeof(address->operands));
+		ir_operand_temporary(address, 0);
+
+		struct ir_instruction *load = ir_instruction(IR_LOAD_WORD);
+		load->operands[0].kind = OPERAND_TEMPORARY;
+		load->operands[0].data.temporary = variable->temporary;
+		ir_operand_copy(load, 1, &address->operands[0]);
+
+		/* before any label, which a tail recursion jumps back to */
+		ir_insert_after(cfg->proc_begin, load);
+		ir_insert_after(cfg->proc_begin, address);
+	}
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+static void register_promotion(struct cfg *function) {
+	cfg = function;
+	max_temporary = dataflow_max_temporary(cfg);
+	temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+	definition_counts = calloc(max_temporary + 1, sizeof(int));
+	assert(NULL != definition_counts);
+
+	for (struct ir_list *iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (register_promotion_is_temporary(definition)) definition_counts[definition->data.temporary]++;
+		if (iter == cfg->proc_end) break;
+	}
+
+	escapes = dataflow_escaping_variables(cfg, temporary_definitions, &max_variable);
+	is_excluded = calloc(max_variable + 1, sizeof(bool));
+	variables = malloc(sizeof(struct register_promotion_variable) * (max_variable + 1));
+	variable_candidates = malloc(sizeof(int) * (max_variable + 1));
+	is_header = malloc(sizeof(bool) * cfg->block_count);
+	assert(NULL != is_excluded && NULL != variables && NULL != variable_candidates && NULL != is_header);
+	for (int v = 0; v <= max_variable; v++) variable_candidates[v] = -1;
+	variable_count = 0;
+
+	register_promotion_find_candidates();
+	if (variable_count > 0) {
+		register_promotion_choose();
+		register_promotion_rewrite();
+	}
+
+	free(temporary_definitions);
+	free(definition_counts);
+	free(escapes);
+	free(is_excluded);
+	free(variables);
+	free(variable_candidates);
+	free(is_header);
+}
+
+void register_promotion_program(void) {
+	struct cfg *cfgs = cfg_build_program();
+
+	for (struct cfg *function = cfgs; NULL != function; function = function->next) {
+		register_promotion(function);
+	}
+
+	cfg_destroy_program(cfgs);
+}
@@ -0,0 +1,31 @@
+#ifndef _REGISTER_PROMOTION_H
+#define _REGISTER_PROMOTION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/* registers mips.c hands out to temporaries, and how many to leave for later passes */
+#define REGISTER_PROMOTION_REGISTERS        17
+#define REGISTER_PROMOTION_SPARE_REGISTERS  4
+
+/*
+ * Keeps word locals and parameters whose address is never taken in a
+ * temporary of their own for the whole function (mem2reg): their loads
+ * become copies from it and their stores copies into it. A parameter is
+ * loaded from its slot once, right after the procBegin.
+ *
+ * A variable the register allocator spills is back in memory, so variables
+ * are promoted by how often they are accessed (weighing loops) for as long
+ * as the temporaries live at any point, theirs included, fit in the
+ * registers, minus a few spare ones.
+ *
+ * Works on ir_list outside SSA form, the temporary is written by every
+ * store. Goes after the loop passes, which track these variables in
+ * memory.
+ */
+void register_promotion_program(void);
+
+#endif
@@ -0,0 +1,755 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+/*
+ * Compiles a file of IR rewrite rules into the matcher the identity pass
+ * (optimization-1.c) includes:
+ *
+ *   rewrite-generator identity.rules identity-rules.h
+ *
+ * The rules are spread over the IR kinds they match and turned into one
+ * switch on the kind, then a test per operand whether it is a constant, and
+ * only then the rules left for that combination, in the order of the file.
+ * The rule language is described at the top of identity.rules.
+ */
+
+#define REWRITE_MAX_OPERANDS    2
+#define REWRITE_MAX_CLASSES     64
+#define REWRITE_MAX_CLASS_KINDS 16
+#define REWRITE_MAX_KINDS       128
+#define REWRITE_MAX_RULES       128       /* per kind */
+
+enum rewrite_token_kind {
+	TOKEN_OPEN,
+	TOKEN_CLOSE,
+	TOKEN_ARROW,
+	TOKEN_CODE,
+	TOKEN_WORD,
+	TOKEN_END
+};
+
+struct rewrite_token {
+	enum rewrite_token_kind kind;
+	char *text;
+	int line;
+};
+
+enum rewrite_pattern_kind {
+	PATTERN_NAME,                 /* any temporary, or a copy of it as a result */
+	PATTERN_CONSTANT_NAME,        /* (const c) */
+	PATTERN_CONSTANT_NUMBER,      /* (const 0) */
+	PATTERN_CONSTANT_CODE,        /* (const {c - 1}), results only */
+	PATTERN_INSTRUCTION,          /* (KIND ...) */
+	PATTERN_CODE                  /* {...}, results only */
+};
+
+struct rewrite_pattern {
+	enum rewrite_pattern_kind kind;
+	char *text;                   /* the name, number, IR kind or C code */
+	long number;
+	struct rewrite_pattern *operands[REWRITE_MAX_OPERANDS];
+	int operand_count;
+};
+
+struct rewrite_rule {
+	struct rewrite_pattern *left;
+	char *guard;                  /* NULL if there is none */
+	struct rewrite_pattern *right;
+	int line;
+};
+
+/* a name standing for several IR kinds */
+struct rewrite_class {
+	char *name;
+	char *kinds[REWRITE_MAX_CLASS_KINDS];
+	int kind_count;
+};
+
+/* the rules that can match an IR kind, in order */
+struct rewrite_kind {
+	char *name;
+	int arity;
+	bool is_commutative;
+	struct rewrite_rule *rules[REWRITE_MAX_RULES];
+	int rule_count;
+	bool is_emitted;
+};
+
+static const char *file_name;
+static char *source;
+static int position, line;
+static struct rewrite_token token;
+
+static struct rewrite_class classes[REWRITE_MAX_CLASSES];
+static int class_count;
+
+static struct rewrite_kind kinds[REWRITE_MAX_KINDS];
+static int kind_count;
+
+static FILE *output;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static void rewrite_error(int error_line, const char *format, ...) {
+	va_list arguments;
+
+	fprintf(stderr, "%s:%d: ", file_name, error_line);
+	va_start(arguments, format);
+	vfprintf(stderr, format, arguments);
+	va_end(arguments);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+static char *rewrite_copy_text(const char *start, int length) {
+	char *text = malloc(length + 1);
+	assert(NULL != text);
+	memcpy(text, start, length);
+	text[length] = '\0';
+	return text;
+}
+
+static bool rewrite_is_word_character(char character) {
+	return isalnum((unsigned char)character) || '_' == character;
+}
+
+/* the C code mentions the name as an identifier of its own */
+static bool rewrite_code_uses(const char *code, const char *name) {
+	int length = strlen(name);
+	for (const char *iter = strstr(code, name); NULL != iter; iter = strstr(iter + 1, name)) {
+		bool is_start = iter == code || !rewrite_is_word_character(iter[-1]);
+		if (is_start && !rewrite_is_word_character(iter[length])) return true;
+	}
+	return false;
+}
+
+/*********
+ * LEXER *
+ *********/
+
+static void rewrite_next(void) {
+	for (;;) {
+		while (isspace((unsigned char)source[position])) {
+			if ('\n' == source[position]) line++;
+			position++;
+		}
+		if ('#' != source[position]) break;
+		while ('\0' != source[position] && '\n' != source[position]) position++;
+	}
+
+	char *start = &source[position];
+	token.line = line;
+	token.text = NULL;
+
+	if ('\0' == *start) {
+		token.kind = TOKEN_END;
+	} else if ('(' == *start || ')' == *start) {
+		token.kind = '(' == *start ? TOKEN_OPEN : TOKEN_CLOSE;
+		position++;
+	} else if ('-' == start[0] && '>' == start[1]) {
+		token.kind = TOKEN_ARROW;
+		position += 2;
+	} else if ('{' == *start) {
+		/* C code, up to the matching brace */
+		int depth = 0;
+		do {
+			if ('\0' == source[position]) rewrite_error(token.line, "unterminated {");
+			if ('\n' == source[position]) line++;
+			if ('{' == source[position]) depth++;
+			if ('}' == source[position]) depth--;
+			position++;
+		} while (depth > 0);
+		token.kind = TOKEN_CODE;
+		token.text = rewrite_copy_text(start + 1, &source[position] - start - 2);
+	} else if (rewrite_is_word_character(*start) || ('-' == start[0] && isdigit((unsigned char)start[1]))) {
+		position++;
+		while (rewrite_is_word_character(source[position])) position++;
+		token.kind = TOKEN_WORD;
+		token.text = rewrite_copy_text(start, &source[position] - start);
+	} else {
+		rewrite_error(line, "unexpected '%c'", *start);
+	}
+}
+
+static void rewrite_expect(enum rewrite_token_kind kind, const char *what) {
+	if (kind != token.kind) rewrite_error(token.line, "expected %s", what);
+	rewrite_next();
+}
+
+static char *rewrite_expect_word(const char *what) {
+	char *text = token.text;
+	rewrite_expect(TOKEN_WORD, what);
+	return text;
+}
+
+/**********
+ * PARSER *
+ **********/
+
+static bool rewrite_is_number(const char *text) {
+	if ('-' == *text) text++;
+	return isdigit((unsigned char)*text);
+}
+
+static bool rewrite_is_ir_kind(const char *text) {
+	return 0 == strncmp("IR_", text, 3);
+}
+
+static struct rewrite_pattern *rewrite_pattern(enum rewrite_pattern_kind kind, char *text) {
+	struct rewrite_pattern *pattern = calloc(1, sizeof(struct rewrite_pattern));
+	assert(NULL != pattern);
+	pattern->kind = kind;
+	pattern->text = text;
+	return pattern;
+}
+
+/* (const 0), (const c) or, in a result, (const {...}), after the "const" */
+static struct rewrite_pattern *rewrite_parse_constant(bool is_result) {
+	struct rewrite_pattern *pattern;
+
+	if (TOKEN_CODE == token.kind && is_result) {
+		pattern = rewrite_pattern(PATTERN_CONSTANT_CODE, token.text);
+		rewrite_next();
+	} else {
+		char *text = rewrite_expect_word("a number or a name");
+		if (rewrite_is_number(text)) {
+			pattern = rewrite_pattern(PATTERN_CONSTANT_NUMBER, text);
+			pattern->number = strtol(text, NULL, 0);
+		} else {
+			pattern = rewrite_pattern(PATTERN_CONSTANT_NAME, text);
+		}
+	}
+	rewrite_expect(TOKEN_CLOSE, ")");
+	return pattern;
+}
+
+/* an operand of the instruction a rule matches, or a result */
+static struct rewrite_pattern *rewrite_parse_operand(bool is_result) {
+	if (TOKEN_WORD == token.kind) {
+		struct rewrite_pattern *pattern = rewrite_pattern(PATTERN_NAME, token.text);
+		if (rewrite_is_number(token.text)) rewrite_error(token.line, "a number has to be a (const %s)", token.text);
+		rewrite_next();
+		return pattern;
+	}
+	if (TOKEN_CODE == token.kind && is_result) {
+		struct rewrite_pattern *pattern = rewrite_pattern(PATTERN_CODE, token.text);
+		rewrite_next();
+		return pattern;
+	}
+
+	int open_line = token.line;
+	rewrite_expect(TOKEN_OPEN, "an operand");
+	char *head = rewrite_expect_word("const or an IR kind");
+	if (0 == strcmp("const", head)) return rewrite_parse_constant(is_result);
+
+	if (!is_result) rewrite_error(open_line, "the identity pass sees one instruction at a time, (%s ...) can't be matched", head);
+	if (!rewrite_is_ir_kind(head)) rewrite_error(open_line, "a result has to name an IR kind, not %s", head);
+
+	struct rewrite_pattern *pattern = rewrite_pattern(PATTERN_INSTRUCTION, head);
+	while (TOKEN_CLOSE != token.kind) {
+		if (REWRITE_MAX_OPERANDS == pattern->operand_count) rewrite_error(open_line, "too many operands");
+		struct rewrite_pattern *operand = rewrite_parse_operand(true);
+		if (PATTERN_CODE == operand->kind) rewrite_error(open_line, "an operand can't be {...}, use (const {...})");
+		pattern->operands[pattern->operand_count++] = operand;
+	}
+	rewrite_next();
+	if (0 == pattern->operand_count) rewrite_error(open_line, "%s needs an operand", head);
+	return pattern;
+}
+
+static struct rewrite_class *rewrite_find_class(const char *name) {
+	for (int i = 0; i < class_count; i++) {
+		if (0 == strcmp(classes[i].name, name)) return &classes[i];
+	}
+	return NULL;
+}
+
+static struct rewrite_kind *rewrite_find_kind(char *name, int kind_line) {
+	for (int i = 0; i < kind_count; i++) {
+		if (0 == strcmp(kinds[i].name, name)) return &kinds[i];
+	}
+	if (!rewrite_is_ir_kind(name)) rewrite_error(kind_line, "%s is neither an IR kind nor declared with kinds", name);
+	if (REWRITE_MAX_KINDS == kind_count) rewrite_error(kind_line, "too many IR kinds");
+
+	struct rewrite_kind *kind = &kinds[kind_count++];
+	kind->name = name;
+	kind->arity = -1;
+	return kind;
+}
+
+/* (kinds NAME KIND...) */
+static void rewrite_parse_kinds(void) {
+	int kinds_line = token.line;
+	char *name = rewrite_expect_word("a name");
+
+	if (rewrite_is_ir_kind(name) || NULL != rewrite_find_class(name)) rewrite_error(kinds_line, "%s is already taken", name);
+	if (REWRITE_MAX_CLASSES == class_count) rewrite_error(kinds_line, "too many kinds");
+
+	struct rewrite_class *class = &classes[class_count++];
+	class->name = name;
+	while (TOKEN_CLOSE != token.kind) {
+		char *kind = rewrite_expect_word("an IR kind");
+		if (!rewrite_is_ir_kind(kind)) rewrite_error(kinds_line, "%s isn't an IR kind", kind);
+		if (REWRITE_MAX_CLASS_KINDS == class->kind_count) rewrite_error(kinds_line, "too many IR kinds in %s", name);
+		class->kinds[class->kind_count++] = kind;
+	}
+	rewrite_next();
+}
+
+/* (commutative NAME-or-KIND...) */
+static void rewrite_parse_commutative(void) {
+	while (TOKEN_CLOSE != token.kind) {
+		int name_line = token.line;
+		char *name = rewrite_expect_word("a kind");
+		struct rewrite_class *class = rewrite_find_class(name);
+
+		if (NULL == class) {
+			rewrite_find_kind(name, name_line)->is_commutative = true;
+		} else {
+			for (int i = 0; i < class->kind_count; i++) rewrite_find_kind(class->kinds[i], name_line)->is_commutative = true;
+		}
+	}
+	rewrite_next();
+}
+
+/* what a rule needs of an operand, whatever the names */
+static bool rewrite_is_same_shape(struct rewrite_pattern *pattern_1, struct rewrite_pattern *pattern_2) {
+	if (PATTERN_CONSTANT_NUMBER == pattern_1->kind && PATTERN_CONSTANT_NUMBER == pattern_2->kind) {
+		return pattern_1->number == pattern_2->number;
+	}
+	return pattern_1->kind == pattern_2->kind;
+}
+
+static void rewrite_add_rule(struct rewrite_kind *kind, struct rewrite_rule *rule) {
+	int arity = rule->left->operand_count;
+
+	if (-1 != kind->arity && arity != kind->arity) {
+		rewrite_error(rule->line, "%s had %d operands in an earlier rule", kind->name, kind->arity);
+	}
+	if (REWRITE_MAX_RULES == kind->rule_count) rewrite_error(rule->line, "too many rules for %s", kind->name);
+	kind->arity = arity;
+	kind->rules[kind->rule_count++] = rule;
+}
+
+/* the names a result or guard refers to have to be bound by the instruction */
+static void rewrite_check_names(struct rewrite_rule *rule, struct rewrite_pattern *pattern) {
+	if (PATTERN_NAME != pattern->kind && PATTERN_CONSTANT_NAME != pattern->kind) {
+		for (int i = 0; i < pattern->operand_count; i++) rewrite_check_names(rule, pattern->operands[i]);
+		return;
+	}
+
+	for (int i = 0; i < rule->left->operand_count; i++) {
+		struct rewrite_pattern *operand = rule->left->operands[i];
+		if (operand->kind == pattern->kind && 0 == strcmp(operand->text, pattern->text)) return;
+	}
+	rewrite_error(rule->line, "%s isn't bound to %s by %s", pattern->text,
+		PATTERN_NAME == pattern->kind ? "an operand" : "a constant", rule->left->text);
+}
+
+/* PATTERN [if {C}] -> RESULT */
+static void rewrite_parse_rule(char *head, int rule_line) {
+	struct rewrite_rule *rule = calloc(1, sizeof(struct rewrite_rule));
+	assert(NULL != rule);
+	rule->line = rule_line;
+	rule->left = rewrite_pattern(PATTERN_INSTRUCTION, head);
+
+	while (TOKEN_CLOSE != token.kind) {
+		if (REWRITE_MAX_OPERANDS == rule->left->operand_count) rewrite_error(rule_line, "too many operands");
+		rule->left->operands[rule->left->operand_count++] = rewrite_parse_operand(false);
+	}
+	rewrite_next();
+	if (0 == rule->left->operand_count) rewrite_error(rule_line, "%s needs an operand", head);
+
+	/* a name twice is the same temporary, which can't be a constant once and any temporary the other time */
+	for (int i = 0; i < rule->left->operand_count; i++) {
+		for (int j = 0; j < i; j++) {
+			struct rewrite_pattern *operand_1 = rule->left->operands[j], *operand_2 = rule->left->operands[i];
+			if (PATTERN_CONSTANT_NUMBER == operand_1->kind || PATTERN_CONSTANT_NUMBER == operand_2->kind) continue;
+			if (0 == strcmp(operand_1->text, operand_2->text) && operand_1->kind != operand_2->kind) {
+				rewrite_error(rule_line, "%s is bound to an operand and a constant", operand_1->text);
+			}
+		}
+	}
+
+	if (TOKEN_WORD == token.kind && 0 == strcmp("if", token.text)) {
+		rewrite_next();
+		if (TOKEN_CODE != token.kind) rewrite_error(token.line, "expected {...} after if");
+		rule->guard = token.text;
+		rewrite_next();
+	}
+	rewrite_expect(TOKEN_ARROW, "->");
+	rule->right = rewrite_parse_operand(true);
+	rewrite_check_names(rule, rule->right);
+
+	/* the same rule with the operands the other way around, for the kinds that are commutative */
+	struct rewrite_rule *mirror = NULL;
+	struct rewrite_pattern **operands = rule->left->operands;
+	if (2 == rule->left->operand_count && !rewrite_is_same_shape(operands[0], operands[1])) {
+		mirror = malloc(sizeof(struct rewrite_rule));
+		assert(NULL != mirror);
+		*mirror = *rule;
+		mirror->left = rewrite_pattern(PATTERN_INSTRUCTION, head);
+		mirror->left->operand_count = 2;
+		mirror->left->operands[0] = operands[1];
+		mirror->left->operands[1] = operands[0];
+	}
+
+	struct rewrite_class *class = rewrite_find_class(head);
+	int member_count = NULL == class ? 1 : class->kind_count;
+	for (int i = 0; i < member_count; i++) {
+		struct rewrite_kind *kind = rewrite_find_kind(NULL == class ? head : class->kinds[i], rule_line);
+		rewrite_add_rule(kind, rule);
+		if (kind->is_commutative && NULL != mirror) rewrite_add_rule(kind, mirror);
+	}
+}
+
+static void rewrite_parse(void) {
+	line = 1;
+	position = 0;
+	rewrite_next();
+
+	while (TOKEN_END != token.kind) {
+		int item_line = token.line;
+		rewrite_expect(TOKEN_OPEN, "(");
+		char *head = rewrite_expect_word("kinds, commutative or an IR kind");
+
+		if (0 == strcmp("kinds", head)) {
+			rewrite_parse_kinds();
+		} else if (0 == strcmp("commutative", head)) {
+			rewrite_parse_commutative();
+		} else {
+			rewrite_parse_rule(head, item_line);
+		}
+	}
+}
+
+/***********
+ * PRINTER *
+ ***********/
+
+static void rewrite_print_pattern(struct rewrite_pattern *pattern) {
+	switch (pattern->kind) {
+		case PATTERN_NAME:
+			fprintf(output, "%s", pattern->text);
+			break;
+		case PATTERN_CONSTANT_NAME:
+		case PATTERN_CONSTANT_NUMBER:
+			fprintf(output, "(const %s)", pattern->text);
+			break;
+		case PATTERN_CONSTANT_CODE:
+			fprintf(output, "(const {%s})", pattern->text);
+			break;
+		case PATTERN_CODE:
+			fprintf(output, "{%s}", pattern->text);
+			break;
+		case PATTERN_INSTRUCTION:
+			fprintf(output, "(%s", pattern->text);
+			for (int i = 0; i < pattern->operand_count; i++) {
+				fprintf(output, " ");
+				rewrite_print_pattern(pattern->operands[i]);
+			}
+			fprintf(output, ")");
+			break;
+	}
+}
+
+static void rewrite_indent(int depth) {
+	for (int i = 0; i < depth; i++) fprintf(output, "\t");
+}
+
+/***********
+ * EMITTER *
+ ***********/
+
+static bool rewrite_pattern_uses(struct rewrite_pattern *pattern, const char *name) {
+	switch (pattern->kind) {
+		case PATTERN_NAME:
+		case PATTERN_CONSTANT_NAME:
+			return 0 == strcmp(pattern->text, name);
+		case PATTERN_CONSTANT_CODE:
+		case PATTERN_CODE:
+			return rewrite_code_uses(pattern->text, name);
+		case PATTERN_INSTRUCTION:
+			for (int i = 0; i < pattern->operand_count; i++) {
+				if (rewrite_pattern_uses(pattern->operands[i], name)) return true;
+			}
+			return false;
+		default:
+			return false;
+	}
+}
+
+static bool rewrite_rule_uses(struct rewrite_rule *rule, const char *name) {
+	return (NULL != rule->guard && rewrite_code_uses(rule->guard, name)) || rewrite_pattern_uses(rule->right, name);
+}
+
+/* the C expression for an operand of a new instruction */
+static void rewrite_emit_operand(struct rewrite_pattern *pattern) {
+	switch (pattern->kind) {
+		case PATTERN_NAME:
+			fprintf(output, "&%s", pattern->text);
+			break;
+		case PATTERN_CONSTANT_NAME:
+		case PATTERN_CONSTANT_NUMBER:
+			fprintf(output, "ir_expand_constant(node, %s)", pattern->text);
+			break;
+		case PATTERN_CONSTANT_CODE:
+			fprintf(output, "ir_expand_constant(node, %s)", pattern->text);
+			break;
+		case PATTERN_INSTRUCTION:
+			fprintf(output, "ir_expand_step(node, false, %s, ", pattern->text);
+			rewrite_emit_operand(pattern->operands[0]);
+			fprintf(output, ", ");
+			if (2 == pattern->operand_count) {
+				rewrite_emit_operand(pattern->operands[1]);
+			} else {
+				fprintf(output, "NULL");
+			}
+			fprintf(output, ")");
+			break;
+		default:
+			assert(0);
+			break;
+	}
+}
+
+/* the statements that turn the instruction into the result */
+static void rewrite_emit_result(struct rewrite_pattern *right, int depth) {
+	rewrite_indent(depth);
+	switch (right->kind) {
+		case PATTERN_NAME:
+			fprintf(output, "ir_rewrite_copy(instruction, &%s);\n", right->text);
+			break;
+		case PATTERN_CONSTANT_NAME:
+		case PATTERN_CONSTANT_NUMBER:
+			fprintf(output, "ir_rewrite_constant(instruction, %s);\n", right->text);
+			break;
+		case PATTERN_CONSTANT_CODE:
+			fprintf(output, "ir_rewrite_constant(instruction, %s);\n", right->text);
+			break;
+		case PATTERN_INSTRUCTION:
+			fprintf(output, "ir_expand_step(node, true, %s, ", right->text);
+			rewrite_emit_operand(right->operands[0]);
+			fprintf(output, ", ");
+			if (2 == right->operand_count) {
+				rewrite_emit_operand(right->operands[1]);
+			} else {
+				fprintf(output, "NULL");
+			}
+			fprintf(output, ");\n");
+			break;
+		case PATTERN_CODE:
+			fprintf(output, "if (%s) return true;\n", right->text);
+			return;
+	}
+	rewrite_indent(depth);
+	fprintf(output, "return true;\n");
+}
+
+/* true if the rule always rewrites the instruction once the tree gets to it, which the rules after it never do */
+static bool rewrite_emit_rule(struct rewrite_rule *rule, int depth) {
+	struct rewrite_pattern **operands = rule->left->operands;
+	int arity = rule->left->operand_count;
+	bool is_first_test = true;
+
+	rewrite_indent(depth);
+	fprintf(output, "/* ");
+	rewrite_print_pattern(rule->left);
+	if (NULL != rule->guard) fprintf(output, " if {%s}", rule->guard);
+	fprintf(output, " -> ");
+	rewrite_print_pattern(rule->right);
+	fprintf(output, " */\n");
+
+	/* the tests that need nothing bound: given constants and names used twice */
+	rewrite_indent(depth);
+	for (int i = 0; i < arity; i++) {
+		const char *test = NULL;
+		char buffer[256];
+
+		if (PATTERN_CONSTANT_NUMBER == operands[i]->kind) {
+			snprintf(buffer, sizeof(buffer), "%s%s == ir_constant_value(constant_%d)",
+				operands[i]->number < 0 ? "(uint32_t)" : "", operands[i]->text, i + 1);
+			test = buffer;
+		}
+		for (int j = 0; j < i && NULL == test; j++) {
+			if (PATTERN_CONSTANT_NUMBER == operands[j]->kind || 0 != strcmp(operands[j]->text, operands[i]->text)) continue;
+			if (PATTERN_NAME == operands[i]->kind) {
+				snprintf(buffer, sizeof(buffer), "instruction->operands[%d].data.temporary == instruction->operands[%d].data.temporary", j + 1, i + 1);
+			} else {
+				snprintf(buffer, sizeof(buffer), "ir_constant_value(constant_%d) == ir_constant_value(constant_%d)", j + 1, i + 1);
+			}
+			test = buffer;
+		}
+
+		if (NULL == test) continue;
+		fprintf(output, "%s%s", is_first_test ? "if (" : " && ", test);
+		is_first_test = false;
+	}
+	fprintf(output, "%s{\n", is_first_test ? "" : ") ");
+	depth++;
+
+	/* the names the guard and the result use, once each */
+	for (int i = 0; i < arity; i++) {
+		bool is_bound = PATTERN_CONSTANT_NUMBER == operands[i]->kind || !rewrite_rule_uses(rule, operands[i]->text);
+		for (int j = 0; j < i && !is_bound; j++) is_bound = 0 == strcmp(operands[j]->text, operands[i]->text);
+		if (is_bound) continue;
+
+		rewrite_indent(depth);
+		if (PATTERN_NAME == operands[i]->kind) {
+			fprintf(output, "struct ir_operand %s = instruction->operands[%d];\n", operands[i]->text, i + 1);
+		} else {
+			fprintf(output, "uint32_t %s = ir_constant_value(constant_%d);\n", operands[i]->text, i + 1);
+		}
+	}
+
+	if (NULL != rule->guard) {
+		rewrite_indent(depth);
+		fprintf(output, "if (%s) {\n", rule->guard);
+		rewrite_emit_result(rule->right, depth + 1);
+		rewrite_indent(depth);
+		fprintf(output, "}\n");
+	} else {
+		rewrite_emit_result(rule->right, depth);
+	}
+
+	rewrite_indent(depth - 1);
+	fprintf(output, "}\n");
+	return is_first_test && NULL == rule->guard && PATTERN_CODE != rule->right->kind;
+}
+
+/* splits the rules on whether operand i is a constant, the rules for an operand that may be anything go both ways */
+static void rewrite_emit_tree(struct rewrite_rule **rules, int rule_count, int arity, int operand, int depth) {
+	if (0 == rule_count) return;
+
+	if (operand == arity) {
+		for (int i = 0; i < rule_count && !rewrite_emit_rule(rules[i], depth); i++);
+		return;
+	}
+
+	bool is_split = false;
+	for (int i = 0; i < rule_count; i++) is_split |= PATTERN_NAME != rules[i]->left->operands[operand]->kind;
+	if (!is_split) {
+		rewrite_emit_tree(rules, rule_count, arity, operand + 1, depth);
+		return;
+	}
+
+	struct rewrite_rule *constant_rules[REWRITE_MAX_RULES], *other_rules[REWRITE_MAX_RULES];
+	int constant_count = 0, other_count = 0;
+	for (int i = 0; i < rule_count; i++) {
+		constant_rules[constant_count++] = rules[i];
+		if (PATTERN_NAME == rules[i]->left->operands[operand]->kind) other_rules[other_count++] = rules[i];
+	}
+
+	rewrite_indent(depth);
+	fprintf(output, "if (NULL != constant_%d) {\n", operand + 1);
+	rewrite_emit_tree(constant_rules, constant_count, arity, operand + 1, depth + 1);
+	rewrite_indent(depth);
+	if (0 == other_count) {
+		fprintf(output, "}\n");
+		return;
+	}
+	fprintf(output, "} else {\n");
+	rewrite_emit_tree(other_rules, other_count, arity, operand + 1, depth + 1);
+	rewrite_indent(depth);
+	fprintf(output, "}\n");
+}
+
+static bool rewrite_is_same_rules(struct rewrite_kind *kind_1, struct rewrite_kind *kind_2) {
+	if (kind_1->rule_count != kind_2->rule_count) return false;
+	for (int i = 0; i < kind_1->rule_count; i++) {
+		if (kind_1->rules[i] != kind_2->rules[i]) return false;
+	}
+	return true;
+}
+
+static void rewrite_emit(void) {
+	fprintf(output,
+		"/*\n"
+		" * Generated by rewrite-generator from %s, do not edit.\n"
+		" */\n"
+		"\n"
+		"static bool ir_rewrite_by_rules(struct ir_list *node) {\n"
+		"\tstruct ir_instruction *instruction = node->data;\n"
+		"\n"
+		"\tswitch (instruction->kind) {\n",
+		file_name
+	);
+
+	for (int i = 0; i < kind_count; i++) {
+		struct rewrite_kind *kind = &kinds[i];
+		if (kind->is_emitted || 0 == kind->rule_count) continue;
+
+		/* kinds with the same rules share the code */
+		int last = i;
+		for (int j = i + 1; j < kind_count; j++) {
+			if (!kinds[j].is_emitted && rewrite_is_same_rules(kind, &kinds[j])) last = j;
+		}
+		for (int j = i; j <= last; j++) {
+			if (kinds[j].is_emitted || !rewrite_is_same_rules(kind, &kinds[j])) continue;
+			fprintf(output, "\t\tcase %s:%s\n", kinds[j].name, j == last ? " {" : "");
+			kinds[j].is_emitted = true;
+		}
+
+		bool is_declared = false;
+		for (int operand = 0; operand < kind->arity; operand++) {
+			bool is_constant_tested = false;
+			for (int r = 0; r < kind->rule_count; r++) {
+				is_constant_tested |= PATTERN_NAME != kind->rules[r]->left->operands[operand]->kind;
+			}
+			if (!is_constant_tested) continue;
+			fprintf(output, "\t\t\tconst char *constant_%d = ir_get_const_map_entry(instruction->operands[%d].data.temporary);\n",
+				operand + 1, operand + 1);
+			is_declared = true;
+		}
+		if (is_declared) fprintf(output, "\n");
+
+		rewrite_emit_tree(kind->rules, kind->rule_count, kind->arity, 0, 3);
+		fprintf(output, "\t\t\treturn false;\n\t\t}\n");
+	}
+
+	fprintf(output,
+		"\t\tdefault:\n"
+		"\t\t\treturn false;\n"
+		"\t}\n"
+		"}\n"
+	);
+}
+
+int main(int argc, char **argv) {
+	if (3 != argc) {
+		fprintf(stderr, "usage: %s <rules> <output>\n", argv[0]);
+		return 1;
+	}
+	file_name = argv[1];
+
+	FILE *input = fopen(file_name, "r");
+	if (NULL == input) {
+		perror(file_name);
+		return 1;
+	}
+	fseek(input, 0, SEEK_END);
+	long size = ftell(input);
+	fseek(input, 0, SEEK_SET);
+	source = malloc(size + 1);
+	assert(NULL != source);
+	source[fread(source, 1, size, input)] = '\0';
+	fclose(input);
+
+	rewrite_parse();
+
+	output = fopen(argv[2], "w");
+	if (NULL == output) {
+		perror(argv[2]);
+		return 1;
+	}
+	rewrite_emit();
+	fclose(output);
+	return 0;
+}
@@ -0,0 +1,467 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "ssa.h"
+#include "dataflow.h"
+#include "constant-propagation.h"
+#include "sccp.h"
+
+/***********
+ * LATTICE *
+ ***********/
+
+enum sccp_state {
+	SCCP_UNKNOWN,         /* no executable definition seen yet */
+	SCCP_CONSTANT,
+	SCCP_VARYING
+};
+
+struct sccp_value {
+	enum sccp_state state;
+	uint32_t constant;
+};
+
+/* an instruction and the block it is in */
+struct sccp_site {
+	struct ir_list *node;
+	struct cfg_block *block;
+};
+
+/* an edge of the cfg */
+struct sccp_edge {
+	struct cfg_block *from, *to;
+};
+
+static int max_temporary;
+static struct sccp_value *values;
+static struct sccp_site *definitions;           /* temporary -> its definition */
+
+/* temporary -> the instructions reading it, use_sites[use_offsets[t] .. use_offsets[t + 1]) */
+static int *use_offsets;
+static struct sccp_site *use_sites;
+
+static bool *executable_blocks;
+static bool **executable_edges;                 /* block id -> predecessor index -> executable */
+
+static struct sccp_edge *edge_worklist;
+static int edge_worklist_size, edge_worklist_capacity;
+static struct sccp_site *site_worklist;
+static int site_worklist_size, site_worklist_capacity;
+
+static bool sccp_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static struct sccp_value sccp_operand_value(struct ir_operand *operand) {
+	struct sccp_value varying = { SCCP_VARYING, 0 };
+	if (!sccp_is_temporary(operand)) return varying;
+	return values[operand->data.temporary];
+}
+
+static struct sccp_value sccp_meet(struct sccp_value left, struct sccp_value right) {
+	struct sccp_value varying = { SCCP_VARYING, 0 };
+
+	if (SCCP_UNKNOWN == left.state) return right;
+	if (SCCP_UNKNOWN == right.state) return left;
+	if (SCCP_VARYING == left.state || SCCP_VARYING == right.state) return varying;
+	return left.constant == right.constant ? left : varying;
+}
+
+/***************
+ * DEF-USE MAP *
+ ***************/
+
+static void sccp_build_sites(struct cfg *cfg) {
+	struct ir_list *iter;
+
+	max_temporary = dataflow_max_temporary(cfg);
+	values = calloc(max_temporary + 1, sizeof(struct sccp_value));
+	definitions = calloc(max_temporary + 1, sizeof(struct sccp_site));
+	use_offsets = calloc(max_temporary + 2, sizeof(int));
+	assert(NULL != values && NULL != definitions && NULL != use_offsets);
+
+	/* count the uses of every temporary, phi arguments included */
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		for (iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *definition = ir_definition_operand(instruction);
+
+			if (NULL != definition && sccp_is_temporary(definition)) {
+				definitions[definition->data.temporary].node = iter;
+				definitions[definition->data.temporary].block = block;
+			}
+			for (int i = 0; i < ir_use_count(instruction); i++) {
+				struct ir_operand *use = ir_use_operand(instruction, i);
+				if (sccp_is_temporary(use)) use_offsets[use->data.temporary + 1]++;
+			}
+			if (iter == block->last) break;
+		}
+	}
+
+	for (int t = 0; t < max_temporary + 1; t++) use_offsets[t + 1] += use_offsets[t];
+	use_sites = malloc(sizeof(struct sccp_site) * (use_offsets[max_temporary + 1] + 1));
+	int *filled = calloc(max_temporary + 1, sizeof(int));
+	assert(NULL != use_sites && NULL != filled);
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		for (iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			for (int i = 0; i < ir_use_count(instruction); i++) {
+				struct ir_operand *use = ir_use_operand(instruction, i);
+				if (!sccp_is_temporary(use)) continue;
+
+				int temporary = use->data.temporary;
+				struct sccp_site *site = &use_sites[use_offsets[temporary] + filled[temporary]++];
+				site->node = iter;
+				site->block = block;
+			}
+			if (iter == block->last) break;
+		}
+	}
+	free(filled);
+
+	/* a temporary nothing in the function defines can hold anything */
+	for (int t = 0; t <= max_temporary; t++) {
+		if (NULL == definitions[t].node) values[t].state = SCCP_VARYING;
+	}
+}
+
+/*************
+ * WORKLISTS *
+ *************/
+
+/* an edge already executable has nothing left to do, so it is not queued again */
+static void sccp_push_edge(struct cfg_block *from, struct cfg_block *to) {
+	int predecessor = cfg_predecessor_index(to, from);
+	assert(predecessor >= 0);
+	if (executable_edges[to->id][predecessor]) return;
+
+	if (edge_worklist_size == edge_worklist_capacity) {
+		edge_worklist_capacity = 0 == edge_worklist_capacity ? 64 : edge_worklist_capacity * 2;
+		edge_worklist = realloc(edge_worklist, sizeof(struct sccp_edge) * edge_worklist_capacity);
+		assert(NULL != edge_worklist);
+	}
+	edge_worklist[edge_worklist_size].from = from;
+	edge_worklist[edge_worklist_size].to = to;
+	edge_worklist_size++;
+}
+
+static void sccp_push_site(struct sccp_site *site) {
+	if (site_worklist_size == site_worklist_capacity) {
+		site_worklist_capacity = 0 == site_worklist_capacity ? 64 : site_worklist_capacity * 2;
+		site_worklist = realloc(site_worklist, sizeof(struct sccp_site) * site_worklist_capacity);
+		assert(NULL != site_worklist);
+	}
+	site_worklist[site_worklist_size++] = *site;
+}
+
+/* lowers the value of a temporary and revisits its uses if it changed */
+static void sccp_lower(int temporary, struct sccp_value value) {
+	struct sccp_value old = values[temporary];
+
+	value = sccp_meet(old, value);
+	if (value.state == old.state && value.constant == old.constant) return;
+
+	values[temporary] = value;
+	for (int u = use_offsets[temporary]; u < use_offsets[temporary + 1]; u++) {
+		sccp_push_site(&use_sites[u]);
+	}
+}
+
+/**************
+ * EVALUATION *
+ **************/
+
+static bool sccp_is_conditional(struct ir_instruction *instruction) {
+	return IR_GOTO_IF_FALSE == instruction->kind || IR_GOTO_IF_TRUE == instruction->kind;
+}
+
+static bool sccp_is_taken_successor(struct cfg_block *block, struct cfg_block *successor) {
+	struct ir_instruction *label = successor->first->data;
+	return IR_LABEL == label->kind && 0 == strcmp(ir_branch_target(block->last->data), label->operands[0].data.name);
+}
+
+/* queues the successor edges the end of the block can take */
+static void sccp_visit_terminator(struct cfg_block *block, bool force) {
+	struct ir_instruction *instruction = block->last->data;
+
+	if (!sccp_is_conditional(instruction)) {
+		for (int s = 0; s < block->successor_count; s++) {
+			sccp_push_edge(block, block->successors[s]);
+		}
+		return;
+	}
+
+	bool taken = false, not_taken = false;
+	struct sccp_value condition = sccp_operand_value(&instruction->operands[0]);
+
+	if (SCCP_CONSTANT == condition.state) {
+		taken = IR_GOTO_IF_FALSE == instruction->kind ? 0 == condition.constant : 0 != condition.constant;
+		not_taken = !taken;
+	} else if (SCCP_VARYING == condition.state || force) {
+		taken = true;
+		not_taken = true;
+	}
+
+	for (int s = 0; s < block->successor_count; s++) {
+		struct cfg_block *successor = block->successors[s];
+		if (
+			(taken && sccp_is_taken_successor(block, successor)) ||
+			(not_taken && cfg_falls_through(block, successor))
+		) {
+			sccp_push_edge(block, successor);
+		}
+	}
+}
+
+/* the meet of the arguments coming in over executable edges */
+static struct sccp_value sccp_evaluate_phi(struct ir_instruction *instruction, struct cfg_block *block) {
+	struct sccp_value value = { SCCP_UNKNOWN, 0 };
+
+	for (int i = 0; i < instruction->phi_argument_count; i++) {
+		struct ir_operand *argument = &instruction->phi_arguments[i];
+
+		/* an undefined argument can be taken to be whatever the others are */
+		if (!executable_edges[block->id][i] || OPERAND_TEMPORARY != argument->kind) continue;
+		value = sccp_meet(value, sccp_operand_value(argument));
+	}
+	return value;
+}
+
+static struct sccp_value sccp_evaluate(struct ir_instruction *instruction) {
+	struct sccp_value value = { SCCP_VARYING, 0 };
+
+	switch (instruction->kind) {
+		case IR_CONST_INT:
+			value.state = SCCP_CONSTANT;
+			value.constant = (uint32_t)instruction->operands[1].data.number;
+			return value;
+		case IR_COPY:
+			return sccp_operand_value(&instruction->operands[1]);
+		default:
+			break;
+	}
+
+	int use_count = ir_use_count(instruction);
+	if (use_count < 1 || use_count > 2 || !dataflow_is_expression(instruction)) return value;
+
+	struct sccp_value left = sccp_operand_value(ir_use_operand(instruction, 0));
+	struct sccp_value right = left;
+	if (2 == use_count) right = sccp_operand_value(ir_use_operand(instruction, 1));
+
+	if (SCCP_VARYING == left.state || SCCP_VARYING == right.state) return value;
+	if (SCCP_UNKNOWN == left.state || SCCP_UNKNOWN == right.state) {
+		value.state = SCCP_UNKNOWN;
+		return value;
+	}
+
+	if (constant_propagation_fold(instruction->kind, left.constant, right.constant, &value.constant)) {
+		value.state = SCCP_CONSTANT;
+	}
+	return value;
+}
+
+static void sccp_visit(struct ir_list *node, struct cfg_block *block) {
+	struct ir_instruction *instruction = node->data;
+	struct ir_operand *definition = ir_definition_operand(instruction);
+
+	if (!executable_blocks[block->id]) return;
+
+	if (node == block->last && sccp_is_conditional(instruction)) {
+		sccp_visit_terminator(block, false);
+		return;
+	}
+	if (NULL == definition || !sccp_is_temporary(definition)) return;
+
+	if (IR_PHI == instruction->kind) {
+		sccp_lower(definition->data.temporary, sccp_evaluate_phi(instruction, block));
+	} else {
+		sccp_lower(definition->data.temporary, sccp_evaluate(instruction));
+	}
+}
+
+static void sccp_visit_edge(struct cfg_block *from, struct cfg_block *to) {
+	int predecessor = cfg_predecessor_index(to, from);
+	assert(predecessor >= 0);
+
+	if (executable_edges[to->id][predecessor]) return;
+	executable_edges[to->id][predecessor] = true;
+
+	struct ir_list *iter;
+
+	/* a block already reached only has to redo its phis for the new edge */
+	if (executable_blocks[to->id]) {
+		for (iter = to->first; ; iter = iter->next) {
+			if (IR_PHI == iter->data->kind) sccp_visit(iter, to);
+			if (iter == to->last) break;
+		}
+		return;
+	}
+
+	executable_blocks[to->id] = true;
+	for (iter = to->first; ; iter = iter->next) {
+		sccp_visit(iter, to);
+		if (iter == to->last) break;
+	}
+	if (!sccp_is_conditional(to->last->data)) {
+		sccp_visit_terminator(to, false);
+	}
+}
+
+/*
+ * Runs both worklists dry. A branch whose condition never got a value (it
+ * only depends on undefined temporaries) is then taken to go both ways, and
+ * the propagation resumes until no such branch is left.
+ */
+static void sccp_propagate(struct cfg *cfg) {
+	struct cfg_block *entry = cfg->blocks[0];
+
+	executable_blocks[entry->id] = true;
+	for (struct ir_list *iter = entry->first; ; iter = iter->next) {
+		sccp_visit(iter, entry);
+		if (iter == entry->last) break;
+	}
+	if (!sccp_is_conditional(entry->last->data)) {
+		sccp_visit_terminator(entry, false);
+	}
+
+	bool forced = true;
+	while (forced) {
+		while (edge_worklist_size > 0 || site_worklist_size > 0) {
+			if (edge_worklist_size > 0) {
+				struct sccp_edge edge = edge_worklist[--edge_worklist_size];
+				sccp_visit_edge(edge.from, edge.to);
+			} else {
+				struct sccp_site site = site_worklist[--site_worklist_size];
+				sccp_visit(site.node, site.block);
+			}
+		}
+
+		forced = false;
+		for (int b = 0; b < cfg->block_count; b++) {
+			struct cfg_block *block = cfg->blocks[b];
+			if (!executable_blocks[b] || !sccp_is_conditional(block->last->data)) continue;
+			if (SCCP_UNKNOWN != sccp_operand_value(&block->last->data->operands[0]).state) continue;
+
+			sccp_visit_terminator(block, true);
+			forced = forced || edge_worklist_size > 0;
+		}
+	}
+}
+
+/***********
+ * REWRITE *
+ ***********/
+
+/* constants move past the other phis of their block, phis have to stay together */
+static void sccp_rewrite_definition(struct ir_list *node, uint32_t constant) {
+	if (IR_PHI == node->data->kind) {
+		struct ir_list *last = node;
+		while (NULL != last->next && IR_PHI == last->next->data->kind) last = last->next;
+
+		if (last != node) {
+			ir_unlink(node);
+			node = ir_insert_after(last, node->data);
+		}
+	}
+	constant_propagation_rewrite(node, constant);
+}
+
+static void sccp_fold_branch(struct cfg_block *block) {
+	struct ir_instruction *instruction = block->last->data;
+	struct sccp_value condition = sccp_operand_value(&instruction->operands[0]);
+	if (SCCP_CONSTANT != condition.state) return;
+
+	bool taken = IR_GOTO_IF_FALSE == instruction->kind ? 0 == condition.constant : 0 != condition.constant;
+	if (taken) {
+		instruction->kind = IR_GOTO;
+		ir_operand_copy(instruction, 0, &instruction->operands[1]);
+	} else {
+		ir_unlink(block->last);
+	}
+}
+
+static void sccp_rewrite(struct cfg *cfg) {
+	struct ir_list *iter, *next;
+
+	for (int t = 0; t <= max_temporary; t++) {
+		if (SCCP_CONSTANT != values[t].state || !executable_blocks[definitions[t].block->id]) continue;
+		sccp_rewrite_definition(definitions[t].node, values[t].constant);
+	}
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+
+		if (executable_blocks[b]) {
+			/* arguments coming in over edges that are never taken are dead */
+			for (iter = block->first; ; iter = iter->next) {
+				struct ir_instruction *instruction = iter->data;
+				if (IR_PHI == instruction->kind) {
+					for (int i = 0; i < instruction->phi_argument_count; i++) {
+						if (!executable_edges[b][i]) memset(&instruction->phi_arguments[i], 0, sizeof(struct ir_operand));
+					}
+				}
+				if (iter == block->last) break;
+			}
+			if (sccp_is_conditional(block->last->data)) sccp_fold_branch(block);
+			continue;
+		}
+
+		/* the procEnd stays, it may be all that's left of an unreachable exit block */
+		for (iter = block->first; ; iter = next) {
+			bool is_last = iter == block->last;
+			next = iter->next;
+			if (IR_PROC_END != iter->data->kind) ir_unlink(iter);
+			if (is_last) break;
+		}
+	}
+
+	ssa_rebuild_cfg(cfg);
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+void sccp(struct cfg *cfg) {
+	sccp_build_sites(cfg);
+
+	executable_blocks = calloc(cfg->block_count, sizeof(bool));
+	executable_edges = malloc(sizeof(bool *) * cfg->block_count);
+	assert(NULL != executable_blocks && NULL != executable_edges);
+	for (int b = 0; b < cfg->block_count; b++) {
+		executable_edges[b] = calloc(cfg->blocks[b]->predecessor_count + 1, sizeof(bool));
+		assert(NULL != executable_edges[b]);
+	}
+
+	sccp_propagate(cfg);
+	sccp_rewrite(cfg);
+
+	for (int b = 0; b < cfg->block_count; b++) free(executable_edges[b]);
+	free(executable_edges);
+	free(executable_blocks);
+	free(values);
+	free(definitions);
+	free(use_offsets);
+	free(use_sites);
+	free(edge_worklist);
+	free(site_worklist);
+	edge_worklist = NULL;
+	site_worklist = NULL;
+	edge_worklist_size = edge_worklist_capacity = 0;
+	site_worklist_size = site_worklist_capacity = 0;
+}
+
+void sccp_program(struct cfg *cfgs) {
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		sccp(cfg);
+	}
+}
@@ -0,0 +1,21 @@
+#ifndef _SCCP_H
+#define _SCCP_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Sparse conditional constant propagation over a function in SSA form.
+ * Temporaries start out unknown and blocks unreachable, and only the edges a
+ * branch can actually take are followed, so a value is constant when it is
+ * constant on every executable path. Afterwards constant definitions become
+ * constInts, branches on a constant condition become a goto or fall through,
+ * and the blocks that were never reached are deleted.
+ */
+void sccp(struct cfg *cfg);
+void sccp_program(struct cfg *cfgs);
+
+#endif
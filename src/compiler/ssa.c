@@ -0,0 +1,742 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "ssa.h"
+
+/*
+ * A phi placed by ssa_construct, together with the temporary it merges. The
+ * variable is kept on the side because the phi's own operand is renamed as
+ * soon as its block is visited.
+ */
+struct ssa_phi {
+	struct ir_list *node;
+	int variable;
+};
+
+struct ssa_block_phis {
+	struct ssa_phi *phis;
+	int count;
+	int capacity;
+};
+
+struct ssa_stack {
+	int *values;
+	int count;
+	int capacity;
+};
+
+/* per function construction state */
+struct ssa_state {
+	struct cfg *cfg;
+	int max_temporary;
+
+	bool *is_variable;                    /* indexed by temporary */
+	struct ssa_stack *stacks;             /* indexed by temporary */
+	struct ssa_block_phis *block_phis;    /* indexed by block id */
+
+	int *pushed;                          /* renaming log, popped per block */
+	int pushed_count;
+	int pushed_capacity;
+};
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool ssa_is_temporary(struct ir_operand *operand) {
+	return NULL != operand && OPERAND_TEMPORARY == operand->kind;
+}
+
+static int ssa_max_temporary(struct ir_list *from, struct ir_list *to) {
+	int max_temporary = 0;
+	struct ir_list *iter;
+
+	for (iter = from; NULL != iter; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		struct ir_operand *definition = ir_definition_operand(instruction);
+
+		if (ssa_is_temporary(definition) && definition->data.temporary > max_temporary) {
+			max_temporary = definition->data.temporary;
+		}
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (ssa_is_temporary(use) && use->data.temporary > max_temporary) {
+				max_temporary = use->data.temporary;
+			}
+		}
+		if (iter == to) break;
+	}
+	return max_temporary;
+}
+
+static struct ir_instruction *ssa_copy_instruction(struct ir_operand *destination, struct ir_operand *source) {
+	struct ir_instruction *instruction = ir_instruction(IR_COPY);
+	ir_operand_copy(instruction, 0, destination);
+	ir_operand_copy(instruction, 1, source);
+	return instruction;
+}
+
+/*
+ * The front end emits (phi, d, a, b) for && / || values and ternaries.
+ * Ternary arms already write their final register directly (the phi's
+ * arguments are never defined), the logical operators define a and b in
+ * their own arms. Either way the merge is turned into plain definitions of
+ * d in each arm, which renaming then reconnects with proper phis.
+ */
+static void ssa_lower_front_end_phis(struct ir_list *proc_begin, struct ir_list *proc_end) {
+	int max_temporary = ssa_max_temporary(proc_begin, proc_end);
+	struct ir_list **definitions = calloc(max_temporary + 1, sizeof(struct ir_list *));
+	assert(NULL != definitions);
+
+	struct ir_list *iter, *next;
+	for (iter = proc_begin; iter != proc_end; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (ssa_is_temporary(definition)) {
+			definitions[definition->data.temporary] = iter;
+		}
+	}
+
+	for (iter = proc_begin; iter != proc_end; iter = next) {
+		next = iter->next;
+		struct ir_instruction *instruction = iter->data;
+		if (IR_PHI != instruction->kind || NULL != instruction->phi_arguments) continue;
+
+		for (int i = 1; i <= 2; i++) {
+			struct ir_operand *argument = &instruction->operands[i];
+			if (!ssa_is_temporary(argument)) continue;
+
+			struct ir_list *definition = definitions[argument->data.temporary];
+			if (NULL == definition || definition->data == instruction) continue;
+
+			ir_insert_after(definition, ssa_copy_instruction(&instruction->operands[0], argument));
+		}
+		ir_unlink(iter);
+	}
+
+	free(definitions);
+}
+
+/****************
+ * CONSTRUCTION *
+ ****************/
+
+static void ssa_add_phi(struct ssa_state *state, struct cfg_block *block, int variable) {
+	struct ssa_block_phis *block_phis = &state->block_phis[block->id];
+
+	struct ir_instruction *phi = ir_instruction(IR_PHI);
+	phi->operands[0].kind = OPERAND_TEMPORARY;
+	phi->operands[0].data.temporary = variable;
+	phi->phi_argument_count = block->predecessor_count;
+	phi->phi_arguments = calloc(block->predecessor_count, sizeof(struct ir_operand));
+	assert(NULL != phi->phi_arguments);
+
+	/* phis go after the block's label, following any placed already */
+	struct ir_list *anchor = 0 == block_phis->count ? block->first : block_phis->phis[block_phis->count - 1].node;
+	struct ir_list *node = ir_insert_after(anchor, phi);
+	if (anchor == block->last) block->last = node;
+
+	if (block_phis->count == block_phis->capacity) {
+		block_phis->capacity = 0 == block_phis->capacity ? 4 : block_phis->capacity * 2;
+		block_phis->phis = realloc(block_phis->phis, sizeof(struct ssa_phi) * block_phis->capacity);
+		assert(NULL != block_phis->phis);
+	}
+	block_phis->phis[block_phis->count].node = node;
+	block_phis->phis[block_phis->count].variable = variable;
+	block_phis->count++;
+}
+
+/*
+ * Places pruned phis: a variable gets a phi in the iterated dominance
+ * frontier of its definitions, but only in blocks where it is live on entry.
+ */
+static void ssa_place_phis(struct ssa_state *state) {
+	struct cfg *cfg = state->cfg;
+	int temporaries = state->max_temporary + 1;
+
+	/* count definitions and find the blocks holding them */
+	int *definition_counts = calloc(temporaries, sizeof(int));
+	int *definition_stamps = malloc(sizeof(int) * temporaries);
+	int *use_stamps = malloc(sizeof(int) * temporaries);
+	assert(NULL != definition_counts && NULL != definition_stamps && NULL != use_stamps);
+
+	/* (temporary, block) pairs: definitions and upward exposed uses */
+	int pair_capacity = 64, definition_pair_count = 0, exposed_pair_count = 0;
+	int *definition_pairs = malloc(sizeof(int) * 2 * pair_capacity);
+	int exposed_capacity = 64;
+	int *exposed_pairs = malloc(sizeof(int) * 2 * exposed_capacity);
+	assert(NULL != definition_pairs && NULL != exposed_pairs);
+
+	for (int i = 0; i < temporaries; i++) {
+		definition_stamps[i] = -1;
+		use_stamps[i] = -1;
+	}
+
+	for (int b = 0; b < cfg->reachable_count; b++) {
+		struct cfg_block *block = cfg->reverse_postorder[b];
+		struct ir_list *iter;
+
+		for (iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+
+			for (int i = 0; i < ir_use_count(instruction); i++) {
+				struct ir_operand *use = ir_use_operand(instruction, i);
+				if (!ssa_is_temporary(use)) continue;
+
+				int temporary = use->data.temporary;
+				if (definition_stamps[temporary] == block->id || use_stamps[temporary] == block->id) continue;
+				use_stamps[temporary] = block->id;
+
+				if (exposed_pair_count == exposed_capacity) {
+					exposed_capacity *= 2;
+					exposed_pairs = realloc(exposed_pairs, sizeof(int) * 2 * exposed_capacity);
+					assert(NULL != exposed_pairs);
+				}
+				exposed_pairs[2 * exposed_pair_count] = temporary;
+				exposed_pairs[2 * exposed_pair_count + 1] = block->id;
+				exposed_pair_count++;
+			}
+
+			struct ir_operand *definition = ir_definition_operand(instruction);
+			if (ssa_is_temporary(definition)) {
+				int temporary = definition->data.temporary;
+				definition_counts[temporary]++;
+				if (definition_stamps[temporary] != block->id) {
+					definition_stamps[temporary] = block->id;
+
+					if (definition_pair_count == pair_capacity) {
+						pair_capacity *= 2;
+						definition_pairs = realloc(definition_pairs, sizeof(int) * 2 * pair_capacity);
+						assert(NULL != definition_pairs);
+					}
+					definition_pairs[2 * definition_pair_count] = temporary;
+					definition_pairs[2 * definition_pair_count + 1] = block->id;
+					definition_pair_count++;
+				}
+			}
+
+			if (iter == block->last) break;
+		}
+	}
+
+	/* only temporaries written more than once need phis and renaming */
+	for (int i = 0; i < temporaries; i++) {
+		state->is_variable[i] = definition_counts[i] > 1;
+	}
+
+	/* group the pairs by temporary */
+	int *definition_starts = calloc(temporaries + 1, sizeof(int));
+	int *exposed_starts = calloc(temporaries + 1, sizeof(int));
+	int *definition_blocks = malloc(sizeof(int) * (definition_pair_count + 1));
+	int *exposed_blocks = malloc(sizeof(int) * (exposed_pair_count + 1));
+	assert(NULL != definition_starts && NULL != exposed_starts);
+	assert(NULL != definition_blocks && NULL != exposed_blocks);
+
+	for (int i = 0; i < definition_pair_count; i++) definition_starts[definition_pairs[2 * i] + 1]++;
+	for (int i = 0; i < exposed_pair_count; i++) exposed_starts[exposed_pairs[2 * i] + 1]++;
+	for (int i = 0; i < temporaries; i++) {
+		definition_starts[i + 1] += definition_starts[i];
+		exposed_starts[i + 1] += exposed_starts[i];
+	}
+	int *fill = calloc(temporaries, sizeof(int));
+	assert(NULL != fill);
+	for (int i = 0; i < definition_pair_count; i++) {
+		int temporary = definition_pairs[2 * i];
+		definition_blocks[definition_starts[temporary] + fill[temporary]++] = definition_pairs[2 * i + 1];
+	}
+	memset(fill, 0, sizeof(int) * temporaries);
+	for (int i = 0; i < exposed_pair_count; i++) {
+		int temporary = exposed_pairs[2 * i];
+		exposed_blocks[exposed_starts[temporary] + fill[temporary]++] = exposed_pairs[2 * i + 1];
+	}
+
+	/* per block marks, stamped with the variable being processed */
+	int *defines = malloc(sizeof(int) * cfg->block_count);
+	int *live_in = malloc(sizeof(int) * cfg->block_count);
+	int *has_phi = malloc(sizeof(int) * cfg->block_count);
+	int *queued = malloc(sizeof(int) * cfg->block_count);
+	struct cfg_block **worklist = malloc(sizeof(struct cfg_block *) * (cfg->block_count + 1));
+	assert(NULL != defines && NULL != live_in && NULL != has_phi && NULL != queued && NULL != worklist);
+	for (int i = 0; i < cfg->block_count; i++) {
+		defines[i] = live_in[i] = has_phi[i] = queued[i] = -1;
+	}
+
+	for (int variable = 0; variable < temporaries; variable++) {
+		if (!state->is_variable[variable]) continue;
+
+		for (int i = definition_starts[variable]; i < definition_starts[variable + 1]; i++) {
+			defines[definition_blocks[i]] = variable;
+		}
+
+		/* live in: walk backwards from the upward exposed uses up to the definitions */
+		int top = 0;
+		for (int i = exposed_starts[variable]; i < exposed_starts[variable + 1]; i++) {
+			struct cfg_block *block = cfg->blocks[exposed_blocks[i]];
+			live_in[block->id] = variable;
+			worklist[top++] = block;
+		}
+		while (top > 0) {
+			struct cfg_block *block = worklist[--top];
+			for (int i = 0; i < block->predecessor_count; i++) {
+				struct cfg_block *predecessor = block->predecessors[i];
+				if (predecessor->reverse_postorder < 0) continue;
+				if (live_in[predecessor->id] == variable || defines[predecessor->id] == variable) continue;
+				live_in[predecessor->id] = variable;
+				worklist[top++] = predecessor;
+			}
+		}
+
+		/* iterated dominance frontier */
+		top = 0;
+		for (int i = definition_starts[variable]; i < definition_starts[variable + 1]; i++) {
+			struct cfg_block *block = cfg->blocks[definition_blocks[i]];
+			queued[block->id] = variable;
+			worklist[top++] = block;
+		}
+		while (top > 0) {
+			struct cfg_block *block = worklist[--top];
+			for (int i = 0; i < block->dominance_frontier_count; i++) {
+				struct cfg_block *frontier = block->dominance_frontier[i];
+				if (has_phi[frontier->id] == variable || live_in[frontier->id] != variable) continue;
+
+				ssa_add_phi(state, frontier, variable);
+				has_phi[frontier->id] = variable;
+				if (queued[frontier->id] != variable) {
+					queued[frontier->id] = variable;
+					worklist[top++] = frontier;
+				}
+			}
+		}
+	}
+
+	free(definition_counts);
+	free(definition_stamps);
+	free(use_stamps);
+	free(definition_pairs);
+	free(exposed_pairs);
+	free(definition_starts);
+	free(exposed_starts);
+	free(definition_blocks);
+	free(exposed_blocks);
+	free(fill);
+	free(defines);
+	free(live_in);
+	free(has_phi);
+	free(queued);
+	free(worklist);
+}
+
+static void ssa_push(struct ssa_state *state, int variable, int value) {
+	struct ssa_stack *stack = &state->stacks[variable];
+	if (stack->count == stack->capacity) {
+		stack->capacity = 0 == stack->capacity ? 4 : stack->capacity * 2;
+		stack->values = realloc(stack->values, sizeof(int) * stack->capacity);
+		assert(NULL != stack->values);
+	}
+	stack->values[stack->count++] = value;
+
+	if (state->pushed_count == state->pushed_capacity) {
+		state->pushed_capacity = 0 == state->pushed_capacity ? 64 : state->pushed_capacity * 2;
+		state->pushed = realloc(state->pushed, sizeof(int) * state->pushed_capacity);
+		assert(NULL != state->pushed);
+	}
+	state->pushed[state->pushed_count++] = variable;
+}
+
+/* gives the instruction's result a fresh temporary and makes it current */
+static void ssa_rename_definition(struct ssa_state *state, struct ir_instruction *instruction) {
+	struct ir_operand *definition = ir_definition_operand(instruction);
+	if (!ssa_is_temporary(definition)) return;
+
+	int variable = definition->data.temporary;
+	if (variable > state->max_temporary || !state->is_variable[variable]) return;
+
+	ir_operand_temporary(instruction, 0);
+	ssa_push(state, variable, definition->data.temporary);
+}
+
+static void ssa_rename_block(struct ssa_state *state, struct cfg_block *block) {
+	int pushed_mark = state->pushed_count;
+	struct ir_list *iter;
+
+	for (iter = block->first; ; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+
+		if (IR_PHI != instruction->kind) {
+			for (int i = 0; i < ir_use_count(instruction); i++) {
+				struct ir_operand *use = ir_use_operand(instruction, i);
+				if (!ssa_is_temporary(use)) continue;
+
+				int variable = use->data.temporary;
+				if (variable > state->max_temporary || !state->is_variable[variable]) continue;
+				if (0 == state->stacks[variable].count) continue;
+
+				use->data.temporary = state->stacks[variable].values[state->stacks[variable].count - 1];
+			}
+		}
+		ssa_rename_definition(state, instruction);
+
+		if (iter == block->last) break;
+	}
+
+	for (int i = 0; i < block->successor_count; i++) {
+		struct cfg_block *successor = block->successors[i];
+		struct ssa_block_phis *successor_phis = &state->block_phis[successor->id];
+		int index = cfg_predecessor_index(successor, block);
+
+		for (int j = 0; j < successor_phis->count; j++) {
+			struct ssa_stack *stack = &state->stacks[successor_phis->phis[j].variable];
+			if (0 == stack->count) continue;
+
+			struct ir_operand *argument = &successor_phis->phis[j].node->data->phi_arguments[index];
+			argument->kind = OPERAND_TEMPORARY;
+			argument->data.temporary = stack->values[stack->count - 1];
+		}
+	}
+
+	for (int i = 0; i < block->dominator_child_count; i++) {
+		ssa_rename_block(state, block->dominator_children[i]);
+	}
+
+	while (state->pushed_count > pushed_mark) {
+		state->stacks[state->pushed[--state->pushed_count]].count--;
+	}
+}
+
+/*
+ * Puts the function in pruned SSA form (Cytron et al. with liveness based
+ * pruning). Expects the front end phis to be lowered already, which
+ * ssa_construct_program takes care of.
+ */
+void ssa_construct(struct cfg *cfg) {
+	struct ssa_state state;
+	memset(&state, 0, sizeof(struct ssa_state));
+
+	state.cfg = cfg;
+	state.max_temporary = ssa_max_temporary(cfg->proc_begin, cfg->proc_end);
+	state.is_variable = calloc(state.max_temporary + 1, sizeof(bool));
+	state.stacks = calloc(state.max_temporary + 1, sizeof(struct ssa_stack));
+	state.block_phis = calloc(cfg->block_count, sizeof(struct ssa_block_phis));
+	assert(NULL != state.is_variable && NULL != state.stacks && NULL != state.block_phis);
+
+	cfg_compute_dominators(cfg);
+	cfg_compute_dominance_frontiers(cfg);
+
+	ssa_place_phis(&state);
+	ssa_rename_block(&state, cfg->blocks[0]);
+
+	for (int i = 0; i <= state.max_temporary; i++) {
+		free(state.stacks[i].values);
+	}
+	for (int i = 0; i < cfg->block_count; i++) {
+		free(state.block_phis[i].phis);
+	}
+	free(state.is_variable);
+	free(state.stacks);
+	free(state.block_phis);
+	free(state.pushed);
+}
+
+/***************
+ * DESTRUCTION *
+ ***************/
+
+/* where copies for the end of a block go: before its closing jump, if any */
+static struct ir_list *ssa_emit_copy(struct cfg_block *block, struct ir_instruction *copy) {
+	if (ir_is_branch(block->last->data)) {
+		return ir_insert_before(block->last, copy);
+	}
+	block->last = ir_insert_after(block->last, copy);
+	return block->last;
+}
+
+/*
+ * The copies on one edge happen in parallel. Copies whose destination no
+ * other pending copy reads go first; when only cycles are left, one
+ * destination is saved in a fresh temporary and its readers use that instead.
+ */
+static void ssa_sequentialize_copies(
+	struct cfg_block *block, struct ir_operand *destinations, struct ir_operand *sources, int count
+) {
+	bool *done = calloc(count, sizeof(bool));
+	assert(NULL != done);
+
+	int remaining = count;
+	while (remaining > 0) {
+		bool progress = false;
+
+		for (int i = 0; i < count; i++) {
+			if (done[i]) continue;
+
+			bool is_read = false;
+			for (int j = 0; j < count && !is_read; j++) {
+				is_read = !done[j] && j != i && sources[j].data.temporary == destinations[i].data.temporary;
+			}
+			if (is_read) continue;
+
+			ssa_emit_copy(block, ssa_copy_instruction(&destinations[i], &sources[i]));
+			done[i] = true;
+			remaining--;
+			progress = true;
+		}
+
+		if (!progress) {
+			/* break a cycle */
+			int i = 0;
+			while (done[i]) i++;
+
+			struct ir_instruction *save = ir_instruction(IR_COPY);
+			ir_operand_temporary(save, 0);
+			ir_operand_copy(save, 1, &destinations[i]);
+			ssa_emit_copy(block, save);
+
+			for (int j = 0; j < count; j++) {
+				if (!done[j] && sources[j].data.temporary == destinations[i].data.temporary) {
+					sources[j] = save->operands[0];
+				}
+			}
+		}
+	}
+
+	free(done);
+}
+
+/*
+ * Replaces the phis with copies at the end of the predecessors, splitting
+ * critical edges so that a copy never runs on a path that didn't come from
+ * its predecessor.
+ */
+void ssa_destruct(struct cfg *cfg) {
+	int block_count = cfg->block_count;
+
+	for (int b = 0; b < block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+
+		/* the phis follow the block's label */
+		struct ir_list *first_phi = block->first->next;
+		int phi_count = 0;
+		struct ir_list *iter;
+		for (iter = first_phi; NULL != iter && IR_PHI == iter->data->kind; iter = iter->next) {
+			phi_count++;
+		}
+		if (0 == phi_count) continue;
+
+		struct ir_operand *destinations = malloc(sizeof(struct ir_operand) * phi_count);
+		struct ir_operand *sources = malloc(sizeof(struct ir_operand) * phi_count);
+		assert(NULL != destinations && NULL != sources);
+
+		for (int p = 0; p < block->predecessor_count; p++) {
+			struct cfg_block *predecessor = block->predecessors[p];
+			if (predecessor->successor_count > 1) {
+				predecessor = cfg_split_edge(cfg, predecessor, block);
+			}
+
+			int count = 0;
+			int i = 0;
+			for (iter = first_phi; i < phi_count; iter = iter->next, i++) {
+				struct ir_instruction *phi = iter->data;
+				assert(phi->phi_argument_count == block->predecessor_count);
+
+				struct ir_operand *argument = &phi->phi_arguments[p];
+				if (!ssa_is_temporary(argument)) continue;
+				if (argument->data.temporary == phi->operands[0].data.temporary) continue;
+
+				destinations[count] = phi->operands[0];
+				sources[count] = *argument;
+				count++;
+			}
+			ssa_sequentialize_copies(predecessor, destinations, sources, count);
+		}
+
+		free(destinations);
+		free(sources);
+
+		for (int i = 0; i < phi_count; i++) {
+			struct ir_list *phi = first_phi;
+			first_phi = first_phi->next;
+			if (phi == block->last) block->last = phi->prev;
+			ir_unlink(phi);
+			free(phi->data->phi_arguments);
+			phi->data->phi_arguments = NULL;
+		}
+	}
+}
+
+/**************
+ * REBUILDING *
+ **************/
+
+/* open addressing from an ir_list node to the block it belongs to */
+struct ssa_block_table {
+	struct ir_list **nodes;
+	struct cfg_block **blocks;
+	int capacity;
+};
+
+static unsigned int ssa_hash_node(struct ir_list *node) {
+	return (unsigned int)((uintptr_t)node >> 4) * 2654435761u;
+}
+
+static void ssa_block_table_build(struct ssa_block_table *table, struct cfg *cfg) {
+	int node_count = 0;
+	struct ir_list *iter;
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		node_count++;
+		if (iter == cfg->proc_end) break;
+	}
+
+	table->capacity = 16;
+	while (table->capacity < node_count * 2) table->capacity *= 2;
+	table->nodes = calloc(table->capacity, sizeof(struct ir_list *));
+	table->blocks = calloc(table->capacity, sizeof(struct cfg_block *));
+	assert(NULL != table->nodes && NULL != table->blocks);
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		for (iter = block->first; ; iter = iter->next) {
+			unsigned int slot = ssa_hash_node(iter) & (table->capacity - 1);
+			while (NULL != table->nodes[slot]) slot = (slot + 1) & (table->capacity - 1);
+			table->nodes[slot] = iter;
+			table->blocks[slot] = block;
+			if (iter == block->last) break;
+		}
+	}
+}
+
+static struct cfg_block *ssa_block_table_get(struct ssa_block_table *table, struct ir_list *node) {
+	unsigned int slot = ssa_hash_node(node) & (table->capacity - 1);
+	while (NULL != table->nodes[slot]) {
+		if (table->nodes[slot] == node) return table->blocks[slot];
+		slot = (slot + 1) & (table->capacity - 1);
+	}
+	return NULL;
+}
+
+static bool ssa_is_linked(struct ir_list *node) {
+	return ir_get_ir_list() == node || NULL != node->prev;
+}
+
+/* a phi and the first node of the block each of its arguments came from */
+struct ssa_saved_phi {
+	struct ir_list *node;
+	struct ir_list **origins;
+};
+
+void ssa_rebuild_cfg(struct cfg *cfg) {
+	struct ssa_saved_phi *saved = NULL;
+	int saved_count = 0, saved_capacity = 0;
+
+	for (int b = 0; b < cfg->block_count; b++) {
+		struct cfg_block *block = cfg->blocks[b];
+		if (!ssa_is_linked(block->first)) continue;
+
+		struct ir_list *iter;
+		for (iter = block->first->next; NULL != iter && IR_PHI == iter->data->kind; iter = iter->next) {
+			struct ir_instruction *phi = iter->data;
+			assert(phi->phi_argument_count == block->predecessor_count);
+
+			if (saved_count == saved_capacity) {
+				saved_capacity = 0 == saved_capacity ? 16 : saved_capacity * 2;
+				saved = realloc(saved, sizeof(struct ssa_saved_phi) * saved_capacity);
+				assert(NULL != saved);
+			}
+			saved[saved_count].node = iter;
+			saved[saved_count].origins = malloc(sizeof(struct ir_list *) * (phi->phi_argument_count + 1));
+			assert(NULL != saved[saved_count].origins);
+			for (int p = 0; p < phi->phi_argument_count; p++) {
+				struct ir_list *origin = block->predecessors[p]->first;
+				saved[saved_count].origins[p] = ssa_is_linked(origin) ? origin : NULL;
+			}
+			saved_count++;
+		}
+	}
+
+	cfg_rebuild(cfg);
+
+	struct ssa_block_table table;
+	ssa_block_table_build(&table, cfg);
+
+	for (int i = 0; i < saved_count; i++) {
+		struct ir_instruction *phi = saved[i].node->data;
+		struct cfg_block *block = ssa_block_table_get(&table, saved[i].node);
+		assert(NULL != block);
+
+		struct ir_operand *arguments = calloc(block->predecessor_count + 1, sizeof(struct ir_operand));
+		assert(NULL != arguments);
+		for (int p = 0; p < block->predecessor_count; p++) {
+			for (int a = 0; a < phi->phi_argument_count; a++) {
+				/* undefined arguments stay undefined whichever edge they are lined up with */
+				if (NULL == saved[i].origins[a] || OPERAND_TEMPORARY != phi->phi_arguments[a].kind) continue;
+				if (ssa_block_table_get(&table, saved[i].origins[a]) != block->predecessors[p]) continue;
+
+				arguments[p] = phi->phi_arguments[a];
+				saved[i].origins[a] = NULL;
+				break;
+			}
+		}
+
+		free(phi->phi_arguments);
+		phi->phi_arguments = arguments;
+		phi->phi_argument_count = block->predecessor_count;
+		free(saved[i].origins);
+	}
+
+	free(saved);
+	free(table.nodes);
+	free(table.blocks);
+
+	cfg_compute_dominators(cfg);
+	cfg_compute_dominance_frontiers(cfg);
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+/*
+ * The MIPS backend has no notion of phis, so any optimization level lowers
+ * the front end's ones (at -O0 they are harmless: temporaries restart at
+ * every statement and the arms end up sharing registers).
+ */
+void ssa_lower_front_end_phis_program(void) {
+	struct ir_list *iter;
+
+	for (iter = ir_get_ir_list(); NULL != iter; iter = iter->next) {
+		if (IR_PROC_BEGIN != iter->data->kind) continue;
+
+		struct ir_list *proc_end = iter;
+		while (IR_PROC_END != proc_end->data->kind) proc_end = proc_end->next;
+
+		ssa_lower_front_end_phis(iter, proc_end);
+		iter = proc_end;
+	}
+}
+
+/*
+ * Builds the cfg of every function and puts them all in SSA form. The
+ * returned cfgs have to be handed back to ssa_destruct_program.
+ */
+struct cfg *ssa_construct_program(void) {
+	ssa_lower_front_end_phis_program();
+
+	struct cfg *cfgs = cfg_build_program();
+	struct cfg *cfg;
+	for (cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		ssa_construct(cfg);
+	}
+	return cfgs;
+}
+
+void ssa_destruct_program(struct cfg *cfgs) {
+	struct cfg *cfg;
+	for (cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		ssa_destruct(cfg);
+	}
+	cfg_destroy_program(cfgs);
+}
@@ -0,0 +1,32 @@
+#ifndef _SSA_H
+#define _SSA_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * SSA form lives directly in ir_list: every temporary has a single
+ * definition and IR_PHI instructions sit right after the label of a join
+ * block, with one phi argument per cfg predecessor (in predecessors order).
+ * A phi argument that isn't a temporary means the value is undefined on that
+ * edge. Passes that change the control flow while in SSA form must keep the
+ * cfg returned by ssa_construct_program up to date.
+ */
+void ssa_construct(struct cfg *cfg);
+void ssa_destruct(struct cfg *cfg);
+
+/*
+ * Rebuilds the cfg after passes removed branches or blocks, and lines the
+ * phi arguments up with the new predecessor lists. Arguments coming from
+ * blocks that are gone or no longer branch to the phi are dropped.
+ */
+void ssa_rebuild_cfg(struct cfg *cfg);
+
+void ssa_lower_front_end_phis_program(void);
+struct cfg *ssa_construct_program(void);
+void ssa_destruct_program(struct cfg *cfg);
+
+#endif
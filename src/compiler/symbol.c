@@ -121,6 +121,7 @@ static struct symbol *symbol_put(struct symbol_table *table, char name[], struct
 	symbol_list->symbol.is_function_defined = 0;
 	symbol_list->symbol.is_system_call = 0;
 	symbol_list->symbol.is_only_for_saving_type = 0;
+	symbol_list->symbol.is_referenced = 1;
 	symbol_list->symbol.arg_number = -1;
 
 	char level[IDENTIFIER_MAX];
@@ -232,6 +233,7 @@ struct string_symbol *create_node_for_string_table(char* string) {
 		char label[40] = "_StringLabel_";
 		strcat(label, id);
 		strncpy(symbol->id, label, 40);
+		symbol->is_referenced = 1;
 		/* Create a new node for the linked list and add it to the end */
     struct string_symbol_list *new_node = malloc(sizeof(struct string_symbol_list));
     new_node->string_symbol = *symbol;
@@ -1241,6 +1243,27 @@ struct symbol_table* symbol_get_procedure_table(char *procedure_name) {
 	return table;
 }
 
+/* the same variable under a new id, for code the inliner moves into another procedure */
+struct symbol *symbol_put_copy(struct symbol_table *table, struct symbol *symbol) {
+	struct symbol *copy = symbol_put(table, symbol->name, symbol->type_tree);
+	copy->is_used = symbol->is_used;
+	return copy;
+}
+
+/* an int local of the procedure for the code generator to spill a temporary to */
+struct symbol *symbol_put_spill(struct symbol_table *table) {
+	struct type_tree *type_tree = malloc(sizeof(struct type_tree));
+	assert(NULL != type_tree);
+	type_tree->identifier = NULL;
+	type_tree->type = type_basic(false, TYPE_BASIC_INT);
+	type_tree->type_kind = TYPE_BASIC;
+	type_tree->type_chain = NULL;
+
+	struct symbol *symbol = symbol_put(table, "spill", type_tree);
+	symbol->is_used = 1;
+	return symbol;
+}
+
 struct symbol* search_symbol_table_by_id(struct symbol_table *table, int variable_id) {
 	if (NULL == table) {
 		/* Variable does not exist */
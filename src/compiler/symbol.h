@@ -28,6 +28,7 @@ struct symbol {
   int is_system_call;
   int arg_number;                 // will be -1 for non-arguments
   int is_only_for_saving_type;    // we want to save types of function declaration arguments too
+  int is_referenced;              // cleared for globals nothing reachable from main uses
   struct result result;
   struct type_tree *type_tree;
 };
@@ -40,6 +41,7 @@ struct symbol_list {
 struct string_symbol {
   char string[STRING_MAX + 1];
   char id[40];
+  int is_referenced;              // cleared for literals nothing reachable from main uses
 };
 
 struct string_symbol_list {
@@ -115,6 +117,8 @@ void symbol_print_table_assignment_format(FILE *output);
 struct string_symbol_list* symbol_get_string_table();
 struct symbol_table* symbol_get_global_symbol_table();
 struct symbol_table* symbol_get_procedure_table(char *procedure_name);
+struct symbol *symbol_put_copy(struct symbol_table *table, struct symbol *symbol);
+struct symbol *symbol_put_spill(struct symbol_table *table);
 
 bool is_syscall(char *function_name);
 #endif /* _SYMBOL_H */
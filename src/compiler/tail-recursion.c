@@ -0,0 +1,249 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "symbol.h"
+#include "tail-recursion.h"
+
+extern int next_temporary;
+
+static struct ir_list *proc_begin, *proc_end;
+
+/***********
+ * HELPERS *
+ ***********/
+
+static bool tail_recursion_is_load(struct ir_instruction *instruction) {
+	return instruction->kind >= IR_LOAD_WORD && instruction->kind <= IR_LOAD_SIGNED_BYTE;
+}
+
+static bool tail_recursion_is_store(struct ir_instruction *instruction) {
+	return IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind;
+}
+
+static bool tail_recursion_is_result(struct ir_instruction *instruction) {
+	return IR_RESULT_WORD == instruction->kind ||
+		IR_RESULT_HALF_WORD == instruction->kind ||
+		IR_RESULT_BYTE == instruction->kind;
+}
+
+static bool tail_recursion_is_return(struct ir_instruction *instruction) {
+	return IR_RETURN_WORD == instruction->kind ||
+		IR_RETURN_HALF_WORD == instruction->kind ||
+		IR_RETURN_BYTE == instruction->kind;
+}
+
+/* an addressOf of a local or parameter */
+static bool tail_recursion_is_local(struct ir_instruction *address) {
+	return IR_ADDRESS_OF == address->kind && !address->operands[2].data.is_string && !address->operands[6].data.number;
+}
+
+static struct ir_instruction *tail_recursion_label(const char *name) {
+	struct ir_instruction *instruction = ir_instruction(IR_LABEL);
+	instruction->operands[0].kind = OPERAND_STRING;
+	strncpy(instruction->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+	return instruction;
+}
+
+static struct ir_instruction *tail_recursion_goto(const char *name) {
+	struct ir_instruction *instruction = ir_instruction(IR_GOTO);
+	instruction->operands[0].kind = OPERAND_STRING;
+	strncpy(instruction->operands[0].data.name, name, IDENTIFIER_MAX + 1);
+	return instruction;
+}
+
+/*********
+ * CALLS *
+ *********/
+
+/* whether the label right before procEnd, where every return goes, has this name */
+static bool tail_recursion_is_exit(const char *name) {
+	struct ir_instruction *label = proc_end->prev->data;
+	return IR_LABEL == label->kind && 0 == strcmp(label->operands[0].data.name, name);
+}
+
+/*
+ * A call is in tail position when all that follows is returning its result:
+ * result r, return r, goto exit (or just falling into the exit label).
+ * Returns the last of those instructions, NULL for any other call.
+ */
+static struct ir_list *tail_recursion_tail(struct ir_list *call) {
+	struct ir_list *iter = call->next;
+	struct ir_operand *result = NULL;
+
+	if (tail_recursion_is_result(iter->data)) {
+		result = &iter->data->operands[0];
+		iter = iter->next;
+	}
+	if (tail_recursion_is_return(iter->data)) {
+		if (NULL == result || !ir_operand_equals(result, &iter->data->operands[0])) return NULL;
+		iter = iter->next;
+	}
+
+	if (IR_GOTO == iter->data->kind && tail_recursion_is_exit(iter->data->operands[0].data.name)) return iter;
+	if (iter == proc_end->prev && IR_LABEL == iter->data->kind) return iter->prev;
+	return NULL;
+}
+
+/* the parameter instructions of the call by index, if it passes exactly count of them */
+static bool tail_recursion_find_parameters(struct ir_list *call, int count, struct ir_list **parameters) {
+	int expected = count - 1;
+
+	for (struct ir_list *iter = call->prev; expected >= 0; iter = iter->prev) {
+		struct ir_instruction *instruction = iter->data;
+
+		if (IR_CALL == instruction->kind || IR_SYS_CALL == instruction->kind || IR_PROC_BEGIN == instruction->kind) {
+			return false;
+		}
+		if (IR_PARAMETER != instruction->kind) continue;
+		if ((int)instruction->operands[0].data.number != expected) return false;
+
+		/* f(x = 3) passes the address it stored to, see mips_print_parameter */
+		struct ir_instruction *previous = iter->prev->data;
+		if (tail_recursion_is_store(previous) && ir_operand_equals(&previous->operands[0], &instruction->operands[1])) {
+			return false;
+		}
+		parameters[expected--] = iter;
+	}
+
+	return count > 0 || IR_PARAMETER != call->prev->data->kind;
+}
+
+/*
+ * Nothing but loads and stores use the address of a variable, so the next
+ * activation can't see this one's variables that the loop reuses.
+ */
+static bool tail_recursion_keeps_addresses(void) {
+	bool *addresses = calloc(next_temporary, sizeof(bool));
+	assert(NULL != addresses);
+
+	for (struct ir_list *iter = proc_begin; iter != proc_end; iter = iter->next) {
+		if (tail_recursion_is_local(iter->data) && OPERAND_TEMPORARY == iter->data->operands[0].kind) {
+			addresses[iter->data->operands[0].data.temporary] = true;
+		}
+	}
+
+	bool keeps = true;
+	for (struct ir_list *iter = proc_begin; iter != proc_end && keeps; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (OPERAND_TEMPORARY != use->kind || !addresses[use->data.temporary]) continue;
+
+			if (!(tail_recursion_is_load(instruction) && use == &instruction->operands[1]) &&
+				!(tail_recursion_is_store(instruction) && use == &instruction->operands[0])) {
+				keeps = false;
+			}
+		}
+	}
+
+	free(addresses);
+	return keeps;
+}
+
+/* an addressOf of the parameter, NULL if the function never reads or writes it */
+static struct ir_instruction *tail_recursion_parameter_address(int index) {
+	for (struct ir_list *iter = proc_begin; iter != proc_end; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+		if (tail_recursion_is_local(instruction) && index == (int)instruction->operands[5].data.number) {
+			return instruction;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * The arguments go into the parameters once all of them are computed, and
+ * the call, with whatever returned its result, becomes a jump to the top.
+ */
+static void tail_recursion_rewrite(
+	struct ir_list *call, struct ir_list *last, struct ir_list **parameters, int count, const char *entry
+) {
+	for (int p = 0; p < count; p++) {
+		struct ir_instruction *original = tail_recursion_parameter_address(p);
+
+		if (NULL != original) {
+			struct ir_instruction *address = ir_instruction(IR_ADDRESS_OF);
+			memcpy(address->operands, original->operands, sizeof(address->operands));
+			ir_operand_temporary(address, 0);
+			ir_insert_before(call, address);
+
+			int size = (int)address->operands[4].data.number;
+			struct ir_instruction *store = ir_instruction(
+				1 == size ? IR_STORE_BYTE : 2 == size ? IR_STORE_HALF_WORD : IR_STORE_WORD
+			);
+			ir_operand_copy(store, 0, &address->operands[0]);
+			ir_operand_copy(store, 1, &parameters[p]->data->operands[1]);
+			ir_insert_before(call, store);
+		}
+		ir_unlink(parameters[p]);
+	}
+
+	ir_insert_before(call, tail_recursion_goto(entry));
+
+	for (struct ir_list *iter = call, *next; ; iter = next) {
+		next = iter->next;
+		ir_unlink(iter);
+		if (iter == last) break;
+	}
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+static void tail_recursion_function(void) {
+	const char *name = proc_begin->data->operands[0].data.name;
+	struct symbol_table *table = symbol_get_procedure_table(proc_begin->data->operands[1].data.name);
+	assert(NULL != table);
+
+	int count = 0;
+	for (struct symbol_list *variable = table->variables; NULL != variable; variable = variable->next) {
+		if (variable->symbol.arg_number + 1 > count) count = variable->symbol.arg_number + 1;
+	}
+
+	if (!tail_recursion_keeps_addresses()) return;
+
+	struct ir_list **parameters = malloc(sizeof(struct ir_list *) * (count + 1));
+	assert(NULL != parameters);
+	char *entry = NULL;
+
+	for (struct ir_list *iter = proc_begin->next; iter != proc_end; ) {
+		struct ir_list *next = iter->next;
+
+		if (IR_CALL == iter->data->kind && 0 == strcmp(iter->data->operands[0].data.name, name)) {
+			struct ir_list *last = tail_recursion_tail(iter);
+
+			if (NULL != last && tail_recursion_find_parameters(iter, count, parameters)) {
+				/* the loop starts right after procBegin, below the prologue */
+				if (NULL == entry) {
+					entry = ir_create_label_name();
+					ir_insert_after(proc_begin, tail_recursion_label(entry));
+				}
+				next = last->next;
+				tail_recursion_rewrite(iter, last, parameters, count, entry);
+			}
+		}
+		iter = next;
+	}
+
+	free(parameters);
+	free(entry);
+}
+
+void tail_recursion_program(void) {
+	for (struct ir_list *iter = ir_get_ir_list(); NULL != iter; iter = iter->next) {
+		if (IR_PROC_BEGIN != iter->data->kind) continue;
+
+		proc_begin = iter;
+		for (proc_end = iter; IR_PROC_END != proc_end->data->kind; proc_end = proc_end->next);
+		tail_recursion_function();
+		iter = proc_end;
+	}
+}
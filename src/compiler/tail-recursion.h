@@ -0,0 +1,24 @@
+#ifndef _TAIL_RECURSION_H
+#define _TAIL_RECURSION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+
+/*
+ * Turns self tail calls into loops. A call of the function itself whose
+ * result (if any) is returned right away stores its arguments into the
+ * parameters, once they've all been computed, and jumps back to a label
+ * at the top of the body instead of taking a new frame.
+ *
+ * A function that lets the address of one of its variables escape (passes
+ * it on, stores it, ...) keeps its calls, since the next activation could
+ * reach the variables the loop overwrites. Tail calls of other functions
+ * are left to mips.c, which reuses the frame for them at -O 2.
+ *
+ * Works on ir_list outside SSA form.
+ */
+void tail_recursion_program(void);
+
+#endif
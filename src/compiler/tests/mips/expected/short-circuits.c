@@ -57,11 +57,11 @@ _GeneratedLabel_3:
 	la	$s1, 108($fp)
 	lw	$s2, 0($s1)
 
-	bgtz	$s2 _GeneratedLabel_4
+	bnez	$s2 _GeneratedLabel_4
 	la	$s3, 104($fp)
 	lw	$s4, 0($s3)
 
-	bgtz	$s4 _GeneratedLabel_4
+	bnez	$s4 _GeneratedLabel_4
 	li	$s5, 0
 
 	b _GeneratedLabel_5
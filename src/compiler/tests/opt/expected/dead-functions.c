@@ -0,0 +1,72 @@
+
+=============== IR OPTIMISED (globaldce) ==============
+(procBegin, main)
+(addressOf, r6, _Global_used_global)
+(constInt, r7, 4)
+(storeWord, r6, r7)
+(addressOf, r8, _Global_used_global)
+(loadWord, r9, r8)
+(parameter, 0, r9)
+(syscall, syscall_print_int)
+(resultWord, r10)
+(constInt, r11, 0)
+(returnWord, r11)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+_Global_used_global:	.word	0
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	la	$s0, _Global_used_global
+	li	$s1, 4
+	sw	$s1, 0($s0)
+	la	$s2, _Global_used_global
+	lw	$s0, 0($s2)
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
@@ -0,0 +1,124 @@
+
+=============== IR OPTIMISED (dce) ==============
+(procBegin, main)
+(addressOf, r1, i)
+(constInt, r2, 0)
+(storeWord, r1, r2)
+(label, _GeneratedLabel_2)
+(addressOf, r3, i)
+(constInt, r4, 3)
+(loadWord, r5, r3)
+(ltSignedWord, r6, r5, r4)
+(gotoIfFalse, r6, _GeneratedLabel_3)
+(addressOf, r7, i)
+(constInt, r8, 1)
+(loadWord, r9, r7)
+(eqWord, r10, r9, r8)
+(gotoIfFalse, r10, _GeneratedLabel_4)
+(addressOf, r11, i)
+(addressOf, r12, i)
+(constInt, r13, 2)
+(loadWord, r14, r12)
+(addSignedWord, r15, r14, r13)
+(storeWord, r11, r15)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_4)
+(addressOf, r16, i)
+(loadWord, r17, r16)
+(constInt, r18, 1)
+(addSignedWord, r19, r17, r18)
+(storeWord, r16, r19)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(addressOf, r20, i)
+(loadWord, r21, r20)
+(parameter, 0, r21)
+(syscall, syscall_print_int)
+(resultWord, r22)
+(constInt, r23, 0)
+(returnWord, r23)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -104
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 100($fp)
+	li	$s1, 0
+	sw	$s1, 0($s0)
+
+_GeneratedLabel_2:
+	la	$s0, 100($fp)
+	li	$s1, 3
+	lw	$s2, 0($s0)
+	slti	$s3, $s2, 3
+
+	beqz	$s3 _GeneratedLabel_3
+	la	$s0, 100($fp)
+	li	$s1, 1
+	lw	$s2, 0($s0)
+	seq	$s3, $s2, $s1
+
+	beqz	$s3 _GeneratedLabel_4
+	la	$s0, 100($fp)
+	la	$s1, 100($fp)
+	li	$s2, 2
+	lw	$s3, 0($s1)
+	addiu	$s4, $s3, 2
+	sw	$s4, 0($s0)
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_4:
+	la	$s0, 100($fp)
+	lw	$s1, 0($s0)
+	li	$s2, 1
+	addiu	$s3, $s1, 1
+	sw	$s3, 0($s0)
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_3:
+	la	$s0, 100($fp)
+	lw	$s1, 0($s0)
+
+	move	$a0, $s1
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+
+
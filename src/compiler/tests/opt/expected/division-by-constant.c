@@ -0,0 +1,194 @@
+
+=============== IR OPTIMISED (identity) ==============
+(procBegin, _Global_f)
+(loadWord, r3, r2)
+(storeWord, r1, r3)
+(loadWord, r6, r4)
+(constInt, r22, 9363)
+(multHighSignedWord, r23, r6, r22)
+(addUnsignedWord, r24, r23, r6)
+(constInt, r25, 2)
+(rightShiftSignedWord, r26, r24, r25)
+(constInt, r27, 31)
+(rightShiftUnsignedWord, r28, r26, r27)
+(addUnsignedWord, r7, r26, r28)
+(parameter, 0, r7)
+(syscall, syscall_print_int)
+(resultWord, r8)
+(loadWord, r11, r9)
+(constInt, r29, 26215)
+(multHighSignedWord, r30, r11, r29)
+(constInt, r31, 2)
+(rightShiftSignedWord, r32, r30, r31)
+(constInt, r33, 31)
+(rightShiftUnsignedWord, r34, r32, r33)
+(addUnsignedWord, r35, r32, r34)
+(constInt, r36, 2)
+(leftShiftWord, r37, r35, r36)
+(addUnsignedWord, r38, r37, r35)
+(addUnsignedWord, r39, r38, r38)
+(subUnsignedWord, r12, r11, r39)
+(parameter, 0, r12)
+(syscall, syscall_print_int)
+(resultWord, r13)
+(loadWord, r16, r14)
+(constInt, r40, 43691)
+(multHighUnsignedWord, r41, r16, r40)
+(constInt, r42, 1)
+(rightShiftUnsignedWord, r17, r41, r42)
+(parameter, 0, r17)
+(syscall, syscall_print_int)
+(resultWord, r18)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r20, 65436)
+(parameter, 0, r20)
+(call, _Global_f)
+(constInt, r21, 0)
+(returnWord, r21)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -104
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	lw	$s0, 0($fp)
+	sw	$s0, 100($fp)
+	lw	$s1, 0($fp)
+	li	$s0, 2454267027
+	mult	$s1, $s0
+	mfhi	$s2
+	addu	$s3, $s2, $s1
+	li	$s0, 2
+	sra	$s1, $s3, $s0
+	li	$s2, 31
+	srl	$s0, $s1, $s2
+	addu	$s3, $s1, $s0
+
+	move	$a0, $s3
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	lw	$s1, 0($fp)
+	li	$s0, 1717986919
+	mult	$s1, $s0
+	mfhi	$s2
+	li	$s3, 2
+	sra	$s0, $s2, $s3
+	li	$s4, 31
+	srl	$s2, $s0, $s4
+	addu	$s3, $s0, $s2
+	li	$s4, 2
+	sll	$s0, $s3, $s4
+	addu	$s2, $s0, $s3
+	addu	$s4, $s2, $s2
+	subu	$s0, $s1, $s4
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	lw	$s1, 100($fp)
+	li	$s0, 2863311531
+	multu	$s1, $s0
+	mfhi	$s2
+	li	$s3, 1
+	srl	$s0, $s2, $s3
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+
+_GeneratedLabel_1:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s1, 4294967196
+
+	move	$a0, $s1
+
+	jal	_Global_f
+	li	$s0, 0
+	move	$v0, $s0
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
+
+
@@ -0,0 +1,278 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, _Global_f)
+(addressOf, r32, b)
+(loadWord, r30, r32)
+(addressOf, r31, a)
+(loadWord, r28, r31)
+(copy, r4, r28)
+(copy, r5, r30)
+(neWord, r6, r4, r5)
+(copy, r29, r6)
+(copy, r8, r29)
+(gotoIfFalse, r8, _GeneratedLabel_2)
+(constInt, r11, 5)
+(copy, r12, r28)
+(addSignedWord, r13, r12, r11)
+(copy, r28, r13)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(copy, r16, r28)
+(copy, r17, r29)
+(addSignedWord, r18, r16, r17)
+(returnWord, r18)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r19, 3)
+(parameter, 0, r19)
+(constInt, r20, 4)
+(parameter, 1, r20)
+(call, _Global_f)
+(resultWord, r21)
+(parameter, 2, r21)
+(syscall, syscall_print_int)
+(resultWord, r22)
+(constInt, r23, 2)
+(parameter, 0, r23)
+(constInt, r24, 2)
+(parameter, 1, r24)
+(call, _Global_f)
+(resultWord, r25)
+(parameter, 2, r25)
+(syscall, syscall_print_int)
+(resultWord, r26)
+(constInt, r27, 0)
+(returnWord, r27)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+
+=============== IR OPTIMISED (constprop) ==============
+(procBegin, _Global_f)
+(addressOf, r32, b)
+(loadWord, r30, r32)
+(addressOf, r31, a)
+(loadWord, r33, r31)
+(copy, r4, r33)
+(copy, r5, r30)
+(neWord, r6, r33, r30)
+(copy, r29, r6)
+(copy, r8, r6)
+(gotoIfFalse, r6, _GeneratedLabel_2)
+(constInt, r11, 5)
+(copy, r12, r33)
+(addSignedWord, r13, r33, r11)
+(copy, r34, r13)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(phi, r35, r13, r33)
+(copy, r16, r35)
+(copy, r17, r6)
+(addSignedWord, r18, r35, r6)
+(returnWord, r18)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r19, 3)
+(parameter, 0, r19)
+(constInt, r20, 4)
+(parameter, 1, r20)
+(call, _Global_f)
+(resultWord, r21)
+(parameter, 2, r21)
+(syscall, syscall_print_int)
+(resultWord, r22)
+(constInt, r23, 2)
+(parameter, 0, r23)
+(constInt, r24, 2)
+(parameter, 1, r24)
+(call, _Global_f)
+(resultWord, r25)
+(parameter, 2, r25)
+(syscall, syscall_print_int)
+(resultWord, r26)
+(constInt, r27, 0)
+(returnWord, r27)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+
+=============== IR OPTIMISED (dce) ==============
+(procBegin, _Global_f)
+(addressOf, r32, b)
+(loadWord, r30, r32)
+(addressOf, r31, a)
+(loadWord, r33, r31)
+(neWord, r6, r33, r30)
+(gotoIfFalse, r6, _GeneratedLabel_2)
+(constInt, r11, 5)
+(addSignedWord, r13, r33, r11)
+(copy, r35, r13)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(copy, r35, r33)
+(label, _GeneratedLabel_3)
+(addSignedWord, r18, r35, r6)
+(returnWord, r18)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r19, 3)
+(parameter, 0, r19)
+(constInt, r20, 4)
+(parameter, 1, r20)
+(call, _Global_f)
+(resultWord, r21)
+(parameter, 2, r21)
+(syscall, syscall_print_int)
+(resultWord, r22)
+(constInt, r23, 2)
+(parameter, 0, r23)
+(constInt, r24, 2)
+(parameter, 1, r24)
+(call, _Global_f)
+(resultWord, r25)
+(parameter, 2, r25)
+(syscall, syscall_print_int)
+(resultWord, r26)
+(constInt, r27, 0)
+(returnWord, r27)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -112
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 8($fp)
+	lw	$s1, 0($s0)
+	la	$s2, 4($fp)
+	lw	$s0, 0($s2)
+	sne	$s3, $s0, $s1
+
+	beqz	$s3 _GeneratedLabel_2
+	li	$s1, 5
+	addiu	$s2, $s0, 5
+	move	$s4, $s2
+
+	b _GeneratedLabel_3
+
+_GeneratedLabel_2:
+	move	$s4, $s0
+
+_GeneratedLabel_3:
+	addu	$s0, $s4, $s3
+	move	$v0, $s0
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 3
+
+	move	$a0, $s0
+
+	li	$s1, 4
+
+	move	$a1, $s1
+
+	jal	_Global_f
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 2
+
+	move	$a0, $s1
+
+	li	$s0, 2
+
+	move	$a1, $s0
+
+	jal	_Global_f
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
+
+
+
+
+
+
@@ -0,0 +1,139 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, main)
+(constInt, r2, 5)
+(copy, r24, r2)
+(copy, r5, r24)
+(copy, r25, r5)
+(constInt, r7, 2)
+(copy, r8, r25)
+(gtSignedWord, r9, r8, r7)
+(gotoIfFalse, r9, _GeneratedLabel_2)
+(constInt, r12, 1)
+(copy, r13, r25)
+(addSignedWord, r14, r13, r12)
+(copy, r26, r14)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(constInt, r17, 1)
+(copy, r18, r24)
+(subSignedWord, r19, r18, r17)
+(copy, r26, r19)
+(label, _GeneratedLabel_3)
+(copy, r21, r26)
+(parameter, 0, r21)
+(syscall, syscall_print_int)
+(resultWord, r22)
+(constInt, r23, 0)
+(returnWord, r23)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+
+=============== IR OPTIMISED (constprop) ==============
+(procBegin, main)
+(constInt, r2, 5)
+(constInt, r24, 5)
+(constInt, r5, 5)
+(constInt, r25, 5)
+(constInt, r7, 2)
+(constInt, r8, 5)
+(constInt, r9, 1)
+(gotoIfFalse, r9, _GeneratedLabel_2)
+(constInt, r12, 1)
+(constInt, r13, 5)
+(constInt, r14, 6)
+(constInt, r28, 6)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(constInt, r17, 1)
+(constInt, r18, 5)
+(constInt, r19, 4)
+(constInt, r27, 4)
+(label, _GeneratedLabel_3)
+(phi, r29, r28, r27)
+(copy, r21, r29)
+(parameter, 0, r29)
+(syscall, syscall_print_int)
+(resultWord, r22)
+(constInt, r23, 0)
+(returnWord, r23)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -112
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	li	$s0, 5
+	li	$s1, 5
+	li	$s0, 5
+	li	$s1, 5
+	li	$s0, 2
+	li	$s1, 5
+	li	$s0, 1
+
+	beqz	$s0 _GeneratedLabel_2
+	li	$s1, 1
+	li	$s0, 5
+	li	$s1, 6
+	li	$s0, 6
+	move	$s1, $s0
+
+	b _GeneratedLabel_3
+
+_GeneratedLabel_2:
+	li	$s0, 1
+	li	$s2, 5
+	li	$s0, 4
+	li	$s2, 4
+	move	$s1, $s2
+
+_GeneratedLabel_3:
+	move	$s0, $s1
+
+	move	$a0, $s1
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+
+
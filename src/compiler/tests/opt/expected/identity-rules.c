@@ -0,0 +1,124 @@
+
+=============== IR OPTIMISED (identity) ==============
+(procBegin, _Global_f)
+(loadWord, r3, r1)
+(copy, r4, r3)
+(copy, r6, r4)
+(copy, r8, r6)
+(returnWord, r8)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r9, 9)
+(parameter, 0, r9)
+(call, _Global_f)
+(resultWord, r10)
+(copy, r12, r10)
+(parameter, 1, r12)
+(syscall, syscall_print_int)
+(resultWord, r13)
+(constInt, r14, 0)
+(returnWord, r14)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -104
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	lw	$s0, 4($fp)
+	move	$s1, $s0
+	move	$s0, $s1
+	move	$s1, $s0
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 9
+
+	move	$a0, $s0
+
+	jal	_Global_f
+	move	$s0, $v0
+	move	$s2, $s0
+
+	move	$a0, $s2
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
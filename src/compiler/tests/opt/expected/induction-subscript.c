@@ -0,0 +1,223 @@
+
+=============== IR OPTIMISED (iv) ==============
+(procBegin, main)
+(addressOf, r1, i)
+(constInt, r2, 0)
+(storeWord, r1, r2)
+(addressOf, r46, a)
+(addressOf, r48, i)
+(loadWord, r47, r48)
+(constInt, r49, 4)
+(multSignedWord, r50, r49, r47)
+(addSignedWord, r51, r46, r50)
+(label, _GeneratedLabel_2)
+(addressOf, r3, i)
+(constInt, r4, 8)
+(loadWord, r5, r3)
+(ltSignedWord, r6, r5, r4)
+(gotoIfFalse, r6, _GeneratedLabel_3)
+(addressOf, r7, a)
+(addressOf, r8, i)
+(loadWord, r9, r8)
+(constInt, r10, 4)
+(multSignedWord, r11, r10, r9)
+(copy, r12, r51)
+(addressOf, r13, i)
+(loadWord, r14, r13)
+(storeWord, r12, r14)
+(addressOf, r15, i)
+(loadWord, r16, r15)
+(constInt, r17, 1)
+(addSignedWord, r18, r16, r17)
+(storeWord, r15, r18)
+(constInt, r52, 4)
+(addSignedWord, r51, r51, r52)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(addressOf, r19, s)
+(constInt, r20, 0)
+(storeWord, r19, r20)
+(addressOf, r21, i)
+(constInt, r22, 0)
+(storeWord, r21, r22)
+(addressOf, r53, a)
+(addressOf, r55, i)
+(loadWord, r54, r55)
+(constInt, r56, 4)
+(multSignedWord, r57, r56, r54)
+(addSignedWord, r58, r53, r57)
+(constInt, r60, 8)
+(constInt, r61, 4)
+(multSignedWord, r62, r61, r60)
+(addSignedWord, r63, r53, r62)
+(label, _GeneratedLabel_4)
+(addressOf, r23, i)
+(constInt, r24, 8)
+(loadWord, r25, r23)
+(ltUnsignedWord, r26, r58, r63)
+(gotoIfFalse, r26, _GeneratedLabel_5)
+(addressOf, r27, s)
+(addressOf, r28, s)
+(addressOf, r29, a)
+(addressOf, r30, i)
+(loadWord, r31, r30)
+(constInt, r32, 4)
+(multSignedWord, r33, r32, r31)
+(copy, r34, r58)
+(loadWord, r35, r28)
+(loadWord, r36, r34)
+(addSignedWord, r37, r35, r36)
+(storeWord, r27, r37)
+(addressOf, r38, i)
+(loadWord, r39, r38)
+(constInt, r40, 1)
+(addSignedWord, r41, r39, r40)
+(constInt, r59, 4)
+(addSignedWord, r58, r58, r59)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_5)
+(addressOf, r42, s)
+(loadWord, r43, r42)
+(parameter, 0, r43)
+(syscall, syscall_print_int)
+(resultWord, r44)
+(constInt, r45, 0)
+(returnWord, r45)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -112
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 108($fp)
+	li	$s1, 0
+	sw	$s1, 0($s0)
+	la	$s2, 104($fp)
+	la	$s0, 108($fp)
+	lw	$s1, 0($s0)
+	li	$s3, 4
+	mul	$s0, $s3, $s1
+	addu	$s4, $s2, $s0
+
+_GeneratedLabel_2:
+	la	$s0, 108($fp)
+	li	$s1, 8
+	lw	$s2, 0($s0)
+	slti	$s3, $s2, 8
+
+	beqz	$s3 _GeneratedLabel_3
+	la	$s0, 104($fp)
+	la	$s1, 108($fp)
+	lw	$s0, 0($s1)
+	li	$s2, 4
+	mul	$s1, $s2, $s0
+	move	$s3, $s4
+	la	$s0, 108($fp)
+	lw	$s1, 0($s0)
+	sw	$s1, 0($s3)
+	la	$s0, 108($fp)
+	lw	$s1, 0($s0)
+	li	$s2, 1
+	addiu	$s3, $s1, 1
+	sw	$s3, 0($s0)
+	li	$s1, 4
+	addu	$s4, $s4, $s1
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_3:
+	la	$s0, 100($fp)
+	li	$s1, 0
+	sw	$s1, 0($s0)
+	la	$s2, 108($fp)
+	li	$s0, 0
+	sw	$s0, 0($s2)
+	la	$s1, 104($fp)
+	la	$s0, 108($fp)
+	lw	$s2, 0($s0)
+	li	$s3, 4
+	mul	$s0, $s3, $s2
+	addu	$s4, $s1, $s0
+	li	$s2, 8
+	li	$s0, 4
+	mul	$s3, $s0, $s2
+	addu	$s5, $s1, $s3
+
+_GeneratedLabel_4:
+	la	$s0, 108($fp)
+	li	$s1, 8
+	lw	$s2, 0($s0)
+	sltu	$s1, $s4, $s5
+
+	beqz	$s1 _GeneratedLabel_5
+	la	$s0, 100($fp)
+	la	$s1, 100($fp)
+	la	$s2, 104($fp)
+	la	$s3, 108($fp)
+	lw	$s2, 0($s3)
+	li	$s6, 4
+	mul	$s3, $s6, $s2
+	move	$s7, $s4
+	lw	$s2, 0($s1)
+	lw	$s3, 0($s7)
+	addu	$s1, $s2, $s3
+	sw	$s1, 0($s0)
+	la	$s2, 108($fp)
+	lw	$s0, 0($s2)
+	li	$s1, 1
+	addiu	$s2, $s0, 1
+	li	$s3, 4
+	addu	$s4, $s4, $s3
+
+	b _GeneratedLabel_4
+
+_GeneratedLabel_5:
+	la	$s0, 100($fp)
+	lw	$s1, 0($s0)
+
+	move	$a0, $s1
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+
+
@@ -0,0 +1,136 @@
+
+=============== IR OPTIMISED (inline) ==============
+(procBegin, _Global_square)
+(addressOf, r1, x)
+(addressOf, r2, x)
+(loadWord, r3, r1)
+(loadWord, r4, r2)
+(multSignedWord, r5, r3, r4)
+(returnWord, r5)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_square)
+(procBegin, main)
+(constInt, r6, 7)
+(addressOf, r15, x)
+(storeWord, r15, r6)
+(addressOf, r10, x)
+(addressOf, r11, x)
+(loadWord, r12, r10)
+(loadWord, r13, r11)
+(multSignedWord, r14, r12, r13)
+(copy, r7, r14)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_3)
+(parameter, 1, r7)
+(syscall, syscall_print_int)
+(resultWord, r8)
+(constInt, r9, 0)
+(returnWord, r9)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_square:
+	addiu	$sp, $sp, -104
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 4($fp)
+	la	$s1, 4($fp)
+	lw	$s2, 0($s0)
+	lw	$s3, 0($s1)
+	mul	$s0, $s2, $s3
+	move	$v0, $s0
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+main:
+	addiu	$sp, $sp, -104
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	li	$s0, 7
+	la	$s1, 100($fp)
+	sw	$s0, 0($s1)
+	la	$s2, 100($fp)
+	la	$s0, 100($fp)
+	lw	$s1, 0($s2)
+	lw	$s3, 0($s0)
+	mul	$s2, $s1, $s3
+	move	$s0, $s2
+
+	b _GeneratedLabel_3
+
+_GeneratedLabel_3:
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+
+
@@ -0,0 +1,163 @@
+
+=============== IR OPTIMISED (ipcp) ==============
+(procBegin, _Global_scale)
+(addressOf, r17, k)
+(constInt, r18, 5)
+(storeWord, r17, r18)
+(addressOf, r1, x)
+(addressOf, r2, k)
+(loadWord, r3, r1)
+(loadWord, r4, r2)
+(multSignedWord, r5, r3, r4)
+(returnWord, r5)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_scale)
+(procBegin, main)
+(constInt, r6, 2)
+(parameter, 0, r6)
+(constInt, r7, 5)
+(constInt, r8, 1)
+(call, _Global_scale)
+(resultWord, r9)
+(parameter, 3, r9)
+(syscall, syscall_print_int)
+(resultWord, r10)
+(constInt, r11, 3)
+(parameter, 0, r11)
+(constInt, r12, 5)
+(constInt, r13, 2)
+(call, _Global_scale)
+(resultWord, r14)
+(parameter, 3, r14)
+(syscall, syscall_print_int)
+(resultWord, r15)
+(constInt, r16, 0)
+(returnWord, r16)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_scale:
+	addiu	$sp, $sp, -112
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 108($fp)
+	li	$s1, 5
+	sw	$s1, 0($s0)
+	la	$s2, 4($fp)
+	la	$s0, 108($fp)
+	lw	$s1, 0($s2)
+	lw	$s3, 0($s0)
+	mul	$s2, $s1, $s3
+	move	$v0, $s2
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 2
+
+	move	$a0, $s0
+
+	li	$s1, 5
+	li	$s0, 1
+	jal	_Global_scale
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 3
+
+	move	$a0, $s1
+
+	li	$s0, 5
+	li	$s1, 2
+	jal	_Global_scale
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
+
+
@@ -0,0 +1,85 @@
+
+=============== IR OPTIMISED (lse) ==============
+(procBegin, main)
+(addressOf, r1, a)
+(constInt, r2, 1)
+(addressOf, r3, a)
+(constInt, r4, 2)
+(addressOf, r5, b)
+(addressOf, r6, a)
+(addressOf, r7, a)
+(copy, r8, r4)
+(copy, r9, r4)
+(addSignedWord, r10, r8, r9)
+(addressOf, r11, b)
+(copy, r12, r10)
+(parameter, 0, r12)
+(syscall, syscall_print_int)
+(resultWord, r13)
+(constInt, r14, 0)
+(returnWord, r14)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -104
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	la	$s0, 100($fp)
+	li	$s1, 1
+	la	$s0, 100($fp)
+	li	$s1, 2
+	la	$s0, 96($fp)
+	la	$s2, 100($fp)
+	la	$s0, 100($fp)
+	move	$s2, $s1
+	move	$s0, $s1
+	addu	$s3, $s2, $s0
+	la	$s1, 96($fp)
+	move	$s0, $s3
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+
+
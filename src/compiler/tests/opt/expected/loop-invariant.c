@@ -0,0 +1,248 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, _Global_f)
+(addressOf, r36, a)
+(loadWord, r34, r36)
+(addressOf, r35, n)
+(loadWord, r33, r35)
+(constInt, r2, 0)
+(copy, r32, r2)
+(constInt, r4, 0)
+(copy, r31, r4)
+(label, _GeneratedLabel_2)
+(copy, r7, r31)
+(copy, r8, r33)
+(ltSignedWord, r9, r7, r8)
+(gotoIfFalse, r9, _GeneratedLabel_3)
+(addressOf, r13, b)
+(copy, r14, r34)
+(loadWord, r15, r13)
+(multSignedWord, r16, r14, r15)
+(copy, r17, r32)
+(addSignedWord, r18, r17, r16)
+(copy, r32, r18)
+(copy, r20, r31)
+(constInt, r21, 1)
+(addSignedWord, r22, r20, r21)
+(copy, r31, r22)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(copy, r24, r32)
+(returnWord, r24)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r25, 2)
+(parameter, 0, r25)
+(constInt, r26, 3)
+(parameter, 1, r26)
+(constInt, r27, 4)
+(parameter, 2, r27)
+(call, _Global_f)
+(resultWord, r28)
+(parameter, 3, r28)
+(syscall, syscall_print_int)
+(resultWord, r29)
+(constInt, r30, 0)
+(returnWord, r30)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+
+=============== IR OPTIMISED (licm) ==============
+(procBegin, _Global_f)
+(addressOf, r36, a)
+(loadWord, r34, r36)
+(addressOf, r35, n)
+(loadWord, r33, r35)
+(constInt, r2, 0)
+(copy, r37, r2)
+(constInt, r4, 0)
+(copy, r38, r4)
+(copy, r8, r33)
+(addressOf, r13, b)
+(copy, r14, r34)
+(loadWord, r15, r13)
+(multSignedWord, r16, r14, r15)
+(label, _GeneratedLabel_2)
+(phi, r39, r38, r42)
+(phi, r40, r37, r41)
+(copy, r7, r39)
+(ltSignedWord, r9, r7, r8)
+(gotoIfFalse, r9, _GeneratedLabel_3)
+(label, _GeneratedLabel_5)
+(copy, r17, r40)
+(addSignedWord, r18, r17, r16)
+(copy, r41, r18)
+(copy, r20, r39)
+(constInt, r21, 1)
+(addSignedWord, r22, r20, r21)
+(copy, r42, r22)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(copy, r24, r40)
+(returnWord, r24)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r25, 2)
+(parameter, 0, r25)
+(constInt, r26, 3)
+(parameter, 1, r26)
+(constInt, r27, 4)
+(parameter, 2, r27)
+(call, _Global_f)
+(resultWord, r28)
+(parameter, 3, r28)
+(syscall, syscall_print_int)
+(resultWord, r29)
+(constInt, r30, 0)
+(returnWord, r30)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -120
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 4($fp)
+	lw	$s1, 0($s0)
+	la	$s2, 12($fp)
+	lw	$s0, 0($s2)
+	li	$s3, 0
+	move	$s2, $s3
+	li	$s4, 0
+	move	$s3, $s4
+	move	$s5, $s0
+	la	$s4, 8($fp)
+	move	$s0, $s1
+	lw	$s6, 0($s4)
+	mul	$s1, $s0, $s6
+	move	$s4, $s3
+	move	$s0, $s2
+
+_GeneratedLabel_2:
+	move	$s2, $s4
+	slt	$s3, $s2, $s5
+
+	beqz	$s3 _GeneratedLabel_3
+
+_GeneratedLabel_5:
+	move	$s2, $s0
+	addu	$s3, $s2, $s1
+	move	$s6, $s3
+	move	$s2, $s4
+	li	$s3, 1
+	addiu	$s7, $s2, 1
+	move	$t0, $s7
+	move	$s4, $t0
+	move	$s0, $s6
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_3:
+	move	$s1, $s0
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 120
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 2
+
+	move	$a0, $s0
+
+	li	$s1, 3
+
+	move	$a1, $s1
+
+	li	$s0, 4
+
+	move	$a2, $s0
+
+	jal	_Global_f
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_4
+
+_GeneratedLabel_4:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
+
+
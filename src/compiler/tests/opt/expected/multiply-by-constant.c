@@ -0,0 +1,163 @@
+
+=============== IR OPTIMISED (identity) ==============
+(procBegin, _Global_f)
+(loadWord, r3, r1)
+(constInt, r19, 2)
+(leftShiftWord, r20, r3, r19)
+(addUnsignedWord, r21, r20, r3)
+(addUnsignedWord, r4, r21, r21)
+(parameter, 0, r4)
+(syscall, syscall_print_int)
+(resultWord, r5)
+(loadWord, r8, r6)
+(constInt, r22, 4)
+(leftShiftWord, r23, r8, r22)
+(subUnsignedWord, r9, r23, r8)
+(parameter, 0, r9)
+(syscall, syscall_print_int)
+(resultWord, r10)
+(loadWord, r14, r11)
+(constInt, r24, 3)
+(leftShiftWord, r25, r14, r24)
+(addUnsignedWord, r26, r25, r14)
+(constInt, r27, 0)
+(subUnsignedWord, r15, r27, r26)
+(parameter, 0, r15)
+(syscall, syscall_print_int)
+(resultWord, r16)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r17, 3)
+(parameter, 0, r17)
+(call, _Global_f)
+(constInt, r18, 0)
+(returnWord, r18)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -104
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	lw	$s0, 4($fp)
+	li	$s1, 2
+	sll	$s2, $s0, $s1
+	addu	$s3, $s2, $s0
+	addu	$s1, $s3, $s3
+
+	move	$a0, $s1
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	lw	$s1, 4($fp)
+	li	$s0, 4
+	sll	$s2, $s1, $s0
+	subu	$s3, $s2, $s1
+
+	move	$a0, $s3
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	lw	$s0, 4($fp)
+	li	$s1, 3
+	sll	$s2, $s0, $s1
+	addu	$s3, $s2, $s0
+	li	$s1, 0
+	subu	$s0, $s1, $s3
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 3
+
+	move	$a0, $s0
+
+	jal	_Global_f
+	li	$s0, 0
+	move	$v0, $s0
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
+
+
@@ -0,0 +1,194 @@
+
+=============== IR OPTIMISED (pre) ==============
+(procBegin, _Global_f)
+(addressOf, r1, x)
+(constInt, r2, 0)
+(storeWord, r1, r2)
+(addressOf, r3, c)
+(loadWord, r4, r3)
+(gotoIfFalse, r4, _GeneratedLabel_2)
+(addressOf, r5, x)
+(addressOf, r6, a)
+(addressOf, r7, b)
+(loadWord, r8, r6)
+(loadWord, r9, r7)
+(addSignedWord, r10, r8, r9)
+(copy, r25, r10)
+(storeWord, r5, r10)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(addressOf, r27, a)
+(loadWord, r26, r27)
+(addressOf, r29, b)
+(loadWord, r28, r29)
+(addSignedWord, r25, r26, r28)
+(label, _GeneratedLabel_3)
+(addressOf, r11, x)
+(addressOf, r12, a)
+(addressOf, r13, b)
+(loadWord, r14, r12)
+(loadWord, r15, r13)
+(copy, r16, r25)
+(loadWord, r17, r11)
+(addSignedWord, r18, r17, r16)
+(returnWord, r18)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r19, 1)
+(parameter, 0, r19)
+(constInt, r20, 2)
+(parameter, 1, r20)
+(constInt, r21, 1)
+(parameter, 2, r21)
+(call, _Global_f)
+(resultWord, r22)
+(parameter, 3, r22)
+(syscall, syscall_print_int)
+(resultWord, r23)
+(constInt, r24, 0)
+(returnWord, r24)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -112
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	la	$s0, 108($fp)
+	li	$s1, 0
+	sw	$s1, 0($s0)
+	la	$s2, 8($fp)
+	lw	$s0, 0($s2)
+
+	beqz	$s0 _GeneratedLabel_2
+	la	$s1, 108($fp)
+	la	$s0, 0($fp)
+	la	$s2, 4($fp)
+	lw	$s3, 0($s0)
+	lw	$s4, 0($s2)
+	addu	$s0, $s3, $s4
+	move	$s2, $s0
+	sw	$s0, 0($s1)
+
+	b _GeneratedLabel_3
+
+_GeneratedLabel_2:
+	la	$s0, 0($fp)
+	lw	$s1, 0($s0)
+	la	$s3, 4($fp)
+	lw	$s0, 0($s3)
+	addu	$s2, $s1, $s0
+
+_GeneratedLabel_3:
+	la	$s0, 108($fp)
+	la	$s1, 0($fp)
+	la	$s3, 4($fp)
+	lw	$s4, 0($s1)
+	lw	$s5, 0($s3)
+	move	$s1, $s2
+	lw	$s3, 0($s0)
+	addu	$s2, $s3, $s1
+	move	$v0, $s2
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 1
+
+	move	$a0, $s0
+
+	li	$s1, 2
+
+	move	$a1, $s1
+
+	li	$s0, 1
+
+	move	$a2, $s0
+
+	jal	_Global_f
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_4
+
+_GeneratedLabel_4:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
+
+
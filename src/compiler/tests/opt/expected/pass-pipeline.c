@@ -0,0 +1,82 @@
+
+=============== IR OPTIMISED (identity) ==============
+(procBegin, main)
+(constInt, r4, 6)
+(storeWord, r1, r4)
+(loadWord, r8, r6)
+(copy, r9, r8)
+(storeWord, r5, r9)
+(loadWord, r11, r10)
+(parameter, 0, r11)
+(syscall, syscall_print_int)
+(resultWord, r12)
+(constInt, r13, 0)
+(returnWord, r13)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+
+=============== IR OPTIMISED (fixpoint) ==============
+(procBegin, main)
+(constInt, r4, 6)
+(storeWord, r1, r4)
+(constInt, r9, 6)
+(storeWord, r5, r9)
+(constInt, r11, 6)
+(parameter, 0, r11)
+(syscall, syscall_print_int)
+(resultWord, r12)
+(constInt, r13, 0)
+(returnWord, r13)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -104
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 6
+	sw	$s0, 100($fp)
+	li	$s1, 6
+	sw	$s1, 96($fp)
+	li	$s0, 6
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+
+
@@ -0,0 +1,173 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, _Global_f)
+(addressOf, r19, a)
+(loadWord, r18, r19)
+(constInt, r1, 1)
+(copy, r3, r18)
+(addSignedWord, r4, r1, r3)
+(constInt, r5, 2)
+(addSignedWord, r6, r4, r5)
+(constInt, r8, 3)
+(copy, r9, r18)
+(multSignedWord, r10, r9, r8)
+(constInt, r11, 4)
+(multSignedWord, r12, r10, r11)
+(addSignedWord, r13, r6, r12)
+(returnWord, r13)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r14, 5)
+(parameter, 0, r14)
+(call, _Global_f)
+(resultWord, r15)
+(parameter, 1, r15)
+(syscall, syscall_print_int)
+(resultWord, r16)
+(constInt, r17, 0)
+(returnWord, r17)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+
+=============== IR OPTIMISED (reassociate) ==============
+(procBegin, _Global_f)
+(addressOf, r19, a)
+(loadWord, r18, r19)
+(constInt, r1, 1)
+(copy, r3, r18)
+(constInt, r5, 2)
+(constInt, r8, 3)
+(copy, r9, r18)
+(constInt, r11, 4)
+(constInt, r20, 12)
+(multSignedWord, r12, r9, r20)
+(addUnsignedWord, r21, r3, r12)
+(constInt, r22, 3)
+(addUnsignedWord, r13, r21, r22)
+(returnWord, r13)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r14, 5)
+(parameter, 0, r14)
+(call, _Global_f)
+(resultWord, r15)
+(parameter, 1, r15)
+(syscall, syscall_print_int)
+(resultWord, r16)
+(constInt, r17, 0)
+(returnWord, r17)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -104
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 4($fp)
+	lw	$s1, 0($s0)
+	li	$s2, 1
+	move	$s0, $s1
+	li	$s2, 2
+	li	$s3, 3
+	move	$s2, $s1
+	li	$s3, 4
+	li	$s1, 12
+	mul	$s3, $s2, $s1
+	addu	$s4, $s0, $s3
+	li	$s1, 3
+	addu	$s0, $s4, $s1
+	move	$v0, $s0
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 5
+
+	move	$a0, $s0
+
+	jal	_Global_f
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
@@ -0,0 +1,141 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, _Global_bump)
+(addressOf, r21, p)
+(loadWord, r20, r21)
+(copy, r2, r20)
+(copy, r4, r20)
+(constInt, r5, 1)
+(loadWord, r6, r4)
+(addSignedWord, r7, r6, r5)
+(storeWord, r2, r7)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_bump)
+(procBegin, main)
+(constInt, r9, 4)
+(copy, r22, r9)
+(addressOf, r10, b)
+(constInt, r11, 6)
+(storeWord, r10, r11)
+(addressOf, r12, b)
+(parameter, 0, r12)
+(call, _Global_bump)
+(addressOf, r14, b)
+(copy, r15, r22)
+(loadWord, r16, r14)
+(addSignedWord, r17, r15, r16)
+(parameter, 0, r17)
+(syscall, syscall_print_int)
+(resultWord, r18)
+(constInt, r19, 0)
+(returnWord, r19)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_bump:
+	addiu	$sp, $sp, -104
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 4($fp)
+	lw	$s1, 0($s0)
+	move	$s2, $s1
+	move	$s0, $s1
+	li	$s3, 1
+	lw	$s1, 0($s0)
+	addiu	$s4, $s1, 1
+	sw	$s4, 0($s2)
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+main:
+	addiu	$sp, $sp, -104
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 4
+	move	$s1, $s0
+	la	$s2, 100($fp)
+	li	$s0, 6
+	sw	$s0, 0($s2)
+	la	$s3, 100($fp)
+
+	move	$a0, $s3
+
+	jal	_Global_bump
+	la	$s0, 100($fp)
+	move	$s2, $s1
+	lw	$s3, 0($s0)
+	addu	$s1, $s2, $s3
+
+	move	$a0, $s1
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+
+
+
+
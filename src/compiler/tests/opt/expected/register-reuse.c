@@ -0,0 +1,91 @@
+
+=============== IR OPTIMISED (identity) ==============
+(procBegin, main)
+(constInt, r2, 1)
+(storeWord, r1, r2)
+(constInt, r5, 2)
+(loadWord, r6, r4)
+(addSignedWord, r7, r6, r5)
+(storeWord, r3, r7)
+(loadWord, r11, r9)
+(loadWord, r12, r10)
+(multSignedWord, r13, r11, r12)
+(storeWord, r8, r13)
+(loadWord, r16, r14)
+(loadWord, r17, r15)
+(addSignedWord, r18, r16, r17)
+(loadWord, r20, r19)
+(addSignedWord, r21, r18, r20)
+(parameter, 0, r21)
+(syscall, syscall_print_int)
+(resultWord, r22)
+(constInt, r23, 0)
+(returnWord, r23)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -112
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	li	$s1, 1
+	sw	$s1, 108($fp)
+	li	$s0, 2
+	lw	$s1, 108($fp)
+	addiu	$s2, $s1, 2
+	sw	$s2, 104($fp)
+	lw	$s1, 104($fp)
+	lw	$s0, 108($fp)
+	mul	$s2, $s1, $s0
+	sw	$s2, 100($fp)
+	lw	$s0, 108($fp)
+	lw	$s1, 104($fp)
+	addu	$s2, $s0, $s1
+	lw	$s0, 100($fp)
+	addu	$s1, $s2, $s0
+
+	move	$a0, $s1
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+
+
@@ -0,0 +1,222 @@
+
+=============== IR OPTIMISED (rotate) ==============
+(procBegin, main)
+(addressOf, r1, s)
+(constInt, r2, 0)
+(storeWord, r1, r2)
+(addressOf, r3, i)
+(constInt, r4, 0)
+(storeWord, r3, r4)
+(addressOf, r32, i)
+(constInt, r33, 5)
+(loadWord, r34, r32)
+(ltSignedWord, r35, r34, r33)
+(gotoIfFalse, r35, _GeneratedLabel_3)
+(label, _GeneratedLabel_6)
+(addressOf, r9, i)
+(constInt, r10, 3)
+(loadWord, r11, r9)
+(eqWord, r12, r11, r10)
+(gotoIfFalse, r12, _GeneratedLabel_4)
+(addressOf, r13, s)
+(addressOf, r14, s)
+(constInt, r15, 10)
+(loadWord, r16, r14)
+(addSignedWord, r17, r16, r15)
+(storeWord, r13, r17)
+(goto, _GeneratedLabel_5)
+(label, _GeneratedLabel_4)
+(label, _GeneratedLabel_5)
+(addressOf, r18, s)
+(addressOf, r19, s)
+(addressOf, r20, i)
+(loadWord, r21, r19)
+(loadWord, r22, r20)
+(addSignedWord, r23, r21, r22)
+(storeWord, r18, r23)
+(addressOf, r24, i)
+(loadWord, r25, r24)
+(constInt, r26, 1)
+(addSignedWord, r27, r25, r26)
+(storeWord, r24, r27)
+(label, _GeneratedLabel_2)
+(addressOf, r5, i)
+(constInt, r6, 5)
+(loadWord, r7, r5)
+(ltSignedWord, r8, r7, r6)
+(gotoIfTrue, r8, _GeneratedLabel_6)
+(label, _GeneratedLabel_3)
+(addressOf, r28, s)
+(loadWord, r29, r28)
+(parameter, 0, r29)
+(syscall, syscall_print_int)
+(resultWord, r30)
+(constInt, r31, 0)
+(returnWord, r31)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+
+=============== IR OPTIMISED (layout) ==============
+(procBegin, main)
+(addressOf, r1, s)
+(constInt, r2, 0)
+(storeWord, r1, r2)
+(addressOf, r3, i)
+(constInt, r4, 0)
+(storeWord, r3, r4)
+(addressOf, r32, i)
+(constInt, r33, 5)
+(loadWord, r34, r32)
+(ltSignedWord, r35, r34, r33)
+(gotoIfFalse, r35, _GeneratedLabel_3)
+(label, _GeneratedLabel_6)
+(addressOf, r9, i)
+(constInt, r10, 3)
+(loadWord, r11, r9)
+(eqWord, r12, r11, r10)
+(gotoIfTrue, r12, _GeneratedLabel_7)
+(label, _GeneratedLabel_4)
+(goto, _GeneratedLabel_5)
+(label, _GeneratedLabel_7)
+(addressOf, r13, s)
+(addressOf, r14, s)
+(constInt, r15, 10)
+(loadWord, r16, r14)
+(addSignedWord, r17, r16, r15)
+(storeWord, r13, r17)
+(label, _GeneratedLabel_5)
+(addressOf, r18, s)
+(addressOf, r19, s)
+(addressOf, r20, i)
+(loadWord, r21, r19)
+(loadWord, r22, r20)
+(addSignedWord, r23, r21, r22)
+(storeWord, r18, r23)
+(addressOf, r24, i)
+(loadWord, r25, r24)
+(constInt, r26, 1)
+(addSignedWord, r27, r25, r26)
+(storeWord, r24, r27)
+(label, _GeneratedLabel_2)
+(addressOf, r5, i)
+(constInt, r6, 5)
+(loadWord, r7, r5)
+(ltSignedWord, r8, r7, r6)
+(gotoIfTrue, r8, _GeneratedLabel_6)
+(label, _GeneratedLabel_3)
+(addressOf, r28, s)
+(loadWord, r29, r28)
+(parameter, 0, r29)
+(syscall, syscall_print_int)
+(resultWord, r30)
+(constInt, r31, 0)
+(returnWord, r31)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -104
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	la	$s0, 100($fp)
+	li	$s1, 0
+	sw	$s1, 0($s0)
+	la	$s2, 96($fp)
+	li	$s0, 0
+	sw	$s0, 0($s2)
+	la	$s1, 96($fp)
+	li	$s0, 5
+	lw	$s2, 0($s1)
+	slt	$s3, $s2, $s0
+
+	beqz	$s3 _GeneratedLabel_3
+
+_GeneratedLabel_6:
+	la	$s0, 96($fp)
+	li	$s1, 3
+	lw	$s2, 0($s0)
+	seq	$s3, $s2, $s1
+
+	bnez	$s3 _GeneratedLabel_7
+
+_GeneratedLabel_4:
+
+	b _GeneratedLabel_5
+
+_GeneratedLabel_7:
+	la	$s0, 100($fp)
+	la	$s1, 100($fp)
+	li	$s2, 10
+	lw	$s3, 0($s1)
+	addiu	$s4, $s3, 10
+	sw	$s4, 0($s0)
+
+_GeneratedLabel_5:
+	la	$s0, 100($fp)
+	la	$s1, 100($fp)
+	la	$s2, 96($fp)
+	lw	$s3, 0($s1)
+	lw	$s4, 0($s2)
+	addu	$s1, $s3, $s4
+	sw	$s1, 0($s0)
+	la	$s2, 96($fp)
+	lw	$s0, 0($s2)
+	li	$s1, 1
+	addiu	$s3, $s0, 1
+	sw	$s3, 0($s2)
+
+_GeneratedLabel_2:
+	la	$s0, 96($fp)
+	li	$s1, 5
+	lw	$s2, 0($s0)
+	slti	$s3, $s2, 5
+
+	bnez	$s3 _GeneratedLabel_6
+
+_GeneratedLabel_3:
+	la	$s0, 100($fp)
+	lw	$s1, 0($s0)
+
+	move	$a0, $s1
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+
+
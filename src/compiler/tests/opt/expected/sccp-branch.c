@@ -0,0 +1,113 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, main)
+(constInt, r2, 3)
+(copy, r16, r2)
+(constInt, r4, 2)
+(copy, r5, r16)
+(ltSignedWord, r6, r5, r4)
+(gotoIfFalse, r6, _GeneratedLabel_2)
+(constInt, r8, 10)
+(copy, r15, r8)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(constInt, r10, 20)
+(copy, r15, r10)
+(label, _GeneratedLabel_3)
+(copy, r12, r15)
+(parameter, 0, r12)
+(syscall, syscall_print_int)
+(resultWord, r13)
+(constInt, r14, 0)
+(returnWord, r14)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+
+=============== IR OPTIMISED (sccp) ==============
+(procBegin, main)
+(constInt, r2, 3)
+(constInt, r16, 3)
+(constInt, r4, 2)
+(constInt, r5, 3)
+(constInt, r6, 0)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(constInt, r10, 20)
+(constInt, r17, 20)
+(label, _GeneratedLabel_3)
+(constInt, r19, 20)
+(constInt, r12, 20)
+(parameter, 0, r12)
+(syscall, syscall_print_int)
+(resultWord, r13)
+(constInt, r14, 0)
+(returnWord, r14)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+main:
+	addiu	$sp, $sp, -104
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 3
+	li	$s1, 3
+	li	$s0, 2
+	li	$s1, 3
+	li	$s0, 0
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+	li	$s0, 20
+	li	$s1, 20
+
+_GeneratedLabel_3:
+	li	$s0, 20
+	li	$s1, 20
+
+	move	$a0, $s1
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+
+
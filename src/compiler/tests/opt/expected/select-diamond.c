@@ -0,0 +1,200 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, _Global_max)
+(addressOf, r23, b)
+(loadWord, r21, r23)
+(addressOf, r22, a)
+(loadWord, r20, r22)
+(copy, r3, r20)
+(copy, r4, r21)
+(gtSignedWord, r5, r3, r4)
+(gotoIfFalse, r5, _GeneratedLabel_2)
+(copy, r8, r20)
+(copy, r19, r8)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(copy, r11, r21)
+(copy, r19, r11)
+(label, _GeneratedLabel_3)
+(copy, r13, r19)
+(returnWord, r13)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_max)
+(procBegin, main)
+(constInt, r14, 3)
+(parameter, 0, r14)
+(constInt, r15, 8)
+(parameter, 1, r15)
+(call, _Global_max)
+(resultWord, r16)
+(parameter, 2, r16)
+(syscall, syscall_print_int)
+(resultWord, r17)
+(constInt, r18, 0)
+(returnWord, r18)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+
+=============== IR OPTIMISED (select) ==============
+(procBegin, _Global_max)
+(addressOf, r23, b)
+(loadWord, r21, r23)
+(addressOf, r22, a)
+(loadWord, r20, r22)
+(copy, r3, r20)
+(copy, r4, r21)
+(gtSignedWord, r5, r3, r4)
+(copy, r8, r20)
+(copy, r25, r8)
+(copy, r11, r21)
+(copy, r24, r11)
+(constInt, r27, 0)
+(subUnsignedWord, r28, r27, r5)
+(bitwiseXorWord, r29, r25, r24)
+(bitwiseAndWord, r30, r29, r28)
+(bitwiseXorWord, r26, r24, r30)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_3)
+(copy, r13, r26)
+(returnWord, r13)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_max)
+(procBegin, main)
+(constInt, r14, 3)
+(parameter, 0, r14)
+(constInt, r15, 8)
+(parameter, 1, r15)
+(call, _Global_max)
+(resultWord, r16)
+(parameter, 2, r16)
+(syscall, syscall_print_int)
+(resultWord, r17)
+(constInt, r18, 0)
+(returnWord, r18)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_max:
+	addiu	$sp, $sp, -112
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 8($fp)
+	lw	$s1, 0($s0)
+	la	$s2, 4($fp)
+	lw	$s0, 0($s2)
+	move	$s3, $s0
+	move	$s2, $s1
+	sgt	$s4, $s3, $s2
+	move	$s5, $s0
+	move	$s2, $s5
+	move	$s0, $s1
+	move	$s3, $s0
+	li	$s1, 0
+	subu	$s0, $s1, $s4
+	xor	$s5, $s2, $s3
+	and	$s1, $s5, $s0
+	xor	$s2, $s3, $s1
+
+	b _GeneratedLabel_3
+
+_GeneratedLabel_3:
+	move	$s0, $s2
+	move	$v0, $s0
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 3
+
+	move	$a0, $s0
+
+	li	$s1, 8
+
+	move	$a1, $s1
+
+	jal	_Global_max
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_4
+
+_GeneratedLabel_4:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
@@ -0,0 +1,42 @@
+=================== IR ===================
+(procBegin, _Global_f)
+(addressOf, r1, a)
+(loadWord, r2, r1)
+(gotoIfFalse, r2, _GeneratedLabel_4)
+(addressOf, r3, b)
+(loadWord, r4, r3)
+(gotoIfTrue, r4, _GeneratedLabel_3)
+(label, _GeneratedLabel_4)
+(addressOf, r5, c)
+(loadWord, r6, r5)
+(unaryLogicalNegation, r7, r6)
+(gotoIfFalse, r7, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(constInt, r8, 1)
+(returnWord, r8)
+(goto, _GeneratedLabel_1)
+(goto, _GeneratedLabel_5)
+(label, _GeneratedLabel_2)
+(label, _GeneratedLabel_5)
+(constInt, r9, 0)
+(returnWord, r9)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r10, 1)
+(parameter, 0, r10)
+(constInt, r11, 0)
+(parameter, 1, r11)
+(constInt, r12, 1)
+(parameter, 2, r12)
+(call, _Global_f)
+(resultWord, r13)
+(parameter, 3, r13)
+(syscall, syscall_print_int)
+(resultWord, r14)
+(constInt, r15, 0)
+(returnWord, r15)
+(goto, _GeneratedLabel_6)
+(label, _GeneratedLabel_6)
+(procEnd, main)
@@ -0,0 +1,188 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, _Global_pick)
+(addressOf, r20, a)
+(loadWord, r19, r20)
+(constInt, r2, 0)
+(copy, r3, r19)
+(gtSignedWord, r4, r3, r2)
+(gotoIfFalse, r4, _GeneratedLabel_2)
+(constInt, r6, 4)
+(copy, r18, r6)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(constInt, r8, 4)
+(copy, r18, r8)
+(label, _GeneratedLabel_3)
+(copy, r11, r18)
+(copy, r12, r19)
+(addSignedWord, r13, r11, r12)
+(returnWord, r13)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_pick)
+(procBegin, main)
+(constInt, r14, 3)
+(parameter, 0, r14)
+(call, _Global_pick)
+(resultWord, r15)
+(parameter, 1, r15)
+(syscall, syscall_print_int)
+(resultWord, r16)
+(constInt, r17, 0)
+(returnWord, r17)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+
+=============== IR OPTIMISED (sccp) ==============
+(procBegin, _Global_pick)
+(addressOf, r20, a)
+(loadWord, r19, r20)
+(constInt, r2, 0)
+(copy, r3, r19)
+(gtSignedWord, r4, r3, r2)
+(gotoIfFalse, r4, _GeneratedLabel_2)
+(constInt, r6, 4)
+(constInt, r22, 4)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(constInt, r8, 4)
+(constInt, r21, 4)
+(label, _GeneratedLabel_3)
+(constInt, r23, 4)
+(constInt, r11, 4)
+(copy, r12, r19)
+(addSignedWord, r13, r11, r12)
+(returnWord, r13)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_pick)
+(procBegin, main)
+(constInt, r14, 3)
+(parameter, 0, r14)
+(call, _Global_pick)
+(resultWord, r15)
+(parameter, 1, r15)
+(syscall, syscall_print_int)
+(resultWord, r16)
+(constInt, r17, 0)
+(returnWord, r17)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_pick:
+	addiu	$sp, $sp, -104
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	la	$s0, 0($fp)
+	lw	$s1, 0($s0)
+	li	$s2, 0
+	move	$s0, $s1
+	sgt	$s3, $s0, $s2
+
+	beqz	$s3 _GeneratedLabel_2
+	li	$s0, 4
+	li	$s2, 4
+
+	b _GeneratedLabel_3
+
+_GeneratedLabel_2:
+	li	$s0, 4
+	li	$s2, 4
+
+_GeneratedLabel_3:
+	li	$s0, 4
+	li	$s2, 4
+	move	$s0, $s1
+	addu	$s3, $s2, $s0
+	move	$v0, $s3
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 3
+
+	move	$a0, $s0
+
+	jal	_Global_pick
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_4
+
+_GeneratedLabel_4:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
@@ -0,0 +1,178 @@
+
+=============== IR OPTIMISED (tailrec) ==============
+(procBegin, _Global_sum)
+(label, _GeneratedLabel_5)
+(addressOf, r1, n)
+(constInt, r2, 0)
+(loadWord, r3, r1)
+(eqWord, r4, r3, r2)
+(gotoIfFalse, r4, _GeneratedLabel_2)
+(addressOf, r5, acc)
+(loadWord, r6, r5)
+(returnWord, r6)
+(goto, _GeneratedLabel_1)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(addressOf, r7, n)
+(constInt, r8, 1)
+(loadWord, r9, r7)
+(subSignedWord, r10, r9, r8)
+(addressOf, r11, acc)
+(addressOf, r12, n)
+(loadWord, r13, r11)
+(loadWord, r14, r12)
+(addSignedWord, r15, r13, r14)
+(addressOf, r22, n)
+(storeWord, r22, r10)
+(addressOf, r23, acc)
+(storeWord, r23, r15)
+(goto, _GeneratedLabel_5)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_sum)
+(procBegin, main)
+(constInt, r17, 10)
+(parameter, 0, r17)
+(constInt, r18, 0)
+(parameter, 1, r18)
+(call, _Global_sum)
+(resultWord, r19)
+(parameter, 2, r19)
+(syscall, syscall_print_int)
+(resultWord, r20)
+(constInt, r21, 0)
+(returnWord, r21)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_sum:
+	addiu	$sp, $sp, -104
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+
+_GeneratedLabel_5:
+	la	$s0, 0($fp)
+	li	$s1, 0
+	lw	$s2, 0($s0)
+	seq	$s3, $s2, $s1
+
+	beqz	$s3 _GeneratedLabel_2
+	la	$s0, 4($fp)
+	lw	$s1, 0($s0)
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+	b _GeneratedLabel_3
+
+_GeneratedLabel_2:
+
+_GeneratedLabel_3:
+	la	$s0, 0($fp)
+	li	$s1, 1
+	lw	$s2, 0($s0)
+	sub	$s3, $s2, $s1
+	la	$s0, 4($fp)
+	la	$s1, 0($fp)
+	lw	$s2, 0($s0)
+	lw	$s4, 0($s1)
+	addu	$s0, $s2, $s4
+	la	$s1, 0($fp)
+	sw	$s3, 0($s1)
+	la	$s2, 4($fp)
+	sw	$s0, 0($s2)
+
+	b _GeneratedLabel_5
+
+_GeneratedLabel_1:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 104
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 10
+
+	move	$a0, $s0
+
+	li	$s1, 0
+
+	move	$a1, $s1
+
+	jal	_Global_sum
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_4
+
+_GeneratedLabel_4:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
@@ -0,0 +1,247 @@
+
+=============== IR OPTIMISED (unroll) ==============
+(procBegin, _Global_sum)
+(addressOf, r1, s)
+(constInt, r2, 0)
+(storeWord, r1, r2)
+(addressOf, r3, i)
+(constInt, r4, 0)
+(storeWord, r3, r4)
+(label, _GeneratedLabel_5)
+(addressOf, r27, i)
+(loadWord, r26, r27)
+(constInt, r28, 1)
+(addSignedWord, r29, r26, r28)
+(addressOf, r32, n)
+(loadWord, r31, r32)
+(ltSignedWord, r30, r29, r31)
+(gotoIfFalse, r30, _GeneratedLabel_2)
+(addressOf, r33, s)
+(addressOf, r34, s)
+(addressOf, r35, i)
+(loadWord, r36, r34)
+(loadWord, r37, r35)
+(addSignedWord, r38, r36, r37)
+(storeWord, r33, r38)
+(addressOf, r39, i)
+(loadWord, r40, r39)
+(constInt, r41, 1)
+(addSignedWord, r42, r40, r41)
+(storeWord, r39, r42)
+(addressOf, r43, s)
+(addressOf, r44, s)
+(addressOf, r45, i)
+(loadWord, r46, r44)
+(loadWord, r47, r45)
+(addSignedWord, r48, r46, r47)
+(storeWord, r43, r48)
+(addressOf, r49, i)
+(loadWord, r50, r49)
+(constInt, r51, 1)
+(addSignedWord, r52, r50, r51)
+(storeWord, r49, r52)
+(goto, _GeneratedLabel_5)
+(label, _GeneratedLabel_2)
+(addressOf, r5, i)
+(addressOf, r6, n)
+(loadWord, r7, r5)
+(loadWord, r8, r6)
+(ltSignedWord, r9, r7, r8)
+(gotoIfFalse, r9, _GeneratedLabel_3)
+(addressOf, r10, s)
+(addressOf, r11, s)
+(addressOf, r12, i)
+(loadWord, r13, r11)
+(loadWord, r14, r12)
+(addSignedWord, r15, r13, r14)
+(storeWord, r10, r15)
+(addressOf, r16, i)
+(loadWord, r17, r16)
+(constInt, r18, 1)
+(addSignedWord, r19, r17, r18)
+(storeWord, r16, r19)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(addressOf, r20, s)
+(loadWord, r21, r20)
+(returnWord, r21)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_sum)
+(procBegin, main)
+(constInt, r22, 10)
+(parameter, 0, r22)
+(call, _Global_sum)
+(resultWord, r23)
+(parameter, 1, r23)
+(syscall, syscall_print_int)
+(resultWord, r24)
+(constInt, r25, 0)
+(returnWord, r25)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_sum:
+	addiu	$sp, $sp, -112
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 108($fp)
+	li	$s1, 0
+	sw	$s1, 0($s0)
+	la	$s2, 104($fp)
+	li	$s0, 0
+	sw	$s0, 0($s2)
+
+_GeneratedLabel_5:
+	la	$s0, 104($fp)
+	lw	$s1, 0($s0)
+	li	$s2, 1
+	addu	$s0, $s1, $s2
+	la	$s3, 4($fp)
+	lw	$s1, 0($s3)
+	slt	$s2, $s0, $s1
+
+	beqz	$s2 _GeneratedLabel_2
+	la	$s0, 108($fp)
+	la	$s1, 108($fp)
+	la	$s2, 104($fp)
+	lw	$s3, 0($s1)
+	lw	$s4, 0($s2)
+	addu	$s1, $s3, $s4
+	sw	$s1, 0($s0)
+	la	$s2, 104($fp)
+	lw	$s0, 0($s2)
+	li	$s1, 1
+	addu	$s3, $s0, $s1
+	sw	$s3, 0($s2)
+	la	$s0, 108($fp)
+	la	$s1, 108($fp)
+	la	$s2, 104($fp)
+	lw	$s3, 0($s1)
+	lw	$s4, 0($s2)
+	addu	$s1, $s3, $s4
+	sw	$s1, 0($s0)
+	la	$s2, 104($fp)
+	lw	$s0, 0($s2)
+	li	$s1, 1
+	addu	$s3, $s0, $s1
+	sw	$s3, 0($s2)
+
+	b _GeneratedLabel_5
+
+_GeneratedLabel_2:
+	la	$s0, 104($fp)
+	la	$s1, 4($fp)
+	lw	$s2, 0($s0)
+	lw	$s3, 0($s1)
+	slt	$s0, $s2, $s3
+
+	beqz	$s0 _GeneratedLabel_3
+	la	$s1, 108($fp)
+	la	$s0, 108($fp)
+	la	$s2, 104($fp)
+	lw	$s3, 0($s0)
+	lw	$s4, 0($s2)
+	addu	$s0, $s3, $s4
+	sw	$s0, 0($s1)
+	la	$s2, 104($fp)
+	lw	$s0, 0($s2)
+	li	$s1, 1
+	addiu	$s3, $s0, 1
+	sw	$s3, 0($s2)
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_3:
+	la	$s0, 108($fp)
+	lw	$s1, 0($s0)
+	move	$v0, $s1
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 10
+
+	move	$a0, $s0
+
+	jal	_Global_sum
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_4
+
+_GeneratedLabel_4:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
@@ -0,0 +1,199 @@
+
+=============== IR OPTIMISED (constprop) ==============
+(procBegin, _Global_f)
+(addressOf, r1, x)
+(addressOf, r2, a)
+(addressOf, r3, b)
+(loadWord, r4, r2)
+(loadWord, r5, r3)
+(multSignedWord, r6, r4, r5)
+(constInt, r7, 1)
+(addSignedWord, r8, r6, r7)
+(storeWord, r1, r8)
+(addressOf, r9, y)
+(addressOf, r10, b)
+(addressOf, r11, a)
+(loadWord, r12, r10)
+(loadWord, r13, r11)
+(multSignedWord, r14, r12, r13)
+(constInt, r15, 2)
+(addSignedWord, r16, r14, r15)
+(storeWord, r9, r16)
+(addressOf, r17, x)
+(addressOf, r18, y)
+(loadWord, r19, r17)
+(loadWord, r20, r18)
+(addSignedWord, r21, r19, r20)
+(returnWord, r21)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r22, 3)
+(parameter, 0, r22)
+(constInt, r23, 4)
+(parameter, 1, r23)
+(call, _Global_f)
+(resultWord, r24)
+(parameter, 2, r24)
+(syscall, syscall_print_int)
+(resultWord, r25)
+(constInt, r26, 0)
+(returnWord, r26)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+
+=============== IR OPTIMISED (cse) ==============
+(procBegin, _Global_f)
+(addressOf, r1, x)
+(addressOf, r2, a)
+(addressOf, r3, b)
+(loadWord, r4, r2)
+(loadWord, r5, r3)
+(multSignedWord, r6, r4, r5)
+(constInt, r7, 1)
+(addSignedWord, r8, r6, r7)
+(storeWord, r1, r8)
+(addressOf, r9, y)
+(constInt, r15, 2)
+(addSignedWord, r16, r6, r15)
+(storeWord, r9, r16)
+(loadWord, r19, r1)
+(loadWord, r20, r9)
+(addSignedWord, r21, r19, r20)
+(returnWord, r21)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r22, 3)
+(parameter, 0, r22)
+(constInt, r23, 4)
+(parameter, 1, r23)
+(call, _Global_f)
+(resultWord, r24)
+(parameter, 2, r24)
+(syscall, syscall_print_int)
+(resultWord, r25)
+(constInt, r26, 0)
+(returnWord, r26)
+(goto, _GeneratedLabel_2)
+(label, _GeneratedLabel_2)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -112
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	la	$s0, 108($fp)
+	la	$s1, 0($fp)
+	la	$s2, 4($fp)
+	lw	$s3, 0($s1)
+	lw	$s4, 0($s2)
+	mul	$s1, $s3, $s4
+	li	$s2, 1
+	addiu	$s3, $s1, 1
+	sw	$s3, 0($s0)
+	la	$s2, 104($fp)
+	li	$s3, 2
+	addiu	$s4, $s1, 2
+	sw	$s4, 0($s2)
+	lw	$s1, 0($s0)
+	lw	$s3, 0($s2)
+	addu	$s0, $s1, $s3
+	move	$v0, $s0
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 3
+
+	move	$a0, $s0
+
+	li	$s1, 4
+
+	move	$a1, $s1
+
+	jal	_Global_f
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_2
+
+_GeneratedLabel_2:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
+
+
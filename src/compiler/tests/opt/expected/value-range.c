@@ -0,0 +1,220 @@
+
+=============== IR OPTIMISED (mem2reg) ==============
+(procBegin, _Global_f)
+(addressOf, r27, k)
+(loadWord, r26, r27)
+(addressOf, r1, c)
+(copy, r3, r26)
+(castWordToByte, r4, r3)
+(storeByte, r1, r4)
+(addressOf, r6, c)
+(loadSignedByte, r7, r6)
+(castSignedByteToWord, r8, r7)
+(constInt, r9, 127)
+(bitwiseAndWord, r10, r8, r9)
+(copy, r25, r10)
+(addressOf, r11, c)
+(loadSignedByte, r12, r11)
+(castSignedByteToWord, r13, r12)
+(constInt, r14, 200)
+(ltSignedWord, r15, r13, r14)
+(gotoIfFalse, r15, _GeneratedLabel_2)
+(constInt, r17, 255)
+(copy, r18, r25)
+(bitwiseAndWord, r19, r18, r17)
+(returnWord, r19)
+(goto, _GeneratedLabel_1)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(constInt, r20, 0)
+(returnWord, r20)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r21, 300)
+(parameter, 0, r21)
+(call, _Global_f)
+(resultWord, r22)
+(parameter, 1, r22)
+(syscall, syscall_print_int)
+(resultWord, r23)
+(constInt, r24, 0)
+(returnWord, r24)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+
+=============== IR OPTIMISED (vrp) ==============
+(procBegin, _Global_f)
+(addressOf, r27, k)
+(loadWord, r26, r27)
+(addressOf, r1, c)
+(copy, r3, r26)
+(copy, r4, r3)
+(storeByte, r1, r4)
+(addressOf, r6, c)
+(loadSignedByte, r7, r6)
+(copy, r8, r7)
+(constInt, r9, 127)
+(bitwiseAndWord, r10, r8, r9)
+(copy, r25, r10)
+(addressOf, r11, c)
+(loadSignedByte, r12, r11)
+(copy, r13, r12)
+(constInt, r14, 200)
+(constInt, r15, 1)
+(gotoIfFalse, r15, _GeneratedLabel_2)
+(constInt, r17, 255)
+(copy, r18, r25)
+(copy, r19, r18)
+(returnWord, r19)
+(goto, _GeneratedLabel_1)
+(goto, _GeneratedLabel_3)
+(label, _GeneratedLabel_2)
+(label, _GeneratedLabel_3)
+(constInt, r20, 0)
+(returnWord, r20)
+(goto, _GeneratedLabel_1)
+(label, _GeneratedLabel_1)
+(procEnd, _Global_f)
+(procBegin, main)
+(constInt, r21, 300)
+(parameter, 0, r21)
+(call, _Global_f)
+(resultWord, r22)
+(parameter, 1, r22)
+(syscall, syscall_print_int)
+(resultWord, r23)
+(constInt, r24, 0)
+(returnWord, r24)
+(goto, _GeneratedLabel_4)
+(label, _GeneratedLabel_4)
+(procEnd, main)
+	.data
+	.text
+	.globl main
+_Global_f:
+	addiu	$sp, $sp, -112
+	sw	$fp, 52($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 4($fp)
+	sw	$a1, 8($fp)
+	sw	$a2, 12($fp)
+	sw	$a3, 16($fp)
+	sw	$s0, 20($fp)
+	sw	$s1, 24($fp)
+	sw	$s2, 28($fp)
+	sw	$s3, 32($fp)
+	sw	$s4, 36($fp)
+	sw	$s5, 40($fp)
+	sw	$s6, 44($fp)
+	sw	$s7, 48($fp)
+	sw	$ra, 56($fp)
+
+	la	$s0, 4($fp)
+	lw	$s1, 0($s0)
+	la	$s2, 111($fp)
+	move	$s0, $s1
+	move	$s3, $s0
+	sb	$s3, 0($s2)
+	la	$s0, 111($fp)
+	lb	$s1, 0($s0)
+	move	$s2, $s1
+	li	$s0, 127
+	and	$s1, $s2, $s0
+	move	$s3, $s1
+	la	$s0, 111($fp)
+	lb	$s1, 0($s0)
+	move	$s2, $s1
+	li	$s0, 200
+	li	$s1, 1
+
+	beqz	$s1 _GeneratedLabel_2
+	li	$s0, 255
+	move	$s1, $s3
+	move	$s0, $s1
+	move	$v0, $s0
+
+	b _GeneratedLabel_1
+
+	b _GeneratedLabel_3
+
+_GeneratedLabel_2:
+
+_GeneratedLabel_3:
+	li	$s0, 0
+	move	$v0, $s0
+
+	b _GeneratedLabel_1
+
+_GeneratedLabel_1:
+
+	lw	$ra, 56($fp)
+	lw	$s7, 48($fp)
+	lw	$s6, 44($fp)
+	lw	$s5, 40($fp)
+	lw	$s4, 36($fp)
+	lw	$s3, 32($fp)
+	lw	$s2, 28($fp)
+	lw	$s1, 24($fp)
+	lw	$s0, 20($fp)
+	lw	$fp, 52($fp)
+	addiu	$sp, $sp, 112
+	jr	$ra
+main:
+	addiu	$sp, $sp, -96
+	sw	$fp, 48($sp)
+	or	$fp, $sp, $0
+	sw	$a0, 0($fp)
+	sw	$a1, 4($fp)
+	sw	$a2, 8($fp)
+	sw	$a3, 12($fp)
+	sw	$s0, 16($fp)
+	sw	$s1, 20($fp)
+	sw	$s2, 24($fp)
+	sw	$s3, 28($fp)
+	sw	$s4, 32($fp)
+	sw	$s5, 36($fp)
+	sw	$s6, 40($fp)
+	sw	$s7, 44($fp)
+	sw	$ra, 52($fp)
+
+	li	$s0, 300
+
+	move	$a0, $s0
+
+	jal	_Global_f
+	move	$s0, $v0
+
+	move	$a0, $s0
+
+
+	li	$v0, 1
+	syscall
+
+	move	$s0, $v0
+	li	$s1, 0
+	move	$v0, $s1
+
+	b _GeneratedLabel_4
+
+_GeneratedLabel_4:
+
+	lw	$ra, 52($fp)
+	lw	$s7, 44($fp)
+	lw	$s6, 40($fp)
+	lw	$s5, 36($fp)
+	lw	$s4, 32($fp)
+	lw	$s3, 28($fp)
+	lw	$s2, 24($fp)
+	lw	$s1, 20($fp)
+	lw	$s0, 16($fp)
+	lw	$fp, 48($fp)
+	addiu	$sp, $sp, 96
+	jr	$ra
+
+
+
+
@@ -0,0 +1,15 @@
+/* -s ir -passes=globaldce */
+int syscall_print_int(int i);
+
+int unused_global;
+int used_global;
+
+int never_called(int x) {
+  return x + unused_global;
+}
+
+int main(void) {
+  used_global = 4;
+  syscall_print_int(used_global);
+  return 0;
+}
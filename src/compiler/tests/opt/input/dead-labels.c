@@ -0,0 +1,16 @@
+/* -s ir -passes=dce */
+int syscall_print_int(int i);
+
+int main(void) {
+  int i;
+  i = 0;
+  while (i < 3) {
+    if (i == 1) {
+      i = i + 2;
+      continue;
+    }
+    i++;
+  }
+  syscall_print_int(i);
+  return 0;
+}
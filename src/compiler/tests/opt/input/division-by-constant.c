@@ -0,0 +1,15 @@
+/* -s mips -O 1 */
+int syscall_print_int(int i);
+
+void f(int x) {
+  unsigned int u;
+  u = x;
+  syscall_print_int(x / 7);
+  syscall_print_int(x % 10);
+  syscall_print_int(u / 3);
+}
+
+int main(void) {
+  f(-100);
+  return 0;
+}
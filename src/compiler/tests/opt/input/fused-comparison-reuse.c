@@ -0,0 +1,15 @@
+/* -s mips -O 2 -passes=mem2reg,constprop,dce */
+int syscall_print_int(int i);
+
+int f(int a, int b) {
+  int c;
+  c = a != b;
+  if (c) a = a + 5;
+  return a + c;
+}
+
+int main(void) {
+  syscall_print_int(f(3, 4));
+  syscall_print_int(f(2, 2));
+  return 0;
+}
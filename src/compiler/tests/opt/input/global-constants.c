@@ -0,0 +1,12 @@
+/* -s ir -passes=mem2reg,constprop */
+int syscall_print_int(int i);
+
+int main(void) {
+  int a, b, c;
+  a = 5;
+  b = a;
+  if (b > 2) c = b + 1;
+  else c = a - 1;
+  syscall_print_int(c);
+  return 0;
+}
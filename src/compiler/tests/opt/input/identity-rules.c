@@ -0,0 +1,11 @@
+/* -s ir -passes=identity */
+int syscall_print_int(int i);
+
+int f(int a) {
+  return (a + 0) * 1 - 0;
+}
+
+int main(void) {
+  syscall_print_int(f(9) * 1);
+  return 0;
+}
@@ -0,0 +1,12 @@
+/* -s ir -passes=iv */
+int syscall_print_int(int i);
+
+int main(void) {
+  int a[8];
+  int i, s;
+  for (i = 0; i < 8; i++) a[i] = i;
+  s = 0;
+  for (i = 0; i < 8; i++) s = s + a[i];
+  syscall_print_int(s);
+  return 0;
+}
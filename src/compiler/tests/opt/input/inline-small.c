@@ -0,0 +1,11 @@
+/* -s ir -passes=inline */
+int syscall_print_int(int i);
+
+int square(int x) {
+  return x * x;
+}
+
+int main(void) {
+  syscall_print_int(square(7));
+  return 0;
+}
@@ -0,0 +1,12 @@
+/* -s ir -passes=ipcp */
+int syscall_print_int(int i);
+
+int scale(int x, int k, int unused) {
+  return x * k;
+}
+
+int main(void) {
+  syscall_print_int(scale(2, 5, 1));
+  syscall_print_int(scale(3, 5, 2));
+  return 0;
+}
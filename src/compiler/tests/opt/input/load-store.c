@@ -0,0 +1,11 @@
+/* -s ir -passes=lse */
+int syscall_print_int(int i);
+
+int main(void) {
+  int a, b;
+  a = 1;
+  a = 2;
+  b = a + a;
+  syscall_print_int(b);
+  return 0;
+}
@@ -0,0 +1,14 @@
+/* -s ir -passes=mem2reg,licm */
+int syscall_print_int(int i);
+
+int f(int a, int b, int n) {
+  int i, s;
+  s = 0;
+  for (i = 0; i < n; i++) s = s + a * b;
+  return s;
+}
+
+int main(void) {
+  syscall_print_int(f(2, 3, 4));
+  return 0;
+}
@@ -0,0 +1,13 @@
+/* -s mips -O 1 */
+int syscall_print_int(int i);
+
+void f(int x) {
+  syscall_print_int(x * 10);
+  syscall_print_int(x * 15);
+  syscall_print_int(x * -9);
+}
+
+int main(void) {
+  f(3);
+  return 0;
+}
@@ -0,0 +1,14 @@
+/* -s ir -passes=pre */
+int syscall_print_int(int i);
+
+int f(int a, int b, int c) {
+  int x;
+  x = 0;
+  if (c) x = a + b;
+  return x + (a + b);
+}
+
+int main(void) {
+  syscall_print_int(f(1, 2, 1));
+  return 0;
+}
@@ -0,0 +1,10 @@
+/* -s ir -passes=identity,fixpoint(constprop,dce) */
+int syscall_print_int(int i);
+
+int main(void) {
+  int a, b;
+  a = 2 * 3;
+  b = a + 0;
+  syscall_print_int(b);
+  return 0;
+}
@@ -0,0 +1,11 @@
+/* -s ir -passes=mem2reg,reassociate */
+int syscall_print_int(int i);
+
+int f(int a) {
+  return 1 + a + 2 + a * 3 * 4;
+}
+
+int main(void) {
+  syscall_print_int(f(5));
+  return 0;
+}
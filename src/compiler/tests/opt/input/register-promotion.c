@@ -0,0 +1,15 @@
+/* -s ir -passes=mem2reg */
+int syscall_print_int(int i);
+
+void bump(int *p) {
+  *p = *p + 1;
+}
+
+int main(void) {
+  int a, b;
+  a = 4;
+  b = 6;
+  bump(&b);
+  syscall_print_int(a + b);
+  return 0;
+}
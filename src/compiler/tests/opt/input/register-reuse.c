@@ -0,0 +1,11 @@
+/* -s mips -O 1 */
+int syscall_print_int(int i);
+
+int main(void) {
+  int a, b, c;
+  a = 1;
+  b = a + 2;
+  c = b * a;
+  syscall_print_int(a + b + c);
+  return 0;
+}
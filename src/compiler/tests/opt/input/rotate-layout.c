@@ -0,0 +1,15 @@
+/* -s ir -passes=rotate,layout */
+int syscall_print_int(int i);
+
+int main(void) {
+  int i, s;
+  s = 0;
+  i = 0;
+  while (i < 5) {
+    if (i == 3) s = s + 10;
+    s = s + i;
+    i++;
+  }
+  syscall_print_int(s);
+  return 0;
+}
@@ -0,0 +1,11 @@
+/* -s ir -passes=mem2reg,sccp */
+int syscall_print_int(int i);
+
+int main(void) {
+  int a, b;
+  a = 3;
+  if (a < 2) b = 10;
+  else b = 20;
+  syscall_print_int(b);
+  return 0;
+}
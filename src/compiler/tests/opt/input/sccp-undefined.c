@@ -0,0 +1,13 @@
+/* -s ir -passes=mem2reg,sccp */
+int syscall_print_int(int i);
+
+int f(void) {
+  int x2;
+  while (x2 > 0) x2 = x2 - 1;
+  return 7;
+}
+
+int main(void) {
+  syscall_print_int(f());
+  return 0;
+}
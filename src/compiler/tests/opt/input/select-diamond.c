@@ -0,0 +1,14 @@
+/* -s mips -O 2 -passes=mem2reg,select */
+int syscall_print_int(int i);
+
+int max(int a, int b) {
+  int m;
+  if (a > b) m = a;
+  else m = b;
+  return m;
+}
+
+int main(void) {
+  syscall_print_int(max(3, 8));
+  return 0;
+}
@@ -0,0 +1,12 @@
+/* -s ir */
+int syscall_print_int(int i);
+
+int f(int a, int b, int c) {
+  if ((a && b) || !c) return 1;
+  return 0;
+}
+
+int main(void) {
+  syscall_print_int(f(1, 0, 1));
+  return 0;
+}
@@ -0,0 +1,14 @@
+/* -s ir -passes=mem2reg,sccp */
+int syscall_print_int(int i);
+
+int pick(int a) {
+  int x;
+  if (a > 0) x = 4;
+  else x = 4;
+  return x + a;
+}
+
+int main(void) {
+  syscall_print_int(pick(3));
+  return 0;
+}
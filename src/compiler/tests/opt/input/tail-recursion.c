@@ -0,0 +1,12 @@
+/* -s ir -passes=tailrec */
+int syscall_print_int(int i);
+
+int sum(int n, int acc) {
+  if (n == 0) return acc;
+  return sum(n - 1, acc + n);
+}
+
+int main(void) {
+  syscall_print_int(sum(10, 0));
+  return 0;
+}
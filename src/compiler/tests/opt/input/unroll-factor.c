@@ -0,0 +1,14 @@
+/* -s ir -passes=unroll -unroll-factor 2 */
+int syscall_print_int(int i);
+
+int sum(int n) {
+  int i, s;
+  s = 0;
+  for (i = 0; i < n; i++) s = s + i;
+  return s;
+}
+
+int main(void) {
+  syscall_print_int(sum(10));
+  return 0;
+}
@@ -0,0 +1,14 @@
+/* -s ir -passes=constprop,cse */
+int syscall_print_int(int i);
+
+int f(int a, int b) {
+  int x, y;
+  x = a * b + 1;
+  y = b * a + 2;
+  return x + y;
+}
+
+int main(void) {
+  syscall_print_int(f(3, 4));
+  return 0;
+}
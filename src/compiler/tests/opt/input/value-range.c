@@ -0,0 +1,16 @@
+/* -s ir -passes=mem2reg,vrp */
+int syscall_print_int(int i);
+
+int f(int k) {
+  char c;
+  int x;
+  c = k;
+  x = c & 127;
+  if (c < 200) return x & 255;
+  return 0;
+}
+
+int main(void) {
+  syscall_print_int(f(300));
+  return 0;
+}
@@ -0,0 +1 @@
+64 203 274 20 287 -164 -379 -550 20 -523 
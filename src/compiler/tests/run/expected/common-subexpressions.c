@@ -0,0 +1 @@
+42 15 -46 -16 73 1 
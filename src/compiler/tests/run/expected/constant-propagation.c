@@ -0,0 +1 @@
+90 93 4 12 
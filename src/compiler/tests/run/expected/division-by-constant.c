@@ -0,0 +1,17 @@
+0 0 0 0 0 0 0 0 0 0 0 0 0 0 
+0 0 0 0 0 0 0 0 0 0 0 
+0 -1 0 -1 0 -1 0 -1 0 0 -1 0 -1 0 
+1431655765 0 613566756 3 429496729 5 6700416 268435455 15 1 1294967295 
+2 1 1 0 -1 2 0 7 0 0 7 0 7 0 
+2 1 1 0 0 7 0 0 7 0 7 
+-2 -1 -1 0 1 -2 0 -7 0 0 -7 0 -7 0 
+1431655763 0 613566755 4 429496728 9 6700416 268435455 9 1 1294967289 
+715827882 1 306783378 1 -429496729 2 214748364 7 3350208 268435455 7 -134217727 15 2 
+715827882 1 306783378 1 214748364 7 3350208 134217727 15 0 2147483647 
+-715827882 -2 -306783378 -2 429496729 -3 -214748364 -8 -3350208 -268435456 0 134217728 0 -2 
+715827882 2 306783378 2 214748364 8 3350208 134217728 0 0 -2147483648 
+-333333 0 -142857 0 199999 -4 -99999 -9 -1560 -124999 -7 62499 -15 0 
+1431322432 1 613423899 4 429396729 7 6698856 268372956 1 1 1293967297 
+41152263 0 17636684 1 -24691357 4 12345678 9 192600 15432098 5 -7716049 5 0 
+41152263 0 17636684 1 12345678 9 192600 7716049 5 0 123456789 
+
@@ -0,0 +1 @@
+-44 0 14 4 0 18 -44 0 11 4 0 15 6 1 1 1 9 
@@ -0,0 +1 @@
+3 9 36 44 0 6 
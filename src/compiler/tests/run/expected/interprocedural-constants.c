@@ -0,0 +1 @@
+810 118 365 -155 55 30 7 12 
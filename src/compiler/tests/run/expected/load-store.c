@@ -0,0 +1 @@
+7 11 7 9 10 2 1 21 6 
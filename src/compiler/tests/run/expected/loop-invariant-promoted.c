@@ -0,0 +1 @@
+24 0 2 123 72 
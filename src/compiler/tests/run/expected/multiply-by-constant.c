@@ -0,0 +1,6 @@
+0 0 0 0 0 0 0 0 0 0 0 
+3 5 10 15 31 100 -9 -64 1000000 2147483647 7 
+-9 -15 -30 -45 -93 -300 27 192 -3000000 -2147483645 -21 
+37035 61725 123450 185175 382695 1234500 -111105 -790080 -539901888 2147471303 86415 
+-2147483648 -2147483648 0 -2147483648 -2147483648 0 -2147483648 0 0 -2147483648 -2147483648 
+
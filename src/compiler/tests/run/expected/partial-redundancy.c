@@ -0,0 +1 @@
+10 6 0 60 
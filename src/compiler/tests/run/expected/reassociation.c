@@ -0,0 +1,8 @@
+7 7 2 -6 -180 29 -96 -1 0 0 4 -2147483642 
+8 8 1 -7 -120 29 -64 -1 0 0 9 -2147483641 
+9 9 0 -8 -60 29 -32 -1 0 0 16 -2147483640 
+10 10 -1 -9 0 29 0 0 0 0 25 -2147483639 
+11 11 -2 -10 60 29 32 0 0 0 36 -2147483638 
+12 12 -3 -11 120 29 64 0 0 0 49 -2147483637 
+13 13 -4 -12 180 29 96 0 0 0 64 -2147483636 
+
@@ -0,0 +1 @@
+1002 55090 
@@ -0,0 +1 @@
+6 -11 1 2 1 -7 6 -1 1 2 1 3 1 255 10 0 266 
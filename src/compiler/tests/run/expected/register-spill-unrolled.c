@@ -0,0 +1 @@
+1 -1 4 0 4 1 -1 4 0 4 1 0 1 1 3 
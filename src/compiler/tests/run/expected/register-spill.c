@@ -0,0 +1 @@
+8 0 -7 2 0 -5 1 255 0 1 257 1 255 0 1 257 
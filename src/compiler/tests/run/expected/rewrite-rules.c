@@ -0,0 +1,88 @@
+23
+23
+23
+0
+0
+0
+23
+161
+23
+-23
+0
+0
+3
+2
+7
+2
+-23
+-23
+-23
+0
+0
+0
+-23
+-161
+-23
+23
+0
+0
+-3
+-2
+1
+536870909
+5
+0
+-1
+0
+5
+5
+5
+-1
+5
+5
+-6
+0
+5
+-9
+0
+-1
+0
+-9
+-9
+-9
+-1
+-9
+-9
+8
+0
+-9
+1
+0
+0
+1
+0
+1
+0
+1
+0
+1
+1
+1
+1
+1
+1
+5
+-7
+42
+-3
+-2
+16
+-16
+8
+14
+6
+-5
+-6
+1
+0
+
@@ -0,0 +1 @@
+-1 2404 40004 0 1010 
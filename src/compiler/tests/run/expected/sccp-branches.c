@@ -0,0 +1 @@
+0 10 5 -5 
@@ -0,0 +1 @@
+4 8 4 4 0 7 7 3000 0 
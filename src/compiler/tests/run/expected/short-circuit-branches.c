@@ -0,0 +1,24 @@
+0 8 0 32 512 0 0 0 1 
+0 4 0 32 256 0 0 128 1 
+2 8 0 32 512 0 0 128 1 
+2 4 0 32 256 0 0 128 1 
+2 8 0 0 256 0 1 128 0 
+2 4 16 0 256 0 1 128 0 
+3 4 16 32 256 0 1 128 0 
+3 4 16 0 256 64 1 128 0 
+0 3 1 -1206 
+0 3 1 -1005 
+0 3 1 -804 
+0 3 1 -603 
+0 3 1 -402 
+0 3 1 -201 
+0 3 1 0 
+1 3 1 100 
+102 103 2 200 
+303 103 3 603 
+604 106 4 703 
+1005 110 5 803 
+1506 115 5 903 
+2107 121 5 1003 
+2808 128 5 1103 
+
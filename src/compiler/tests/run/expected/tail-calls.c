@@ -0,0 +1 @@
+500500 0 21 12 
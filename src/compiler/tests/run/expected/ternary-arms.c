@@ -0,0 +1 @@
+-5 3 -2 6 12 -28 8 6 
@@ -0,0 +1 @@
+10 0 18 84 198 360 423 522 501 7 0 1 55 0 1093 
@@ -0,0 +1 @@
+296 63 0 40 0 35 0 0 3 
@@ -0,0 +1,11 @@
+6 1 0 1 10 80 15 5 1 
+-6 1 0 1 242 144 -21 -7 1 
+128 1 0 1 254 240 381 127 1 
+-127 1 0 1 0 0 -384 -128 1 
+45 1 0 1 88 192 900 44 1 
+1 1 0 1 0 0 0 0 1 
+113 1 0 1 224 0 13392 112 1 
+0 1 0 1 254 240 -3 -1 1 
+65 1 0 1 128 0 -76608 64 1 
+25 1 0 1 48 128 97608 24 1 
+
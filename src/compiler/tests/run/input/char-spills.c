@@ -0,0 +1,29 @@
+void syscall_print_int(int i);
+void syscall_print_string(char *s);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int mix(int a, int b) {
+  char ch;
+  int c, d, e, f, g, h, i, j, k, l, m, n, o, q, r, s, t, u, v, w;
+  ch = 20;
+  c = a + b; d = a - b; e = a * 3; f = b * 5; g = c + d; h = e - f;
+  i = g * 2; j = h + c; k = i - j; l = a + 7; m = b + 11; n = c + e;
+  o = d + f; q = g + h; r = i + l; s = j + m; t = k + n; u = o + q;
+  v = r + s; w = t + u;
+  if (!(4 <= ch)) p(12);
+  p(c + d + e + f + g + h + i + j + k + l);
+  p(m + n + o + q + r + s + t + u + v + w);
+  p(a + b + c + d + e + f + g + h + i + j + k + l + m + n + o + q + r + s + t + u + v + w);
+  p(ch);
+  return c + d + e + f + g + h + i + j + k + l + m + n + o + q + r + s + t + u + v + w + ch;
+}
+
+int main(void) {
+  p(mix(3, 4));
+  p(mix(-9, 2));
+  return 0;
+}
@@ -0,0 +1,37 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int common(int a, int b, int *q) {
+  int x, y, z;
+  x = a * b + a;
+  y = b * a + a;
+  *q = x;
+  z = a * b - (b + a);
+  return x + y + z + (a + b);
+}
+
+int reload(int *q, int a) {
+  int x, y;
+  x = a + *q;
+  *q = 1;
+  y = a + *q;
+  return x * 10 + y;
+}
+
+int main(void) {
+  int v;
+  v = 0;
+  p(common(3, 4, &v));
+  p(v);
+  p(common(-2, 7, &v));
+  p(v);
+  v = 5;
+  p(reload(&v, 2));
+  p(v);
+  return 0;
+}
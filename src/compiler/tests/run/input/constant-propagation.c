@@ -0,0 +1,35 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int fold(int n) {
+  int a, b, c, i;
+  a = 6;
+  b = a * 7;
+  c = b;
+  for (i = 0; i < n; i++) {
+    if (c > 40) a = a + 1;
+    else c = 0;
+  }
+  return a + b + c;
+}
+
+int copies(int x) {
+  int y, z;
+  y = x;
+  z = y;
+  if (z > 3) y = 3;
+  return y + z;
+}
+
+int main(void) {
+  p(fold(0));
+  p(fold(3));
+  p(copies(2));
+  p(copies(9));
+  return 0;
+}
@@ -0,0 +1,7 @@
+int syscall_print_int(int i); void syscall_print_string(char *s);
+int used, unused, other;
+int helper(int x) { return x + unused; }
+int dead(int x) { return helper(x) * 2; }
+int deadrec(int x) { if (x) return deadrec(x - 1); return 0; }
+int live(int x) { other = x; return other + used; }
+int main(void) { int r; used = 3; r = live(2); syscall_print_int(r); syscall_print_string("hi"); return 0; }
@@ -0,0 +1,41 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+void signed_division(int x) {
+  p(x / 3); p(x % 3);
+  p(x / 7); p(x % 7);
+  p(x / -5); p(x % -5);
+  p(x / 10); p(x % 10);
+  p(x / 641); p(x / 8); p(x % 8);
+  p(x / -16); p(x % -16);
+  p(x / 1000000007);
+  syscall_print_string("\n");
+}
+
+void unsigned_division(int x) {
+  unsigned int u;
+  u = x;
+  p(u / 3); p(u % 3);
+  p(u / 7); p(u % 7);
+  p(u / 10); p(u % 10);
+  p(u / 641); p(u / 16); p(u % 16);
+  p(u / 3000000000); p(u % 3000000000);
+  syscall_print_string("\n");
+}
+
+int main(void) {
+  signed_division(0); unsigned_division(0);
+  signed_division(-1); unsigned_division(-1);
+  signed_division(7); unsigned_division(7);
+  signed_division(-7); unsigned_division(-7);
+  signed_division(2147483647); unsigned_division(2147483647);
+  signed_division(-2147483647 - 1); unsigned_division(-2147483647 - 1);
+  signed_division(-999999); unsigned_division(-999999);
+  signed_division(123456789); unsigned_division(123456789);
+  return 0;
+}
@@ -0,0 +1,8 @@
+void syscall_print_int(int);
+void syscall_print_string(char*);
+void p(int v) { syscall_print_int(v); syscall_print_string(" "); }
+int h0(int x, int y) { return x - y * 3; }
+int h1(int x, int y) { if (x > y) return x; return y + 1; }
+int f0(int a, int b) { int c, d, i, j; c = -2; d = 2; if ((b > 1)) { i = 5; while (i > 0) { if (((a >> 1) && 3)) { d = ((0 / 5) << 1); c = (((c >= 100) * (5 | 0)) % 5); b = (h1((c << 3), 8) - (a + b)); } i = i - 1; } b = ((b | c) - (100 + (2 + 5))); c = (100 | ((b & d) + (b - c))); } i = 1; while (i > 0) { b = ((1 >> 1) | (c != (b >> 1))); i = i - 1; } d = ((a != b) >> 1); c = (((b && a) * (a & 255)) << 1); if ((10 >= (b - c))) { d = (((255 << 4) + (a + 1)) ^ ((d | a) ^ (100 / 3))); if (d) { for (i = 0; i < 7; i++) { c = (!(d / 16)); c = (b != (b | a)); } for (i = 0; i < 4; i++) { d = 8; } d = h1((c - (a <= d)), ((2 != a) + (-c))); } } p(a); p(b); p(c); p(d); return a + b + c + d; }
+int f1(int a, int b) { int c, d, i, j; c = 4; d = -2; a = ((b < h0(1000, 10)) % 16); a = (((b >= 255) / 5) << 1); d = ((a >= (7 * c)) <= (d + (b < d))); p(h0((c && b), (255 % 16))); p(a); p(b); p(c); p(d); return a + b + c + d; }
+int main(void) { p(f1(-11, 14)); p(f1(16, 11)); p(f0(6, 14)); return 0; }
@@ -0,0 +1,59 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int g;
+
+char lo(char c) {
+  return c;
+}
+
+int get(int *q) {
+  int r;
+  r = *q;
+  return r;
+}
+
+void set(int *q, int v) {
+  if (v < 0) return;
+  *q = v;
+}
+
+int twice(int x) {
+  return x + x;
+}
+
+int odd(int n);
+
+int even(int n) {
+  if (n == 0) return 1;
+  return odd(n - 1);
+}
+
+int odd(int n) {
+  if (n == 0) return 0;
+  return even(n - 1);
+}
+
+int main(void) {
+  int i, v;
+  v = 3;
+  set(&v, 0 - 5);
+  p(get(&v));
+  set(&v, 9);
+  p(get(&v));
+  p(twice(twice(v)));
+  p(lo(300));
+  p(even(7));
+  i = 0;
+  while (i < 3) {
+    g = g + twice(i);
+    i = i + 1;
+  }
+  p(g);
+  return 0;
+}
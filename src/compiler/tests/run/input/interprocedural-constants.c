@@ -0,0 +1,28 @@
+int syscall_print_int(int i); void syscall_print_string(char *s);
+void show(int v) { syscall_print_int(v); syscall_print_string(" "); }
+int work(int x, int flag, int unused, int mode) {
+  int r, k;
+  r = x;
+  for (k = 0; k < 3; k++) {
+    if (flag) r = r * 3 + k; else r = r + 1;
+    if (mode == 2) r = r - k; else if (mode == 5) r = r ^ 7; else r = r + mode;
+    if (r > 1000) r = r - 999;
+    if (r < -1000) r = r + 999;
+  }
+  return r;
+}
+int rec(int n, int step) { if (n <= 0) return 0; return n + rec(n - step, step); }
+int same(char c, int d) { return c + d; }
+int a1(int i) { return work(i, 1, i * 7, 2); }
+int a2(int i) { return work(i, 1, 0, 5); }
+int a3(int i) { return work(i, 1, i, i); }
+int main(void) {
+  int i, s;
+  s = 0;
+  for (i = 0; i < 6; i++) { s = s + a1(i); s = s + work(i, 1, 3, 2); }
+  show(s);
+  show(a2(4)); show(a3(9)); show(a3(-4));
+  show(rec(10, 1)); show(rec(12, 3));
+  show(same(3, 4)); show(same(3, 9));
+  return 0;
+}
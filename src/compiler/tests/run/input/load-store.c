@@ -0,0 +1,58 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int g;
+int h;
+int ga[4];
+
+void bump(int *q) {
+  *q = *q + 1;
+}
+
+int f(int *q, int *r) {
+  int t;
+  *q = 1;
+  *r = 2;
+  t = *q;
+  return t;
+}
+
+int main(void) {
+  int a[5];
+  int x, y, s;
+  int *q;
+  a[0] = 3;
+  a[1] = 4;
+  a[2] = a[0] + a[1];
+  p(a[2]);
+  g = 5;
+  h = 6;
+  g = g + h;
+  p(g);
+  g = 7;
+  p(g);
+  x = 1;
+  q = &x;
+  *q = 9;
+  y = x;
+  p(y);
+  bump(&x);
+  p(x);
+  p(f(&x, &x));
+  p(f(&x, &y));
+  q = a;
+  q[3] = 10;
+  q[4] = 11;
+  s = a[3] + q[4];
+  p(s);
+  ga[1] = 5;
+  q = ga;
+  *(q + 1) = 6;
+  p(ga[1]);
+  return 0;
+}
@@ -0,0 +1,44 @@
+/* -O 1 -passes=mem2reg,licm; -O 1 -passes=mem2reg,fixpoint(constprop,sccp),licm,dce */
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int f(int a, int b, int n) {
+  int i, s;
+  s = 0;
+  for (i = 0; i < n; i++) s = s + a * b;
+  return s;
+}
+
+int arm(int a, int b, int n) {
+  int i, s, t;
+  s = 0;
+  t = 1;
+  for (i = 0; i < n; i++) {
+    if (i > 2) t = a * b;
+    s = s + t;
+  }
+  return s;
+}
+
+int nest(int a, int n) {
+  int i, j, s;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) s = s + (a + 3) * (i + 1);
+  }
+  return s;
+}
+
+int main(void) {
+  p(f(2, 3, 4));
+  p(f(2, 3, 0));
+  p(arm(5, 6, 2));
+  p(arm(5, 6, 7));
+  p(nest(1, 3));
+  return 0;
+}
@@ -0,0 +1,25 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+void products(int x) {
+  unsigned int u;
+  u = x;
+  p(x * 3); p(x * 5); p(x * 10); p(x * 15);
+  p(x * 31); p(x * 100); p(x * -9); p(x * -64);
+  p(x * 1000000); p(x * 2147483647); p(u * 7);
+  syscall_print_string("\n");
+}
+
+int main(void) {
+  products(0);
+  products(1);
+  products(-3);
+  products(12345);
+  products(-2147483647 - 1);
+  return 0;
+}
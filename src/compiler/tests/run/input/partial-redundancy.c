@@ -0,0 +1,30 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int partial(int a, int b, int c) {
+  int x;
+  x = 0;
+  if (c > 0) x = a + b;
+  else a = a + 1;
+  return x + (a + b);
+}
+
+int invariant(int a, int b, int n) {
+  int s, i;
+  s = 0;
+  for (i = 0; i < n; i++) s = s + (a - b) * 2;
+  return s;
+}
+
+int main(void) {
+  p(partial(2, 3, 1));
+  p(partial(2, 3, 0));
+  p(invariant(9, 4, 0));
+  p(invariant(9, 4, 6));
+  return 0;
+}
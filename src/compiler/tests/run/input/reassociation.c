@@ -0,0 +1,26 @@
+int syscall_print_int(int i); void syscall_print_string(char *s);
+int chain(int a, int b) { return a + 1 + b + 2; }
+int chain2(int a, int b) { return 2 + b + 1 + a; }
+int subs(int a, int b, int c) { return 5 - a - (b - 3) + c - c; }
+int negs(int a, int b) { return -a - b - 7; }
+int prods(int a, int b) { return 3 * a * 4 * b; }
+int bits(int a, int b) { int s; s = (a & 255) & b & 15; s = s | (a ^ b ^ a); return s | (8 | b); }
+int shl(int x) { return (x << 2) << 3; }
+int shr(int x) { return (x >> 20) >> 20; }
+int shru(int x) { unsigned int u; u = x; u = (u >> 20) >> 20; return u; }
+int shl2(int x) { return (x << 20) << 20; }
+int both(int a, int b) { int s; int t; s = a + b + 1; t = b + 1 + a; return s * t; }
+int big(int a) { return a + 2147483647 + 10; }
+void show(int v) { syscall_print_int(v); syscall_print_string(" "); }
+void show1(int i) {
+  show(chain(i, 7)); show(chain2(i, 7)); show(subs(i, 9, i * 3)); show(negs(i, 2)); show(prods(i, 5)); show(bits(i * 37, 29));
+}
+void show2(int i) {
+  show(shl(i)); show(shr(i * 100000000)); show(shru(i * 100000000)); show(shl2(i)); show(both(i, 4)); show(big(i));
+  syscall_print_string("\n");
+}
+int main(void) {
+  int i;
+  for (i = -3; i < 4; i++) { show1(i); show2(i); }
+  return 0;
+}
@@ -0,0 +1,30 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+void bump(int *q) {
+  *q = *q + 1;
+}
+
+int locals(int n) {
+  int a, b, c, i;
+  a = 0;
+  b = 1;
+  for (i = 0; i < n; i++) {
+    c = a + b;
+    a = b;
+    b = c;
+  }
+  bump(&c);
+  return a * 1000 + c;
+}
+
+int main(void) {
+  p(locals(1));
+  p(locals(10));
+  return 0;
+}
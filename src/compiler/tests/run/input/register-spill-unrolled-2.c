@@ -0,0 +1,8 @@
+void syscall_print_int(int);
+void syscall_print_string(char*);
+void p(int v) { syscall_print_int(v); syscall_print_string(" "); }
+int h0(int x, int y) { return x - y * 3; }
+int h1(int x, int y) { if (x > y) return x; return y + 1; }
+int f0(int a, int b) { int c, d, i, j; c = 4; d = 4; for (i = 0; i < 2; i++) { b = (-(c - 255)); if (2) { j = 6; while (j > 0) { d = (((d % 5) == (a ^ 100)) != ((b % 16) != (c && 16))); c = (d >> 2); j = j - 1; } } j = 5; while (j > 0) { d = (((10 - d) ^ (c < c)) && c); if (h0((a > a), (5 << 2))) { a = (a < ((5 / 3) >= (a != c))); } j = j - 1; } } c = (((3 || 0) % 16) || ((b != 100) < c)); c = ((0 * (10 <= d)) >= ((0 - 2) <= 8)); c = 10; p(a); p(b); p(c); p(d); return a + b + c + d; }
+int f1(int a, int b) { int c, d, i, j; c = 2; d = 1; c = c; b = ((!c) == 3); b = ((0 && (2 - c)) == (c <= 0)); a = a; p((c ^ (5 - d))); p(a); p(b); p(c); p(d); return a + b + c + d; }
+int main(void) { p(f1(-11, -11)); p(f1(-1, -20)); p(f0(14, -4)); return 0; }
@@ -0,0 +1,7 @@
+void syscall_print_int(int);
+void syscall_print_string(char*);
+void p(int v) { syscall_print_int(v); syscall_print_string(" "); }
+int h0(int x, int y) { return x - y * 3; }
+int h1(int x, int y) { if (x > y) return x; return y + 1; }
+int f0(int a, int b) { int c, d, i, j; c = 4; d = 1; d = ((8 > (c + b)) || ((255 + d) + (b ^ d))); if ((!c)) { a = c; } else { i = 5; while (i > 0) { if (((d << 4) > (d - b))) { c = a; d = (((d >> 2) <= 0) + ((16 % 10) % -3)); } else { a = (((a > c) / -3) / -3); d = (((c >> 4) + (b == c)) & a); } a = (100 != 2); i = i - 1; } b = (-((a || 7) && (5 > b))); } p(a); p(b); p(c); p(d); return a + b + c + d; }
+int main(void) { p(f0(-6, -19)); p(f0(-11, -18)); p(f0(8, 12)); return 0; }
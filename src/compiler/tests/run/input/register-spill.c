@@ -0,0 +1,9 @@
+void syscall_print_int(int);
+void syscall_print_string(char*);
+void p(int v) { syscall_print_int(v); syscall_print_string(" "); }
+int h0(int x, int y) { return x - y * 3; }
+int h1(int x, int y) { if (x > y) return x; return y + 1; }
+int f0(int a, int b) { int c, d, i, j; c = 0; d = -5; if (255) { if (((3 + d) & (b % -3))) { for (i = 0; i < 4; i++) { a = (((a != c) & 3) >= ((a > b) & (1 <= 255))); a = (((3 == a) > 255) != (!(16 <= 2))); d = d; } d = d; d = (((b ^ c) <= (16 < 100)) / 10); } else { c = (((!b) != (10 || 255)) ^ d); for (i = 0; i < 4; i++) { d = (((a >> 2) <= a) < ((a || b) & (16 >> 4))); b = 2; } } for (i = 0; i < 3; i++) { a = (((a && b) - (255 * d)) + ((b - d) + (c && a))); j = 2; while (j > 0) { a = c; d = (100 & ((0 < 1000) % 7)); j = j - 1; } for (j = 0; j < 5; j++) { a = (((16 - b) || (1000 - 100)) - (h0(b, b) == (d + 7))); } } i = 4; while (i > 0) { b = (-(2 & d)); a = a; i = i - 1; } } if ((d >> 2)) { for (i = 0; i < 4; i++) { if ((a - h0(0, d))) { c = ((-(-100)) > c); a = (-1); a = h1(((1 + d) - (c * 2)), (d < (-c))); } else { b = ((a << 2) + d); d = d; } } d = (((255 <= 0) != (100 < b)) + (b * (d - c))); i = 4; while (i > 0) { j = 5; while (j > 0) { a = b; j = j - 1; } j = 4; while (j > 0) { a = a; j = j - 1; } i = i - 1; } } else { b = 255; d = ((b >> 3) && ((0 * 255) >= d)); } p(a); p(b); p(c); p(d); return a + b + c + d; }
+int f1(int a, int b) { int c, d, i, j; c = 2; d = 0; a = ((c & (a || b)) >> 1); p(((10 || 1000) - b)); p(a); p(b); p(c); p(d); return a + b + c + d; }
+int f2(int a, int b) { int c, d, i, j; c = -5; d = -4; i = 6; while (i > 0) { c = h0(((d >> 3) == 0), ((5 - c) << 2)); for (j = 0; j < 2; j++) { c = (b & ((a + a) % -3)); p(b); if (((c / -3) || c)) { a = ((-255) % -3); a = 10; } else { c = (8 * h0((d <= c), 0)); } } i = i - 1; } for (i = 0; i < 8; i++) { c = (b + ((1000 || 2) + (0 - c))); j = 5; while (j > 0) { if (((2 && b) >= (100 - 100))) { b = ((a ^ (c - c)) == ((c & a) ^ (5 << 4))); d = (((a && d) ^ a) < (-1000)); c = (((a | 255) || c) < ((d != 0) >> 3)); } else { c = b; } a = (((d >= 7) % 7) || 3); j = j - 1; } } i = 2; while (i > 0) { d = ((-(a > b)) & ((a - a) / 5)); b = (((b >= a) << 2) + ((a - 8) % -3)); i = i - 1; } i = 5; while (i > 0) { for (j = 0; j < 8; j++) { if ((b || (!c))) { d = (1000 && ((7 >= c) - (c <= d))); a = 5; } else { c = a; } if (5) { c = (1000 - ((a + 100) >> 2)); d = (((d << 1) >= b) + (100 == (b <= 2))); d = 16; } else { c = (((d >= 16) << 2) == d); d = c; } if ((3 < b)) { b = ((h0(2, 10) <= (!c)) - 8); b = h0(((-a) + c), ((c == c) + (c != c))); d = (1000 != a); } else { c = 3; } } i = i - 1; } p(a); p(b); p(c); p(d); return a + b + c + d; }
+int main(void) { p(f1(-10, -7)); p(f0(-14, 17)); p(f0(20, -20)); return 0; }
@@ -0,0 +1,64 @@
+int syscall_print_int(int i);
+void syscall_print_string(char *s);
+void show(int v) {
+  syscall_print_int(v); syscall_print_string("\n");
+}
+int arith(int x) {
+  int a; int b; unsigned int u;
+  u = x;
+  a = x + 0; show(a);
+  a = 0 + x; show(a);
+  a = x - 0; show(a);
+  a = x - x; show(a);
+  a = x * 0; show(a);
+  a = 0 * x; show(a);
+  a = x * 1; show(a);
+  a = 7 * x; show(a);
+  a = x / 1; show(a);
+  a = x / -1; show(a);
+  a = x % 1; show(a);
+  a = x % -1; show(a);
+  a = x / 7; show(a);
+  a = x % 7; show(a);
+  b = u % 8; show(b);
+  b = u / 8; show(b);
+  return 0;
+}
+int bits(int x) {
+  int a; unsigned int u;
+  u = x;
+  a = x << 0; show(a);
+  a = 0 << x; show(a);
+  a = -1 >> x; show(a);
+  a = x & 0; show(a);
+  a = x & -1; show(a);
+  a = x & x; show(a);
+  a = x | 0; show(a);
+  a = x | -1; show(a);
+  a = x | x; show(a);
+  a = x ^ 0; show(a);
+  a = x ^ -1; show(a);
+  a = x ^ x; show(a);
+  a = 0 ^ x; show(a);
+  return 0;
+}
+int cmps(int x) {
+  unsigned int u;
+  u = x;
+  show(x == x); show(x != x); show(x < x); show(x <= x); show(x > x); show(x >= x);
+  show(u < 0); show(u >= 0); show(0 > u); show(0 <= u);
+  show(3 < 5); show(-3 < 5); show(5 >= 5); show(7 == 7); show(7 != 8);
+  return 0;
+}
+int folds(int x) {
+  show(2 + 3); show(2 - 9); show(6 * 7); show(-17 / 5); show(-17 % 5); show(1 << 4); show(-64 >> 2);
+  show(12 & 10); show(12 | 10); show(12 ^ 10); show(-5); show(~5); show(!0); show(!7);
+  return 0;
+}
+int main(void) {
+  arith(23); arith(-23);
+  bits(5); bits(-9);
+  cmps(4);
+  folds(3);
+  return 0;
+}
@@ -0,0 +1,43 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int loops(int n) {
+  int i, s;
+  s = 0;
+  i = 0;
+  while (i < n) {
+    i++;
+    if (i == 3) continue;
+    if (i > 7) break;
+    s = s + i;
+  }
+  do {
+    s = s * 2;
+    i--;
+  } while (i > 4);
+  return s * 100 + i;
+}
+
+int rare(int n) {
+  int i, s;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    if (i == n - 1) s = s + 1000;
+    else s = s + i;
+  }
+  return s;
+}
+
+int main(void) {
+  p(loops(0));
+  p(loops(5));
+  p(loops(12));
+  p(rare(0));
+  p(rare(6));
+  return 0;
+}
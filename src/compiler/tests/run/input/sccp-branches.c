@@ -0,0 +1,41 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int never(int n) {
+  int x, y;
+  x = 1;
+  y = 0;
+  while (n > 0) {
+    if (x != 1) {
+      y = y + 100;
+      x = 2;
+    } else {
+      y = y + 2;
+    }
+    n--;
+  }
+  if (x == 1) return y;
+  return -1;
+}
+
+int decided(int a) {
+  int k;
+  k = 4;
+  if (k * 2 == 8) a = a + k;
+  else a = a - k;
+  while (k < 0) a = a * 3;
+  return a;
+}
+
+int main(void) {
+  p(never(0));
+  p(never(5));
+  p(decided(1));
+  p(decided(-9));
+  return 0;
+}
@@ -0,0 +1,38 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int choose(int c, int a, int b) {
+  int x;
+  if (c) x = a + 1;
+  else x = b * 2;
+  return x;
+}
+
+int clamp(int a) {
+  int x;
+  x = 0;
+  if (a > 5) x = a - 5;
+  return x;
+}
+
+int distance(int a, int b) {
+  return a < b ? b - a : a - b;
+}
+
+int main(void) {
+  p(choose(1, 3, 4));
+  p(choose(0, 3, 4));
+  p(choose(-1, 3, 4));
+  p(clamp(9));
+  p(clamp(2));
+  p(distance(3, 10));
+  p(distance(10, 3));
+  p(distance(-1000, 2000));
+  p(distance(-7, -7));
+  return 0;
+}
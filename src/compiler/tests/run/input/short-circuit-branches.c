@@ -0,0 +1,30 @@
+int syscall_print_int(int i); void syscall_print_string(char *s);
+int side(int *calls, int v) { *calls = *calls + 1; return v; }
+void show(int v) { syscall_print_int(v); syscall_print_string(" "); }
+int t1(int a, int b, int c) { int r; r = 0; if (a && b) r = r + 1; if (a || b) r = r + 2; return r; }
+int t2(int a, int b, int c) { int r; r = 0; if ((a && b) || c) r = r + 4; else r = r + 8; return r; }
+int t3(int a, int b, int c) { int r; r = 0; if (a && (b || c)) r = r + 16; return r; }
+int t4(int a, int b, int c) { int r; r = 0; if (!a || (b && !c)) r = r + 32; return r; }
+int t5(int *calls, int a, int b, int c) { int r; r = 0; if (a && side(calls, b) > 0 && c) r = 64; return r; }
+int t6(int *calls, int a, int b, int c) { int r; r = 0; if (a || side(calls, b) > 0 || c) r = 128; return r; }
+int t7(int a, int b, int c) { return (a || c) ? 256 : 512; }
+int l1(int n) { int i, s; s = 0; i = 0; while (i < n && s < 40) { s = s + i; i++; if (s > 30 && i > 3) break; } return s * 100 + i; }
+int l2(int n) { int j, s; s = 0; for (j = 0; j < n || j < 3; j++) { if (j == 2 && n > 1) s = s + 100; s = s + j; } return s; }
+int l3(int n) { int j, s; s = 0; j = 0; do { j++; s = s + 1; } while (j < n && j < 5 || j == 7); return s; }
+int l4(int n) { int i, s; s = n * 2; i = n; while ((i > 0 || i == -5) && (s > 0 && i != 3)) { i--; s = s - 1; } return s * 100 + i; }
+void row1(int a, int b, int c) { show(t1(a, b, c)); show(t2(a, b, c)); show(t3(a, b, c)); show(t4(a, b, c)); show(t7(a, b, c)); }
+void row2(int a, int b, int c) {
+  int calls;
+  calls = 0;
+  show(t5(&calls, a, b, c)); show(calls);
+  calls = 0;
+  show(t6(&calls, a, b, c)); show(calls);
+  syscall_print_string("\n");
+}
+void row3(int a) { show(l1(a)); show(l2(a)); show(l3(a)); show(l4(a)); syscall_print_string("\n"); }
+int main(void) {
+  int a, b, c;
+  for (a = 0; a < 2; a++) for (b = 0; b < 2; b++) for (c = 0; c < 2; c++) { row1(a, b, c); row2(a, b, c); }
+  for (a = -6; a < 9; a++) row3(a);
+  return 0;
+}
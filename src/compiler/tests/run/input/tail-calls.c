@@ -0,0 +1,37 @@
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int sum(int n, int acc) {
+  if (n == 0) return acc;
+  return sum(n - 1, acc + n);
+}
+
+int odd(int n);
+
+int even(int n) {
+  if (n == 0) return 1;
+  return odd(n - 1);
+}
+
+int odd(int n) {
+  if (n == 0) return 0;
+  return even(n - 1);
+}
+
+int swap(int a, int b, int n) {
+  if (n == 0) return a * 10 + b;
+  return swap(b, a, n - 1);
+}
+
+int main(void) {
+  p(sum(1000, 0));
+  p(even(2001));
+  p(swap(1, 2, 3));
+  p(swap(1, 2, 4));
+  return 0;
+}
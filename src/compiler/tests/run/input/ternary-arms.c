@@ -0,0 +1,35 @@
+void syscall_print_int(int i);
+void syscall_print_string(char *s);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int negated(int c, int a) {
+  return (c ? -5 : a + 0) * 1;
+}
+
+int shifted(int c, int a) {
+  return (c ? -5 : a + 0) + 3;
+}
+
+int scaled(int c, int a) {
+  return (c ? a - 0 : -7) * 4;
+}
+
+int constant(int c, int a) {
+  return (c ? 5 : a) + 3;
+}
+
+int main(void) {
+  p(negated(1, 3));
+  p(negated(0, 3));
+  p(shifted(1, 3));
+  p(shifted(0, 3));
+  p(scaled(1, 3));
+  p(scaled(0, 3));
+  p(constant(1, 3));
+  p(constant(0, 3));
+  return 0;
+}
@@ -0,0 +1,51 @@
+/* -O 1 -funroll-loops; -O 2 -funroll-loops -unroll-factor 2; -O 2 -funroll-loops -unroll-factor 5 */
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int triangle(int n) {
+  int i, s;
+  s = 0;
+  for (i = 1; i <= n; i = i + 1) s = s + i;
+  return s;
+}
+
+int powers(int n) {
+  int i, x, s;
+  x = 1;
+  s = 0;
+  for (i = 0; i < n; i++) {
+    s = s + x;
+    x = x * 3;
+  }
+  return s;
+}
+
+int main(void) {
+  int i, j, t;
+  t = 0;
+  for (i = 0; i < 5; i = i + 1) t = t + i;
+  p(t);
+  for (j = 0; j <= 17; j = j + 4) {
+    t = 0;
+    for (i = 0; i < j; i = i + 1) t = t + i * 3;
+    p(t);
+  }
+  for (i = 0; i < 20; i = i + 3) t = t + i;
+  p(t);
+  for (i = 19; i >= 2; i = i - 2) t = t + i;
+  p(t);
+  for (i = 0; i != 7; i = i + 1) t = t - i;
+  p(t);
+  p(i);
+  p(triangle(0));
+  p(triangle(1));
+  p(triangle(10));
+  p(powers(0));
+  p(powers(7));
+  return 0;
+}
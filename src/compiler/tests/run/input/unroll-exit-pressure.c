@@ -0,0 +1,25 @@
+/* -O 2 -funroll-loops -unroll-factor 3; -O 2 -funroll-loops -unroll-factor 8 */
+void syscall_print_int(int);
+void syscall_print_string(char *);
+
+void p(int v) {
+  syscall_print_int(v);
+  syscall_print_string(" ");
+}
+
+int g(int a, int b) {
+  int r;
+  r = 0;
+  while (a > 0 && b > 0) { a--; b--; r = r + 8; }
+  p(r);
+  p(a);
+  p(b);
+  return r;
+}
+
+int main(void) {
+  g(100, 37);
+  g(5, 40);
+  g(0, 3);
+  return 0;
+}
@@ -0,0 +1,20 @@
+int syscall_print_int(int i); void syscall_print_string(char *s);
+void show(int v) { syscall_print_int(v); syscall_print_string(" "); }
+int widen(int k) { char c; int i; c = k; i = c; return i + 1; }
+int cmp(int k) { char c; c = k; if (c < 200) return 1; return 0; }
+int cmp2(int k) { char c; c = k; return c == 300; }
+int cmps(int k) { short s; s = k; return s > -40000; }
+int mask(int k) { char c; int x; c = k; x = c & 127; return (x & 255) + (x | 0); }
+int mask2(int k) { char c; int x; c = k; x = (c & 15) << 4; return (x & 240) | (x & 15); }
+int shorts(int k) { short s; int i; s = k; i = s; return i * 3; }
+int casts(int k) { char c; short s; c = k; s = c; return s; }
+int rem(int k) { int x; x = (k & 1023) % 10; return x < 10; }
+void row(int k) {
+  show(widen(k)); show(cmp(k)); show(cmp2(k)); show(cmps(k)); show(mask(k)); show(mask2(k));
+  show(shorts(k)); show(casts(k)); show(rem(k * 1000));
+  syscall_print_string("\n");
+}
+int main(void) {
+  row(5); row(-7); row(127); row(-128); row(300); row(0); row(70000); row(-1); row(40000); row(-33000);
+  return 0;
+}
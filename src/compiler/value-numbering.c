@@ -0,0 +1,418 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "value-numbering.h"
+
+/********
+ * KEYS *
+ ********/
+
+enum value_numbering_operand_kind {
+	VALUE_NUMBERING_TEMPORARY,
+	VALUE_NUMBERING_CONSTANT,
+	VALUE_NUMBERING_VARIABLE,
+	VALUE_NUMBERING_STRING
+};
+
+/* what a value is computed from: the opcode and the value numbers of its operands */
+struct value_numbering_key {
+	enum ir_instruction_kind kind;
+	int operand_count;
+	enum value_numbering_operand_kind operand_kinds[2];
+	uint32_t operand_values[2];
+	const char *name;                       /* label of a string literal */
+};
+
+#define VALUE_NUMBERING_NOT_A_LOAD (-2)
+#define VALUE_NUMBERING_POINTER_LOAD (-1)
+
+struct value_numbering_entry {
+	struct value_numbering_key key;
+	int block;                              /* the table is emptied by moving to another block */
+	int temporary;
+	int variable;                           /* the variable a load reads, or one of the two above */
+	int clock;                              /* when the value was computed */
+};
+
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+static int *replacements;                       /* temporary -> the earlier temporary holding its value */
+
+static int max_variable;
+static bool *escapes;                           /* variable -> pointer stores and calls may write it */
+static int *variable_clocks;                    /* variable -> when it was last stored to */
+static int pointer_clock;                       /* when anything was last stored to */
+static int unknown_clock;                       /* when some escaping variable may last have been written */
+
+static struct value_numbering_entry *entries;
+static int capacity;
+
+static bool value_numbering_is_temporary(struct ir_operand *operand) {
+	return OPERAND_TEMPORARY == operand->kind && operand->data.temporary <= max_temporary;
+}
+
+static bool value_numbering_is_load(struct ir_instruction *instruction) {
+	return (
+		IR_LOAD_WORD == instruction->kind ||
+		IR_LOAD_HALF_WORD == instruction->kind ||
+		IR_LOAD_SIGNED_HALF_WORD == instruction->kind ||
+		IR_LOAD_BYTE == instruction->kind ||
+		IR_LOAD_SIGNED_BYTE == instruction->kind
+	);
+}
+
+static bool value_numbering_is_store(struct ir_instruction *instruction) {
+	return (
+		IR_STORE_WORD == instruction->kind ||
+		IR_STORE_HALF_WORD == instruction->kind ||
+		IR_STORE_BYTE == instruction->kind
+	);
+}
+
+static bool value_numbering_is_commutative(enum ir_instruction_kind kind) {
+	switch (kind) {
+		case IR_MULT_SIGNED_WORD:
+		case IR_MULT_UNSIGNED_WORD:
+		case IR_MULT_HIGH_SIGNED_WORD:
+		case IR_MULT_HIGH_UNSIGNED_WORD:
+		case IR_ADD_SIGNED_WORD:
+		case IR_ADD_UNSIGNED_WORD:
+		case IR_EQ_WORD:
+		case IR_NE_WORD:
+		case IR_BITWISE_AND_WORD:
+		case IR_BITWISE_XOR_WORD:
+		case IR_BITWISE_OR_WORD:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* the variable a load or store accesses, -1 if it goes through a pointer */
+static int value_numbering_variable(struct ir_instruction *instruction) {
+	struct ir_instruction *address = instruction->offset_variable;
+
+	if (NULL == address) {
+		struct ir_operand *operand = &instruction->operands[value_numbering_is_store(instruction) ? 0 : 1];
+		if (!value_numbering_is_temporary(operand)) return -1;
+
+		struct ir_list *definition = temporary_definitions[operand->data.temporary];
+		if (NULL == definition) return -1;
+		address = definition->data;
+	}
+
+	if (IR_ADDRESS_OF != address->kind || address->operands[2].data.is_string) return -1;
+	return address->operands[3].data.variable_id;
+}
+
+static int value_numbering_replacement(int temporary) {
+	while (replacements[temporary] != temporary) temporary = replacements[temporary];
+	return temporary;
+}
+
+static void value_numbering_replace_uses(struct ir_instruction *instruction) {
+	for (int i = 0; i < ir_use_count(instruction); i++) {
+		struct ir_operand *use = ir_use_operand(instruction, i);
+		if (value_numbering_is_temporary(use)) {
+			use->data.temporary = value_numbering_replacement(use->data.temporary);
+		}
+	}
+}
+
+/* constants are numbered by their value, so two constInts of 4 are the same operand */
+static bool value_numbering_operand(
+	struct ir_operand *operand, enum value_numbering_operand_kind *kind, uint32_t *value
+) {
+	if (!value_numbering_is_temporary(operand)) return false;
+
+	struct ir_list *definition = temporary_definitions[operand->data.temporary];
+	if (NULL != definition && IR_CONST_INT == definition->data->kind) {
+		*kind = VALUE_NUMBERING_CONSTANT;
+		*value = (uint32_t)definition->data->operands[1].data.number;
+	} else {
+		*kind = VALUE_NUMBERING_TEMPORARY;
+		*value = (uint32_t)operand->data.temporary;
+	}
+	return true;
+}
+
+static bool value_numbering_make_key(struct ir_instruction *instruction, struct value_numbering_key *key, int *variable) {
+	memset(key, 0, sizeof(struct value_numbering_key));
+	key->kind = instruction->kind;
+	*variable = VALUE_NUMBERING_NOT_A_LOAD;
+
+	if (IR_ADDRESS_OF == instruction->kind) {
+		key->operand_count = 1;
+		if (instruction->operands[2].data.is_string) {
+			key->operand_kinds[0] = VALUE_NUMBERING_STRING;
+			key->name = instruction->operands[1].data.name;
+		} else {
+			key->operand_kinds[0] = VALUE_NUMBERING_VARIABLE;
+			key->operand_values[0] = (uint32_t)instruction->operands[3].data.variable_id;
+		}
+		return true;
+	}
+
+	if (value_numbering_is_load(instruction)) {
+		key->operand_count = 1;
+		*variable = value_numbering_variable(instruction);
+		if (*variable >= 0) {
+			key->operand_kinds[0] = VALUE_NUMBERING_VARIABLE;
+			key->operand_values[0] = (uint32_t)*variable;
+			return true;
+		}
+		*variable = VALUE_NUMBERING_POINTER_LOAD;
+		return value_numbering_operand(&instruction->operands[1], &key->operand_kinds[0], &key->operand_values[0]);
+	}
+
+	if (!dataflow_is_expression(instruction)) return false;
+
+	key->operand_count = ir_use_count(instruction);
+	assert(key->operand_count <= 2);
+	for (int i = 0; i < key->operand_count; i++) {
+		if (!value_numbering_operand(ir_use_operand(instruction, i), &key->operand_kinds[i], &key->operand_values[i])) {
+			return false;
+		}
+	}
+
+	/* a > b is b < a and a >= b is b <= a */
+	bool swap = false;
+	switch (instruction->kind) {
+		case IR_GT_SIGNED_WORD: key->kind = IR_LT_SIGNED_WORD; swap = true; break;
+		case IR_GT_UNSIGNED_WORD: key->kind = IR_LT_UNSIGNED_WORD; swap = true; break;
+		case IR_GE_SIGNED_WORD: key->kind = IR_LE_SIGNED_WORD; swap = true; break;
+		case IR_GE_UNSIGNED_WORD: key->kind = IR_LE_UNSIGNED_WORD; swap = true; break;
+		default: break;
+	}
+
+	/* commutative operands go in (kind, value) order */
+	if (value_numbering_is_commutative(instruction->kind) && 2 == key->operand_count) {
+		swap =
+			key->operand_kinds[0] > key->operand_kinds[1] ||
+			(key->operand_kinds[0] == key->operand_kinds[1] && key->operand_values[0] > key->operand_values[1]);
+	}
+
+	if (swap) {
+		enum value_numbering_operand_kind kind = key->operand_kinds[0];
+		uint32_t value = key->operand_values[0];
+		key->operand_kinds[0] = key->operand_kinds[1];
+		key->operand_values[0] = key->operand_values[1];
+		key->operand_kinds[1] = kind;
+		key->operand_values[1] = value;
+	}
+	return true;
+}
+
+/*********
+ * TABLE *
+ *********/
+
+static unsigned int value_numbering_hash(struct value_numbering_key *key) {
+	unsigned int hash = (unsigned int)key->kind * 2654435761u;
+	for (int i = 0; i < key->operand_count; i++) {
+		hash = (hash ^ (unsigned int)key->operand_kinds[i]) * 16777619u;
+		hash = (hash ^ key->operand_values[i]) * 16777619u;
+	}
+	if (NULL != key->name) {
+		for (const char *c = key->name; '\0' != *c; c++) hash = (hash ^ (unsigned char)*c) * 16777619u;
+	}
+	return hash;
+}
+
+static bool value_numbering_same_key(struct value_numbering_key *key_1, struct value_numbering_key *key_2) {
+	if (key_1->kind != key_2->kind || key_1->operand_count != key_2->operand_count) return false;
+	for (int i = 0; i < key_1->operand_count; i++) {
+		if (key_1->operand_kinds[i] != key_2->operand_kinds[i]) return false;
+		if (key_1->operand_values[i] != key_2->operand_values[i]) return false;
+	}
+	if (NULL != key_1->name || NULL != key_2->name) {
+		return NULL != key_1->name && NULL != key_2->name && 0 == strcmp(key_1->name, key_2->name);
+	}
+	return true;
+}
+
+/* the slot holding the key in this block, or the empty slot it would go in */
+static struct value_numbering_entry *value_numbering_find(struct value_numbering_key *key, int block) {
+	unsigned int slot = value_numbering_hash(key) & (capacity - 1);
+
+	while (entries[slot].block == block) {
+		if (value_numbering_same_key(&entries[slot].key, key)) break;
+		slot = (slot + 1) & (capacity - 1);
+	}
+	return &entries[slot];
+}
+
+/* a loaded value is stale once a store or call in between may have written its memory */
+static bool value_numbering_is_valid(struct value_numbering_entry *entry) {
+	if (VALUE_NUMBERING_NOT_A_LOAD == entry->variable) return true;
+	if (VALUE_NUMBERING_POINTER_LOAD == entry->variable) return entry->clock > pointer_clock;
+
+	if (entry->clock <= variable_clocks[entry->variable]) return false;
+	return !escapes[entry->variable] || entry->clock > unknown_clock;
+}
+
+/**********
+ * MEMORY *
+ **********/
+
+/* a variable escapes when its address is used as anything but the address of a load or store */
+static void value_numbering_find_escapes(struct cfg *cfg) {
+	struct ir_list *iter;
+
+	max_variable = 0;
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *address = NULL != iter->data->offset_variable ? iter->data->offset_variable : iter->data;
+		if (IR_ADDRESS_OF == address->kind && !address->operands[2].data.is_string) {
+			int variable = address->operands[3].data.variable_id;
+			if (variable > max_variable) max_variable = variable;
+		}
+		if (iter == cfg->proc_end) break;
+	}
+
+	escapes = calloc(max_variable + 1, sizeof(bool));
+	variable_clocks = calloc(max_variable + 1, sizeof(int));
+	assert(NULL != escapes && NULL != variable_clocks);
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_instruction *instruction = iter->data;
+
+		/* globals can be written by any call */
+		struct ir_instruction *address = NULL != instruction->offset_variable ? instruction->offset_variable : instruction;
+		if (IR_ADDRESS_OF == address->kind && !address->operands[2].data.is_string && 0 != address->operands[6].data.number) {
+			escapes[address->operands[3].data.variable_id] = true;
+		}
+
+		for (int i = 0; i < ir_use_count(instruction); i++) {
+			struct ir_operand *use = ir_use_operand(instruction, i);
+			if (!value_numbering_is_temporary(use)) continue;
+
+			struct ir_list *definition = temporary_definitions[use->data.temporary];
+			if (NULL == definition || IR_ADDRESS_OF != definition->data->kind) continue;
+			if (definition->data->operands[2].data.is_string) continue;
+
+			bool is_address =
+				(value_numbering_is_load(instruction) && use == &instruction->operands[1]) ||
+				(value_numbering_is_store(instruction) && use == &instruction->operands[0]);
+			if (!is_address) {
+				escapes[definition->data->operands[3].data.variable_id] = true;
+			}
+		}
+		if (iter == cfg->proc_end) break;
+	}
+}
+
+static void value_numbering_clobber(struct ir_instruction *instruction, int clock) {
+	if (value_numbering_is_store(instruction)) {
+		int variable = value_numbering_variable(instruction);
+		pointer_clock = clock;
+		if (variable >= 0) {
+			variable_clocks[variable] = clock;
+		} else {
+			unknown_clock = clock;
+		}
+	} else if (IR_CALL == instruction->kind || IR_SYS_CALL == instruction->kind) {
+		pointer_clock = clock;
+		unknown_clock = clock;
+	}
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+/*
+ * Nodes at the edge of a block stay where they are (the cfg refers to them)
+ * and go in the next dead code pass once nothing reads them.
+ */
+static void value_numbering_block(struct cfg_block *block, int *clock) {
+	struct ir_list *iter, *next;
+
+	for (iter = block->first; ; iter = next) {
+		struct ir_instruction *instruction = iter->data;
+		struct ir_operand *definition = ir_definition_operand(instruction);
+		bool is_last = iter == block->last;
+		struct value_numbering_key key;
+		int variable;
+
+		next = iter->next;
+		(*clock)++;
+		value_numbering_replace_uses(instruction);
+
+		if (
+			NULL != definition &&
+			value_numbering_is_temporary(definition) &&
+			value_numbering_make_key(instruction, &key, &variable)
+		) {
+			struct value_numbering_entry *entry = value_numbering_find(&key, block->id);
+
+			if (entry->block == block->id && value_numbering_is_valid(entry)) {
+				replacements[definition->data.temporary] = entry->temporary;
+				if (iter != block->first && !is_last) ir_unlink(iter);
+			} else {
+				entry->key = key;
+				entry->block = block->id;
+				entry->temporary = definition->data.temporary;
+				entry->variable = variable;
+				entry->clock = *clock;
+			}
+		}
+
+		value_numbering_clobber(instruction, *clock);
+		if (is_last) break;
+	}
+}
+
+void value_numbering(struct cfg *cfg) {
+	struct ir_list *iter;
+	int instruction_count = 0;
+
+	max_temporary = dataflow_max_temporary(cfg);
+	temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+	replacements = malloc(sizeof(int) * (max_temporary + 1));
+	assert(NULL != replacements);
+	for (int t = 0; t <= max_temporary; t++) replacements[t] = t;
+
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		instruction_count++;
+		if (iter == cfg->proc_end) break;
+	}
+	capacity = 16;
+	while (capacity < instruction_count * 2) capacity *= 2;
+	entries = malloc(sizeof(struct value_numbering_entry) * capacity);
+	assert(NULL != entries);
+	for (int slot = 0; slot < capacity; slot++) entries[slot].block = -1;
+
+	value_numbering_find_escapes(cfg);
+	pointer_clock = 0;
+	unknown_clock = 0;
+
+	int clock = 0;
+	for (int b = 0; b < cfg->block_count; b++) {
+		value_numbering_block(cfg->blocks[b], &clock);
+	}
+
+	/* uses in other blocks and phi arguments, the earlier temporary dominates them all in SSA form */
+	for (iter = cfg->proc_begin; ; iter = iter->next) {
+		value_numbering_replace_uses(iter->data);
+		if (iter == cfg->proc_end) break;
+	}
+
+	free(temporary_definitions);
+	free(replacements);
+	free(entries);
+	free(escapes);
+	free(variable_clocks);
+}
+
+void value_numbering_program(struct cfg *cfgs) {
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		value_numbering(cfg);
+	}
+}
@@ -0,0 +1,22 @@
+#ifndef _VALUE_NUMBERING_H
+#define _VALUE_NUMBERING_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Local value numbering over a function in SSA form. Within every basic
+ * block an expression, address or load that computes a value already held
+ * by an earlier temporary is dropped and its uses read that temporary.
+ * Operands are compared by value number (constants by their value), the
+ * operands of commutative opcodes are put in a fixed order, and a load is
+ * only reused while no store or call in between can have written the
+ * memory it reads.
+ */
+void value_numbering(struct cfg *cfg);
+void value_numbering_program(struct cfg *cfgs);
+
+#endif
@@ -0,0 +1,556 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "ir.h"
+#include "cfg.h"
+#include "dataflow.h"
+#include "value-range.h"
+
+/* what is known of a temporary: the signed range it lies in and the bits it must have */
+struct value_range_fact {
+	int64_t min, max;
+	uint32_t zeros, ones;
+};
+
+static int max_temporary;
+static struct ir_list **temporary_definitions;
+static int *definition_counts;
+static struct value_range_fact *facts;
+static bool *is_known;                          /* its definition has been seen */
+
+/*********
+ * FACTS *
+ *********/
+
+static struct value_range_fact value_range_anything(void) {
+	struct value_range_fact fact = { INT32_MIN, INT32_MAX, 0, 0 };
+	return fact;
+}
+
+static struct value_range_fact value_range_between(int64_t min, int64_t max) {
+	struct value_range_fact fact = value_range_anything();
+	if (min >= INT32_MIN && max <= INT32_MAX) {
+		fact.min = min;
+		fact.max = max;
+	}
+	return fact;
+}
+
+static struct value_range_fact value_range_constant(uint32_t value) {
+	struct value_range_fact fact = { (int32_t)value, (int32_t)value, ~value, value };
+	return fact;
+}
+
+static bool value_range_is_constant(struct value_range_fact *fact) {
+	return fact->min == fact->max;
+}
+
+/* the value with all bits up to the highest one of value set */
+static uint32_t value_range_smear(uint32_t value) {
+	value |= value >> 1;
+	value |= value >> 2;
+	value |= value >> 4;
+	value |= value >> 8;
+	value |= value >> 16;
+	return value;
+}
+
+static int value_range_trailing_zeros(uint32_t zeros) {
+	int count = 0;
+	while (count < 32 && (zeros & (1u << count))) count++;
+	return count;
+}
+
+/* each of range and bits narrowed by what the other says */
+static void value_range_normalize(struct value_range_fact *fact) {
+	int64_t min, max;
+
+	if (fact->min >= 0) fact->zeros |= ~value_range_smear((uint32_t)fact->max);
+	if (fact->max < 0) fact->ones |= ~value_range_smear(~(uint32_t)fact->min);
+
+	if (fact->zeros & 0x80000000u) {
+		min = fact->ones;
+		max = ~fact->zeros;
+	} else if (fact->ones & 0x80000000u) {
+		min = (int32_t)fact->ones;
+		max = (int32_t)~fact->zeros;
+	} else {
+		min = (int32_t)(fact->ones | 0x80000000u);
+		max = (int32_t)(~fact->zeros & 0x7fffffffu);
+	}
+	if (min > fact->min) fact->min = min;
+	if (max < fact->max) fact->max = max;
+
+	/* only in code that can't run */
+	if (fact->min > fact->max || (fact->zeros & fact->ones)) *fact = value_range_anything();
+	if (value_range_is_constant(fact)) *fact = value_range_constant((uint32_t)fact->min);
+}
+
+static struct value_range_fact value_range_join(struct value_range_fact *left, struct value_range_fact *right) {
+	struct value_range_fact fact;
+	fact.min = left->min < right->min ? left->min : right->min;
+	fact.max = left->max > right->max ? left->max : right->max;
+	fact.zeros = left->zeros & right->zeros;
+	fact.ones = left->ones & right->ones;
+	return fact;
+}
+
+/* operands[2] of a unary instruction is never set, so any temporary may turn up */
+static struct value_range_fact value_range_of(struct ir_operand *operand) {
+	if (OPERAND_TEMPORARY != operand->kind) return value_range_anything();
+
+	int temporary = operand->data.temporary;
+	if (temporary < 0 || temporary > max_temporary) return value_range_anything();
+	if (!is_known[temporary] || 1 != definition_counts[temporary]) return value_range_anything();
+	return facts[temporary];
+}
+
+/**************
+ * ARITHMETIC *
+ **************/
+
+static int64_t value_range_lowest(int64_t *values, int count) {
+	int64_t lowest = values[0];
+	for (int i = 1; i < count; i++) if (values[i] < lowest) lowest = values[i];
+	return lowest;
+}
+
+static int64_t value_range_highest(int64_t *values, int count) {
+	int64_t highest = values[0];
+	for (int i = 1; i < count; i++) if (values[i] > highest) highest = values[i];
+	return highest;
+}
+
+/* low bits that are zero in both stay zero in sums and differences, and add up in products */
+static uint32_t value_range_low_zeros(int count) {
+	return count >= 32 ? 0xffffffffu : (1u << count) - 1;
+}
+
+static struct value_range_fact value_range_add(struct value_range_fact *left, struct value_range_fact *right, bool is_subtraction) {
+	struct value_range_fact fact = is_subtraction ?
+		value_range_between(left->min - right->max, left->max - right->min) :
+		value_range_between(left->min + right->min, left->max + right->max);
+	int zeros_1 = value_range_trailing_zeros(left->zeros), zeros_2 = value_range_trailing_zeros(right->zeros);
+	fact.zeros |= value_range_low_zeros(zeros_1 < zeros_2 ? zeros_1 : zeros_2);
+	return fact;
+}
+
+/* the products of the ends of both ranges, of which two are the lowest and highest; 32 bit values multiply within 63 */
+static void value_range_products(struct value_range_fact *left, struct value_range_fact *right, int64_t *products) {
+	products[0] = left->min * right->min;
+	products[1] = left->min * right->max;
+	products[2] = left->max * right->min;
+	products[3] = left->max * right->max;
+}
+
+static struct value_range_fact value_range_multiply(struct value_range_fact *left, struct value_range_fact *right) {
+	struct value_range_fact fact;
+	int64_t products[4];
+
+	value_range_products(left, right, products);
+	fact = value_range_between(value_range_lowest(products, 4), value_range_highest(products, 4));
+	fact.zeros |= value_range_low_zeros(value_range_trailing_zeros(left->zeros) + value_range_trailing_zeros(right->zeros));
+	return fact;
+}
+
+/* the upper word of the 64 bit product, for division by constants */
+static struct value_range_fact value_range_multiply_high(struct value_range_fact *left, struct value_range_fact *right) {
+	int64_t products[4];
+
+	value_range_products(left, right, products);
+	return value_range_between(value_range_lowest(products, 4) >> 32, value_range_highest(products, 4) >> 32);
+}
+
+static struct value_range_fact value_range_divide(struct value_range_fact *left, struct value_range_fact *right) {
+	int64_t quotients[4];
+
+	if (right->min <= 0 && right->max >= 0) return value_range_anything();
+	quotients[0] = left->min / right->min;
+	quotients[1] = left->min / right->max;
+	quotients[2] = left->max / right->min;
+	quotients[3] = left->max / right->max;
+	return value_range_between(value_range_lowest(quotients, 4), value_range_highest(quotients, 4));
+}
+
+/* the remainder is smaller than the divisor and has the sign of the dividend */
+static struct value_range_fact value_range_remainder(struct value_range_fact *left, struct value_range_fact *right) {
+	if (right->min <= 0 && right->max >= 0) return value_range_anything();
+
+	int64_t limit = (right->min > 0 ? right->max : -right->min) - 1;
+	int64_t min = left->min < -limit ? -limit : left->min;
+	int64_t max = left->max > limit ? limit : left->max;
+	return value_range_between(min > 0 ? 0 : min, max < 0 ? 0 : max);
+}
+
+static struct value_range_fact value_range_shift(enum ir_instruction_kind kind, struct value_range_fact *left, struct value_range_fact *right) {
+	struct value_range_fact fact = value_range_anything();
+
+	/* by an amount that isn't known, only the sign of a right shift is */
+	if (!value_range_is_constant(right)) {
+		if (IR_RIGHT_SHIFT_SIGNED_WORD == kind) return value_range_between(left->min < 0 ? left->min : 0, left->max > 0 ? left->max : 0);
+		if (IR_RIGHT_SHIFT_UNSIGNED_WORD == kind && left->min >= 0) return value_range_between(0, left->max);
+		return fact;
+	}
+
+	/* sllv, srav and srlv only look at the low 5 bits of the amount */
+	int amount = (int)(right->min & 31);
+	switch (kind) {
+		case IR_LEFT_SHIFT_WORD:
+			fact = value_range_between(left->min * ((int64_t)1 << amount), left->max * ((int64_t)1 << amount));
+			fact.zeros = (left->zeros << amount) | value_range_low_zeros(amount);
+			fact.ones = left->ones << amount;
+			break;
+		case IR_RIGHT_SHIFT_SIGNED_WORD:
+			fact = value_range_between(left->min >> amount, left->max >> amount);
+			fact.zeros = (uint32_t)((int32_t)left->zeros >> amount);
+			fact.ones = (uint32_t)((int32_t)left->ones >> amount);
+			break;
+		case IR_RIGHT_SHIFT_UNSIGNED_WORD:
+			if (left->min >= 0) fact = value_range_between(left->min >> amount, left->max >> amount);
+			fact.zeros = (left->zeros >> amount) | ~(0xffffffffu >> amount);
+			fact.ones = left->ones >> amount;
+			break;
+		default:
+			assert(0);
+			break;
+	}
+	return fact;
+}
+
+static struct value_range_fact value_range_bits(enum ir_instruction_kind kind, struct value_range_fact *left, struct value_range_fact *right) {
+	struct value_range_fact fact = value_range_anything();
+
+	switch (kind) {
+		case IR_BITWISE_AND_WORD:
+			fact.zeros = left->zeros | right->zeros;
+			fact.ones = left->ones & right->ones;
+			if (left->min >= 0 || right->min >= 0) {
+				fact.min = 0;
+				fact.max = left->min < 0 || (right->min >= 0 && right->max < left->max) ? right->max : left->max;
+			}
+			break;
+		case IR_BITWISE_OR_WORD:
+			fact.zeros = left->zeros & right->zeros;
+			fact.ones = left->ones | right->ones;
+			break;
+		case IR_BITWISE_XOR_WORD:
+			fact.zeros = (left->zeros & right->zeros) | (left->ones & right->ones);
+			fact.ones = (left->zeros & right->ones) | (left->ones & right->zeros);
+			break;
+		default:
+			assert(0);
+			break;
+	}
+	return fact;
+}
+
+/* 1 or 0 if the ranges (or bits, for == and !=) decide the comparison, -1 if they don't */
+static int value_range_decide(enum ir_instruction_kind kind, struct value_range_fact *left, struct value_range_fact *right) {
+	bool is_different = (left->ones & right->zeros) || (left->zeros & right->ones);
+
+	/* unsigned compares like signed while both are non-negative */
+	switch (kind) {
+		case IR_LT_UNSIGNED_WORD:
+		case IR_LE_UNSIGNED_WORD:
+		case IR_GE_UNSIGNED_WORD:
+		case IR_GT_UNSIGNED_WORD:
+			if (left->min < 0 || right->min < 0) return -1;
+			break;
+		default:
+			break;
+	}
+
+	switch (kind) {
+		case IR_LT_SIGNED_WORD:
+		case IR_LT_UNSIGNED_WORD:
+			if (left->max < right->min) return 1;
+			if (left->min >= right->max) return 0;
+			return -1;
+		case IR_LE_SIGNED_WORD:
+		case IR_LE_UNSIGNED_WORD:
+			if (left->max <= right->min) return 1;
+			if (left->min > right->max) return 0;
+			return -1;
+		case IR_GE_SIGNED_WORD:
+		case IR_GE_UNSIGNED_WORD:
+			if (left->min >= right->max) return 1;
+			if (left->max < right->min) return 0;
+			return -1;
+		case IR_GT_SIGNED_WORD:
+		case IR_GT_UNSIGNED_WORD:
+			if (left->min > right->max) return 1;
+			if (left->max <= right->min) return 0;
+			return -1;
+		case IR_EQ_WORD:
+		case IR_NE_WORD:
+			if (is_different || left->max < right->min || left->min > right->max) return IR_NE_WORD == kind;
+			if (value_range_is_constant(left) && value_range_is_constant(right)) return IR_EQ_WORD == kind;
+			return -1;
+		default:
+			assert(0);
+			return -1;
+	}
+}
+
+/*
+ * Casts as the backend does them: the narrowing ones are a move, the signed
+ * widening ones shift left and arithmetic right by 16, 8 (byte to half word)
+ * and 24, and the unsigned ones mask with 0xff (half word to word) or 0xffff
+ * (byte to half word or word).
+ */
+static struct value_range_fact value_range_sign_extend(struct value_range_fact *operand, int bits) {
+	uint32_t low = value_range_low_zeros(bits - 1);
+	struct value_range_fact fact = value_range_between(-((int64_t)1 << (bits - 1)), ((int64_t)1 << (bits - 1)) - 1);
+
+	fact.zeros = operand->zeros & low;
+	fact.ones = operand->ones & low;
+	return fact;
+}
+
+static bool value_range_is_cast_redundant(enum ir_instruction_kind kind, struct value_range_fact *operand) {
+	switch (kind) {
+		case IR_CAST_SIGNED_HALF_WORD_TO_WORD:
+			return operand->min >= -32768 && operand->max <= 32767;
+		case IR_CAST_SIGNED_BYTE_TO_HALF_WORD:
+			return operand->min >= -8388608 && operand->max <= 8388607;
+		case IR_CAST_SIGNED_BYTE_TO_WORD:
+			return operand->min >= -128 && operand->max <= 127;
+		case IR_CAST_UNSIGNED_HALF_WORD_TO_WORD:
+			return 0 == (~operand->zeros & ~0xffu);
+		case IR_CAST_UNSIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_WORD:
+			return 0 == (~operand->zeros & ~0xffffu);
+		default:
+			return true;
+	}
+}
+
+static struct value_range_fact value_range_cast(enum ir_instruction_kind kind, struct value_range_fact *operand) {
+	struct value_range_fact mask;
+
+	if (value_range_is_cast_redundant(kind, operand)) return *operand;
+	switch (kind) {
+		case IR_CAST_SIGNED_HALF_WORD_TO_WORD:
+			return value_range_sign_extend(operand, 16);
+		case IR_CAST_SIGNED_BYTE_TO_HALF_WORD:
+			return value_range_sign_extend(operand, 24);
+		case IR_CAST_SIGNED_BYTE_TO_WORD:
+			return value_range_sign_extend(operand, 8);
+		case IR_CAST_UNSIGNED_HALF_WORD_TO_WORD:
+			mask = value_range_constant(0xff);
+			return value_range_bits(IR_BITWISE_AND_WORD, operand, &mask);
+		case IR_CAST_UNSIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_WORD:
+			mask = value_range_constant(0xffff);
+			return value_range_bits(IR_BITWISE_AND_WORD, operand, &mask);
+		default:
+			assert(0);
+			return value_range_anything();
+	}
+}
+
+static struct value_range_fact value_range_compute(struct ir_instruction *instruction) {
+	struct value_range_fact left = value_range_of(&instruction->operands[1]);
+	struct value_range_fact right = value_range_of(&instruction->operands[2]);
+	struct value_range_fact fact;
+	int decision;
+
+	switch (instruction->kind) {
+		case IR_CONST_INT:
+			return value_range_constant((uint32_t)instruction->operands[1].data.number);
+		case IR_COPY:
+			return left;
+		case IR_PHI:
+			if (0 == instruction->phi_argument_count) return value_range_anything();
+			fact = value_range_of(&instruction->phi_arguments[0]);
+			for (int i = 1; i < instruction->phi_argument_count; i++) {
+				struct value_range_fact argument = value_range_of(&instruction->phi_arguments[i]);
+				fact = value_range_join(&fact, &argument);
+			}
+			return fact;
+
+		/* lb and lh, whatever the kind */
+		case IR_LOAD_BYTE:
+		case IR_LOAD_SIGNED_BYTE:
+			return value_range_between(-128, 127);
+		case IR_LOAD_HALF_WORD:
+		case IR_LOAD_SIGNED_HALF_WORD:
+			return value_range_between(-32768, 32767);
+
+		case IR_ADD_SIGNED_WORD:
+		case IR_ADD_UNSIGNED_WORD:
+			return value_range_add(&left, &right, false);
+		case IR_SUB_SIGNED_WORD:
+		case IR_SUB_UNSIGNED_WORD:
+			return value_range_add(&left, &right, true);
+		case IR_MULT_SIGNED_WORD:
+		case IR_MULT_UNSIGNED_WORD:
+			return value_range_multiply(&left, &right);
+		case IR_MULT_HIGH_SIGNED_WORD:
+			return value_range_multiply_high(&left, &right);
+		case IR_MULT_HIGH_UNSIGNED_WORD:
+			if (left.min < 0 || right.min < 0) return value_range_anything();
+			return value_range_multiply_high(&left, &right);
+		case IR_DIV_SIGNED_WORD:
+			return value_range_divide(&left, &right);
+		case IR_DIV_UNSIGNED_WORD:
+			if (left.min < 0 || right.min < 0) return value_range_anything();
+			return value_range_divide(&left, &right);
+		case IR_REM_SIGNED_WORD:
+			return value_range_remainder(&left, &right);
+		case IR_REM_UNSIGNED_WORD:
+			if (right.min <= 0) return value_range_anything();
+			if (left.min < 0) return value_range_between(0, right.max - 1);
+			return value_range_remainder(&left, &right);
+		case IR_LEFT_SHIFT_WORD:
+		case IR_RIGHT_SHIFT_SIGNED_WORD:
+		case IR_RIGHT_SHIFT_UNSIGNED_WORD:
+			return value_range_shift(instruction->kind, &left, &right);
+		case IR_BITWISE_AND_WORD:
+		case IR_BITWISE_OR_WORD:
+		case IR_BITWISE_XOR_WORD:
+			return value_range_bits(instruction->kind, &left, &right);
+
+		case IR_LT_SIGNED_WORD:
+		case IR_LT_UNSIGNED_WORD:
+		case IR_LE_SIGNED_WORD:
+		case IR_LE_UNSIGNED_WORD:
+		case IR_GE_SIGNED_WORD:
+		case IR_GE_UNSIGNED_WORD:
+		case IR_GT_SIGNED_WORD:
+		case IR_GT_UNSIGNED_WORD:
+		case IR_EQ_WORD:
+		case IR_NE_WORD:
+			decision = value_range_decide(instruction->kind, &left, &right);
+			return decision < 0 ? value_range_between(0, 1) : value_range_constant(decision);
+
+		case IR_UNARY_MINUS:
+			return value_range_between(-left.max, -left.min);
+		case IR_UNARY_LOGICAL_NEGATION:
+			if (left.min > 0 || left.max < 0 || left.ones) return value_range_constant(0);
+			if (value_range_is_constant(&left)) return value_range_constant(1);
+			return value_range_between(0, 1);
+		case IR_UNARY_BITWISE_NEGATION:
+			fact = value_range_between(-left.max - 1, -left.min - 1);
+			fact.zeros = left.ones;
+			fact.ones = left.zeros;
+			return fact;
+
+		case IR_CAST_WORD_TO_HALF_WORD:
+		case IR_CAST_WORD_TO_BYTE:
+		case IR_CAST_HALF_WORD_TO_BYTE:
+		case IR_CAST_UNSIGNED_HALF_WORD_TO_WORD:
+		case IR_CAST_SIGNED_HALF_WORD_TO_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_SIGNED_BYTE_TO_HALF_WORD:
+		case IR_CAST_UNSIGNED_BYTE_TO_WORD:
+		case IR_CAST_SIGNED_BYTE_TO_WORD:
+			return value_range_cast(instruction->kind, &left);
+
+		default:
+			return value_range_anything();
+	}
+}
+
+/************
+ * REWRITES *
+ ************/
+
+static bool value_range_is_cast(struct ir_instruction *instruction) {
+	return instruction->kind >= IR_CAST_WORD_TO_HALF_WORD && instruction->kind <= IR_CAST_SIGNED_BYTE_TO_WORD;
+}
+
+static void value_range_to_copy(struct ir_instruction *instruction, int position) {
+	instruction->kind = IR_COPY;
+	instruction->operands[1] = instruction->operands[position];
+}
+
+/* and x, c where x has no bits outside c; or x, c where x has all the bits of c */
+static bool value_range_is_mask_redundant(struct ir_instruction *instruction, int position) {
+	struct value_range_fact operand = value_range_of(&instruction->operands[position]);
+	struct value_range_fact mask = value_range_of(&instruction->operands[3 - position]);
+
+	if (!value_range_is_constant(&mask)) return false;
+	if (IR_BITWISE_AND_WORD == instruction->kind) return 0 == (~operand.zeros & ~mask.ones);
+	if (IR_BITWISE_OR_WORD == instruction->kind) return 0 == (mask.ones & ~operand.ones);
+	return false;
+}
+
+static void value_range_rewrite(struct ir_instruction *instruction, struct value_range_fact *fact) {
+	if (!dataflow_is_expression(instruction)) return;
+
+	if (value_range_is_constant(fact)) {
+		instruction->kind = IR_CONST_INT;
+		ir_operand_number(instruction, 1, (uint32_t)fact->min);
+		return;
+	}
+
+	/* a cast of a value it leaves as it is */
+	if (value_range_is_cast(instruction)) {
+		struct value_range_fact operand = value_range_of(&instruction->operands[1]);
+		if (value_range_is_cast_redundant(instruction->kind, &operand)) value_range_to_copy(instruction, 1);
+		return;
+	}
+
+	for (int position = 1; position <= 2; position++) {
+		if (value_range_is_mask_redundant(instruction, position)) {
+			value_range_to_copy(instruction, position);
+			return;
+		}
+	}
+}
+
+/***********
+ * PROGRAM *
+ ***********/
+
+void value_range(struct cfg *cfg) {
+	max_temporary = dataflow_max_temporary(cfg);
+	temporary_definitions = dataflow_temporary_definitions(cfg, max_temporary);
+	definition_counts = calloc(max_temporary + 1, sizeof(int));
+	facts = calloc(max_temporary + 1, sizeof(struct value_range_fact));
+	is_known = calloc(max_temporary + 1, sizeof(bool));
+	assert(NULL != definition_counts && NULL != facts && NULL != is_known);
+
+	for (struct ir_list *iter = cfg->proc_begin; ; iter = iter->next) {
+		struct ir_operand *definition = ir_definition_operand(iter->data);
+		if (NULL != definition && OPERAND_TEMPORARY == definition->kind && definition->data.temporary <= max_temporary) {
+			definition_counts[definition->data.temporary]++;
+		}
+		if (iter == cfg->proc_end) break;
+	}
+
+	/* in reverse postorder every operand but those of loop phis is seen before its use */
+	for (int b = 0; b < cfg->reachable_count; b++) {
+		struct cfg_block *block = cfg->reverse_postorder[b];
+		for (struct ir_list *iter = block->first; ; iter = iter->next) {
+			struct ir_instruction *instruction = iter->data;
+			struct ir_operand *definition = ir_definition_operand(instruction);
+
+			if (NULL != definition && OPERAND_TEMPORARY == definition->kind && definition->data.temporary <= max_temporary) {
+				struct value_range_fact fact = value_range_compute(instruction);
+				value_range_normalize(&fact);
+				value_range_rewrite(instruction, &fact);
+
+				facts[definition->data.temporary] = fact;
+				is_known[definition->data.temporary] = true;
+			}
+			if (iter == block->last) break;
+		}
+	}
+
+	free(temporary_definitions);
+	free(definition_counts);
+	free(facts);
+	free(is_known);
+}
+
+void value_range_program(struct cfg *cfgs) {
+	for (struct cfg *cfg = cfgs; NULL != cfg; cfg = cfg->next) {
+		value_range(cfg);
+	}
+}
@@ -0,0 +1,28 @@
+#ifndef _VALUE_RANGE_H
+#define _VALUE_RANGE_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "ir.h"
+#include "cfg.h"
+
+/*
+ * Value range and known bits analysis over a function in SSA form. Every
+ * temporary gets the signed range it lies in and the bits it is known to
+ * have, from constants, the sign extension of byte and half word loads, the
+ * masks and shifts applied to it and the arithmetic on it, and these are
+ * used to
+ *
+ *   - turn casts into copies where the value already fits (a char loaded
+ *     and widened to an int is already sign extended),
+ *   - fold comparisons, and any other computation, whose result is known
+ *     (a char is always below 128),
+ *   - drop ands and ors that don't change any bit the value may have.
+ *
+ * Phis whose arguments come around a loop are taken to be anything.
+ */
+void value_range(struct cfg *cfg);
+void value_range_program(struct cfg *cfgs);
+
+#endif